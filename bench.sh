@@ -0,0 +1,69 @@
+#!/bin/sh -
+#
+# usage: bench.sh FILE.wav [NTHREADS...]
+#
+# thread scaling of the multi-threaded modes; build with make.sh first.
+#   times 'ttaR encode -t N' and 'ttaR decode -t N' for each N, and prints
+#   the best of NRUNS runs in seconds. the false sharing fixes only show
+#   up with more threads than there are idle cores to spare, so run it on
+#   a multi-core machine with N up to (and past) the core count
+#
+# needs a date(1) with '%N' (GNU, busybox)
+
+readonly ROOT="$(realpath "$(dirname "$0")")";
+readonly BUILD="$ROOT/build";
+
+readonly CLI="$BUILD/ttaR";
+
+readonly NRUNS="${NRUNS:-5}";
+
+##############################################################################
+
+if [ $# -lt 1 ] || [ ! -f "$1" ]; then
+	printf 'usage: %s FILE.wav [NTHREADS...]\n' "$0" >&2;
+	exit 1;
+fi
+if [ ! -x "$CLI" ]; then
+	printf '%s: %s not built; run make.sh\n' "$0" "$CLI" >&2;
+	exit 1;
+fi
+readonly INFILE="$1";
+shift;
+if [ $# -eq 0 ]; then
+	set -- 1 2 4 8 16 32;
+fi
+
+TMP="$(mktemp -d)" || exit $?;
+readonly TMP;
+trap 'rm -rf -- "$TMP"' EXIT;
+
+export LD_LIBRARY_PATH="$BUILD${LD_LIBRARY_PATH:+:$LD_LIBRARY_PATH}";
+
+# best_of MODE INFILE OUTFILE NTHREADS
+best_of() {
+	best=;
+	i=0;
+	while [ $i -lt "$NRUNS" ]; do
+		t0="$(date +%s.%N)";
+		"$CLI" "$1" -q -t "$4" -o "$3" -- "$2" || exit $?;
+		t1="$(date +%s.%N)";
+		best="$(awk -v a="$t0" -v b="$t1" -v best="$best" 'BEGIN {
+			t = b - a;
+			if ( (best == "") || (t < best) ){ best = t; }
+			printf "%.3f", best;
+		}')";
+		i=$((i + 1));
+	done
+	printf '%s' "$best";
+}
+
+# the file to decode
+"$CLI" encode -q -S -o "$TMP/in.tta" -- "$INFILE" || exit $?;
+
+printf '%-8s %8s %8s\n' 'threads' 'encode' 'decode';
+for n in "$@"; do
+	enc="$(best_of encode "$INFILE" "$TMP/out.tta" "$n")" || exit $?;
+	dec="$(best_of decode "$TMP/in.tta" "$TMP/out.wav" "$n")" || exit $?;
+	printf '%-8s %8s %8s\n' "$n" "$enc" "$dec";
+	rm -f -- "$TMP/out.tta" "$TMP/out.wav";
+done
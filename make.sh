@@ -5,6 +5,7 @@ readonly SRC="$ROOT/src";
 readonly BUILD="$ROOT/build";
 
 readonly LIB="$BUILD/libttaR.so";
+readonly LIB_MT="$BUILD/libttaR_mt.so";
 readonly CLI="$BUILD/ttaR";
 
 readonly CC='clang';
@@ -31,12 +32,19 @@ readonly CFLAGS_CLI;
 LD_CLI="-L$BUILD -lpthread -lttaR";
 readonly LD_CLI;
 
+CFLAGS_MT="$CFLAGS_SHARED";
+CFLAGS_MT="$CFLAGS_MT -O3";
+CFLAGS_MT="$CFLAGS_MT -shared -fPIC";
+readonly CFLAGS_MT;
+
 ##############################################################################
 
 if [ ! -e "$BUILD" ]; then
 	mkdir -- "$BUILD" || exit $?;
 fi
 cp -- "$SRC/libttaR.h" "$BUILD/" &
+cp -- "$SRC/libttaR_mt.h" "$BUILD/" &
 "$CC" $CFLAGS_LIB "$SRC/build_lib.c" -o "$LIB";
-"$CC" $CFLAGS_CLI "$SRC/build_cli.c" -o "$CLI" $LD_CLI;
+"$CC" $CFLAGS_CLI "$SRC/build_cli.c" -o "$CLI" $LD_CLI &
+"$CC" $CFLAGS_MT "$SRC/build_mt.c" -o "$LIB_MT" $LD_CLI;
 wait;
@@ -4,7 +4,7 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
@@ -20,6 +20,11 @@
 #define _POSIX_C_SOURCE		200809L
 #endif	/* _POSIX_C_SOURCE */
 
+/* for syscall(2) (futex, io_uring) */
+#if defined(__linux__) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE
+#endif	/* _DEFAULT_SOURCE */
+
 #if !defined(_FILE_OFFSET_BITS) || (_FILE_OFFSET_BITS < 64)
 #undef	_FILE_OFFSET_BITS
 #define _FILE_OFFSET_BITS	64
@@ -31,12 +36,15 @@
 
 #define C_BUILD_C
 
+#include "./cli/affinity.c"
 #include "./cli/alloc.c"
+#include "./cli/autotune.c"
 #include "./cli/cli.c"
 #include "./cli/debug.c"
 #include "./cli/formats/guid.c"
 #include "./cli/formats/metatags_skip.c"
 #include "./cli/formats/tta1_check.c"
+#include "./cli/formats/tta2_check.c"
 #include "./cli/formats/tta_seek.c"
 #include "./cli/formats/tta_seek_check.c"
 #include "./cli/formats/tta_write.c"
@@ -47,15 +55,21 @@
 #include "./cli/help.c"
 #include "./cli/main.c"
 #include "./cli/modes/bufs.c"
+#include "./cli/modes/mode_autotune.c"
 #include "./cli/modes/mode_decode.c"
 #include "./cli/modes/mode_decode_loop.c"
 #include "./cli/modes/mode_encode.c"
 #include "./cli/modes/mode_encode_loop.c"
+#include "./cli/modes/mode_repair.c"
+#include "./cli/modes/mode_test.c"
 #include "./cli/modes/mt-struct.c"
+#include "./cli/modes/resync.c"
 #include "./cli/open.c"
 #include "./cli/opts/common.c"
 #include "./cli/opts/decode.c"
 #include "./cli/opts/encode.c"
 #include "./cli/opts/optsget.c"
+#include "./cli/opts/repair.c"
+#include "./cli/opts/test.c"
 
 /* EOF //////////////////////////////////////////////////////////////////// */
@@ -0,0 +1,38 @@
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// build_mt.c                                                               //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+#ifndef S_SPLINT_S
+
+#if __STDC_VERSION__ < 199901L
+#error "compile with '-std=c99'"
+#endif	/* __STDC_VERSION__ */
+
+#if !defined(_POSIX_C_SOURCE) || (_POSIX_C_SOURCE < 200809L)
+#undef	_POSIX_C_SOURCE
+#define _POSIX_C_SOURCE		200809L
+#endif	/* _POSIX_C_SOURCE */
+
+/* for syscall(2) (futex) */
+#if defined(__linux__) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE
+#endif	/* _DEFAULT_SOURCE */
+
+#endif	/* S_SPLINT_S */
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#define C_BUILD_C
+
+#include "./mt/mt.c"
+#include "./mt/mt_dec.c"
+#include "./mt/mt_enc.c"
+
+/* EOF //////////////////////////////////////////////////////////////////// */
@@ -0,0 +1,347 @@
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// affinity.c                                                               //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//      --affinity thread placement. Only the CPUs in the mask the process  //
+// started with are used. They are ordered with the first thread of every   //
+// physical core first, then the second, and so on, so the coders get      //
+// distinct cores before any two share one. The reader and writer get:      //
+//     - the last physical core, if the coders leave one free               //
+//     - else the SMT siblings the coders do not use                        //
+//     - else the whole startup mask                                        //
+// A thread inherits the mask of the thread that creates it, so the main    //
+// thread sets its own mask before creating each thread, then restores it.  //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+#include <assert.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "./affinity.h"
+#include "./common.h"
+#include "./debug.h"
+#include "./system.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#define CPUSET_WORDBITS		(CHAR_BIT * sizeof(unsigned long))
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#undef set
+ALWAYS_INLINE void cpuset_add(struct CPUSet *RESTRICT set, unsigned int)
+/*@modifies	*set@*/
+;
+
+PURE
+ALWAYS_INLINE bool cpuset_test(const struct CPUSet *RESTRICT, unsigned int)
+/*@*/
+;
+
+static unsigned int affinity_coder_cpu(unsigned int, unsigned int)
+/*@globals	affinity@*/
+;
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/**@var affinity
+ * @brief the placement order; unused if ncpu is 0
+**/
+/*@checkmod@*/
+static struct Affinity affinity;
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/**@fn affinity_load
+ * @brief gets the startup mask and the core of each CPU in it, and orders
+ *   the CPUs for placement
+ *
+ * @note a CPU with an unknown topology counts as a core of its own
+**/
+BUILD NOINLINE void
+affinity_load(void)
+/*@globals	fileSystem,
+		internalState,
+		affinity
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		affinity
+@*/
+{
+	unsigned int package[CPUSET_NCPU], coreid[CPUSET_NCPU];
+	uint16_t     list[CPUSET_NCPU], rank[CPUSET_NCPU], idx[CPUSET_NCPU];
+	unsigned int ncpu = 0, ncore = 0, cpu, i, j, k, r;
+
+	memset(&affinity, 0x00, sizeof affinity);
+
+	if UNLIKELY ( ! cpuset_get(&affinity.orig) ){
+		warning_tta("%s: not supported on this system", "--affinity");
+		return;
+	}
+
+	/* the allowed CPUs, and which core each is on */
+	for ( cpu = 0; cpu < CPUSET_NCPU; ++cpu ){
+		if ( ! cpuset_test(&affinity.orig, cpu) ){
+			continue;
+		}
+		if ( ! cpu_topology(cpu, &package[ncpu], &coreid[ncpu]) ){
+			package[ncpu] = UINT_MAX;
+			coreid[ncpu]  = cpu;
+		}
+		list[ncpu++] = (uint16_t) cpu;
+	}
+	if UNLIKELY ( ncpu == 0 ){
+		return;
+	}
+
+	/* the rank of each CPU among its SMT siblings, and its core */
+	for ( i = 0; i < ncpu; ++i ){
+		rank[i] = 0;
+		idx[i]  = 0;
+		for ( j = 0; j < i; ++j ){
+			if ( (package[j] == package[i])
+			    &&
+			     (coreid[j] == coreid[i])
+			){
+				idx[i]   = idx[j];
+				rank[i] += 1u;
+			}
+		}
+		if ( rank[i] == 0 ){
+			idx[i] = (uint16_t) ncore++;
+		}
+	}
+
+	/* placement order */
+	k = 0;
+	for ( r = 0; k < ncpu; ++r ){
+		for ( i = 0; i < ncpu; ++i ){
+			if ( rank[i] == r ){
+				affinity.cpu[k]  = list[i];
+				affinity.core[k] = idx[i];
+				k += 1u;
+			}
+		}
+	}
+	affinity.ncpu  = ncpu;
+	affinity.ncore = ncore;
+
+	return;
+}
+
+/**@fn affinity_nthreads_default
+ * @brief the default number of coder threads
+ *
+ * @return the number of physical cores in the startup mask with
+ *   --affinity, else the number of online processors
+**/
+BUILD unsigned int
+affinity_nthreads_default(void)
+/*@globals	internalState,
+		affinity
+@*/
+{
+	return (affinity.ncpu != 0
+		? affinity.ncore : get_nprocessors_onln()
+	);
+}
+
+/**@fn affinity_nprocessors
+ * @brief the number of processors the threads can run on
+ *
+ * @return the number of CPUs in the startup mask with --affinity, else the
+ *   number of online processors
+**/
+BUILD unsigned int
+affinity_nprocessors(void)
+/*@globals	internalState,
+		affinity
+@*/
+{
+	return (affinity.ncpu != 0
+		? affinity.ncpu : get_nprocessors_onln()
+	);
+}
+
+/* ======================================================================== */
+
+/**@fn affinity_set_io
+ * @brief sets the calling thread's mask to the one for the reader and
+ *   writer threads
+ *
+ * @param ncoders - number of coder threads
+**/
+BUILD void
+affinity_set_io(const unsigned int ncoders)
+/*@globals	internalState,
+		affinity
+@*/
+/*@modifies	internalState@*/
+{
+	const unsigned int io_core = affinity.ncore - 1u;
+	struct CPUSet set;
+	unsigned int k;
+
+	if ( affinity.ncpu == 0 ){
+		return;
+	}
+
+	memset(&set, 0x00, sizeof set);
+	if ( ncoders < affinity.ncore ){
+		/* a core of its own */
+		for ( k = 0; k < affinity.ncpu; ++k ){
+			if ( affinity.core[k] == io_core ){
+				cpuset_add(&set, affinity.cpu[k]);
+			}
+		}
+	}
+	else if ( ncoders < affinity.ncpu ){
+		/* the SMT siblings left over */
+		for ( k = ncoders; k < affinity.ncpu; ++k ){
+			cpuset_add(&set, affinity.cpu[k]);
+		}
+	}
+	else {	set = affinity.orig; }
+
+	(void) cpuset_set(&set);
+	return;
+}
+
+/**@fn affinity_set_coder
+ * @brief sets the calling thread's mask to the one for a coder thread
+ *
+ * @param i       - index of the coder thread
+ * @param ncoders - number of coder threads
+**/
+BUILD void
+affinity_set_coder(const unsigned int i, const unsigned int ncoders)
+/*@globals	internalState,
+		affinity
+@*/
+/*@modifies	internalState@*/
+{
+	struct CPUSet set;
+
+	if ( affinity.ncpu == 0 ){
+		return;
+	}
+
+	memset(&set, 0x00, sizeof set);
+	cpuset_add(&set, affinity_coder_cpu(i, ncoders));
+
+	(void) cpuset_set(&set);
+	return;
+}
+
+/**@fn affinity_restore
+ * @brief restores the calling thread's startup mask
+**/
+BUILD void
+affinity_restore(void)
+/*@globals	internalState,
+		affinity
+@*/
+/*@modifies	internalState@*/
+{
+	if ( affinity.ncpu == 0 ){
+		return;
+	}
+	(void) cpuset_set(&affinity.orig);
+	return;
+}
+
+/* ------------------------------------------------------------------------ */
+
+/**@fn affinity_coder_cpu
+ * @brief picks the CPU for a coder thread
+ *
+ * @param i       - index of the coder thread
+ * @param ncoders - number of coder threads
+ *
+ * @return the CPU
+ *
+ * @note with more coders than CPUs, they wrap around
+**/
+static unsigned int
+affinity_coder_cpu(unsigned int i, const unsigned int ncoders)
+/*@globals	affinity@*/
+{
+	const unsigned int io_core = affinity.ncore - 1u;
+	unsigned int nskip = 0, k;
+
+	assert(affinity.ncpu != 0);
+
+	if ( ncoders >= affinity.ncore ){
+		return affinity.cpu[i % affinity.ncpu];
+	}
+
+	/* skip the reader/writer core */
+	for ( k = 0; k < affinity.ncpu; ++k ){
+		if ( affinity.core[k] == io_core ){
+			nskip += 1u;
+		}
+	}
+	i %= affinity.ncpu - nskip;
+	for ( k = 0; k < affinity.ncpu; ++k ){
+		if ( affinity.core[k] == io_core ){
+			continue;
+		}
+		if ( i-- == 0 ){
+			break;
+		}
+	}
+	assert(k < affinity.ncpu);
+
+	return affinity.cpu[k];
+}
+
+/* ======================================================================== */
+
+/**@fn cpuset_add
+ * @brief adds a CPU to a set
+ *
+ * @param set - CPU set
+ * @param cpu - CPU number
+**/
+ALWAYS_INLINE void
+cpuset_add(struct CPUSet *const RESTRICT set, const unsigned int cpu)
+/*@modifies	*set@*/
+{
+	assert(cpu < CPUSET_NCPU);
+
+	set->word[cpu / CPUSET_WORDBITS] |= (1uL << (cpu % CPUSET_WORDBITS));
+	return;
+}
+
+/**@fn cpuset_test
+ * @brief checks whether a CPU is in a set
+ *
+ * @param set - CPU set
+ * @param cpu - CPU number
+ *
+ * @return true if it is
+**/
+PURE
+ALWAYS_INLINE bool
+cpuset_test(const struct CPUSet *const RESTRICT set, const unsigned int cpu)
+/*@*/
+{
+	assert(cpu < CPUSET_NCPU);
+
+	return (((set->word[cpu / CPUSET_WORDBITS]
+		>> (cpu % CPUSET_WORDBITS)) & 1uL) != 0
+	);
+}
+
+/* EOF //////////////////////////////////////////////////////////////////// */
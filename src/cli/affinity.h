@@ -0,0 +1,67 @@
+#ifndef H_TTA_AFFINITY_H
+#define H_TTA_AFFINITY_H
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// affinity.h                                                               //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "./common.h"
+#include "./system.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+struct Affinity {
+	struct CPUSet	orig;			/* mask on startup          */
+	unsigned int	ncpu;			/* 0 if not in use          */
+	unsigned int	ncore;
+	uint16_t	cpu[CPUSET_NCPU];	/* placement order          */
+	uint16_t	core[CPUSET_NCPU];	/* physical core of cpu[]   */
+};
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+BUILD_EXTERN NOINLINE void affinity_load(void)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState
+@*/
+;
+
+BUILD_EXTERN unsigned int affinity_nthreads_default(void)
+/*@globals	internalState@*/
+;
+
+BUILD_EXTERN unsigned int affinity_nprocessors(void)
+/*@globals	internalState@*/
+;
+
+/* ------------------------------------------------------------------------ */
+
+BUILD_EXTERN void affinity_set_io(unsigned int)
+/*@globals	internalState@*/
+/*@modifies	internalState@*/
+;
+
+BUILD_EXTERN void affinity_set_coder(unsigned int, unsigned int)
+/*@globals	internalState@*/
+/*@modifies	internalState@*/
+;
+
+BUILD_EXTERN void affinity_restore(void)
+/*@globals	internalState@*/
+/*@modifies	internalState@*/
+;
+
+/* EOF //////////////////////////////////////////////////////////////////// */
+#endif	/* H_TTA_AFFINITY_H */
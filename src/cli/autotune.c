@@ -0,0 +1,347 @@
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// autotune.c                                                               //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//      the cache is a small text file:                                     //
+//                                                                          //
+//      libttaR VERSION (DATE); BUILDINFO; CPU                              //
+//      MODE SAMPLEBYTES NCHAN KERNEL                                       //
+//      ...                                                                 //
+//                                                                          //
+//      MODE is "enc" or "dec", and KERNEL is "default" or "mch". The first //
+// line is the key; the timings only hold for the same library build on    //
+// the same CPU model, so a cache with any other key is thrown out.        //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../libttaR.h"
+
+#include "./alloc.h"
+#include "./autotune.h"
+#include "./common.h"
+#include "./debug.h"
+#include "./main.h"
+#include "./system.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#undef dest
+static void autotune_key(/*@out@*/ char *RESTRICT dest, size_t)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*dest
+@*/
+;
+
+#undef at
+#undef line
+static int autotune_line_parse(
+	struct AutoTune *RESTRICT at, const char *RESTRICT line
+)
+/*@modifies	*at@*/
+;
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/**@var autotune
+ * @brief kernel choices loaded from the cache; all default if none
+**/
+/*@checkmod@*/
+static struct AutoTune autotune;
+
+/*@unchecked@*/
+static const char *const autotune_mode_str[2u] = { "enc", "dec" };
+
+/*@unchecked@*/
+static const char *const autotune_kernel_str[LIBTTAr_KERNEL_MAX + 1u] = {
+	"default", "mch"
+};
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/**@fn autotune_cache_name
+ * @brief gets the name of the autotune cache file
+ *
+ * @return the name of the cache file, or NULL if there is no cache directory
+**/
+/*@only@*/ /*@null@*/
+BUILD char *
+autotune_cache_name(void)
+/*@globals	internalState@*/
+/*@modifies	internalState@*/
+{
+	const char *dir = getenv(CACHEDIR_ENV);
+	const char *sfx = "";
+	char *retval;
+	size_t size;
+	UNUSED union {	int d; } result;
+
+	if ( (dir == NULL) || (dir[0] == '\0') ){
+		dir = getenv(CACHEDIR_ENV_FALLBACK);
+		sfx = CACHEDIR_SFX_FALLBACK;
+	}
+	if ( (dir == NULL) || (dir[0] == '\0') ){
+		return NULL;
+	}
+
+	size   = strlen(dir) + strlen(sfx) + (sizeof AUTOTUNE_CACHE_NAME) + 1u;
+	retval = malloc_check(size);
+	result.d = snprintf(
+		retval, size, "%s%s%c%s", dir, sfx, PATH_DELIM,
+		AUTOTUNE_CACHE_NAME
+	);
+	assert((result.d > 0) && ((size_t) result.d < size));
+
+	return retval;
+}
+
+/**@fn autotune_load
+ * @brief loads the kernel choices from the cache file, if there is one
+ *
+ * @note a missing cache is not an error; everything stays default
+**/
+BUILD NOINLINE void
+autotune_load(void)
+/*@globals	fileSystem,
+		internalState,
+		autotune
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		autotune
+@*/
+{
+	struct AutoTune at;
+	char line[AUTOTUNE_KEY_SIZE], key[AUTOTUNE_KEY_SIZE];
+	char *name;
+	FILE *file;
+	size_t lineno = 0;
+	union {	int d; } result;
+
+	name = autotune_cache_name();
+	if ( name == NULL ){
+		return;
+	}
+	file = fopen(name, "r");
+	if ( file == NULL ){
+		free(name);
+		return;
+	}
+	memset(&at, 0x00, sizeof at);
+
+	/* key check */
+	if UNLIKELY (
+	     (fgets(line, (int) sizeof line, file) == NULL)
+	    ||
+	     (strncmp(line, "libttaR ", (sizeof "libttaR ") - 1u) != 0)
+	){
+		warning_tta("%s: malformed autotune cache", name);
+		goto cleanup;
+	}
+	lineno += 1u;
+	line[strcspn(line, "\n")] = '\0';
+	autotune_key(key, sizeof key);
+	if UNLIKELY ( strcmp(line, key) != 0 ){
+		warning_tta("%s: stale autotune cache, rerun --autotune", name);
+		goto cleanup;
+	}
+
+	/* kernel choices */
+	while ( fgets(line, (int) sizeof line, file) != NULL ){
+		lineno += 1u;
+		result.d = autotune_line_parse(&at, line);
+		if UNLIKELY ( result.d != 0 ){
+			warning_tta(
+				"%s: malformed autotune cache, line %zu",
+				name, lineno
+			);
+			goto cleanup;
+		}
+	}
+	autotune = at;
+cleanup:
+	result.d = fclose(file);
+	if UNLIKELY ( result.d != 0 ){
+		error_sys_nf(errno, "fclose", name);
+	}
+	free(name);
+	return;
+}
+
+/**@fn autotune_key
+ * @brief makes the key line of the cache file
+ *
+ * @param dest - destination buffer
+ * @param size - size of 'dest'
+ *
+ * @note the key is the full library version, how the library was built
+ *   (compiler, LIBTTAr_OPT_*, SIMD), and the CPU model
+**/
+static void
+autotune_key(/*@out@*/ char *const RESTRICT dest, const size_t size)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*dest
+@*/
+{
+	char cpu[AUTOTUNE_CPU_SIZE];
+
+	if ( ! cpu_model(cpu, sizeof cpu) ){
+		(void) snprintf(cpu, sizeof cpu, "unknown");
+	}
+	(void) snprintf(dest, size, "libttaR %u.%u.%u-%u%s%s (%s); %s; %s",
+		libttaR_info.version, libttaR_info.version_major,
+		libttaR_info.version_minor, libttaR_info.version_revis,
+		(libttaR_info.version_extra[0] != '\0' ? "~" : ""),
+		libttaR_info.version_extra, libttaR_info.version_date,
+		libttaR_buildinfo, cpu
+	);
+	return;
+}
+
+/**@fn autotune_line_parse
+ * @brief parses a kernel choice line from the cache file
+ *
+ * @param at   - autotune struct to fill
+ * @param line - the line
+ *
+ * @return 0 on success
+**/
+static int
+autotune_line_parse(
+	struct AutoTune *const RESTRICT at, const char *const RESTRICT line
+)
+/*@modifies	*at@*/
+{
+	char mode_str[4u], kernel_str[8u];
+	unsigned int samplebytes, nchan;
+	unsigned int mode, kernel;
+
+	if ( sscanf(
+		line, "%3s %u %u %7s", mode_str, &samplebytes, &nchan,
+		kernel_str
+	     ) != 4
+	){
+		return -1;
+	}
+	for ( mode = 0; mode < 2u; ++mode ){
+		if ( strcmp(mode_str, autotune_mode_str[mode]) == 0 ){
+			break;
+		}
+	}
+	for ( kernel = 0; kernel <= LIBTTAr_KERNEL_MAX; ++kernel ){
+		if ( strcmp(kernel_str, autotune_kernel_str[kernel]) == 0 ){
+			break;
+		}
+	}
+	if ( (mode == 2u)
+	    ||
+	     (samplebytes == 0) || (samplebytes > LIBTTAr_SAMPLEBYTES_MAX)
+	    ||
+	     (nchan == 0) || (nchan > AUTOTUNE_NCLASS)
+	    ||
+	     (kernel > LIBTTAr_KERNEL_MAX)
+	){
+		return -1;
+	}
+
+	at->kernel[mode][samplebytes - 1u][nchan - 1u] = (
+		(enum LibTTAr_Kernel) kernel
+	);
+	return 0;
+}
+
+/**@fn autotune_save
+ * @brief writes the kernel choices to the cache file
+ *
+ * @param at   - autotune struct
+ * @param name - name of the cache file
+ *
+ * @return 0 on success
+**/
+BUILD NOINLINE int
+autotune_save(
+	const struct AutoTune *const RESTRICT at,
+	const char *const RESTRICT name
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem@*/
+{
+	char key[AUTOTUNE_KEY_SIZE];
+	FILE *file;
+	unsigned int mode, i, j;
+	union {	int d; } result;
+
+	autotune_key(key, sizeof key);
+	file = fopen(name, "w");
+	if UNLIKELY ( file == NULL ){
+		error_sys_nf(errno, "fopen", name);
+		return -1;
+	}
+
+	(void) fprintf(file, "%s\n", key);
+	for ( mode = 0; mode < 2u; ++mode ){
+		for ( i = 0; i < LIBTTAr_SAMPLEBYTES_MAX; ++i ){
+			for ( j = 0; j < AUTOTUNE_NCLASS; ++j ){
+				(void) fprintf(file, "%s %u %u %s\n",
+					autotune_mode_str[mode], i + 1u,
+					j + 1u, autotune_kernel_str[
+						at->kernel[mode][i][j]
+					]
+				);
+			}
+		}
+	}
+
+	result.d = fclose(file);
+	if UNLIKELY ( result.d != 0 ){
+		error_sys_nf(errno, "fclose", name);
+		return -1;
+	}
+	return 0;
+}
+
+/**@fn autotune_kernel
+ * @brief gets the kernel to use for a file
+ *
+ * @param mode        - encode or decode
+ * @param samplebytes - number of bytes per PCM sample
+ * @param nchan       - number of audio channels
+ *
+ * @return the kernel for the codec functions' misc struct
+**/
+PURE
+BUILD enum LibTTAr_Kernel
+autotune_kernel(
+	const enum ProgramMode mode, const enum LibTTAr_SampleBytes samplebytes,
+	const unsigned int nchan
+)
+/*@globals	autotune@*/
+{
+	/* only the unrolled nchan have a choice */
+	if ( (nchan == 0) || (nchan > AUTOTUNE_NCLASS) ){
+		return LIBTTAr_KERNEL_DEFAULT;
+	}
+	return autotune.kernel[mode][samplebytes - 1u][nchan - 1u];
+}
+
+/* EOF //////////////////////////////////////////////////////////////////// */
@@ -0,0 +1,70 @@
+#ifndef H_TTA_AUTOTUNE_H
+#define H_TTA_AUTOTUNE_H
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// autotune.h                                                               //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+#include "../libttaR.h"
+
+#include "./common.h"
+#include "./main.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#define AUTOTUNE_CACHE_NAME	"ttaR.autotune"
+
+/* nchan classes with more than one kernel: 1ch, 2ch */
+#define AUTOTUNE_NCLASS		2u
+
+/* the key line of the cache file, and the CPU model part of it */
+#define AUTOTUNE_KEY_SIZE	1024u
+#define AUTOTUNE_CPU_SIZE	 128u
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+struct AutoTune {
+	/* [mode][samplebytes - 1u][nchan - 1u] */
+	enum LibTTAr_Kernel	kernel[2u][LIBTTAr_SAMPLEBYTES_MAX][AUTOTUNE_NCLASS];
+};
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/*@only@*/ /*@null@*/
+BUILD_EXTERN char *autotune_cache_name(void)
+/*@globals	internalState@*/
+/*@modifies	internalState@*/
+;
+
+BUILD_EXTERN NOINLINE void autotune_load(void)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState
+@*/
+;
+
+#undef at
+BUILD_EXTERN NOINLINE int autotune_save(
+	const struct AutoTune *RESTRICT at, const char *RESTRICT
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem@*/
+;
+
+PURE
+BUILD_EXTERN enum LibTTAr_Kernel autotune_kernel(
+	enum ProgramMode, enum LibTTAr_SampleBytes, unsigned int
+)
+/*@*/
+;
+
+/* EOF //////////////////////////////////////////////////////////////////// */
+#endif	/* H_TTA_AUTOTUNE_H */
@@ -4,7 +4,7 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
@@ -61,6 +61,11 @@ static void errprint_stats_codectime(double, double, size_t)
 /*@modifies	fileSystem@*/
 ;
 
+static void errprint_stats_queue(const struct QueueStats *RESTRICT)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem@*/
+;
+
 CONST
 /*@observer@*/
 static const char *decfmt_name(enum DecFormat) /*@*/;
@@ -141,6 +146,9 @@ errprint_stats_postcodec(
 	errprint_stats_pcm(pcmtime, estat->nframes, nbytes_pcm);
 	errprint_stats_tta(pcmtime, nbytes_pcm, estat->nbytes_encoded);
 	errprint_stats_codectime(pcmtime, estat->encodetime, nbytes_pcm);
+	if ( estat->queue.depth_in != 0 ){
+		errprint_stats_queue(&estat->queue);
+	}
 
 	return;
 }
@@ -150,7 +158,7 @@ errprint_stats_postcodec(
  *
  * @param runtime - total runtime
  * @param nfiles  - total number of files coded
- * @param mode    - encode or decode
+ * @param mode    - encode, decode, or test
 **/
 BUILD NOINLINE void
 errprint_runtime(
@@ -171,11 +179,14 @@ errprint_runtime(
 	case MODE_DECODE:
 		mode_str = "decoded";
 		break;
+	case MODE_TEST:
+		mode_str = "tested";
+		break;
 	}
 
 	(void) fputc('\n', stderr);
-	(void) fprintf(stderr, " %zu files %s (and written) in ",
-		nfiles, mode_str
+	(void) fprintf(stderr, " %zu files %s%s in ",
+		nfiles, mode_str, (mode != MODE_TEST ? " (and written)" : "")
 	);
 	errprint_time(runtime);
 	/* MAYBE print the number of warnings */
@@ -428,6 +439,32 @@ errprint_stats_codectime(
 	return;
 }
 
+/**@fn errprint_stats_queue
+ * @brief print stats about the multi-threaded frame queue to stderr
+ *
+ * @param qstat - frame queue stats struct
+**/
+static void
+errprint_stats_queue(const struct QueueStats *const RESTRICT qstat)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem@*/
+{
+	(void) fputs(" queue\t: ", stderr);
+	(void) fprintf(stderr, "%u in, %u out",
+		qstat->depth_in, qstat->depth_out
+	);
+
+	(void) fputs("\t; stalls ", stderr);
+	(void) fprintf(stderr, "%zu read, %zu code, %zu write",
+		qstat->nstall_reader, qstat->nstall_coder,
+		qstat->nstall_writer
+	);
+
+	(void) fputc('\n', stderr);
+
+	return;
+}
+
 /* ------------------------------------------------------------------------ */
 
 /**@fn decfmt_name
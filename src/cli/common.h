@@ -6,7 +6,7 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
@@ -54,6 +54,7 @@
 #define X_ATTRIBUTE_GNUC_COLD		cold
 
 #define X_ATTRIBUTE_GNUC_PACKED		packed
+#define X_ATTRIBUTE_GNUC_ALIGNED	aligned
 
 #else	/* ! defined(__GNUC__) */
 
@@ -69,6 +70,7 @@
 #define X_ATTRIBUTE_GNUC_COLD		nil
 
 #define X_ATTRIBUTE_GNUC_PACKED		nil
+#define X_ATTRIBUTE_GNUC_ALIGNED	nil
 
 #endif	/* __GNUC__ */
 
@@ -154,6 +156,14 @@
 #define PACKED
 #endif	/* PACKED */
 
+/* only a hint; nothing may depend on it for correctness */
+#if X_HAS_ATTRIBUTE_GNUC(X_ATTRIBUTE_GNUC_ALIGNED)
+#define ALIGNED(x_align)	\
+	__attribute__((X_ATTRIBUTE_GNUC_ALIGNED(x_align)))
+#else
+#define ALIGNED(x_align)
+#endif	/* ALIGNED */
+
 /* //////////////////////////////////////////////////////////////////////// */
 
 #ifdef __GNUC__
@@ -223,5 +233,8 @@
 #define BUILD_EXTERN		extern /*@external@*/ /*@unused@*/
 #endif	/* C_BUILD_C */
 
+/* libttaR_mt's public functions */
+#define BUILD_EXPORT		/*@unused@*/
+
 /* EOF //////////////////////////////////////////////////////////////////// */
 #endif	/* H_TTA_CODEC_COMMON_H */
@@ -4,7 +4,7 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
@@ -23,6 +23,7 @@
 #include "./debug.h"
 #include "./formats.h"
 #include "./main.h"
+#include "./modes/atomic.h"
 #include "./system.h"
 
 /* //////////////////////////////////////////////////////////////////////// */
@@ -48,13 +49,14 @@ static NOINLINE void print_error_tta(
  * @return value of g_nwarnings
  *
  * @note g_nwarnings is the return value of the program
+ * @note atomic, since the worker threads of 'ttaR test' report errors too
 **/
 static int
 inc_nwarnings(void)
 /*@globals	g_nwarnings@*/
 /*@modifies	g_nwarnings@*/
 {
-	return (int) (g_nwarnings += (uint8_t) (g_nwarnings < UINT8_MAX));
+	return (int) atomic_inc_sat_u8(&g_nwarnings);
 }
 
 /* ======================================================================== */
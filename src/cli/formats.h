@@ -6,7 +6,7 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
@@ -26,16 +26,21 @@
 /* //////////////////////////////////////////////////////////////////////// */
 
 enum EncFormat {
-	xENCFMT_TTA1
-/*
+	xENCFMT_TTA1,
 	xENCFMT_TTA2
+/*
 	xENCFMT_MKA_TTA1
 	xENCFMT_MKA_TTA2
 */
 };
-#define xENCFMT_NMEMB		1u
-#define xENCFMT_NAME_ARRAY	{ "tta1"}
-#define xENCFMT_EXT_ARRAY	{".tta" }
+#define xENCFMT_NMEMB		2u
+#define xENCFMT_NAME_ARRAY	{ "tta1",  "tta2"}
+#define xENCFMT_EXT_ARRAY	{".tta" , ".tta" }
+
+/* what comes after the TTA of a frame; the CRC, or a TTA2 frame footer */
+#define TTA_FRAMEFOOTER_LEN(x_encfmt)	((x_encfmt) == xENCFMT_TTA2 \
+	? sizeof(struct TTA2FrameFooter) : sizeof(uint32_t) \
+)
 
 enum DecFormat {
 	DECFMT_RAWPCM,
@@ -83,9 +88,12 @@ struct SeekTable {
 
 /* ======================================================================== */
 
+/* decpcm_size of a stream that is read until it ends (a pipe) */
+#define DECPCM_SIZE_UNKNOWN	SIZE_MAX
+
 /* MAYBE: have a Dec/Enc FileStats and a CommonFileStats */
 struct FileStats {
-	off_t			decpcm_off;
+	off_t			decpcm_off;	/* -1 for a pipe          */
 	size_t			decpcm_size;
 
 	off_t			enctta_off;	/* end of TTA header      */
@@ -110,12 +118,23 @@ struct FileStats {
 	struct Guid128		wavsubformat;	/* Extensible only        */
 };
 
+/* -M frame queue; all zero in -S */
+struct QueueStats {
+	unsigned int	depth_in;	/* input buffers at the end       */
+	unsigned int	depth_out;	/* output buffers at the end      */
+	size_t		nstall_reader;	/* waits for a free buffer        */
+	size_t		nstall_coder;	/* waits for the reader           */
+	size_t		nstall_writer;	/* waits for the coders           */
+};
+
 struct EncStats {
 	size_t	nframes;
 	size_t	nsamples_flat;
 	size_t	nsamples_perchan;	/* for TTA1 header        */
 	size_t	nbytes_encoded;
+	size_t	nframes_badverify;	/* --verify mismatches    */
 	double	encodetime;
+	struct QueueStats	queue;
 };
 
 struct DecStats {
@@ -124,6 +143,7 @@ struct DecStats {
 	size_t	nsamples_perchan;
 	size_t	nbytes_decoded;
 	double	decodetime;
+	struct QueueStats	queue;
 };
 
 /* //////////////////////////////////////////////////////////////////////// */
@@ -170,6 +190,22 @@ BUILD_EXTERN enum FileCheck filecheck_tta1(
 
 /* ------------------------------------------------------------------------ */
 
+/* tta2_check.c */
+
+#undef fstat
+#undef file
+BUILD_EXTERN enum FileCheck filecheck_tta2(
+	/*@out@*/ struct FileStats *RESTRICT fstat, FILE *RESTRICT file
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*fstat,
+		file
+@*/
+;
+
+/* ------------------------------------------------------------------------ */
+
 /* tta_seek.c */
 
 CONST
@@ -234,9 +270,9 @@ BUILD_EXTERN enum FileCheck filecheck_tta_seektable(
 /* tta_write.c */
 
 #undef outfile
-BUILD_EXTERN void prewrite_tta1_header_seektable(
+BUILD_EXTERN void prewrite_tta_header_seektable(
 	FILE *RESTRICT outfile, const struct SeekTable *RESTRICT,
-	const char *RESTRICT
+	enum EncFormat, const char *RESTRICT
 )
 /*@globals	fileSystem@*/
 /*@modifies	fileSystem,
@@ -255,6 +291,17 @@ BUILD_EXTERN off_t write_tta1_header(
 @*/
 ;
 
+#undef outfile
+BUILD_EXTERN off_t write_tta2_header(
+	FILE *RESTRICT outfile, size_t, size_t,
+	const struct FileStats *RESTRICT, const char *
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		outfile
+@*/
+;
+
 #undef outfile
 BUILD_EXTERN void write_tta_seektable(
 	FILE *RESTRICT outfile, const struct SeekTable *RESTRICT,
@@ -286,14 +333,6 @@ BUILD_EXTERN enum FileCheck filecheck_w64(
 
 /* w64_write.c */
 
-#undef outfile
-BUILD_EXTERN void prewrite_w64_header(FILE *RESTRICT outfile, const char *)
-/*@globals	fileSystem@*/
-/*@modifies	fileSystem,
-		outfile
-@*/
-;
-
 #undef outfile
 BUILD_EXTERN void write_w64_header(
 	FILE *RESTRICT outfile, size_t, const struct FileStats *RESTRICT,
@@ -337,16 +376,6 @@ BUILD_EXTERN enum FileCheck filecheck_wav_read_subchunk_fmt(
 
 /* wav_write.c */
 
-#undef outfile
-BUILD_EXTERN void prewrite_wav_header(
-	FILE *RESTRICT outfile, const char *RESTRICT
-)
-/*@globals	fileSystem@*/
-/*@modifies	fileSystem,
-		outfile
-@*/
-;
-
 #undef outfile
 BUILD_EXTERN void write_wav_header(
 	FILE *RESTRICT outfile, size_t, const struct FileStats *RESTRICT,
@@ -6,13 +6,20 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
 //  http://tausoft.org/wiki/True_Audio_Codec_Format                         //
 //                                                                          //
+//      TTA2 is laid out like TTA1, header then seektable then frames, but  //
+// the header has 64-bit sizes, the seektable starts with its signature,    //
+// and each frame ends in a footer (signature, size, and CRC) instead of    //
+// just the CRC. A frame can then be found without the seektable, by its    //
+// footer. The seektable entries are the sizes of the frames with their     //
+// footers, as in TTA1.                                                     //
+//                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
 
 #include <stdint.h>
@@ -60,6 +67,9 @@
 #define TTA2_CHAN_TFR	UINT32_C(0x00002000)
 #define TTA2_CHAN_LFE2	UINT32_C(0x00004000)
 
+/* the channels that are where WAVE has them */
+#define TTA2_CHAN_WAVE	UINT32_C(0x000007FF)
+
 /* //////////////////////////////////////////////////////////////////////// */
 
 /* all int's are little-endian */
@@ -85,5 +95,19 @@ struct TTA2Header {
 	uint32_t	crc;		/* header CRC             */
 } PACKED;
 
+/* the data block starts with it, then the seektable and its CRC */
+struct TTA2SeekTableHeader {
+	uint8_t		sig[3u];	/* TTA2_SEEKTABLE_SIG     */
+	uint8_t		reserved;	/* 0                      */
+} PACKED;
+
+/* the CRC is last, so the footer of a TTA1 frame is the tail of it */
+struct TTA2FrameFooter {
+	uint8_t		sig[3u];	/* TTA2_FRAMEFOOTER_SIG   */
+	uint8_t		reserved;	/* 0                      */
+	uint32_t	size;		/* of the frame before it */
+	uint32_t	crc;		/* frame CRC              */
+} PACKED;
+
 /* EOF //////////////////////////////////////////////////////////////////// */
 #endif	/* H_TTA_FORMATS_TTA_H */
@@ -0,0 +1,119 @@
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// formats/tta2_check.c                                                     //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2026, Shane Seelig                                         //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../../libttaR.h"
+
+#include "../byteswap.h"
+#include "../common.h"
+#include "../formats.h"
+
+#include "./tta.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/**@fn filecheck_tta2
+ * @brief check if a file is TTA2
+ *
+ * @param fstat - bloated file stats struct
+ * @param file  - input file
+ *
+ * @return FILECHECK_OK if file format is TTA2
+ *
+ * @pre 'file' should be at the appropriate offset before calling
+ *
+ * @note the seektable's signature is read too, so that 'file' is left at
+ *   the seektable like with TTA1
+**/
+BUILD enum FileCheck
+filecheck_tta2(
+	/*@out@*/ struct FileStats *const RESTRICT fstat,
+	FILE *const RESTRICT file
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*fstat,
+		file
+@*/
+{
+	const off_t start = ftello(file);
+	/* * */
+	struct TTA2Header hdr;
+	struct TTA2SeekTableHeader sthdr;
+	uint64_t nsamples, size;
+	union {	size_t		z;
+		int		d;
+		uint32_t	u_32;
+		enum FileCheck	fc;
+	} result;
+
+	result.z = fread(&hdr, sizeof hdr, SIZE_C(1), file);
+	if ( result.z != SIZE_C(1) ){
+		if ( feof(file) != 0 ){
+			return FILECHECK_MALFORMED;
+		}
+		return FILECHECK_READ_ERROR;
+	}
+	if ( memcmp(hdr.preamble, TTA2_PREAMBLE, sizeof hdr.preamble) != 0 ){
+		/* reset file stream and return */
+		result.d = fseeko(file, start, SEEK_SET);
+		if ( result.d != 0 ){
+			return FILECHECK_SEEK_ERROR;
+		}
+		return FILECHECK_MISMATCH;
+	}
+
+	result.u_32 = libttaR_crc32(&hdr, (sizeof hdr) - (sizeof hdr.crc));
+	if ( result.u_32 != byteswap_letoh_u32(hdr.crc) ){
+		return FILECHECK_CORRUPTED;
+	}
+
+	/* no room for it in a size_t (32-bit) */
+	nsamples = byteswap_letoh_u64(hdr.nsamples);
+	size     = byteswap_letoh_u64(hdr.size);
+	if ( (nsamples > (uint64_t) SIZE_MAX) || (size > (uint64_t) SIZE_MAX)
+	    ||
+	     (size < (uint64_t) sizeof sthdr)
+	){
+		return FILECHECK_MALFORMED;
+	}
+
+	result.z = fread(&sthdr, sizeof sthdr, SIZE_C(1), file);
+	if ( result.z != SIZE_C(1) ){
+		if ( feof(file) != 0 ){
+			return FILECHECK_MALFORMED;
+		}
+		return FILECHECK_READ_ERROR;
+	}
+	if ( memcmp(sthdr.sig, TTA2_SEEKTABLE_SIG, sizeof sthdr.sig) != 0 ){
+		return FILECHECK_MALFORMED;
+	}
+
+	fstat->encfmt		= xENCFMT_TTA2;
+	fstat->nchan		= byteswap_letoh_u16(hdr.nchan);
+	fstat->samplebits	= byteswap_letoh_u16(hdr.samplebits);
+	fstat->samplerate	= byteswap_letoh_u32(hdr.samplerate);
+	fstat->chanmask_wav	= (
+		byteswap_letoh_u32(hdr.chanmask) & TTA2_CHAN_WAVE
+	);
+	fstat->nsamples_enc	= (size_t) nsamples;
+
+	fstat->enctta_off	= ftello(file);
+	fstat->enctta_size	= (size_t) (size - sizeof sthdr);
+
+	return FILECHECK_OK;
+}
+
+/* EOF //////////////////////////////////////////////////////////////////// */
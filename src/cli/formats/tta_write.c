@@ -4,7 +4,7 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
@@ -28,25 +28,27 @@
 #include "../common.h"
 #include "../debug.h"
 #include "../formats.h"
+#include "../system.h"
 
 #include "./tta.h"
 
 /* //////////////////////////////////////////////////////////////////////// */
 
-/**@fn prewrite_tta1_header
- * @brief reserves space for the TTA1 header and seektable
+/**@fn prewrite_tta_header_seektable
+ * @brief reserves space for the TTA header and seektable
  *
  * @param outfile      - destination file
  * @param st           - seektable
+ * @param encfmt       - TTA1 or TTA2
  * @param outfile_name - name of the destination file (errors)
  *
  * @note MAYBE write a preliminary header instead
 **/
 BUILD void
-prewrite_tta1_header_seektable(
+prewrite_tta_header_seektable(
 	FILE *const RESTRICT outfile,
 	const struct SeekTable *const RESTRICT st,
-	const char *const RESTRICT outfile_name
+	const enum EncFormat encfmt, const char *const RESTRICT outfile_name
 )
 /*@globals	fileSystem@*/
 /*@modifies	fileSystem,
@@ -54,7 +56,11 @@ prewrite_tta1_header_seektable(
 @*/
 {
 	const off_t offset = (off_t) (	/* header + seektable + st-crc */
-		  sizeof(struct TTA1Header)
+		  (encfmt == xENCFMT_TTA2
+			?   sizeof(struct TTA2Header)
+			  + sizeof(struct TTA2SeekTableHeader)
+			: sizeof(struct TTA1Header)
+		  )
 		+ (st->limit * (sizeof *st->table)) + sizeof(uint32_t)
 	);
 	/* * */
@@ -88,7 +94,8 @@ prewrite_tta1_header_seektable(
  *
  * @return the offset of the end of the header
  *
- * @pre outfile should be at correct offset before calling
+ * @note written in place at the start of the file; the file's position is
+ *   left alone
 **/
 BUILD off_t
 write_tta1_header(
@@ -101,7 +108,6 @@ write_tta1_header(
 @*/
 {
 	struct TTA1Header hdr;
-	union {	size_t z; } result;
 
 	if UNLIKELY ( nsamples_perchan_total > (size_t) UINT32_MAX ){
 		warning_tta("%s: broken header field: nsamples",
@@ -123,12 +129,72 @@ write_tta1_header(
 	));
 
 	/* write */
-	result.z = fwrite(&hdr, sizeof hdr, SIZE_C(1), outfile);
-	if UNLIKELY ( result.z != SIZE_C(1) ){
-		error_sys(errno, "fwrite", outfile_name);
+	if UNLIKELY ( ! file_pwrite(outfile, &hdr, sizeof hdr, 0) ){
+		error_sys(errno, "pwrite", outfile_name);
 	}
 
-	return ftello(outfile);
+	return (off_t) sizeof hdr;
+}
+
+/**@fn write_tta2_header
+ * @brief write a TTA2 header, and the signature of the seektable after it
+ *
+ * @param outfile      - destination file
+ * @param nsamples_perchan_total - number of samples of 'nchan' channels
+ * @param data_size    - size of the seektable (with its signature and CRC)
+ *   and the frames
+ * @param fstat        - bloated file stats struct
+ * @param outfile_name - name of the destination file (warnings/errors)
+ *
+ * @return the offset of the seektable
+ *
+ * @note written in place at the start of the file; the file's position is
+ *   left alone
+**/
+BUILD off_t
+write_tta2_header(
+	FILE *const RESTRICT outfile, const size_t nsamples_perchan_total,
+	const size_t data_size, const struct FileStats *const RESTRICT fstat,
+	const char *outfile_name
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		outfile
+@*/
+{
+	struct {
+		struct TTA2Header		hdr;
+		struct TTA2SeekTableHeader	sthdr;
+	} PACKED out;
+
+	(void) memcpy(
+		&out.hdr.preamble, TTA2_PREAMBLE, sizeof out.hdr.preamble
+	);
+	out.hdr.nchan		= byteswap_htole_u16(fstat->nchan);
+	out.hdr.samplebits	= byteswap_htole_u16(fstat->samplebits);
+	out.hdr.samplerate	= byteswap_htole_u32(fstat->samplerate);
+	out.hdr.chanmask	= byteswap_htole_u32(
+		fstat->chanmask_wav & TTA2_CHAN_WAVE
+	);
+	out.hdr.nsamples	= byteswap_htole_u64(
+		(uint64_t) nsamples_perchan_total
+	);
+	out.hdr.size		= byteswap_htole_u64((uint64_t) data_size);
+	out.hdr.crc		= byteswap_htole_u32(libttaR_crc32(
+		&out.hdr, (sizeof out.hdr) - (sizeof out.hdr.crc)
+	));
+
+	(void) memcpy(
+		&out.sthdr.sig, TTA2_SEEKTABLE_SIG, sizeof out.sthdr.sig
+	);
+	out.sthdr.reserved	= 0;
+
+	/* write */
+	if UNLIKELY ( ! file_pwrite(outfile, &out, sizeof out, 0) ){
+		error_sys(errno, "pwrite", outfile_name);
+	}
+
+	return (off_t) sizeof out;
 }
 
 /**@fn write_tta_seektable
@@ -137,6 +203,8 @@ write_tta1_header(
  * @param outfile      - destination file
  * @param st           - seektable struct
  * @param outfile_name - name of the destination file (errors)
+ *
+ * @note written in place at st->off; the file's position is left alone
 **/
 BUILD void
 write_tta_seektable(
@@ -149,29 +217,22 @@ write_tta_seektable(
 		outfile
 @*/
 {
+	const size_t table_size = st->nmemb * (sizeof *st->table);
 	uint32_t crc;	/* little-endian */
-	union {	int	d;
-		size_t	z;
-	} result;
-
-	result.d = fseeko(outfile, st->off, SEEK_SET);
-	if UNLIKELY ( result.d != 0 ){
-		error_sys(errno, "fseeko", outfile_name);
-	}
 
 	/* write seektable */
-	result.z = fwrite(st->table, sizeof *st->table, st->nmemb, outfile);
-	if UNLIKELY ( result.z != st->nmemb ){
-		error_sys(errno, "fwrite", outfile_name);
+	if UNLIKELY ( ! file_pwrite(outfile, st->table, table_size, st->off) ){
+		error_sys(errno, "pwrite", outfile_name);
 	}
 
 	/* calc then write seektable CRC */
-	crc = byteswap_htole_u32(libttaR_crc32(
-		st->table, st->nmemb * (sizeof *st->table)
-	));
-	result.z = fwrite(&crc, sizeof crc, SIZE_C(1), outfile);
-	if UNLIKELY ( result.z != SIZE_C(1) ){
-		error_sys(errno, "fwrite", outfile_name);
+	crc = byteswap_htole_u32(libttaR_crc32(st->table, table_size));
+	if UNLIKELY (
+	     ! file_pwrite(
+		outfile, &crc, sizeof crc, st->off + (off_t) table_size
+	     )
+	){
+		error_sys(errno, "pwrite", outfile_name);
 	}
 	return;
 }
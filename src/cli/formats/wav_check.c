@@ -4,11 +4,12 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
 
+#include <errno.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -23,10 +24,21 @@
 /* //////////////////////////////////////////////////////////////////////// */
 
 #undef file
+#undef rh
 static enum FileCheck filecheck_wav_find_subchunk(
-	FILE *const RESTRICT file, const uint8_t *const RESTRICT
+	FILE *const RESTRICT file, const uint8_t *const RESTRICT,
+	/*@out@*/ struct RiffHeader *const RESTRICT rh
 )
 /*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		file,
+		*rh
+@*/
+;
+
+#undef file
+static enum FileCheck filecheck_wav_skip(FILE *const RESTRICT file, off_t)
+/*@globals	fileSystem@*/
 /*@modifies	fileSystem,
 		file
 @*/
@@ -43,6 +55,11 @@ static enum FileCheck filecheck_wav_find_subchunk(
  * @return FILECHECK_OK if file format is Microsoft RIFF/WAVE
  *
  * @pre 'file' should be at the appropriate offset before calling
+ *
+ * @note a pipe can be read from, since the stream is only moved forward
+ *   once it is known to be a WAV; its decpcm_off is -1
+ * @note a data size of 0 or 0xFFFFFFFF, as is written by something that
+ *   does not know the size yet, is DECPCM_SIZE_UNKNOWN
 **/
 BUILD enum FileCheck
 filecheck_wav(
@@ -90,35 +107,27 @@ filecheck_wav(
 	}
 
 	/* search for format subchunk */
-	result.fc = filecheck_wav_find_subchunk(file, RIFF_ID_FMT);
+	result.fc = filecheck_wav_find_subchunk(file, RIFF_ID_FMT, &chunk.rh);
 	if ( result.fc != FILECHECK_OK ){
 		return result.fc;
 	}
-	result.d = fseeko(file, (off_t) (sizeof chunk.rh), SEEK_CUR);
-	if ( result.d != 0 ){
-		return FILECHECK_SEEK_ERROR;
-	}
 	result.fc = filecheck_wav_read_subchunk_fmt(fstat, file);
 	if ( result.fc != FILECHECK_OK ){
 		return result.fc;
 	}
 
 	/* search for data subchunk header */
-	result.fc = filecheck_wav_find_subchunk(file, RIFF_ID_DATA);
+	result.fc = filecheck_wav_find_subchunk(file, RIFF_ID_DATA, &chunk.rh);
 	if ( result.fc != FILECHECK_OK ){
 		return result.fc;
 	}
-	result.z = fread(&chunk.rh, sizeof chunk.rh, SIZE_C(1), file);
-	if ( result.z != SIZE_C(1) ){
-		if ( feof(file) != 0 ){
-			return FILECHECK_MALFORMED;
-		}
-		return FILECHECK_READ_ERROR;
-	}
 
 	fstat->decfmt      = DECFMT_WAV;
 	fstat->decpcm_off  = ftello(file);
 	fstat->decpcm_size = (size_t) byteswap_letoh_u32(chunk.rh.size);
+	if ( (chunk.rh.size == 0) || (chunk.rh.size == UINT32_MAX) ){
+		fstat->decpcm_size = DECPCM_SIZE_UNKNOWN;
+	}
 
 	return FILECHECK_OK;
 }
@@ -148,9 +157,10 @@ filecheck_wav_read_subchunk_fmt(
 		struct RiffSubChunk_WaveFormatExtensible_Tail	wfx;
 	} chunk;
 	uint16_t format;
-	union {	size_t	z;
-		off_t	o;
-		int	d;
+	union {	size_t		z;
+		off_t		o;
+		int		d;
+		enum FileCheck	fc;
 	} result;
 
 	result.z = fread(&chunk.fmt, sizeof chunk.fmt, SIZE_C(1), file);
@@ -209,9 +219,9 @@ filecheck_wav_read_subchunk_fmt(
 			- (byteswap_letoh_u16(chunk.wfx.size)
 			+ (sizeof chunk.wfx.size))
 		);
-		result.d = fseeko(file, result.o, SEEK_CUR);
-		if ( result.d != 0 ){
-			return FILECHECK_SEEK_ERROR;
+		result.fc = filecheck_wav_skip(file, result.o);
+		if ( result.fc != FILECHECK_OK ){
+			return result.fc;
 		}
 	}
 	return FILECHECK_OK;
@@ -224,55 +234,101 @@ filecheck_wav_read_subchunk_fmt(
  *
  * @param file   - source file
  * @param target - ID of the subchunk we are searching for
+ * @param rh     - the header of the subchunk found
  *
  * @return FILECHECK_OK if found
  *
  * @pre 'file' should be at the beginning of a subchunk before calling
+ * @post 'file' is past the header of the subchunk found
 **/
 static enum FileCheck
 filecheck_wav_find_subchunk(
-	FILE *const RESTRICT file, const uint8_t *const RESTRICT target
+	FILE *const RESTRICT file, const uint8_t *const RESTRICT target,
+	/*@out@*/ struct RiffHeader *const RESTRICT rh
 )
 /*@globals	fileSystem@*/
 /*@modifies	fileSystem,
-		file
+		file,
+		*rh
 @*/
 {
-	struct RiffHeader rh;
-	union {	size_t	z;
-		int	d;
+	union {	size_t		z;
+		enum FileCheck	fc;
 	} result;
 
 	/* check subchunks until target is found */
-	goto loop_entr;
-	do {
-		/* seek to end of current subchunk */
-		result.d = fseeko(
-			file, (off_t) byteswap_letoh_u32(rh.size), SEEK_CUR
-		);
-		if ( result.d != 0 ){
-			return FILECHECK_SEEK_ERROR;
-		}
-loop_entr:
-		result.z = fread(&rh, sizeof rh, SIZE_C(1), file);
+	for (;;){
+		result.z = fread(rh, sizeof *rh, SIZE_C(1), file);
 		if ( result.z != SIZE_C(1) ){
 			if ( feof(file) != 0 ){
 				return FILECHECK_MALFORMED;
 			}
 			return FILECHECK_READ_ERROR;
 		}
+		if ( memcmp(&rh->id, target, sizeof rh->id) == 0 ){
+			break;
+		}
 
-		if ( byteswap_letoh_u32(rh.size) == 0 ){
+		if ( byteswap_letoh_u32(rh->size) == 0 ){
 			return FILECHECK_MALFORMED;
 		}
+		/* skip to end of current subchunk */
+		result.fc = filecheck_wav_skip(
+			file, (off_t) byteswap_letoh_u32(rh->size)
+		);
+		if ( result.fc != FILECHECK_OK ){
+			return result.fc;
+		}
 	}
-	while ( memcmp(&rh.id, target, sizeof rh.id) != 0 );
+	return FILECHECK_OK;
+}
 
-	/* seek to start of subchunk before returning */
-	result.d = fseeko(file, -((off_t) (sizeof rh)), SEEK_CUR);
-	if ( result.d != 0 ){
+/**@fn filecheck_wav_skip
+ * @brief moves the file stream forward
+ *
+ * @param file   - source file
+ * @param offset - how far to move it
+ *
+ * @return FILECHECK_OK on success
+ *
+ * @note a pipe is read through instead
+**/
+static enum FileCheck
+filecheck_wav_skip(FILE *const RESTRICT file, off_t offset)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		file
+@*/
+{
+	uint8_t buf[512u];
+	size_t nbytes;
+	union {	size_t	z;
+		int	d;
+	} result;
+
+	if ( offset == 0 ){
+		return FILECHECK_OK;
+	}
+	result.d = fseeko(file, offset, SEEK_CUR);
+	if ( result.d == 0 ){
+		return FILECHECK_OK;
+	}
+	if ( (offset < 0) || (errno != ESPIPE) ){
 		return FILECHECK_SEEK_ERROR;
 	}
+
+	for ( ; offset != 0; offset -= (off_t) nbytes ){
+		nbytes = (offset < (off_t) sizeof buf
+			? (size_t) offset : sizeof buf
+		);
+		result.z = fread(buf, nbytes, SIZE_C(1), file);
+		if ( result.z != SIZE_C(1) ){
+			if ( feof(file) != 0 ){
+				return FILECHECK_MALFORMED;
+			}
+			return FILECHECK_READ_ERROR;
+		}
+	}
 	return FILECHECK_OK;
 }
 
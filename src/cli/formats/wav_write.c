@@ -4,7 +4,7 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
@@ -16,8 +16,6 @@
 #include <stdio.h>
 #include <string.h>
 
-#include <unistd.h>
-
 #include "../byteswap.h"
 #include "../common.h"
 #include "../debug.h"
@@ -26,44 +24,6 @@
 
 /* //////////////////////////////////////////////////////////////////////// */
 
-/**@fn prewrite_wav_header
- * @brief reserves space for the Microsoft RIFF/WAVE header
- *
- * @param outfile      - destination file
- * @param outfile_name - name of the destination file (errors)
-**/
-/* MAYBE: write a preliminary header instead */
-BUILD void
-prewrite_wav_header(
-	FILE *const RESTRICT outfile, const char *const RESTRICT outfile_name
-)
-/*@globals	fileSystem@*/
-/*@modifies	fileSystem,
-		outfile
-@*/
-{
-	union {	int d; } result;
-
-	result.d = fflush(outfile);
-	if UNLIKELY ( result.d != 0 ){
-		error_sys(errno, "fflush", outfile_name);
-	}
-
-	result.d = ftruncate(
-		fileno(outfile),
-		(off_t) sizeof(struct RiffHeader_WriteTemplate)
-	);
-	if UNLIKELY ( (result.d != 0) && (errno != EINVAL) ){ /* /dev/null */
-		error_sys(errno, "ftruncate", outfile_name);
-	}
-
-	result.d = fseeko(outfile, 0, SEEK_END);
-	if UNLIKELY ( result.d != 0 ){
-		error_sys(errno, "fseeko", outfile_name);
-	}
-	return;
-}
-
 /**@fn write_wav_header
  * @brief write a Microsoft RIFF/WAVE header
  *
@@ -4,7 +4,7 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
@@ -62,8 +62,10 @@ static const char help_main[] = {
 "\n"
 "\t"    "ttaR MODE --help\n"
 "\n"
+"\t"    "ttaR --autotune\n"
+"\n"
 " Modes:\n"
-"\t"    "encode, decode\n"
+"\t"    "encode, decode, test, repair\n"
 };
 
 /*@unchecked@*/
@@ -80,6 +82,22 @@ static const char help_mode_usage0_decode[] = {
 "\t"    "ttaR decode"
 };
 
+/*@unchecked@*/
+static const char help_mode_usage_test[] = {
+/*12345670123456701234567012345670123456701234567012345670123456701234567012*/
+" Usage:\n"
+"\t"    "ttaR test [-options] INFILE...\n"
+"\n"
+};
+
+/*@unchecked@*/
+static const char help_mode_usage_repair[] = {
+/*12345670123456701234567012345670123456701234567012345670123456701234567012*/
+" Usage:\n"
+"\t"    "ttaR repair [-options] INFILE... [-o OUTFILE|OUTDIR]\n"
+"\n"
+};
+
 /*@unchecked@*/
 static const char help_mode_usage1[] = {
 " [-options] INFILE... [-o OUTFILE]\n"
@@ -96,8 +114,12 @@ static const char help_mode_usage1[] = {
 #define OPT_COMMON_MULTI_THREADED \
 "    [*]\t" \
         "-M, --multi-threaded\t\t"      "with NPROCESSORS_ONLN threads\n"
+#define OPT_COMMON_AFFINITY \
+"\t"    "    --affinity\t\t\t"          "pin threads, physical cores first\n"
 
 /*12345670123456701234567012345670123456701234567012345670123456701234567012*/
+#define OPT_COMMON_BULK_IO \
+"\t"    "    --bulk-io\t\t\t"           "page cache drop-behind\n"
 #define OPT_COMMON_DELETE_SRC \
 "\t"    "-d, --delete-src\t\t"          "delete each infile after coding\n"
 #define OPT_COMMON_OUTFILE \
@@ -108,14 +130,27 @@ static const char help_mode_usage1[] = {
 "\t"    "-t, --threads=N\t\t\t"         "multi-threaded with N threads\n"
 
 /*12345670123456701234567012345670123456701234567012345670123456701234567012*/
+#define OPT_ENCODE_DIRECT \
+"\t"    "    --direct\t\t\t"            "write around the page cache\n"
+#define OPT_ENCODE_FORMAT \
+"\t"    "-f, --format=FMT\t\t"          "outfile format\n" \
+"\t\t"          "FMT: [*] tta1, tta2\n"
 #define OPT_ENCODE_RAWPCM \
 "\t"    "    --rawpcm=FMT,SRATE,NCHAN\t""rawpcm file stats\n" \
 "\t\t"          "FMT: u8, i16le, i24le\n"
+#define OPT_ENCODE_VERIFY \
+"\t"    "    --verify\t\t\t"            "decode and check each frame\n"
 
 /*12345670123456701234567012345670123456701234567012345670123456701234567012*/
 #define OPT_DECODE_FORMAT \
 "\t"    "-f, --format=FMT\t\t"          "outfile format\n" \
 "\t\t"          "FMT: raw, [*] w64, wav\n"
+#define OPT_DECODE_MMAP \
+"\t"    "    --mmap\t\t\t"              "decoder threads write to a mapping\n"
+#define OPT_DECODE_PREAD \
+"\t"    "    --pread\t\t\t"             "decoder threads read their frames\n"
+#define OPT_DECODE_SUBFRAME \
+"\t"    "    --subframe=N\t\t"          "write every N samples; implies -S\n"
 
 
 /*@unchecked@*/
@@ -125,12 +160,17 @@ OPT_COMMON_HELP
 "\n"
 OPT_COMMON_SINGLE_THREADED
 OPT_COMMON_MULTI_THREADED
+OPT_COMMON_AFFINITY
 "\n"
+OPT_COMMON_BULK_IO
 OPT_COMMON_DELETE_SRC
+OPT_ENCODE_DIRECT
+OPT_ENCODE_FORMAT
 OPT_COMMON_OUTFILE
 OPT_COMMON_QUIET
 OPT_ENCODE_RAWPCM
 OPT_COMMON_THREADS
+OPT_ENCODE_VERIFY
 };
 
 /*@unchecked@*/
@@ -140,9 +180,40 @@ OPT_COMMON_HELP
 "\n"
 OPT_COMMON_SINGLE_THREADED
 OPT_COMMON_MULTI_THREADED
+OPT_COMMON_AFFINITY
 "\n"
+OPT_COMMON_BULK_IO
 OPT_COMMON_DELETE_SRC
 OPT_DECODE_FORMAT
+OPT_DECODE_MMAP
+OPT_COMMON_OUTFILE
+OPT_DECODE_PREAD
+OPT_COMMON_QUIET
+OPT_DECODE_SUBFRAME
+OPT_COMMON_THREADS
+};
+
+/*@unchecked@*/
+static const char help_mode_opts_test[] = {
+" Options:\n"
+OPT_COMMON_HELP
+"\n"
+OPT_COMMON_SINGLE_THREADED
+OPT_COMMON_MULTI_THREADED
+"\n"
+OPT_COMMON_BULK_IO
+OPT_COMMON_QUIET
+OPT_COMMON_THREADS
+};
+
+/*@unchecked@*/
+static const char help_mode_opts_repair[] = {
+" Options:\n"
+OPT_COMMON_HELP
+"\n"
+OPT_COMMON_SINGLE_THREADED
+OPT_COMMON_MULTI_THREADED
+"\n"
 OPT_COMMON_OUTFILE
 OPT_COMMON_QUIET
 OPT_COMMON_THREADS
@@ -199,6 +270,38 @@ errprint_help_mode_decode(void)
 	return;
 }
 
+/**@fn errprint_help_mode_test
+ * @brief print the mode test's help to stderr
+**/
+COLD
+BUILD NOINLINE void
+errprint_help_mode_test(void)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem@*/
+{
+	errprint_program_intro(&ttaR_info, &libttaR_info);
+	(void) fputs(help_mode_usage_test, stderr);
+	(void) fputs(help_mode_opts_test, stderr);
+
+	return;
+}
+
+/**@fn errprint_help_mode_repair
+ * @brief print the mode repair's help to stderr
+**/
+COLD
+BUILD NOINLINE void
+errprint_help_mode_repair(void)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem@*/
+{
+	errprint_program_intro(&ttaR_info, &libttaR_info);
+	(void) fputs(help_mode_usage_repair, stderr);
+	(void) fputs(help_mode_opts_repair, stderr);
+
+	return;
+}
+
 /* ------------------------------------------------------------------------ */
 
 /**@fn errprint_program_intro
@@ -6,7 +6,7 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
@@ -33,5 +33,17 @@ BUILD_EXTERN NOINLINE void errprint_help_mode_decode(void)
 /*@modifies	fileSystem@*/
 ;
 
+COLD
+BUILD_EXTERN NOINLINE void errprint_help_mode_test(void)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem@*/
+;
+
+COLD
+BUILD_EXTERN NOINLINE void errprint_help_mode_repair(void)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem@*/
+;
+
 /* EOF //////////////////////////////////////////////////////////////////// */
 #endif	/* H_TTA_HELP_H */
@@ -4,7 +4,7 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
@@ -53,6 +53,44 @@ BUILD_EXTERN NOINLINE int mode_decode(
 @*/
 ;
 
+#undef argv
+BUILD_EXTERN NOINLINE int mode_repair(
+	unsigned int, unsigned int, char *const *argv
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		**argv
+@*/
+;
+
+#undef argv
+BUILD_EXTERN NOINLINE int mode_test(
+	unsigned int, unsigned int, char *const *argv
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		**argv
+@*/
+;
+
+#undef argv
+BUILD_EXTERN NOINLINE int mode_autotune(
+	unsigned int, unsigned int, char *const *argv
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState
+@*/
+;
+
 /* ======================================================================== */
 
 static void atexit_cleanup(void)
@@ -108,6 +146,13 @@ BUILD struct GlobalFlags g_flag = {
 /*@checkmod@*/
 BUILD unsigned int g_nthreads = 0;
 
+/**@var g_subframe
+ * @brief number of samples per channel to decode and write at a time, or 0
+ *   for whole frames (--subframe)
+**/
+/*@checkmod@*/
+BUILD unsigned int g_subframe = 0;
+
 /**@var g_rm_on_sigint
  * @brief name of the currently opened destination file for removal on a
  *   handled signal
@@ -164,6 +209,15 @@ main(const int argc, char *const *const argv)
 	else if ( strcmp(argv[1u], "decode") == 0 ){
 		retval = mode_decode(2u, (unsigned int) argc, argv);
 	}
+	else if ( strcmp(argv[1u], "test") == 0 ){
+		retval = mode_test(2u, (unsigned int) argc, argv);
+	}
+	else if ( strcmp(argv[1u], "repair") == 0 ){
+		retval = mode_repair(2u, (unsigned int) argc, argv);
+	}
+	else if ( strcmp(argv[1u], "--autotune") == 0 ){
+		retval = mode_autotune(2u, (unsigned int) argc, argv);
+	}
 	else {	error_tta_nf("bad mode '%s'", argv[1u]);
 print_main_help:
 		errprint_help_main();
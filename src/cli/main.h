@@ -6,7 +6,7 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
@@ -22,7 +22,8 @@
 
 enum ProgramMode {
 	MODE_ENCODE,
-	MODE_DECODE
+	MODE_DECODE,
+	MODE_TEST
 };
 
 enum ThreadMode {
@@ -40,7 +41,14 @@ struct GlobalFlags {
 	bool		 quiet;
 	bool		 delete_src;
 	bool		 rawpcm;
+	bool		 affinity;
+	bool		 bulk_io;
+	bool		 direct;
+	bool		 mmap_out;
+	bool		 verify;
+	bool		 pread;
 	enum ThreadMode	 threadmode:8u;
+	enum EncFormat	 encfmt:8u;
 	enum DecFormat	 decfmt:8u;
 };
 
@@ -63,6 +71,9 @@ BUILD_EXTERN struct GlobalFlags g_flag;
 /*@checkmod@*/
 BUILD_EXTERN unsigned int g_nthreads;
 
+/*@checkmod@*/
+BUILD_EXTERN unsigned int g_subframe;
+
 /*@checkmod@*/ /*@dependent@*/ /*@null@*/
 BUILD_EXTERN char *g_rm_on_sigint;
 
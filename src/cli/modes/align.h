@@ -28,6 +28,13 @@ union x_max_alignment {
 #define ALIGNOF(x_x)	(sizeof(union x_max_alignment))
 #endif	/* ALIGNOF */
 
+/* assumed size of a cache line. data written by different threads is kept
+     at least this far apart, so that they do not fight over the line
+*/
+#ifndef CACHE_LINE_SIZE
+#define CACHE_LINE_SIZE	((size_t) 64u)
+#endif
+
 /* ======================================================================== */
 
 /**@fn ALIGN_FW_DIFF
@@ -0,0 +1,136 @@
+#ifndef H_TTA_MODES_ARENA_H
+#define H_TTA_MODES_ARENA_H
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// modes/arena.h                                                            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//      One mapping per coding run that every buffer of the run is carved   //
+// out of, in order, and all freed together. The caller sizes it up front   //
+// with ARENA_SIZE for each piece. The memory starts zeroed. It is mapped   //
+// straight from the system so that it can be backed by huge pages, and    //
+// so that its pages can be faulted in ahead of time (pages_populate), or   //
+// given back (pages_discard), a range at a time.                           //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../common.h"
+#include "../debug.h"
+#include "../system.h"
+
+#include "./align.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/* whether to try explicit huge pages (MAP_HUGETLB) first. they have to be
+     reserved by the admin, so it is off by default; transparent huge pages
+     are asked for either way
+*/
+#ifndef ARENA_HUGETLB
+#define ARENA_HUGETLB		false
+#endif
+
+/* every piece starts on its own cache line */
+#define ARENA_ALIGN		CACHE_LINE_SIZE
+
+/* space a piece of 'x_size' bytes takes up in an arena */
+#define ARENA_SIZE(x_size)	( \
+	(x_size) + ALIGN_FW_DIFF((x_size), ARENA_ALIGN) \
+)
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+struct Arena {
+	/*@owned@*/ /*@null@*/
+	uint8_t		*base;
+	size_t		size;
+	size_t		used;
+};
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/**@fn arena_init
+ * @brief maps an arena
+ *
+ * @param arena - arena
+ * @param size  - size of the arena; the sum of the ARENA_SIZE's of the pieces
+**/
+INLINE void
+arena_init(/*@out@*/ struct Arena *const RESTRICT arena, const size_t size)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*arena
+@*/
+/*@allocates	arena->base@*/
+{
+	assert(size != 0);
+
+	arena->size = size;
+	arena->used = 0;
+	arena->base = pages_map(&arena->size, ARENA_HUGETLB);
+	if UNLIKELY ( arena->base == NULL ){
+		error_sys(errno, "mmap", NULL);
+	}
+	assert(arena->base != NULL);
+
+	return;
+}
+
+/**@fn arena_free
+ * @brief unmaps an arena, and with it everything carved out of it
+ *
+ * @param arena - arena
+**/
+INLINE void
+arena_free(struct Arena *const RESTRICT arena)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*arena
+@*/
+/*@releases	arena->base@*/
+{
+	pages_unmap(arena->base, arena->size);
+	arena->base = NULL;
+	return;
+}
+
+/* ------------------------------------------------------------------------ */
+
+/**@fn arena_alloc
+ * @brief carves the next piece out of an arena
+ *
+ * @param arena - arena
+ * @param size  - size of the piece
+ *
+ * @return the piece; aligned to ARENA_ALIGN and zeroed
+**/
+/*@dependent@*/
+ALWAYS_INLINE void *
+arena_alloc(struct Arena *const RESTRICT arena, const size_t size)
+/*@modifies	arena->used@*/
+{
+	uint8_t *const ptr = &arena->base[arena->used];
+
+	arena->used += ARENA_SIZE(size);
+	assert(arena->used <= arena->size);
+
+	return ptr;
+}
+
+/* EOF //////////////////////////////////////////////////////////////////// */
+#endif	/* H_TTA_MODES_ARENA_H */
@@ -0,0 +1,246 @@
+#ifndef H_TTA_MODES_ATOMIC_H
+#define H_TTA_MODES_ATOMIC_H
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// modes/atomic.h                                                           //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//      C99 has no atomics, so these wrap the GNU __atomic builtins. Only   //
+// the orderings the frame ring needs are here.                             //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../common.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#if defined(__ATOMIC_SEQ_CST)
+#define X_ATOMIC_RELAXED	__ATOMIC_RELAXED
+#define X_ATOMIC_ACQUIRE	__ATOMIC_ACQUIRE
+#define X_ATOMIC_RELEASE	__ATOMIC_RELEASE
+#define X_ATOMIC_ACQ_REL	__ATOMIC_ACQ_REL
+#define X_ATOMIC_SEQ_CST	__ATOMIC_SEQ_CST
+#elif defined(S_SPLINT_S)
+#define __atomic_load_n(x_ptr, x_order)			(*(x_ptr))
+#define __atomic_store_n(x_ptr, x_val, x_order)		(*(x_ptr) = (x_val))
+#define __atomic_fetch_add(x_ptr, x_val, x_order)	(*(x_ptr) += (x_val))
+#define __atomic_fetch_sub(x_ptr, x_val, x_order)	(*(x_ptr) -= (x_val))
+#define __atomic_compare_exchange_n( \
+	x_ptr, x_expected, x_desired, x_weak, x_order_s, x_order_f \
+) \
+	(*(x_ptr) == *(x_expected) \
+		? (*(x_ptr) = (x_desired), true) \
+		: (*(x_expected) = *(x_ptr), false) \
+	)
+#else
+#error "compiler does not have the '__atomic' builtins"
+#endif	/* __ATOMIC_SEQ_CST */
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/* number of cpu_relax() polls before waitvar_wait() blocks. spinning only
+     helps when the thread being waited on has its own processor; otherwise
+     it just burns the time slice that thread needs
+*/
+#define WAITVAR_NSPIN(x_nthreads, x_nprocessors)	( \
+	(x_nthreads) <= (x_nprocessors) ? 512u : 0 \
+)
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/**@fn atomic_load_acq_u32
+ * @brief atomic load with acquire ordering
+ *
+ * @param ptr - pointer to the value
+ *
+ * @return the value
+**/
+ALWAYS_INLINE uint32_t
+atomic_load_acq_u32(const uint32_t *const RESTRICT ptr)
+/*@*/
+{
+	return __atomic_load_n(ptr, X_ATOMIC_ACQUIRE);
+}
+
+/**@fn atomic_load_u32
+ * @brief atomic load with sequentially-consistent ordering
+ *
+ * @param ptr - pointer to the value
+ *
+ * @return the value
+**/
+ALWAYS_INLINE uint32_t
+atomic_load_u32(const uint32_t *const RESTRICT ptr)
+/*@*/
+{
+	return __atomic_load_n(ptr, X_ATOMIC_SEQ_CST);
+}
+
+/**@fn atomic_store_u32
+ * @brief atomic store with sequentially-consistent ordering
+ *
+ * @param ptr   - pointer to the value
+ * @param value - new value
+**/
+ALWAYS_INLINE void
+atomic_store_u32(uint32_t *const RESTRICT ptr, const uint32_t value)
+/*@modifies	*ptr@*/
+{
+	__atomic_store_n(ptr, value, X_ATOMIC_SEQ_CST);
+	return;
+}
+
+/**@fn atomic_inc_u32
+ * @brief atomic increment with sequentially-consistent ordering
+ *
+ * @param ptr - pointer to the value
+**/
+ALWAYS_INLINE void
+atomic_inc_u32(uint32_t *const RESTRICT ptr)
+/*@modifies	*ptr@*/
+{
+	(void) __atomic_fetch_add(ptr, 1u, X_ATOMIC_SEQ_CST);
+	return;
+}
+
+/**@fn atomic_dec_u32
+ * @brief atomic decrement with sequentially-consistent ordering
+ *
+ * @param ptr - pointer to the value
+**/
+ALWAYS_INLINE void
+atomic_dec_u32(uint32_t *const RESTRICT ptr)
+/*@modifies	*ptr@*/
+{
+	(void) __atomic_fetch_sub(ptr, 1u, X_ATOMIC_SEQ_CST);
+	return;
+}
+
+/* ------------------------------------------------------------------------ */
+
+/**@fn atomic_load_z
+ * @brief atomic load; only the value itself is ordered
+ *
+ * @param ptr - pointer to the value
+ *
+ * @return the value
+**/
+ALWAYS_INLINE size_t
+atomic_load_z(const size_t *const RESTRICT ptr)
+/*@*/
+{
+	return __atomic_load_n(ptr, X_ATOMIC_RELAXED);
+}
+
+/**@fn atomic_fetch_inc_z
+ * @brief atomic post-increment; only the counter itself is ordered
+ *
+ * @param ptr - pointer to the counter
+ *
+ * @return the value before the increment
+**/
+ALWAYS_INLINE size_t
+atomic_fetch_inc_z(size_t *const RESTRICT ptr)
+/*@modifies	*ptr@*/
+{
+	return __atomic_fetch_add(ptr, SIZE_C(1), X_ATOMIC_RELAXED);
+}
+
+/**@fn atomic_fetch_inc_acq_rel_z
+ * @brief atomic post-increment with acquire-release ordering; chains the
+ *   increments, so each one sees what the earlier ones published
+ *
+ * @param ptr - pointer to the counter
+ *
+ * @return the value before the increment
+**/
+ALWAYS_INLINE size_t
+atomic_fetch_inc_acq_rel_z(size_t *const RESTRICT ptr)
+/*@modifies	*ptr@*/
+{
+	return __atomic_fetch_add(ptr, SIZE_C(1), X_ATOMIC_ACQ_REL);
+}
+
+/**@fn atomic_min_z
+ * @brief atomically lowers a value to 'value', if it is not already lower;
+ *   only the value itself is ordered
+ *
+ * @param ptr   - pointer to the value
+ * @param value - the candidate
+**/
+ALWAYS_INLINE void
+atomic_min_z(size_t *const RESTRICT ptr, const size_t value)
+/*@modifies	*ptr@*/
+{
+	size_t old = __atomic_load_n(ptr, X_ATOMIC_RELAXED);
+
+	while ( (value < old)
+	    &&
+	     (! __atomic_compare_exchange_n(
+		ptr, &old, value, true, X_ATOMIC_RELAXED, X_ATOMIC_RELAXED
+	     ))
+	){;}
+	return;
+}
+
+/* ------------------------------------------------------------------------ */
+
+/**@fn atomic_inc_sat_u8
+ * @brief atomic increment that stops at UINT8_MAX; only the counter
+ *   itself is ordered
+ *
+ * @param ptr - pointer to the counter
+ *
+ * @return the value after the increment
+**/
+ALWAYS_INLINE uint8_t
+atomic_inc_sat_u8(uint8_t *const RESTRICT ptr)
+/*@modifies	*ptr@*/
+{
+	uint8_t old = __atomic_load_n(ptr, X_ATOMIC_RELAXED);
+
+	while ( (old < UINT8_MAX)
+	    &&
+	     (! __atomic_compare_exchange_n(
+		ptr, &old, (uint8_t) (old + 1u), true, X_ATOMIC_RELAXED,
+		X_ATOMIC_RELAXED
+	     ))
+	){;}
+	return (uint8_t) (old + (old < UINT8_MAX));
+}
+
+/* ======================================================================== */
+
+/**@fn cpu_relax
+ * @brief spin-wait hint for the processor
+**/
+ALWAYS_INLINE void
+cpu_relax(void)
+/*@*/
+{
+#if defined(S_SPLINT_S)
+	/* nothing */
+#elif defined(__x86_64__) || defined(__i386__)
+	__asm__ __volatile__ ("pause" ::: "memory");
+#elif defined(__aarch64__) || defined(__arm__)
+	__asm__ __volatile__ ("yield" ::: "memory");
+#elif defined(__powerpc__) || defined(__powerpc64__)
+	__asm__ __volatile__ ("or 27,27,27" ::: "memory");
+#else
+	__asm__ __volatile__ ("" ::: "memory");
+#endif
+	return;
+}
+
+/* EOF //////////////////////////////////////////////////////////////////// */
+#endif	/* H_TTA_MODES_ATOMIC_H */
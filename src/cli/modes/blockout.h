@@ -0,0 +1,257 @@
+#ifndef H_TTA_MODES_BLOCKOUT_H
+#define H_TTA_MODES_BLOCKOUT_H
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// modes/blockout.h                                                         //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2026, Shane Seelig                                         //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//      An output file written in big, aligned blocks instead of a write    //
+// per frame. The frames are copied into a BLOCKOUT_SIZE buffer, and each   //
+// full buffer goes out in one pwrite at an aligned offset, so the file     //
+// can be written with O_DIRECT (file_direct), past the page cache. The     //
+// block the file's position is in is started from its aligned start; what  //
+// is before the position in it is written over with zeros.                 //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <sys/types.h>
+
+#include "../common.h"
+#include "../debug.h"
+#include "../system.h"
+
+#include "./align.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/* size of a block, at least; pages_map() rounds it up to whole pages */
+#ifndef BLOCKOUT_SIZE
+#define BLOCKOUT_SIZE		((size_t) (1u * 1024u * 1024u))
+#endif
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+struct BlockOut {
+	/*@owned@*/ /*@null@*/
+	uint8_t		*buf;		/* NULL if not in use        */
+	size_t		size;
+	size_t		used;
+	off_t		offset;		/* of buf[0] in the file     */
+	bool		direct;		/* O_DIRECT is on            */
+};
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/**@fn blockout_init
+ * @brief starts writing a file in blocks from its position
+ *
+ * @param bo         - the block writer
+ * @param filehandle - the file
+ * @param name       - name of the file (warnings/errors)
+ * @param direct     - whether to try O_DIRECT
+ *
+ * @note bo->buf is left NULL if the file is not a regular file
+**/
+INLINE void
+blockout_init(
+	/*@out@*/ struct BlockOut *const RESTRICT bo,
+	FILE *const RESTRICT filehandle, const char *const RESTRICT name,
+	const bool direct
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*bo,
+		filehandle
+@*/
+{
+	off_t pos;
+	union {	int d; } result;
+
+	memset(bo, 0x00, sizeof *bo);
+	if ( ! file_regsize(filehandle, &pos) ){
+		return;
+	}
+
+	result.d = fflush(filehandle);
+	if UNLIKELY ( result.d != 0 ){
+		error_sys(errno, "fflush", name);
+	}
+	pos = ftello(filehandle);
+	if UNLIKELY ( pos < 0 ){
+		error_sys(errno, "ftello", name);
+	}
+
+	bo->size = BLOCKOUT_SIZE;
+	bo->buf  = pages_map(&bo->size, false);
+	if UNLIKELY ( bo->buf == NULL ){
+		error_sys(errno, "mmap", NULL);
+	}
+	assert(bo->buf != NULL);
+	bo->used   = (size_t) (pos % (off_t) FILE_DIRECT_ALIGN);
+	bo->offset = pos - (off_t) bo->used;
+
+	if ( direct ){
+		bo->direct = file_direct(filehandle, true);
+		if UNLIKELY ( ! bo->direct ){
+			warning_tta("%s: O_DIRECT not supported, %s",
+				name, "writing through the page cache"
+			);
+		}
+	}
+	return;
+}
+
+/**@fn blockout_flush
+ * @brief writes out a full block
+ *
+ * @param bo         - the block writer
+ * @param filehandle - the file
+ * @param name       - name of the file (errors)
+**/
+INLINE void
+blockout_flush(
+	struct BlockOut *const RESTRICT bo, FILE *const RESTRICT filehandle,
+	const char *const RESTRICT name
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*bo,
+		filehandle
+@*/
+{
+	assert((bo->buf != NULL) && (bo->used == bo->size));
+
+	if UNLIKELY (
+	     ! file_pwrite(filehandle, bo->buf, bo->size, bo->offset)
+	){
+		error_sys(errno, "pwrite", name);
+	}
+	bo->offset += (off_t) bo->size;
+	bo->used    = 0;
+	return;
+}
+
+/**@fn blockout_writev
+ * @brief copies a gather list into the blocks, writing out each one that
+ *   fills up
+ *
+ * @param bo         - the block writer
+ * @param filehandle - the file
+ * @param name       - name of the file (errors)
+ * @param iov        - the gather list
+ * @param niov       - number of entries in iov
+**/
+INLINE void
+blockout_writev(
+	struct BlockOut *const RESTRICT bo, FILE *const RESTRICT filehandle,
+	const char *const RESTRICT name, const iovec_p *RESTRICT iov,
+	size_t niov
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*bo,
+		filehandle
+@*/
+{
+	const uint8_t *src;
+	size_t len, nbytes;
+
+	assert(bo->buf != NULL);
+
+	for ( ; niov != 0; ++iov, --niov ){
+		src = iov->iov_base;
+		len = iov->iov_len;
+		while ( len != 0 ){
+			nbytes = bo->size - bo->used;
+			if ( nbytes > len ){
+				nbytes = len;
+			}
+			(void) memcpy(&bo->buf[bo->used], src, nbytes);
+			bo->used += nbytes;
+			src       = &src[nbytes];
+			len      -= nbytes;
+			if ( bo->used == bo->size ){
+				blockout_flush(bo, filehandle, name);
+			}
+		}
+	}
+	return;
+}
+
+/**@fn blockout_finish
+ * @brief writes out the last block, and leaves the file's position at the
+ *   end of what was written
+ *
+ * @param bo         - the block writer
+ * @param filehandle - the file
+ * @param name       - name of the file (errors)
+ *
+ * @note with O_DIRECT, the last block is zero-padded to FILE_DIRECT_ALIGN,
+ *   so the file should be truncated to its position afterwards
+ * @note a no-op if bo->buf is NULL
+**/
+INLINE void
+blockout_finish(
+	struct BlockOut *const RESTRICT bo, FILE *const RESTRICT filehandle,
+	const char *const RESTRICT name
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*bo,
+		filehandle
+@*/
+/*@releases	bo->buf@*/
+{
+	size_t len;
+	union {	int d; } result;
+
+	if ( bo->buf == NULL ){
+		return;
+	}
+
+	len = bo->used;
+	if ( bo->direct ){
+		len += ALIGN_FW_DIFF(len, FILE_DIRECT_ALIGN);
+		memset(&bo->buf[bo->used], 0x00, len - bo->used);
+	}
+	if UNLIKELY (
+	     (len != 0) && (! file_pwrite(filehandle, bo->buf, len, bo->offset))
+	){
+		error_sys(errno, "pwrite", name);
+	}
+	if UNLIKELY ( bo->direct && (! file_direct(filehandle, false)) ){
+		error_sys(errno, "fcntl", name);
+	}
+
+	result.d = fseeko(filehandle, bo->offset + (off_t) bo->used, SEEK_SET);
+	if UNLIKELY ( result.d != 0 ){
+		error_sys(errno, "fseeko", name);
+	}
+
+	pages_unmap(bo->buf, bo->size);
+	bo->buf = NULL;
+	return;
+}
+
+/* EOF //////////////////////////////////////////////////////////////////// */
+#endif	/* H_TTA_MODES_BLOCKOUT_H */
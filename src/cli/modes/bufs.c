@@ -4,12 +4,13 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
 
 #include <assert.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -18,42 +19,98 @@
 #include "../alloc.h"
 #include "../common.h"
 #include "../debug.h"
+#include "../system.h"
 
+#include "./arena.h"
 #include "./bufs.h"
 
 /* //////////////////////////////////////////////////////////////////////// */
 
+#undef cb
+static NOINLINE void codecbuf_ttabuf_grow(
+	struct CodecBuf *const RESTRICT cb, size_t
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		cb->ttabuf_len,
+		cb->ttabuf,
+		cb->ttabuf_owned
+@*/
+;
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/**@fn encbuf_arena_size
+ * @brief the arena space encbuf_init will carve out
+ *
+ * @param ni32_len    - length of the i32buf
+ * @param ttabuf_len  - size of the ttabuf
+ * @param nchan       - number of audio channels
+ * @param samplebytes - number of bytes per PCM sample
+ * @param mode        - single threaded, or which multi threaded half
+ *
+ * @return the arena space
+**/
+CONST
+BUILD size_t
+encbuf_arena_size(
+	const size_t ni32_len, const size_t ttabuf_len,
+	const unsigned int nchan, const enum LibTTAr_SampleBytes samplebytes,
+	const enum CodecBufMode mode
+)
+/*@*/
+{
+	const size_t i32buf_size = ARENA_SIZE(ni32_len * (sizeof(int32_t)));
+	const size_t pcmbuf_size = ARENA_SIZE(ni32_len * samplebytes);
+	const size_t ttabuf_size = ARENA_SIZE(
+		(ttabuf_len * nchan)
+		 + libttaR_ttabuf_safety_margin(samplebytes, nchan)
+	);
+	size_t retval = 0;
+
+	switch ( mode ){
+	case CBM_SINGLE_THREADED:
+		retval = i32buf_size + pcmbuf_size + ttabuf_size;
+		break;
+	case CBM_MULTI_THREADED_INPUT:
+		retval = pcmbuf_size;
+		break;
+	case CBM_MULTI_THREADED_OUTPUT:
+		retval = ttabuf_size;
+		break;
+	}
+	return retval;
+}
+
 /**@fn encbuf_init
  * @brief initializes an encbuf
  *
  * @param eb          - encode buffers struct
+ * @param arena       - arena to carve the buffers out of
  * @param ni32_len    - length of the i32buf
  * @param ttabuf_len  - size of the ttabuf
  * @param nchan       - number of audio channels
  * @param samplebytes - number of bytes per PCM sample
- * @param mode        - single or multi threaded
+ * @param mode        - single threaded, or which multi threaded half
 **/
 BUILD NOINLINE void
 encbuf_init(
-	/*@out@*/ struct EncBuf *const RESTRICT eb, const size_t ni32_len,
+	/*@out@*/ struct EncBuf *const RESTRICT eb,
+	struct Arena *const RESTRICT arena, const size_t ni32_len,
 	const size_t ttabuf_len, const unsigned int nchan,
 	const enum LibTTAr_SampleBytes samplebytes, enum CodecBufMode mode
 )
-/*@globals	fileSystem,
-		internalState
-@*/
-/*@modifies	fileSystem,
-		internalState,
-		*eb
-@*/
-/*@allocates	eb->i32buf,
-		eb->pcmbuf,
-		eb->ttabuf
+/*@modifies	*eb,
+		arena->used
 @*/
 {
 	const size_t safety_margin = libttaR_ttabuf_safety_margin(
 		samplebytes, nchan
 	);
+	const size_t used = arena->used;
 
 	assert(safety_margin != 0);
 
@@ -62,91 +119,195 @@ encbuf_init(
 	eb->ttabuf_len = (ttabuf_len * nchan) + safety_margin;
 	assert(eb->ttabuf_len != 0);
 
+	eb->i32buf = NULL;
+	eb->pcmbuf = NULL;
+	eb->ttabuf = NULL;
 	switch ( mode ){
 	default:
 		assert(false);
 		break;
 	case CBM_SINGLE_THREADED:
-		eb->i32buf = calloc_check(eb->i32buf_len, sizeof *eb->i32buf);
+		eb->i32buf = arena_alloc(
+			arena, eb->i32buf_len * (sizeof *eb->i32buf)
+		);
+		eb->pcmbuf = arena_alloc(arena, eb->i32buf_len * samplebytes);
+		eb->ttabuf = arena_alloc(arena, eb->ttabuf_len);
+		break;
+	case CBM_MULTI_THREADED_INPUT:
+		eb->pcmbuf = arena_alloc(arena, eb->i32buf_len * samplebytes);
 		break;
-	case CBM_MULTI_THREADED:
-		eb->i32buf = NULL;
+	case CBM_MULTI_THREADED_OUTPUT:
+		eb->ttabuf = arena_alloc(arena, eb->ttabuf_len);
 		break;
 	}
-	eb->pcmbuf = calloc_check(eb->i32buf_len, (size_t) samplebytes);
-	eb->ttabuf = malloc_check(eb->ttabuf_len);
+	eb->slot         = &arena->base[used];
+	eb->slot_size    = arena->used - used;
+	eb->ttabuf_owned = false;
+	eb->ttabuf_used  = 0;
+	eb->nseg         = 0;
+	eb->seg          = NULL;
 
 	return;
 }
 
-/**@fn encbuf_adjust
- * @brief adjust an encbuf
+/**@fn encbuf_spill
+ * @brief gets the next spill segment for the frame being encoded
  *
- * @param eb      - encode buffers struct
- * @param add_len - additional size for the ttabuf
- * @param nchan   - number of audio channels
+ * @param eb          - encode buffers struct
+ * @param samplebytes - number of bytes per PCM sample
+ * @param nchan       - number of audio channels
  *
- * @note in encode loop
+ * @return the segment; its used is 0
+ *
+ * @note in encode loop, only for a frame bigger than the ttabuf
 **/
-HOT
-BUILD void
-encbuf_adjust(
-	struct EncBuf *const RESTRICT eb, const size_t add_len,
-	const unsigned int nchan
+/*@dependent@*/
+BUILD NOINLINE struct TTASeg *
+encbuf_spill(
+	struct EncBuf *const RESTRICT eb,
+	const enum LibTTAr_SampleBytes samplebytes, const unsigned int nchan
 )
 /*@globals	fileSystem,
 		internalState
 @*/
 /*@modifies	fileSystem,
 		internalState,
-		eb->ttabuf_len,
-		eb->ttabuf
+		eb->nseg,
+		eb->seg
 @*/
 {
-	const size_t new_len = add_len * nchan;
+	const size_t safety_margin = libttaR_ttabuf_safety_margin(
+		samplebytes, nchan
+	);
+	struct TTASeg *seg;
 
-	assert(new_len != 0);
+	assert(safety_margin != 0);
+	assert(eb->ttabuf_len > safety_margin);
 
-	/* the safety-margin should have already been added by here */
-	eb->ttabuf_len += new_len;
-	eb->ttabuf      = realloc_check(eb->ttabuf, eb->ttabuf_len);
+	if UNLIKELY ( eb->nseg == TTABUF_NSEG_MAX ){
+		error_tta("%s: too many spill segments", "encbuf_spill");
+	}
+	if ( eb->seg == NULL ){
+		eb->seg = calloc_check(
+			(size_t) TTABUF_NSEG_MAX, sizeof *eb->seg
+		);
+	}
 
-	return;
+	seg = &eb->seg[eb->nseg++];
+	if ( seg->buf == NULL ){
+		seg->len  = ((eb->ttabuf_len - safety_margin) / 8u) + 1u;
+		seg->len <<= eb->nseg - 1u;
+		seg->len += safety_margin;
+		seg->buf  = malloc_check(seg->len);
+	}
+	seg->used = 0;
+
+	return seg;
+}
+
+/**@fn encbuf_iovec
+ * @brief fills in the gather list for writing out an encoded frame
+ *
+ * @param iov        - gather list; room for (TTABUF_NSEG_MAX + 2u) entries
+ * @param eb         - encode buffers struct
+ * @param footer     - the frame's footer (CRC, or TTA2 footer)
+ * @param footer_len - length of 'footer'
+ *
+ * @return number of entries filled in
+**/
+BUILD unsigned int
+encbuf_iovec(
+	/*@out@*/ iovec_p *const RESTRICT iov,
+	const struct EncBuf *const RESTRICT eb,
+	const void *const RESTRICT footer, const size_t footer_len
+)
+/*@modifies	*iov@*/
+{
+	unsigned int n = 0, i;
+
+	iov[n].iov_base   = eb->ttabuf;
+	iov[n++].iov_len  = eb->ttabuf_used;
+	for ( i = 0; i < eb->nseg; ++i ){
+		assert(eb->seg != NULL);
+		iov[n].iov_base  = eb->seg[i].buf;
+		iov[n++].iov_len = eb->seg[i].used;
+	}
+	iov[n].iov_base   = (void *) footer;
+	iov[n++].iov_len  = footer_len;
+
+	return n;
 }
 
 /* ======================================================================== */
 
+/**@fn decbuf_arena_size
+ * @brief the arena space decbuf_init will carve out
+ *
+ * @param ni32_len    - length of the i32buf
+ * @param ttabuf_len  - size of the ttabuf
+ * @param nchan       - number of audio channels
+ * @param samplebytes - number of bytes per PCM sample
+ * @param mode        - single threaded, or which multi threaded half
+ *
+ * @return the arena space
+**/
+CONST
+BUILD size_t
+decbuf_arena_size(
+	const size_t ni32_len, const size_t ttabuf_len,
+	const unsigned int nchan, const enum LibTTAr_SampleBytes samplebytes,
+	const enum CodecBufMode mode
+)
+/*@*/
+{
+	const size_t i32buf_size = ARENA_SIZE(ni32_len * (sizeof(int32_t)));
+	const size_t pcmbuf_size = ARENA_SIZE(ni32_len * samplebytes);
+	const size_t ttabuf_size = ARENA_SIZE(
+		(ttabuf_len * nchan)
+		 + libttaR_ttabuf_safety_margin(samplebytes, nchan)
+	);
+	size_t retval = 0;
+
+	switch ( mode ){
+	case CBM_SINGLE_THREADED:
+		retval = i32buf_size + pcmbuf_size + ttabuf_size;
+		break;
+	case CBM_MULTI_THREADED_INPUT:
+		retval = ttabuf_size;
+		break;
+	case CBM_MULTI_THREADED_OUTPUT:
+		retval = pcmbuf_size;
+		break;
+	}
+	return retval;
+}
+
 /**@fn decbuf_init
  * @brief initializes a decbuf
  *
  * @param db          - decode buffers struct
+ * @param arena       - arena to carve the buffers out of
  * @param ni32_len    - length of the i32buf
  * @param ttabuf_len  - size of the ttabuf
  * @param nchan       - number of audio channels
  * @param samplebytes - number of bytes per PCM sample
- * @param mode        - single or multi threaded
+ * @param mode        - single threaded, or which multi threaded half
 **/
 BUILD NOINLINE void
 decbuf_init(
-	/*@out@*/ struct DecBuf *const RESTRICT db, const size_t ni32_len,
+	/*@out@*/ struct DecBuf *const RESTRICT db,
+	struct Arena *const RESTRICT arena, const size_t ni32_len,
 	const size_t ttabuf_len, const unsigned int nchan,
 	const enum LibTTAr_SampleBytes samplebytes, enum CodecBufMode mode
 )
-/*@globals	fileSystem,
-		internalState
-@*/
-/*@modifies	fileSystem,
-		internalState,
-		*db
-@*/
-/*@allocates	db->i32buf,
-		db->pcmbuf,
-		db->ttabuf
+/*@modifies	*db,
+		arena->used
 @*/
 {
 	const size_t safety_margin = libttaR_ttabuf_safety_margin(
 		samplebytes, nchan
 	);
+	const size_t used = arena->used;
 
 	assert(safety_margin != 0);
 
@@ -155,19 +316,33 @@ decbuf_init(
 	db->ttabuf_len = (ttabuf_len * nchan) + safety_margin;
 	assert(db->ttabuf_len != 0);
 
+	db->i32buf = NULL;
+	db->pcmbuf = NULL;
+	db->ttabuf = NULL;
 	switch ( mode ){
 	default:
 		assert(false);
 		break;
 	case CBM_SINGLE_THREADED:
-		db->i32buf = calloc_check(ni32_len, sizeof *db->i32buf);
+		db->i32buf = arena_alloc(
+			arena, ni32_len * (sizeof *db->i32buf)
+		);
+		db->pcmbuf = arena_alloc(arena, ni32_len * samplebytes);
+		db->ttabuf = arena_alloc(arena, db->ttabuf_len);
+		break;
+	case CBM_MULTI_THREADED_INPUT:
+		db->ttabuf = arena_alloc(arena, db->ttabuf_len);
 		break;
-	case CBM_MULTI_THREADED:
-		db->i32buf = NULL;
+	case CBM_MULTI_THREADED_OUTPUT:
+		db->pcmbuf = arena_alloc(arena, ni32_len * samplebytes);
 		break;
 	}
-	db->pcmbuf = calloc_check(ni32_len, (size_t) samplebytes);
-	db->ttabuf = malloc_check(db->ttabuf_len);
+	db->slot         = &arena->base[used];
+	db->slot_size    = arena->used - used;
+	db->ttabuf_owned = false;
+	db->ttabuf_used  = 0;
+	db->nseg         = 0;
+	db->seg          = NULL;
 
 	return;
 }
@@ -194,7 +369,8 @@ decbuf_check_adjust(
 /*@modifies	fileSystem,
 		internalState,
 		db->ttabuf_len,
-		db->ttabuf
+		db->ttabuf,
+		db->ttabuf_owned
 @*/
 {
 	const size_t safety_margin = libttaR_ttabuf_safety_margin(
@@ -208,42 +384,142 @@ decbuf_check_adjust(
 	assert(newsize != 0);
 
 	if ( newsize > db->ttabuf_len ){
-		db->ttabuf_len = newsize;
-		db->ttabuf     = realloc_check(db->ttabuf, newsize);
+		codecbuf_ttabuf_grow(db, newsize);
 	}
 	return;
 }
 
 /* ======================================================================== */
 
+/**@fn codecbuf_ttabuf_grow
+ * @brief grows a ttabuf, moving it out of the arena the first time
+ *
+ * @param cb      - codec buffers struct
+ * @param new_len - new size of the ttabuf
+**/
+static NOINLINE void
+codecbuf_ttabuf_grow(struct CodecBuf *const RESTRICT cb, const size_t new_len)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		cb->ttabuf_len,
+		cb->ttabuf,
+		cb->ttabuf_owned
+@*/
+{
+	uint8_t *ttabuf;
+
+	assert(new_len > cb->ttabuf_len);
+
+	if ( cb->ttabuf_owned ){
+		cb->ttabuf = realloc_check(cb->ttabuf, new_len);
+	}
+	else {	ttabuf = malloc_check(new_len);
+		memcpy(ttabuf, cb->ttabuf, cb->ttabuf_len);
+		cb->ttabuf       = ttabuf;
+		cb->ttabuf_owned = true;
+	}
+	cb->ttabuf_len = new_len;
+
+	return;
+}
+
+/**@fn codecbuf_prefault
+ * @brief faults in the arena memory of a codecbuf
+ *
+ * @param cb - codec buffers struct
+ *
+ * @note safe while another thread uses the buffers
+**/
+BUILD void
+codecbuf_prefault(const struct CodecBuf *const RESTRICT cb)
+/*@globals	internalState@*/
+/*@modifies	internalState@*/
+{
+	(void) pages_populate(cb->slot, cb->slot_size);
+	return;
+}
+
+/**@fn codecbuf_discard
+ * @brief gives the arena memory of an unused codecbuf back to the system;
+ *   it faults back in, zeroed, when next used
+ *
+ * @param cb - codec buffers struct
+**/
+BUILD void
+codecbuf_discard(const struct CodecBuf *const RESTRICT cb)
+/*@globals	internalState@*/
+/*@modifies	internalState@*/
+{
+	pages_discard(cb->slot, cb->slot_size);
+	return;
+}
+
 /**@fn codecbuf_free
- * @brief free any allocated pointers in a codecbuf
+ * @brief frees the parts of a codecbuf that are not in the arena
  *
- * @param cb   - codec buffers struct
- * @param mode - single or multi threaded
+ * @param cb - codec buffers struct
 **/
 BUILD NOINLINE void
-codecbuf_free(
-	const struct CodecBuf *const RESTRICT cb, enum CodecBufMode mode
-)
+codecbuf_free(const struct CodecBuf *const RESTRICT cb)
 /*@globals	internalState@*/
 /*@modifies	internalState@*/
-/*@releases	cb->i32buf,
-		cb->pcmbuf,
-		cb->ttabuf
-@*/
 {
-	if ( mode == CBM_SINGLE_THREADED ){
-		free(cb->i32buf);
-	}
-	free(cb->pcmbuf);
-	free(cb->ttabuf);
+	unsigned int i;
 
+	if ( cb->ttabuf_owned ){
+		free(cb->ttabuf);
+	}
+	if ( cb->seg != NULL ){
+		for ( i = 0; i < TTABUF_NSEG_MAX; ++i ){
+			free(cb->seg[i].buf);
+		}
+		free(cb->seg);
+	}
 	return;
 }
 
 /* ======================================================================== */
 
+/**@fn priv_arena_size
+ * @brief the arena space priv_arena_alloc will carve out
+ *
+ * @param nchan - number of audio channels
+ *
+ * @return the arena space
+**/
+CONST
+BUILD size_t
+priv_arena_size(const unsigned int nchan)
+/*@*/
+{
+	return ARENA_SIZE(libttaR_codecstate_priv_size(nchan));
+}
+
+/**@fn priv_arena_alloc
+ * @brief carves a TTAr private state struct out of an arena
+ *
+ * @param arena - arena
+ * @param nchan - number of audio channels
+ *
+ * @return pointer to a properly sized and aligned buffer for a TTAr private
+ *   state struct
+**/
+/*@dependent@*/
+BUILD struct LibTTAr_CodecState_Priv *
+priv_arena_alloc(struct Arena *const RESTRICT arena, const unsigned int nchan)
+/*@modifies	arena->used@*/
+{
+	const size_t size = libttaR_codecstate_priv_size(nchan);
+
+	assert(size != 0);
+	assert(ARENA_ALIGN % LIBTTAr_CODECSTATE_PRIV_ALIGN == 0);
+
+	return arena_alloc(arena, size);
+}
+
 /**@fn priv_alloc
  * @brief allocate a buffer for a TTAr private state struct
  *
@@ -6,12 +6,13 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
 
 #include <assert.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -20,86 +21,136 @@
 #include "../alloc.h"
 #include "../common.h"
 #include "../formats.h"
+#include "../system.h"
 
 #include "./align.h"
+#include "./arena.h"
 
 /* //////////////////////////////////////////////////////////////////////// */
 
-#define TTABUF_LEN_DEFAULT		((size_t) BUFSIZ)
+/* a TTA frame is about the size of its PCM, so the ttabuf starts out that
+     big. in the encoder, the rare bigger frame spills over into a chain of
+     heap segments instead of the ttabuf being grown (and copied); each one
+     is twice as big as the last, starting at an eighth of the ttabuf. in
+     the decoder, the ttabuf grows out of the arena
+*/
+#define TTABUF_LEN_FRAME(x_i32buf_len, x_nchan, x_samplebytes)	( \
+	((x_i32buf_len) / (x_nchan)) * ((size_t) (x_samplebytes)) \
+)
+
+#define TTABUF_NSEG_MAX			16u
 
+/* in -M, a frame's input and output buffers live apart (see "mt-struct.h"),
+     so each codecbuf only allocates one of them
+*/
 enum CodecBufMode {
 	CBM_SINGLE_THREADED,
-	CBM_MULTI_THREADED
+	CBM_MULTI_THREADED_INPUT,	/* enc: pcmbuf; dec: ttabuf */
+	CBM_MULTI_THREADED_OUTPUT	/* enc: ttabuf; dec: pcmbuf */
 };
 
 /* //////////////////////////////////////////////////////////////////////// */
 
+/* a spill segment; kept for the next frame that spills */
+struct TTASeg {
+	/*@only@*/ /*@null@*/
+	uint8_t	*buf;
+	size_t	len;
+	size_t	used;
+};
+
+/* in -M, neighbouring codecbufs in a pool are used by different coders.
+     the buffers are carved out of an arena (see "arena.h"), except for a
+     ttabuf that had to grow
+*/
 struct CodecBuf {
 	size_t	i32buf_len;
 	size_t	ttabuf_len;
-	/*@only@*/ /*@null@*/	/* @only@ in -S, @dependent@ in -M          */
+	/*@dependent@*/ /*@null@*/
 	int32_t	*i32buf;	/* thread owned in -M; page-fault reduction */
-	/*@only@*/
-	uint8_t	*pcmbuf;
-	/*@only@*/
+	/*@dependent@*/ /*@null@*/
+	uint8_t	*pcmbuf;	/* either may be borrowed in -M             */
+	/*@dependent@*/ /*@null@*/
 	uint8_t	*ttabuf;
-};
+	/*@dependent@*/ /*@null@*/
+	uint8_t	*slot;		/* the arena memory the codecbuf owns       */
+	size_t	slot_size;
+	bool	ttabuf_owned;	/* grown out of the arena; malloc'd         */
+	/* * */
+	size_t	ttabuf_used;	/* enc: bytes of the frame in the ttabuf    */
+	unsigned int	nseg;	/* enc: spill segments of the frame         */
+	/*@only@*/ /*@null@*/
+	struct TTASeg	*seg;	/* enc: TTABUF_NSEG_MAX of them; malloc'd   */
+} ALIGNED(CACHE_LINE_SIZE);
 
 #define EncBuf	CodecBuf
 #define DecBuf	CodecBuf
 
 /* //////////////////////////////////////////////////////////////////////// */
 
+CONST
+BUILD_EXTERN size_t encbuf_arena_size(
+	size_t, size_t, unsigned int, enum LibTTAr_SampleBytes,
+	enum CodecBufMode
+)
+/*@*/
+;
+
 #undef eb
+#undef arena
 BUILD_EXTERN NOINLINE void encbuf_init(
-	/*@out@*/ struct EncBuf *const RESTRICT eb, size_t, size_t,
-	unsigned int, enum LibTTAr_SampleBytes, enum CodecBufMode
+	/*@out@*/ struct EncBuf *const RESTRICT eb,
+	struct Arena *const RESTRICT arena, size_t, size_t, unsigned int,
+	enum LibTTAr_SampleBytes, enum CodecBufMode
 )
-/*@globals	fileSystem,
-		internalState
-@*/
-/*@modifies	fileSystem,
-		internalState,
-		*eb
-@*/
-/*@allocates	eb->i32buf,
-		eb->pcmbuf,
-		eb->ttabuf
+/*@modifies	*eb,
+		arena->used
 @*/
 ;
 
 #undef eb
-HOT
-BUILD_EXTERN void encbuf_adjust(
-	struct EncBuf *const RESTRICT eb, size_t, unsigned int
+/*@dependent@*/
+BUILD_EXTERN NOINLINE struct TTASeg *encbuf_spill(
+	struct EncBuf *const RESTRICT eb, enum LibTTAr_SampleBytes,
+	unsigned int
 )
 /*@globals	fileSystem,
 		internalState
 @*/
 /*@modifies	fileSystem,
 		internalState,
-		eb->ttabuf_len,
-		eb->ttabuf
+		eb->nseg,
+		eb->seg
 @*/
 ;
 
+#undef iov
+BUILD_EXTERN unsigned int encbuf_iovec(
+	/*@out@*/ iovec_p *RESTRICT iov, const struct EncBuf *RESTRICT,
+	const void *RESTRICT, size_t
+)
+/*@modifies	*iov@*/
+;
+
 /* ------------------------------------------------------------------------ */
 
+CONST
+BUILD_EXTERN size_t decbuf_arena_size(
+	size_t, size_t, unsigned int, enum LibTTAr_SampleBytes,
+	enum CodecBufMode
+)
+/*@*/
+;
+
 #undef db
+#undef arena
 BUILD_EXTERN NOINLINE void decbuf_init(
-	/*@out@*/ struct DecBuf *const RESTRICT db, size_t, size_t,
-	unsigned int, enum LibTTAr_SampleBytes, enum CodecBufMode
+	/*@out@*/ struct DecBuf *const RESTRICT db,
+	struct Arena *const RESTRICT arena, size_t, size_t, unsigned int,
+	enum LibTTAr_SampleBytes, enum CodecBufMode
 )
-/*@globals	fileSystem,
-		internalState
-@*/
-/*@modifies	fileSystem,
-		internalState,
-		*db
-@*/
-/*@allocates	db->i32buf,
-		db->pcmbuf,
-		db->ttabuf
+/*@modifies	*db,
+		arena->used
 @*/
 ;
 
@@ -115,26 +166,46 @@ BUILD_EXTERN void decbuf_check_adjust(
 /*@modifies	fileSystem,
 		internalState,
 		db->ttabuf_len,
-		db->ttabuf
+		db->ttabuf,
+		db->ttabuf_owned
 @*/
 ;
 
 /* ------------------------------------------------------------------------ */
 
+#undef cb
+BUILD_EXTERN void codecbuf_prefault(const struct CodecBuf *const RESTRICT cb)
+/*@globals	internalState@*/
+/*@modifies	internalState@*/
+;
+
+#undef cb
+BUILD_EXTERN void codecbuf_discard(const struct CodecBuf *const RESTRICT cb)
+/*@globals	internalState@*/
+/*@modifies	internalState@*/
+;
+
 #undef cb
 BUILD_EXTERN NOINLINE void codecbuf_free(
-	const struct CodecBuf *const RESTRICT cb, enum CodecBufMode
+	const struct CodecBuf *const RESTRICT cb
 )
 /*@globals	internalState@*/
 /*@modifies	internalState@*/
-/*@releases	cb->i32buf,
-		cb->pcmbuf,
-		cb->ttabuf
-@*/
 ;
 
 /* ------------------------------------------------------------------------ */
 
+CONST
+BUILD_EXTERN size_t priv_arena_size(unsigned int) /*@*/;
+
+#undef arena
+/*@dependent@*/
+BUILD_EXTERN struct LibTTAr_CodecState_Priv *priv_arena_alloc(
+	struct Arena *const RESTRICT arena, unsigned int
+)
+/*@modifies	arena->used@*/
+;
+
 /*@only@*/
 BUILD_EXTERN struct LibTTAr_CodecState_Priv * priv_alloc(const unsigned int)
 /*@globals	internalState@*/
@@ -0,0 +1,210 @@
+#ifndef H_TTA_MODES_BULKIO_H
+#define H_TTA_MODES_BULKIO_H
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// modes/bulkio.h                                                           //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2026, Shane Seelig                                         //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//      Drop-behind for --bulk-io. A file is followed through as it is      //
+// read or written, and everything more than a BULKIO_WINDOW behind is      //
+// dropped from the page cache. So a run holds about two windows of each    //
+// file in the cache instead of all of it. An infile has the next window    //
+// read ahead. An outfile has its newest window's writeback started, and    //
+// the one before waited on, before it is dropped; dirty pages cannot be    //
+// dropped. It is fed by whoever is the last to use the data. For the       //
+// multi-threaded modes, that is the writer, for both files.                //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <sys/types.h>
+
+#include "../common.h"
+#include "../system.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/* how far behind the data has to be to be dropped; also the read ahead */
+#ifndef BULKIO_WINDOW
+#define BULKIO_WINDOW		((off_t) (8 * 1024 * 1024))
+#endif
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+struct BulkIO {
+	/*@temp@*/ /*@null@*/
+	FILE		*handle;	/* NULL if not in use        */
+	/*@temp@*/ /*@null@*/
+	const uint8_t	*map;		/* the file mapped from base */
+	off_t		base;		/* where it was started      */
+	off_t		pos;		/* end of what has been used */
+	off_t		done;		/* end of what was dropped   */
+	bool		output;
+};
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/**@fn bulkio_init
+ * @brief starts following a file from its position
+ *
+ * @param bio    - the drop-behind state
+ * @param handle - the file
+ * @param output - whether it is being written
+ * @param map    - the file mapped from its position, or NULL
+ * @param on     - whether to (--bulk-io)
+**/
+INLINE void
+bulkio_init(
+	/*@out@*/ struct BulkIO *const RESTRICT bio, FILE *const handle,
+	const bool output, /*@null@*/ const uint8_t *const map, const bool on
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*bio
+@*/
+{
+	bio->handle = NULL;
+	bio->map    = map;
+	bio->base   = 0;
+	bio->pos    = 0;
+	bio->done   = 0;
+	bio->output = output;
+	if ( ! on ){
+		return;
+	}
+
+	bio->base = ftello(handle);
+	if ( bio->base < 0 ){
+		return;		/* a pipe */
+	}
+	bio->handle = handle;
+	bio->pos    = bio->base;
+	bio->done   = bio->base;
+	if ( ! output ){
+		file_advise(
+			handle, bio->base, BULKIO_WINDOW, FILE_ADVICE_WILLNEED
+		);
+	}
+	return;
+}
+
+/**@fn bulkio_drop
+ * @brief drops a range of the file from the page cache
+ *
+ * @param bio - the drop-behind state
+ * @param end - end of the range; its start is bio->done
+**/
+INLINE void
+bulkio_drop(struct BulkIO *const RESTRICT bio, const off_t end)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		bio->done
+@*/
+{
+	assert(bio->handle != NULL);
+
+	if ( end <= bio->done ){
+		return;
+	}
+	if ( bio->output ){
+		file_writeback(bio->handle, bio->done, end - bio->done, true);
+	}
+	else if ( bio->map != NULL ){
+		/* mapped pages are not dropped */
+		pages_discard(
+			&bio->map[bio->done - bio->base],
+			(size_t) (end - bio->done)
+		);
+	} else{;}
+	file_advise(
+		bio->handle, bio->done, end - bio->done, FILE_ADVICE_DONTNEED
+	);
+	bio->done = end;
+	return;
+}
+
+/**@fn bulkio_update
+ * @brief moves the end of what has been used, and drops what is a window
+ *   behind it, a window at a time
+ *
+ * @param bio    - the drop-behind state
+ * @param nbytes - number of bytes used since bulkio_init()
+**/
+ALWAYS_INLINE void
+bulkio_update(struct BulkIO *const RESTRICT bio, const size_t nbytes)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*bio
+@*/
+{
+	off_t keep;
+
+	if ( bio->handle == NULL ){
+		return;
+	}
+	bio->pos = bio->base + (off_t) nbytes;
+	if LIKELY ( bio->pos - bio->done < 2 * BULKIO_WINDOW ){
+		return;
+	}
+
+	keep = bio->pos - BULKIO_WINDOW;
+	if ( bio->output ){
+		file_writeback(bio->handle, keep, BULKIO_WINDOW, false);
+	}
+	else {	file_advise(
+			bio->handle, bio->pos, BULKIO_WINDOW,
+			FILE_ADVICE_WILLNEED
+		);
+	}
+	bulkio_drop(bio, keep);
+	return;
+}
+
+/**@fn bulkio_finish
+ * @brief drops the rest of what has been used
+ *
+ * @param bio - the drop-behind state
+ *
+ * @note a no-op if not in use
+**/
+INLINE void
+bulkio_finish(struct BulkIO *const RESTRICT bio)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*bio
+@*/
+{
+	if ( bio->handle == NULL ){
+		return;
+	}
+	if ( bio->output ){
+		/* written through a FILE, some of it could still be buffered */
+		(void) fflush(bio->handle);
+	}
+	bulkio_drop(bio, bio->pos);
+	bio->handle = NULL;
+	return;
+}
+
+/* EOF //////////////////////////////////////////////////////////////////// */
+#endif	/* H_TTA_MODES_BULKIO_H */
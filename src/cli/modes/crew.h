@@ -0,0 +1,249 @@
+#ifndef H_TTA_MODES_CREW_H
+#define H_TTA_MODES_CREW_H
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// modes/crew.h                                                             //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//      The worker threads of the multi-threaded coders, kept alive for the //
+// whole run instead of being made and joined for every file. Each member   //
+// runs its routine once per job. The main thread starts a job by bumping   //
+// the job number, and waits for every member to post that it is done, so   //
+// a member only ever waits for the job after the one it last did. The      //
+// routine's arg is only touched between jobs by the main thread.           //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "../alloc.h"
+#include "../common.h"
+
+#include "./threads.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/* the gap between two files is long compared to a frame handoff, so the
+     members block on the job number right away
+*/
+#define CREW_NSPIN		0
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+struct Crew;
+
+struct CrewMember {
+	/*@dependent@*/
+	struct Crew			*crew;
+	start_routine_ret		(*routine)(void *);
+	/*@dependent@*/
+	void				*arg;
+	thread_p			thread;
+};
+
+/* main thread owned, except for the job and done */
+struct Crew {
+	waitvar_p			job;
+	semaphore_p			done;
+	uint32_t			njob;
+	bool				quit;
+	unsigned int			nmemb;
+	/*@only@*/
+	struct CrewMember		*member;
+};
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#undef arg
+START_ROUTINE_ABI
+INLINE start_routine_ret crew_member_loop(void *RESTRICT arg)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*arg
+@*/
+;
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/**@fn crew_init
+ * @brief initializes a crew without any members
+ *
+ * @param crew  - crew
+ * @param nmemb - number of members it will have
+**/
+INLINE void
+crew_init(/*@out@*/ struct Crew *const RESTRICT crew, const unsigned int nmemb)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*crew
+@*/
+{
+	assert(nmemb != 0);
+
+	waitvar_init(&crew->job, 0, CREW_NSPIN);
+	semaphore_init(&crew->done, 0);
+	crew->njob   = 0;
+	crew->quit   = false;
+	crew->nmemb  = 0;
+	crew->member = calloc_check((size_t) nmemb, sizeof *crew->member);
+
+	return;
+}
+
+/**@fn crew_add
+ * @brief creates the next member of a crew
+ *
+ * @param crew    - crew
+ * @param routine - what the member runs each job
+ * @param arg     - argument for the routine
+ *
+ * @note the member inherits the calling thread's affinity mask
+**/
+INLINE void
+crew_add(
+	struct Crew *const RESTRICT crew, start_routine_ret (*routine)(void *),
+	void *const arg
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*crew
+@*/
+{
+	struct CrewMember *const RESTRICT member = &crew->member[crew->nmemb];
+
+	member->crew    = crew;
+	member->routine = routine;
+	member->arg     = arg;
+	thread_create(&member->thread, crew_member_loop, member);
+	crew->nmemb    += 1u;
+
+	return;
+}
+
+/**@fn crew_free
+ * @brief tells the members of a crew to quit, joins them, and frees it
+ *
+ * @param crew - crew
+ *
+ * @pre no job is running
+**/
+INLINE void
+crew_free(struct Crew *const RESTRICT crew)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*crew
+@*/
+/*@releases	crew->member@*/
+{
+	unsigned int i;
+
+	crew->quit  = true;
+	crew->njob += 1u;
+	waitvar_set(&crew->job, crew->njob);
+
+	for ( i = 0; i < crew->nmemb; ++i ){
+		thread_join(&crew->member[i].thread);
+	}
+	free(crew->member);
+	semaphore_destroy(&crew->done);
+	waitvar_destroy(&crew->job);
+
+	return;
+}
+
+/* ------------------------------------------------------------------------ */
+
+/**@fn crew_start
+ * @brief starts a job
+ *
+ * @param crew - crew
+ *
+ * @pre the previous job is done
+**/
+ALWAYS_INLINE void
+crew_start(struct Crew *const RESTRICT crew)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*crew
+@*/
+{
+	crew->njob += 1u;
+	waitvar_set(&crew->job, crew->njob);
+	return;
+}
+
+/**@fn crew_wait
+ * @brief waits for every member of a crew to be done with the job
+ *
+ * @param crew - crew
+**/
+ALWAYS_INLINE void
+crew_wait(struct Crew *const RESTRICT crew)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		crew->done
+@*/
+{
+	unsigned int i;
+
+	for ( i = 0; i < crew->nmemb; ++i ){
+		semaphore_wait(&crew->done);
+	}
+	return;
+}
+
+/* ------------------------------------------------------------------------ */
+
+/**@fn crew_member_loop
+ * @brief the thread function of a crew member
+ *
+ * @param arg - the member
+ *
+ * @retval (start_routine_ret) 0
+**/
+START_ROUTINE_ABI
+INLINE start_routine_ret
+crew_member_loop(void *const RESTRICT arg)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*arg
+@*/
+{
+	struct CrewMember *const RESTRICT member = arg;
+	struct Crew       *const RESTRICT crew   = member->crew;
+	uint32_t njob;
+
+	for ( njob = 1u;; ++njob ){
+		waitvar_wait(&crew->job, njob);
+		if UNLIKELY ( crew->quit ){
+			break;
+		}
+		(void) member->routine(member->arg);
+		semaphore_post(&crew->done);
+	}
+	return (start_routine_ret) 0;
+}
+
+/* EOF //////////////////////////////////////////////////////////////////// */
+#endif	/* H_TTA_MODES_CREW_H */
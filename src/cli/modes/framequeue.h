@@ -0,0 +1,412 @@
+#ifndef H_TTA_MODES_FRAMEQUEUE_H
+#define H_TTA_MODES_FRAMEQUEUE_H
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// modes/framequeue.h                                                       //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//      The buffer pools of the multi-threaded coders. The input pool is    //
+// refilled by the coders, and the output pool by the writer; only the      //
+// reader takes from them, so it alone decides how many buffers are in      //
+// circulation. Every window of frames the reader looks at who waited on    //
+// whom:                                                                    //
+//     - a pool that ran dry while the other side also sat idle is too      //
+//   shallow for the jitter, and gets another buffer                        //
+//     - a pool that has not run dry for a few windows gives one back       //
+//     - a pool that runs dry while nobody else waits is not the problem;   //
+//   the coders (or the writer) are, and more buffers would not help        //
+// A pool never goes below one buffer per coder plus one, or above its      //
+// nmemb, which the caller sizes from the memory budget. The buffers of all //
+// nmemb ids are carved out of the run's arena up front; a shrink only      //
+// gives the pages of a buffer back, and a grow lets them fault back in.    //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../../libttaR.h"
+
+#include "../common.h"
+#include "../formats.h"
+
+#include "./atomic.h"
+#include "./bufs.h"
+#include "./freelist.h"
+#include "./threads.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/* number of windows without running dry before a pool shrinks */
+#define FRAMEQUEUE_NQUIET	4u
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+struct BufPool {
+	struct FreeList		fl;		/* fl.nmemb is the max depth */
+	size_t			head;
+	unsigned int		depth;		/* ids in circulation        */
+	unsigned int		depth_min;
+	unsigned int		nretire;	/* shrinks not yet done      */
+	unsigned int		nquiet;
+	unsigned int		nspare;
+	/*@temp@*/
+	unsigned int		*spare;		/* ids out of circulation    */
+	/*@temp@*/
+	struct CodecBuf		*buf;
+	enum CodecBufMode	mode;
+	bool			pinned;		/* registered with a ring    */
+	size_t			nstall;
+	size_t			nstall_last;
+};
+
+/* all reader thread owned, except for the atomic counters */
+struct FrameQueue {
+	struct BufPool			in;
+	struct BufPool			out;
+	/*@dependent@*/
+	size_t				*nstall_coder;	/* atomic */
+	/*@dependent@*/
+	size_t				*nstall_writer;	/* atomic */
+	size_t				nstall_coder_last;
+	size_t				nstall_writer_last;
+	size_t				window;
+	size_t				nframes;
+};
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/**@fn bufpool_init
+ * @brief initializes a buffer pool with ids [0, depth) in circulation
+ *
+ * @param pool  - buffer pool
+ * @param depth - starting number of buffers
+ * @param nspin - number of polls before a pop blocks
+ *
+ * @pre pool->fl, pool->spare, pool->buf, pool->mode, and pool->depth_min
+ *   are set; all of pool->buf are initialized
+**/
+INLINE void
+bufpool_init(
+	struct BufPool *const RESTRICT pool, const unsigned int depth,
+	const unsigned int nspin
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*pool
+@*/
+{
+	unsigned int i;
+
+	assert((pool->depth_min <= depth) && (depth <= pool->fl.nmemb));
+
+	freelist_init(&pool->fl, depth, nspin);
+	pool->nspare = 0;
+	for ( i = pool->fl.nmemb; i-- > depth; ){
+		pool->spare[pool->nspare++] = i;
+	}
+	pool->head        = 0;
+	pool->depth       = depth;
+	pool->nretire     = 0;
+	pool->nquiet      = 0;
+	pool->nstall      = 0;
+	pool->nstall_last = 0;
+
+	return;
+}
+
+/**@fn framequeue_init
+ * @brief initializes a frame queue and both its pools
+ *
+ * @param fq        - frame queue
+ * @param depth_min - min number of buffers in either pool
+ * @param depth_in  - starting number of input buffers
+ * @param depth_out - starting number of output buffers
+ * @param window    - number of frames between adapts
+ * @param nspin     - number of polls before a pop blocks
+ *
+ * @pre the pools' fl, spare, and buf are set; all the buf's are initialized
+**/
+INLINE void
+framequeue_init(
+	struct FrameQueue *const RESTRICT fq, const unsigned int depth_min,
+	const unsigned int depth_in, const unsigned int depth_out,
+	const size_t window, const unsigned int nspin
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*fq
+@*/
+{
+	fq->window             = window;
+	fq->nframes            = 0;
+	*fq->nstall_coder      = 0;
+	*fq->nstall_writer     = 0;
+	fq->nstall_coder_last  = 0;
+	fq->nstall_writer_last = 0;
+
+	fq->in.mode       = CBM_MULTI_THREADED_INPUT;
+	fq->in.depth_min  = depth_min;
+	bufpool_init(&fq->in, depth_in, nspin);
+
+	fq->out.mode      = CBM_MULTI_THREADED_OUTPUT;
+	fq->out.depth_min = depth_min;
+	bufpool_init(&fq->out, depth_out, nspin);
+
+	return;
+}
+
+/**@fn bufpool_free
+ * @brief destroys a buffer pool and frees what of its buffers is not in the
+ *   arena
+ *
+ * @param pool - buffer pool
+**/
+INLINE void
+bufpool_free(struct BufPool *const RESTRICT pool)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*pool
+@*/
+{
+	unsigned int i;
+
+	freelist_destroy(&pool->fl);
+	for ( i = 0; i < pool->fl.nmemb; ++i ){
+		codecbuf_free(&pool->buf[i]);
+	}
+	return;
+}
+
+/* ------------------------------------------------------------------------ */
+
+/**@fn bufpool_get
+ * @brief takes a buffer id from a pool, waiting for one if it is dry
+ *
+ * @param pool - buffer pool
+ *
+ * @return the id
+ *
+ * @note pending shrinks are done here, with the ids they get back; their
+ *   buffers' pages are given back to the system, unless the pool is pinned
+ *   by a ring, whose fixed I/O would then miss the new pages
+**/
+ALWAYS_INLINE unsigned int
+bufpool_get(struct BufPool *const RESTRICT pool)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*pool
+@*/
+{
+	unsigned int id;
+
+	if ( ! freelist_ready(&pool->fl, pool->head) ){
+		pool->nstall += 1u;
+	}
+	id = freelist_pop(&pool->fl, &pool->head);
+
+	while UNLIKELY ( pool->nretire != 0 ){
+		if ( ! pool->pinned ){
+			codecbuf_discard(&pool->buf[id]);
+		}
+		pool->spare[pool->nspare++] = id;
+		pool->depth   -= 1u;
+		pool->nretire -= 1u;
+		id = freelist_pop(&pool->fl, &pool->head);
+	}
+	return id;
+}
+
+/**@fn bufpool_ready
+ * @brief checks whether a bufpool_get would return without waiting
+ *
+ * @param pool - buffer pool
+ *
+ * @return true if it would; a pending shrink counts as a wait
+**/
+ALWAYS_INLINE bool
+bufpool_ready(const struct BufPool *const RESTRICT pool)
+/*@*/
+{
+	return ((pool->nretire == 0) && freelist_ready(&pool->fl, pool->head));
+}
+
+/**@fn bufpool_adapt
+ * @brief grows or shrinks a pool by one after a window
+ *
+ * @param pool    - buffer pool
+ * @param starved - whether the other side of the pool sat idle
+**/
+INLINE void
+bufpool_adapt(struct BufPool *const RESTRICT pool, const bool starved)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*pool
+@*/
+{
+	const bool   dry    = (pool->nstall != pool->nstall_last);
+	unsigned int id;
+
+	pool->nstall_last = pool->nstall;
+
+	if ( dry ){
+		pool->nquiet = 0;
+		if ( ! starved ){ return; }
+
+		/* grow */
+		if ( pool->nretire != 0 ){
+			pool->nretire -= 1u;
+		}
+		else if ( pool->nspare != 0 ){
+			id = pool->spare[--pool->nspare];
+			freelist_push(&pool->fl, id);
+			pool->depth += 1u;
+		} else{;}
+	}
+	else if ( ++pool->nquiet == FRAMEQUEUE_NQUIET ){
+		pool->nquiet = 0;
+
+		/* shrink */
+		if ( pool->depth - pool->nretire > pool->depth_min ){
+			pool->nretire += 1u;
+		}
+	} else{;}
+
+	return;
+}
+
+/**@fn bufpool_writeback
+ * @brief copies the reader owned part of a buffer pool
+ *
+ * @param pool  - buffer pool
+ * @param local - the reader's copy
+**/
+INLINE void
+bufpool_writeback(
+	struct BufPool *const RESTRICT pool,
+	const struct BufPool *const RESTRICT local
+)
+/*@modifies	*pool@*/
+{
+	pool->head        = local->head;
+	pool->depth       = local->depth;
+	pool->nretire     = local->nretire;
+	pool->nquiet      = local->nquiet;
+	pool->nspare      = local->nspare;
+	pool->nstall      = local->nstall;
+	pool->nstall_last = local->nstall_last;
+
+	return;
+}
+
+/* ======================================================================== */
+
+/**@fn framequeue_tick
+ * @brief counts a frame, and adapts the pools at the end of a window
+ *
+ * @param fq - frame queue
+ *
+ * @note call once per frame from the reader thread
+**/
+ALWAYS_INLINE void
+framequeue_tick(struct FrameQueue *const RESTRICT fq)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*fq
+@*/
+{
+	size_t nstall_coder, nstall_writer;
+	bool   starved_coder, starved_writer;
+
+	if LIKELY ( ++fq->nframes != fq->window ){
+		return;
+	}
+	fq->nframes = 0;
+
+	nstall_coder   = atomic_load_z(fq->nstall_coder);
+	nstall_writer  = atomic_load_z(fq->nstall_writer);
+	starved_coder  = (nstall_coder  != fq->nstall_coder_last);
+	starved_writer = (nstall_writer != fq->nstall_writer_last);
+	fq->nstall_coder_last  = nstall_coder;
+	fq->nstall_writer_last = nstall_writer;
+
+	bufpool_adapt(&fq->in, starved_coder);
+	bufpool_adapt(&fq->out, starved_coder || starved_writer);
+
+	return;
+}
+
+/**@fn framequeue_writeback
+ * @brief copies the reader's private copy of a frame queue back
+ *
+ * @param fq    - frame queue
+ * @param local - the reader's copy
+ *
+ * @note only what the reader changes is copied; the writer reads the rest
+ *   of the output pool the whole time
+**/
+INLINE void
+framequeue_writeback(
+	struct FrameQueue *const RESTRICT fq,
+	const struct FrameQueue *const RESTRICT local
+)
+/*@modifies	*fq@*/
+{
+	bufpool_writeback(&fq->in, &local->in);
+	bufpool_writeback(&fq->out, &local->out);
+	fq->nstall_coder_last  = local->nstall_coder_last;
+	fq->nstall_writer_last = local->nstall_writer_last;
+	fq->nframes            = local->nframes;
+
+	return;
+}
+
+/**@fn framequeue_stats
+ * @brief fills in the frame queue stats
+ *
+ * @param qstat - frame queue stats struct
+ * @param fq    - frame queue
+ *
+ * @pre all the threads are joined
+**/
+INLINE void
+framequeue_stats(
+	/*@out@*/ struct QueueStats *const RESTRICT qstat,
+	const struct FrameQueue *const RESTRICT fq
+)
+/*@modifies	*qstat@*/
+{
+	qstat->depth_in      = fq->in.depth  - fq->in.nretire;
+	qstat->depth_out     = fq->out.depth - fq->out.nretire;
+	qstat->nstall_reader = fq->in.nstall + fq->out.nstall;
+	qstat->nstall_coder  = *fq->nstall_coder;
+	qstat->nstall_writer = *fq->nstall_writer;
+
+	return;
+}
+
+/* EOF //////////////////////////////////////////////////////////////////// */
+#endif	/* H_TTA_MODES_FRAMEQUEUE_H */
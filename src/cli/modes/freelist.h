@@ -0,0 +1,184 @@
+#ifndef H_TTA_MODES_FREELIST_H
+#define H_TTA_MODES_FREELIST_H
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// modes/freelist.h                                                         //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//      A free list of buffer ids for the multi-threaded coders. The coder  //
+// threads push an id back as soon as they are done with its buffer, in     //
+// whatever order they finish; only the reader thread pops. It is a ring of //
+// nmemb cells, each with a waitvar for the push that filled it. There are  //
+// never more than nmemb ids, so a push can never lap a pop. Neighbouring   //
+// cells are pushed by different threads, so each gets its own cache line.  //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../common.h"
+
+#include "./align.h"
+#include "./atomic.h"
+#include "./threads.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/* value of a cell's seq after push number 'x_pos' */
+#define FREELIST_SEQ(x_pos)		((uint32_t) ((x_pos) + 1u))
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+struct FreeListCell {
+	waitvar_p			seq;
+	unsigned int			id;
+} ALIGNED(CACHE_LINE_SIZE);
+
+struct FreeList {
+	unsigned int			nmemb;
+	/*@dependent@*/
+	size_t				*tail;	/* coders; atomic */
+	/*@temp@*/
+	struct FreeListCell		*cell;
+};
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/**@fn freelist_init
+ * @brief initializes a free list with ids [0, nid) in it
+ *
+ * @param fl    - free list
+ * @param nid   - number of ids to start with
+ * @param nspin - number of polls before a pop blocks
+ *
+ * @pre fl->nmemb, fl->tail, and fl->cell are set
+ * @pre nid <= fl->nmemb
+**/
+INLINE void
+freelist_init(
+	struct FreeList *const RESTRICT fl, const unsigned int nid,
+	const unsigned int nspin
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*fl->tail,
+		fl->cell[]
+@*/
+{
+	unsigned int i;
+
+	assert(nid <= fl->nmemb);
+
+	for ( i = 0; i < fl->nmemb; ++i ){
+		fl->cell[i].id = i;
+		waitvar_init(
+			&fl->cell[i].seq, (i < nid ? FREELIST_SEQ(i) : 0),
+			nspin
+		);
+	}
+	*fl->tail = (size_t) nid;
+
+	return;
+}
+
+/**@fn freelist_destroy
+ * @brief destroys the waitvars in a free list
+ *
+ * @param fl - free list
+**/
+INLINE void
+freelist_destroy(struct FreeList *const RESTRICT fl)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		fl->cell[]
+@*/
+{
+	unsigned int i;
+
+	for ( i = 0; i < fl->nmemb; ++i ){
+		waitvar_destroy(&fl->cell[i].seq);
+	}
+	return;
+}
+
+/* ------------------------------------------------------------------------ */
+
+/**@fn freelist_push
+ * @brief gives an id back to the free list
+ *
+ * @param fl - free list
+ * @param id - id to give back
+ *
+ * @note the acq_rel increment orders this push after the pop that emptied
+ *   the cell, even if that pop's id went to some other thread
+**/
+ALWAYS_INLINE void
+freelist_push(struct FreeList *const RESTRICT fl, const unsigned int id)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*fl->tail,
+		fl->cell[]
+@*/
+{
+	const size_t pos = atomic_fetch_inc_acq_rel_z(fl->tail);
+	struct FreeListCell *const RESTRICT cell = &fl->cell[pos % fl->nmemb];
+
+	cell->id = id;
+	waitvar_set(&cell->seq, FREELIST_SEQ(pos));
+	return;
+}
+
+/**@fn freelist_ready
+ * @brief checks whether a pop would return without waiting
+ *
+ * @param fl   - free list
+ * @param head - number of pops so far
+ *
+ * @return true if the next cell has been pushed
+**/
+ALWAYS_INLINE bool
+freelist_ready(const struct FreeList *const RESTRICT fl, const size_t head)
+/*@*/
+{
+	return waitvar_test(
+		&fl->cell[head % fl->nmemb].seq, FREELIST_SEQ(head)
+	);
+}
+
+/**@fn freelist_pop
+ * @brief takes an id from the free list, waiting for one if it is empty
+ *
+ * @param fl   - free list
+ * @param head - number of pops so far; reader thread owned
+ *
+ * @return the id
+**/
+ALWAYS_INLINE unsigned int
+freelist_pop(struct FreeList *const RESTRICT fl, size_t *const RESTRICT head)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		fl->cell[],
+		*head
+@*/
+{
+	const size_t pos = (*head)++;
+	struct FreeListCell *const RESTRICT cell = &fl->cell[pos % fl->nmemb];
+
+	waitvar_wait(&cell->seq, FREELIST_SEQ(pos));
+	return cell->id;
+}
+
+/* EOF //////////////////////////////////////////////////////////////////// */
+#endif	/* H_TTA_MODES_FREELIST_H */
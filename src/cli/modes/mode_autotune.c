@@ -0,0 +1,410 @@
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// modes/mode_autotune.c                                                    //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+#include <assert.h>
+#include <float.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../libttaR.h"
+
+#include "../alloc.h"
+#include "../autotune.h"
+#include "../common.h"
+#include "../debug.h"
+#include "../main.h"
+#include "../system.h"
+
+#include "./bufs.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/* synthetic frames are one TTA1 frame at this rate */
+#define AUTOTUNE_SAMPLERATE	((size_t) 44100u)
+
+/* number of timed runs per kernel; the fastest run is kept */
+#define AUTOTUNE_NRUNS		16u
+
+/* a non-default kernel needs to be this much faster to be picked */
+#define AUTOTUNE_MARGIN		0.97
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+struct AutoTune_Bufs {
+	size_t		ni32;
+	size_t		ttabuf_len;
+	size_t		nbytes_tta;
+	/*@only@*/
+	int32_t		*i32buf;
+	/*@only@*/
+	int32_t		*decbuf;
+	/*@only@*/
+	uint8_t		*ttabuf;
+	/*@only@*/
+	struct LibTTAr_CodecState_Priv	*priv;
+};
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#undef at
+static void autotune_class(
+	struct AutoTune *RESTRICT at, enum LibTTAr_SampleBytes, unsigned int
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*at
+@*/
+;
+
+#undef i32buf
+static void synth_frame(
+	/*@out@*/ int32_t *RESTRICT i32buf, size_t, unsigned int,
+	enum LibTTAr_SampleBytes
+)
+/*@modifies	*i32buf@*/
+;
+
+#undef bufs
+static double bench_encode(
+	struct AutoTune_Bufs *RESTRICT bufs, enum LibTTAr_SampleBytes,
+	unsigned int, enum LibTTAr_Kernel
+)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*bufs
+@*/
+;
+
+#undef bufs
+static double bench_decode(
+	struct AutoTune_Bufs *RESTRICT bufs, enum LibTTAr_SampleBytes,
+	unsigned int, enum LibTTAr_Kernel
+)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*bufs
+@*/
+;
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/**@fn mode_autotune
+ * @brief mode function for benchmarking the codec kernels
+ *
+ * @param optind - index of the first argument
+ * @param argc   - argument count
+ * @param argv   - argument vector
+ *
+ * @return number of warnings/errors
+**/
+BUILD NOINLINE int
+mode_autotune(
+	const unsigned int optind, const unsigned int argc,
+	char *const *const argv
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState
+@*/
+{
+	struct AutoTune at;
+	enum LibTTAr_SampleBytes samplebytes;
+	unsigned int nchan;
+	char *name;
+
+	if UNLIKELY ( optind < argc ){
+		error_tta_nf("unexpected argument '%s'", argv[optind]);
+		return (int) g_nwarnings;
+	}
+
+	memset(&at, 0x00, sizeof at);
+	(void) fputs("\tmode\tsize\tnchan\tdefault\t\tmch\n", stderr);
+
+	for ( samplebytes = LIBTTAr_SAMPLEBYTES_1;
+	      samplebytes <= LIBTTAr_SAMPLEBYTES_MAX; ++samplebytes
+	){
+		for ( nchan = 1u; nchan <= AUTOTUNE_NCLASS; ++nchan ){
+			autotune_class(&at, samplebytes, nchan);
+		}
+	}
+
+	/* cache the results */
+	name = autotune_cache_name();
+	if UNLIKELY ( name == NULL ){
+		error_tta_nf("no cache directory (%s)", CACHEDIR_ENV);
+		return (int) g_nwarnings;
+	}
+	if ( autotune_save(&at, name) == 0 ){
+		(void) fprintf(stderr, "\n\twrote %s\n", name);
+	}
+	free(name);
+
+	return (int) g_nwarnings;
+}
+
+/* ------------------------------------------------------------------------ */
+
+/**@fn autotune_class
+ * @brief benchmarks the kernels for one (samplebytes, nchan) class, and
+ *   picks the fastest
+ *
+ * @param at          - autotune struct to fill
+ * @param samplebytes - number of bytes per PCM sample
+ * @param nchan       - number of audio channels
+**/
+static void
+autotune_class(
+	struct AutoTune *const RESTRICT at,
+	const enum LibTTAr_SampleBytes samplebytes, const unsigned int nchan
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*at
+@*/
+{
+	const size_t nsamples = libttaR_nsamples_perframe_tta1(
+		AUTOTUNE_SAMPLERATE
+	);
+	/* * */
+	struct AutoTune_Bufs bufs;
+	double t_kernel[LIBTTAr_KERNEL_MAX + 1u];
+	enum LibTTAr_Kernel kernel, best;
+	enum ProgramMode mode;
+	unsigned int run;
+	double t;
+
+	bufs.ni32       = nsamples * nchan;
+	bufs.ttabuf_len = (
+		(bufs.ni32 * (size_t) (samplebytes + 1u))
+		+ libttaR_ttabuf_safety_margin(samplebytes, nchan)
+	);
+	bufs.nbytes_tta = 0;
+	bufs.i32buf     = calloc_check(bufs.ni32, sizeof *bufs.i32buf);
+	bufs.decbuf     = calloc_check(bufs.ni32, sizeof *bufs.decbuf);
+	bufs.ttabuf     = malloc_check(bufs.ttabuf_len);
+	bufs.priv       = priv_alloc(nchan);
+
+	synth_frame(bufs.i32buf, nsamples, nchan, samplebytes);
+
+	/* encode first; the decoder needs its output */
+	for ( mode = MODE_ENCODE; mode <= MODE_DECODE; ++mode ){
+		for ( kernel = 0; kernel <= LIBTTAr_KERNEL_MAX; ++kernel ){
+			t_kernel[kernel] = DBL_MAX;
+		}
+
+		/* alternate the kernels so any drift hits them evenly */
+		for ( run = 0; run < AUTOTUNE_NRUNS; ++run ){
+			for ( kernel = 0; kernel <= LIBTTAr_KERNEL_MAX;
+			      ++kernel
+			){
+				t = (mode == MODE_ENCODE
+					? bench_encode(
+						&bufs, samplebytes, nchan,
+						kernel
+					)
+					: bench_decode(
+						&bufs, samplebytes, nchan,
+						kernel
+					)
+				);
+				if ( t < t_kernel[kernel] ){
+					t_kernel[kernel] = t;
+				}
+			}
+		}
+
+		best = LIBTTAr_KERNEL_DEFAULT;
+		for ( kernel = 1u; kernel <= LIBTTAr_KERNEL_MAX; ++kernel ){
+			if ( t_kernel[kernel]
+			    <
+			     t_kernel[best] * AUTOTUNE_MARGIN
+			){
+				best = kernel;
+			}
+		}
+		at->kernel[mode][samplebytes - 1u][nchan - 1u] = best;
+
+		(void) fprintf(stderr, "\t%s\t%u-bit\t%u\t%.3fms%s\t%.3fms%s\n",
+			(mode == MODE_ENCODE ? "enc" : "dec"),
+			8u * (unsigned int) samplebytes, nchan,
+			t_kernel[LIBTTAr_KERNEL_DEFAULT] * 1000.0,
+			(best == LIBTTAr_KERNEL_DEFAULT ? " *" : "\t"),
+			t_kernel[LIBTTAr_KERNEL_MCH] * 1000.0,
+			(best == LIBTTAr_KERNEL_MCH ? " *" : "")
+		);
+	}
+
+	priv_free(bufs.priv);
+	free(bufs.ttabuf);
+	free(bufs.decbuf);
+	free(bufs.i32buf);
+	return;
+}
+
+/* ------------------------------------------------------------------------ */
+
+/**@fn synth_frame
+ * @brief makes a synthetic frame; a triangle wave per channel plus noise
+ *
+ * @param i32buf      - destination buffer
+ * @param nsamples    - number of samples per channel
+ * @param nchan       - number of audio channels
+ * @param samplebytes - number of bytes per PCM sample
+ *
+ * @note the amplitude stays well within the range of 'samplebytes'
+**/
+static void
+synth_frame(
+	/*@out@*/ int32_t *const RESTRICT i32buf, const size_t nsamples,
+	const unsigned int nchan, const enum LibTTAr_SampleBytes samplebytes
+)
+/*@modifies	*i32buf@*/
+{
+	const unsigned int nbits    = 8u * (unsigned int) samplebytes;
+	const int32_t tri_offset    = (int32_t) (UINT32_C(1) << (nbits - 3u));
+	const int32_t noise_offset  = (int32_t) (UINT32_C(1) << (nbits - 6u));
+	/* * */
+	uint32_t lcg = UINT32_C(0x12345678);
+	uint32_t phase;
+	size_t i;
+	unsigned int j;
+
+	for ( i = 0; i < nsamples; ++i ){
+		for ( j = 0; j < nchan; ++j ){
+			phase  = (uint32_t) i * (
+				UINT32_C(0x00A3D70A) + (j * UINT32_C(0x00100000))
+			);
+			phase ^= (uint32_t) (0u - (phase >> 31u));
+			lcg    = (lcg * UINT32_C(1664525)) + UINT32_C(1013904223);
+
+			i32buf[(i * nchan) + j] = (
+				((int32_t) (phase >> (33u - nbits)) - tri_offset)
+				+
+				((int32_t) (lcg >> (37u - nbits)) - noise_offset)
+			);
+		}
+	}
+	return;
+}
+
+/**@fn bench_encode
+ * @brief times encoding the synthetic frame
+ *
+ * @param bufs        - autotune buffers
+ * @param samplebytes - number of bytes per PCM sample
+ * @param nchan       - number of audio channels
+ * @param kernel      - codec kernel
+ *
+ * @return elapsed time in seconds
+ *
+ * @note sets 'bufs'->nbytes_tta for bench_decode()
+**/
+static double
+bench_encode(
+	struct AutoTune_Bufs *const RESTRICT bufs,
+	const enum LibTTAr_SampleBytes samplebytes, const unsigned int nchan,
+	const enum LibTTAr_Kernel kernel
+)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*bufs
+@*/
+{
+	struct LibTTAr_CodecState_User user = LIBTTAr_CODECSTATE_USER_INIT;
+	struct LibTTAr_EncMisc misc;
+	enum LibTTAr_EncRetVal status;
+	timestamp_p ts_start, ts_finish;
+
+	misc.ni32_perframe = bufs->ni32;
+	misc.samplebytes   = samplebytes;
+	misc.nchan         = nchan;
+
+	timestamp_get(&ts_start);
+	do {
+		misc.dest_len    = bufs->ttabuf_len - user.nbytes_tta_total;
+		misc.src_len     = bufs->ni32 - user.ni32_total;
+		misc.ni32_target = bufs->ni32 - user.ni32_total;
+
+		status = libttaR_tta_encode_kernel(
+			&bufs->ttabuf[user.nbytes_tta_total],
+			&bufs->i32buf[user.ni32_total],
+			bufs->priv, &user, &misc, kernel
+		);
+		assert((status == LIBTTAr_ERV_OK_DONE)
+		      ||
+		       (status == LIBTTAr_ERV_OK_AGAIN)
+		);
+	}
+	while ( status == LIBTTAr_ERV_OK_AGAIN );
+	timestamp_get(&ts_finish);
+
+	bufs->nbytes_tta = user.nbytes_tta_total;
+	return timestamp_diff(&ts_start, &ts_finish);
+}
+
+/**@fn bench_decode
+ * @brief times decoding the synthetic frame
+ *
+ * @see bench_encode()
+ *
+ * @note bench_encode() must have been called first
+**/
+static double
+bench_decode(
+	struct AutoTune_Bufs *const RESTRICT bufs,
+	const enum LibTTAr_SampleBytes samplebytes, const unsigned int nchan,
+	const enum LibTTAr_Kernel kernel
+)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*bufs
+@*/
+{
+	struct LibTTAr_CodecState_User user = LIBTTAr_CODECSTATE_USER_INIT;
+	struct LibTTAr_DecMisc misc;
+	UNUSED enum LibTTAr_DecRetVal status;
+	timestamp_p ts_start, ts_finish;
+
+	assert(bufs->nbytes_tta != 0);
+
+	misc.dest_len            = bufs->ni32;
+	misc.src_len             = bufs->ttabuf_len;
+	misc.ni32_target         = bufs->ni32;
+	misc.nbytes_tta_target   = bufs->nbytes_tta;
+	misc.ni32_perframe       = bufs->ni32;
+	misc.nbytes_tta_perframe = bufs->nbytes_tta;
+	misc.samplebytes         = samplebytes;
+	misc.nchan               = nchan;
+
+	timestamp_get(&ts_start);
+	status = libttaR_tta_decode_kernel(
+		bufs->decbuf, bufs->ttabuf, bufs->priv, &user, &misc, kernel
+	);
+	timestamp_get(&ts_finish);
+
+	assert(status == LIBTTAr_DRV_OK_DONE);
+	assert(memcmp(bufs->decbuf, bufs->i32buf,
+		bufs->ni32 * (sizeof *bufs->i32buf)) == 0
+	);
+	return timestamp_diff(&ts_start, &ts_finish);
+}
+
+/* EOF //////////////////////////////////////////////////////////////////// */
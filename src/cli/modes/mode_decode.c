@@ -4,18 +4,23 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
 
 #include <assert.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include <sys/types.h>
+
+#include "../affinity.h"
+#include "../autotune.h"
 #include "../cli.h"
 #include "../common.h"
 #include "../debug.h"
@@ -25,6 +30,8 @@
 #include "../opts.h"
 #include "../system.h"
 
+#include "./resync.h"
+
 /* //////////////////////////////////////////////////////////////////////// */
 
 #undef dstat_out
@@ -68,6 +75,11 @@ BUILD_EXTERN NOINLINE void decmt_loop(
 @*/
 ;
 
+BUILD_EXTERN void decmt_loop_free(void)
+/*@globals	internalState@*/
+/*@modifies	internalState@*/
+;
+
 /* ======================================================================== */
 
 static void dec_loop(struct OpenedFilesMember *RESTRICT)
@@ -81,6 +93,34 @@ static void dec_loop(struct OpenedFilesMember *RESTRICT)
 @*/
 ;
 
+#undef seektable
+#undef infile
+static bool dec_seektable_resync(
+	struct SeekTable *RESTRICT seektable, size_t,
+	const struct FileStats *RESTRICT, FILE *RESTRICT infile,
+	const char *RESTRICT, unsigned int
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*seektable,
+		infile
+@*/
+;
+
+#undef outfile
+static void dec_header_write(
+	FILE *RESTRICT outfile, size_t, const struct FileStats *RESTRICT,
+	const char *RESTRICT
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		outfile
+@*/
+;
+
 /* //////////////////////////////////////////////////////////////////////// */
 
 /**@fn mode_decode
@@ -147,6 +187,14 @@ mode_decode(
 		exit((int) nerrors_file);
 	}
 
+	/* kernel choices from --autotune */
+	autotune_load();
+
+	/* thread placement from --affinity */
+	if ( g_flag.affinity ){
+		affinity_load();
+	}
+
 	/* decode each file */
 	for ( i = 0; i < openedfiles.nmemb; ++i ){
 		if ( (i != 0) && (! g_flag.quiet) ){
@@ -180,6 +228,7 @@ mode_decode(
 	}
 
 	/* cleanup */
+	decmt_loop_free();
 	openedfiles_close_free(&openedfiles);
 
 	return (int) g_nwarnings;
@@ -211,12 +260,14 @@ dec_loop(struct OpenedFilesMember *const RESTRICT ofm)
 	);
 	/* * */
 	const unsigned int nthreads = (g_nthreads != 0
-		? g_nthreads : get_nprocessors_onln()
+		? g_nthreads : affinity_nthreads_default()
 	);
 	/* * */
 	struct DecStats dstat;
 	struct SeekTable seektable;
 	bool ignore_seektable = false;
+	size_t data_size;
+	off_t outfile_size;
 	timestamp_p ts_start, ts_finish;
 	union {	int		d;
 		enum FileCheck	fc;
@@ -246,7 +297,7 @@ dec_loop(struct OpenedFilesMember *const RESTRICT ofm)
 	}
 
 	/* seek to seektable
-		- already there for TTA1
+		- already there for TTA1/TTA2
 	*/
 
 	/* copy/check seektable */
@@ -255,8 +306,11 @@ dec_loop(struct OpenedFilesMember *const RESTRICT ofm)
 	result.fc = filecheck_tta_seektable(&seektable, tmp.z, infile);
 	if UNLIKELY ( result.fc != FILECHECK_OK ){
 		if ( result.fc == FILECHECK_CORRUPTED ){
-			ignore_seektable = true;
 			warning_tta("%s: corrupted seektable", infile_name);
+			ignore_seektable = ! dec_seektable_resync(
+				&seektable, tmp.z, fstat, infile, infile_name,
+				nthreads
+			);
 		}
 		else {	error_filecheck(result.fc, errno, fstat, infile_name);
 			exit(result.fc);
@@ -265,30 +319,29 @@ dec_loop(struct OpenedFilesMember *const RESTRICT ofm)
 	/* MAYBE: check that the seektable entries match the filesize */
 
 	/* open outfile */
-	outfile = fopen_check(outfile_name, "wb", FATAL);
-	if UNLIKELY ( outfile == NULL ){
-		error_sys(errno, "fopen", outfile_name);
+	if ( strcmp(outfile_name, STDOUT_NAME) == 0 ){
+		outfile = stdout;
 	}
-	assert(outfile != NULL);
-	g_rm_on_sigint = outfile_name;
-
-	/* save some space for the outfile header */
-	switch ( fstat->decfmt ){
-	default:
-		assert(false);
-		break;
-	case DECFMT_RAWPCM:
-		break;
-	case DECFMT_WAV:
-		prewrite_wav_header(outfile, outfile_name);
-		break;
-	case DECFMT_W64:
-		prewrite_w64_header(outfile, outfile_name);
-		break;
+	else {	/* a shared, writable mapping needs it open for reading too */
+		outfile = fopen_check(
+			outfile_name, (g_flag.mmap_out ? "w+b" : "wb"), FATAL
+		);
+		if UNLIKELY ( outfile == NULL ){
+			error_sys(errno, "fopen", outfile_name);
+		}
+		assert(outfile != NULL);
+		g_rm_on_sigint = outfile_name;
 	}
 
+	/* write the outfile header with the size from the TTA header, so the
+	     PCM can be streamed right after it
+	*/
+	data_size = (size_t) (fstat->nsamples_enc * fstat->nchan);
+	data_size *= fstat->samplebytes;
+	dec_header_write(outfile, data_size, fstat, outfile_name);
+
 	/* seek to TTA data
-		- already there for TTA1
+		- already there for TTA1/TTA2
 	*/
 
 	if ( ! g_flag.quiet ){
@@ -328,29 +381,21 @@ decode_multi:
 		);
 	}
 
-	/* update header */
-	switch ( fstat->decfmt ){
-	default:
-		assert(false);
-		break;
-	case DECFMT_RAWPCM:
-		break;
-	case DECFMT_W64:
-		rewind(outfile);
-		write_w64_header(
-			outfile,
-			(size_t) (dstat.nsamples_flat * fstat->samplebytes),
-			fstat, outfile_name
-		);
-		break;
-	case DECFMT_WAV:
+	/* update header; only if the size changed (truncated/malformed),
+	     and there is no going back in a pipe
+	*/
+	tmp.z = (size_t) (dstat.nsamples_flat * fstat->samplebytes);
+	if UNLIKELY (
+	     (tmp.z != data_size) && (fstat->decfmt != DECFMT_RAWPCM)
+	    &&
+	     file_regsize(outfile, &outfile_size)
+	){
 		rewind(outfile);
-		write_wav_header(
-			outfile,
-			(size_t) (dstat.nsamples_flat * fstat->samplebytes),
-			fstat, outfile_name
-		);
-		break;
+		dec_header_write(outfile, tmp.z, fstat, outfile_name);
+		result.d = fseeko(outfile, 0, SEEK_END);
+		if UNLIKELY ( result.d != 0 ){
+			error_sys(errno, "fseeko", outfile_name);
+		}
 	}
 
 	if ( ! g_flag.quiet ){
@@ -358,11 +403,18 @@ decode_multi:
 	}
 
 	/* close outfile */
-	result.d = fclose(outfile);
-	if UNLIKELY ( result.d != 0 ){
-		error_sys_nf(errno, "fclose", outfile_name);
+	if ( outfile == stdout ){
+		result.d = fflush(outfile);
+		if UNLIKELY ( result.d != 0 ){
+			error_sys_nf(errno, "fflush", outfile_name);
+		}
+	}
+	else {	result.d = fclose(outfile);
+		if UNLIKELY ( result.d != 0 ){
+			error_sys_nf(errno, "fclose", outfile_name);
+		}
+		g_rm_on_sigint = NULL;
 	}
-	g_rm_on_sigint = NULL;
 
 	if ( ! g_flag.quiet ){
 		timestamp_get(&ts_finish);
@@ -381,4 +433,114 @@ decode_multi:
 	return;
 }
 
+/**@fn dec_seektable_resync
+ * @brief replaces a corrupted seektable with one rebuilt from the frame
+ *   footers, if the file has them
+ *
+ * @param seektable   - seektable struct
+ * @param nframes     - number of frames from the header
+ * @param fstat       - bloated file stats struct
+ * @param infile      - source file; at the first frame
+ * @param infile_name - name of the source file (warnings)
+ * @param nthreads    - number of threads for the search
+ *
+ * @return true if it was rebuilt
+ *
+ * @note the frames are searched in place, so 'infile' has to be a regular
+ *   file; it is left where it was
+**/
+static bool
+dec_seektable_resync(
+	struct SeekTable *const RESTRICT seektable, const size_t nframes,
+	const struct FileStats *const RESTRICT fstat,
+	FILE *const RESTRICT infile, const char *const RESTRICT infile_name,
+	const unsigned int nthreads
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*seektable,
+		infile
+@*/
+{
+	/* a frame of noise can come out bigger than its PCM */
+	const size_t framesize_max = (size_t) (
+		2u * fstat->buflen * fstat->samplebytes
+	);
+	/* * */
+	struct SeekTable rebuilt;
+	struct FileMap map;
+	off_t data_off, size;
+
+	/* only TTA2 frames have footers */
+	if ( fstat->encfmt != xENCFMT_TTA2 ){
+		return false;
+	}
+
+	data_off = ftello(infile);
+	if ( (data_off < 0) || (! file_regsize(infile, &size))
+	    ||
+	     (size <= data_off)
+	    ||
+	     (! file_map(
+		&map, infile, data_off, (size_t) (size - data_off), false
+	     ))
+	){
+		return false;
+	}
+	assert(map.data != NULL);
+
+	(void) tta2_resync(
+		&rebuilt, map.data, (size_t) (size - data_off), nframes,
+		framesize_max,
+		(g_flag.threadmode == THREADMODE_SINGLE ? 1u : nthreads),
+		infile_name
+	);
+	file_unmap(&map);
+
+	warning_tta("%s: seektable rebuilt from the frame footers; "
+		"%zu of %zu frames", infile_name, rebuilt.nmemb, nframes
+	);
+	seektable_free(seektable);
+	*seektable = rebuilt;
+	return true;
+}
+
+/**@fn dec_header_write
+ * @brief writes the outfile header for the decode format, if it has one
+ *
+ * @param outfile      - destination file
+ * @param data_size    - size of the PCM data
+ * @param fstat        - bloated file stats struct
+ * @param outfile_name - name of the destination file (errors)
+**/
+static void
+dec_header_write(
+	FILE *const RESTRICT outfile, const size_t data_size,
+	const struct FileStats *const RESTRICT fstat,
+	const char *const RESTRICT outfile_name
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		outfile
+@*/
+{
+	switch ( fstat->decfmt ){
+	default:
+		assert(false);
+		break;
+	case DECFMT_RAWPCM:
+		break;
+	case DECFMT_WAV:
+		write_wav_header(outfile, data_size, fstat, outfile_name);
+		break;
+	case DECFMT_W64:
+		write_w64_header(outfile, data_size, fstat, outfile_name);
+		break;
+	}
+	return;
+}
+
 /* EOF //////////////////////////////////////////////////////////////////// */
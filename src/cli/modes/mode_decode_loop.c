@@ -4,7 +4,7 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
@@ -21,18 +21,39 @@
 
 #include "../../libttaR.h"
 
-#include "../alloc.h"
+#include "../affinity.h"
+#include "../autotune.h"
 #include "../byteswap.h"
 #include "../cli.h"
 #include "../common.h"
 #include "../debug.h"
 #include "../formats.h"
 #include "../main.h"
+#include "../system.h"
 
+#include "./arena.h"
+#include "./atomic.h"
 #include "./bufs.h"
+#include "./bulkio.h"
+#include "./crew.h"
+#include "./framequeue.h"
+#include "./freelist.h"
 #include "./mt-struct.h"
-#include "./pqueue.h"
 #include "./threads.h"
+#include "./uring.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/* a frame write of the writer's ring, from submit to completion */
+struct DecMT_Write {
+	/*@null@*/ /*@dependent@*/
+	struct DecFrame		*entry;		/* NULL if the slot is free  */
+	size_t			ticket;
+	/*@dependent@*/
+	const uint8_t		*buf;		/* what is left to write     */
+	size_t			len;
+	off_t			offset;
+};
 
 /* //////////////////////////////////////////////////////////////////////// */
 
@@ -55,6 +76,33 @@ static NOINLINE enum LibTTAr_DecRetVal dec_frame_decode(
 @*/
 ;
 
+#undef decbuf
+#undef priv
+#undef user_out
+#undef nsamples_flat_2pad
+#undef outfile
+#undef ni32_written
+static NOINLINE enum LibTTAr_DecRetVal dec_frame_decode_sub(
+	struct DecBuf *RESTRICT decbuf,
+	/*@reldef@*/ struct LibTTAr_CodecState_Priv *RESTRICT priv,
+	/*@out@*/ struct LibTTAr_CodecState_User *RESTRICT user_out,
+	enum LibTTAr_SampleBytes, unsigned int, size_t, size_t,
+	/*@out@*/ size_t *RESTRICT nsamples_flat_2pad, size_t,
+	FILE *RESTRICT outfile, const char *RESTRICT,
+	/*@out@*/ size_t *RESTRICT ni32_written
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*decbuf->i32buf,
+		*decbuf->pcmbuf,
+		*priv,
+		*user_out,
+		*nsamples_flat_2pad,
+		outfile,
+		*ni32_written
+@*/
+;
+
 #undef decbuf
 #undef dstat_out
 #undef outfile
@@ -64,7 +112,7 @@ static void NOINLINE dec_frame_write(
 	struct LibTTAr_CodecState_User *RESTRICT,
 	const char *RESTRICT, FILE *RESTRICT outfile,
 	const char *RESTRICT, enum LibTTAr_SampleBytes, unsigned int,
-	uint32_t, int8_t, size_t, size_t
+	uint32_t, size_t, int8_t, size_t, size_t
 )
 /*@globals	fileSystem@*/
 /*@modifies	fileSystem,
@@ -74,6 +122,22 @@ static void NOINLINE dec_frame_write(
 @*/
 ;
 
+#undef decbuf
+#undef dstat_out
+static size_t dec_frame_check(
+	struct DecBuf *RESTRICT decbuf,
+	/*@in@*/ struct DecStats *RESTRICT dstat_out,
+	const struct LibTTAr_CodecState_User *RESTRICT, const char *RESTRICT,
+	enum LibTTAr_SampleBytes, unsigned int, uint32_t, size_t, int8_t,
+	size_t
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*decbuf->pcmbuf,
+		*dstat_out
+@*/
+;
+
 CONST
 static size_t dec_ni32_perframe(size_t, size_t, size_t, unsigned int) /*@*/;
 
@@ -85,31 +149,174 @@ static NOINLINE void dec_frame_zeropad(
 /*@modifies	*pcmbuf@*/
 ;
 
+#undef decbuf
+COLD
+static NOINLINE void dec_ttabuf_zerotail(
+	const struct DecBuf *RESTRICT decbuf, size_t
+)
+/*@modifies	*decbuf->ttabuf@*/
+;
+
+/* ------------------------------------------------------------------------ */
+
+#undef infile
+#undef entry
+static size_t decmt_read_plan(
+	struct MTArg_IO_File *RESTRICT infile, struct DecFrame *RESTRICT entry,
+	size_t, size_t, size_t
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		infile->offset,
+		*entry
+@*/
+;
+
+#undef infile
+#undef entry
+static bool decmt_read_submit(
+	struct MTArg_IO_File *RESTRICT infile, struct DecFrame *RESTRICT entry,
+	const struct DecBuf *RESTRICT, size_t, size_t, size_t
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*infile,
+		*entry
+@*/
+;
+
+#undef infile
+#undef frame
+static bool decmt_read_done(
+	struct MTArg_IO_File *RESTRICT infile, struct DecFrame *RESTRICT frame,
+	const struct DecBuf *RESTRICT, unsigned int, bool
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*infile,
+		frame[]
+@*/
+;
+
+#undef infile
+#undef frame
+static void decmt_read_drain(
+	struct MTArg_IO_File *RESTRICT infile, struct DecFrame *RESTRICT frame,
+	const struct DecBuf *RESTRICT, unsigned int
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*infile,
+		frame[]
+@*/
+;
+
+#undef outfile
+#undef slot
+#undef outlist
+static bool decmt_write_done(
+	struct MTArg_IO_File *RESTRICT outfile,
+	struct DecMT_Write *RESTRICT slot, struct FreeList *RESTRICT outlist,
+	bool
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*outfile,
+		slot[],
+		*outlist
+@*/
+;
+
+#undef entry
+#undef inbuf
+static void decmt_frame_pread(
+	FILE *RESTRICT, const char *RESTRICT, struct DecFrame *RESTRICT entry,
+	const struct DecBuf *RESTRICT inbuf, size_t
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		entry->crc_read,
+		*inbuf->ttabuf
+@*/
+;
+
 /* ------------------------------------------------------------------------ */
 
+#undef state
+static void decmt_crew_init(struct DecMT_State *RESTRICT state, unsigned int)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*state
+@*/
+;
+
+#undef map
+#undef outfile
+#undef pcm_off
+static bool dec_pcm_map(
+	/*@out@*/ struct FileMap *RESTRICT map, FILE *RESTRICT outfile,
+	const char *RESTRICT, const struct FileStats *RESTRICT,
+	/*@out@*/ off_t *RESTRICT pcm_off
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*map,
+		outfile,
+		*pcm_off
+@*/
+;
+
 #undef arg
 HOT
-START_ROUTINE_ABI
-static start_routine_ret decmt_io(struct MTArg_DecIO *RESTRICT arg)
+static start_routine_ret decmt_reader(struct MTArg_DecIO *RESTRICT arg)
 /*@globals	fileSystem,
 		internalState
 @*/
 /*@modifies	fileSystem,
 		internalState,
-		*arg->frames.navailable,
-		*arg->frames.post_decoder,
-		*arg->frames.ni32_perframe,
-		*arg->frames.decbuf,
-		*arg->frames.crc_read,
-		arg->outfile.handle,
-		arg->infile.handle,
-		*arg->seektable,
+		arg->frames.queue,
+		*arg->frames.frame,
+		arg->infile
+@*/
+;
+
+#undef arg
+HOT
+static start_routine_ret decmt_writer(struct MTArg_DecIO *RESTRICT arg)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*arg->frames.queue.nstall_writer,
+		*arg->frames.queue.out.fl.tail,
+		*arg->frames.queue.out.buf,
+		*arg->frames.frame,
+		arg->outfile,
+		arg->infile.bulk,
 		*arg->dstat_out
 @*/
 ;
 
 #undef arg
-START_ROUTINE_ABI
 static start_routine_ret decmt_decoder_wrapper(void *const RESTRICT arg)
 /*@globals	fileSystem,
 		internalState
@@ -129,16 +336,25 @@ static start_routine_ret decmt_decoder(struct MTArg_Decoder *RESTRICT arg)
 @*/
 /*@modifies	fileSystem,
 		internalState,
-		*arg->frames.navailable,
-		arg->frames.queue,
-		*arg->frames.post_decoder,
+		*arg->frames.ticket,
+		*arg->frames.nstall,
+		*arg->frames.bufs.id_next,
+		*arg->frames.freelist.tail,
 		*arg->frames.decbuf,
-		*arg->frames.dec_retval
+		*arg->frames.frame
 @*/
 ;
 
 /* //////////////////////////////////////////////////////////////////////// */
 
+/**@var decmt_state
+ * @brief the multi-threaded decoder, kept across files
+**/
+/*@checkmod@*/
+static struct DecMT_State decmt_state;
+
+/* //////////////////////////////////////////////////////////////////////// */
+
 /**@fn decst_loop
  * @brief the single-threaded decoder
  *
@@ -174,17 +390,24 @@ decst_loop(
 	const size_t nsamples_enc = fstat->nsamples_enc;
 	const unsigned int nchan  = (unsigned int)   fstat->nchan;
 	const enum LibTTAr_SampleBytes samplebytes = fstat->samplebytes;
+	const size_t footer_len   = TTA_FRAMEFOOTER_LEN(fstat->encfmt);
+	const size_t ttabuf_len   = TTABUF_LEN_FRAME(
+		buflen, nchan, samplebytes
+	);
 	/* * */
 	struct LibTTAr_CodecState_Priv *priv = NULL;
 	struct LibTTAr_CodecState_User user;
+	struct Arena arena;
 	struct DecBuf decbuf;
+	struct TTA2FrameFooter footer;
 	struct DecStats dstat;
+	struct BulkIO bulk_in, bulk_out;
 	/* * */
 	size_t ni32_perframe, nbytes_tta_perframe, framesize_tta, nbytes_read;
 	size_t nsamples_perchan_dec_total = 0;
 	size_t nframes_target = seektable->nmemb, nframes_read = 0;
 	int8_t dec_retval;
-	size_t nsamples_flat_2pad;
+	size_t nsamples_flat_2pad, ni32_written = 0;
 	uint32_t crc_read;
 	union {	size_t	z;
 		int	d;
@@ -192,28 +415,38 @@ decst_loop(
 
 	/* setup */
 	memset(&dstat, 0x00, sizeof dstat);
+	arena_init(&arena,
+		  decbuf_arena_size(
+			buflen, ttabuf_len, nchan, samplebytes,
+			CBM_SINGLE_THREADED
+		)
+		+ priv_arena_size(nchan)
+	);
 	decbuf_init(
-		&decbuf, buflen, TTABUF_LEN_DEFAULT, nchan, samplebytes,
+		&decbuf, &arena, buflen, ttabuf_len, nchan, samplebytes,
 		CBM_SINGLE_THREADED
 	);
-	priv = priv_alloc(nchan);
+	priv = priv_arena_alloc(&arena, nchan);
+	(void) pages_populate(arena.base, arena.used);
+	bulkio_init(&bulk_in, infile, false, NULL, g_flag.bulk_io);
+	bulkio_init(&bulk_out, outfile, true, NULL, g_flag.bulk_io);
 
 	goto loop_entr;
 	do {
-		/* xENCFMT_TTA1:
+		/* xENCFMT_TTA1, xENCFMT_TTA2:
 			- get size of tta-frame from seektable
 		*/
 		framesize_tta = (size_t) byteswap_letoh_u32(
 			seektable->table[nframes_read]
 		);
-		if ( framesize_tta <= (sizeof crc_read) ){
+		if ( framesize_tta <= footer_len ){
 			warning_tta(
 				"%s: frame %zu: malformed seektable entry",
 				infile_name, nframes_read
 			);
 			break;
 		}
-		else {	framesize_tta -= (sizeof crc_read); }
+		else {	framesize_tta -= footer_len; }
 		ni32_perframe = dec_ni32_perframe(
 			nsamples_perchan_dec_total, nsamples_enc, framelen,
 			nchan
@@ -240,13 +473,18 @@ decst_loop(
 					infile_name, nframes_read
 				);
 			}
+			dec_ttabuf_zerotail(&decbuf, nbytes_read);
 			goto loop_truncated;
 		}
 
-		/* read frame footer (CRC); kept as little-endian */
+		/* read frame footer (CRC); kept as little-endian. a TTA1
+		     footer is the tail of a TTA2 one
+		*/
 		result.z = fread(
-			&crc_read, sizeof crc_read, SIZE_C(1), infile
+			&((uint8_t *) &footer)[(sizeof footer) - footer_len],
+			footer_len, SIZE_C(1), infile
 		);
+		crc_read = footer.crc;
 		if UNLIKELY ( result.z != SIZE_C(1) ){
 			if UNLIKELY ( ferror(infile) != 0 ){
 				error_sys(errno, "fread", infile_name);
@@ -261,19 +499,32 @@ loop_truncated:
 		}
 		nframes_read += 1u;
 
-		/* decode frame */
-		dec_retval = (int8_t) dec_frame_decode(
-			&decbuf, priv, &user, samplebytes, nchan,
-			ni32_perframe, nbytes_tta_perframe,
-			&nsamples_flat_2pad
-		);
+		/* decode frame; with --subframe, it is written as it goes */
+		if ( g_subframe == 0 ){
+			dec_retval = (int8_t) dec_frame_decode(
+				&decbuf, priv, &user, samplebytes, nchan,
+				ni32_perframe, nbytes_tta_perframe,
+				&nsamples_flat_2pad
+			);
+		}
+		else {	dec_retval = (int8_t) dec_frame_decode_sub(
+				&decbuf, priv, &user, samplebytes, nchan,
+				ni32_perframe, nbytes_tta_perframe,
+				&nsamples_flat_2pad,
+				(size_t) (g_subframe * nchan), outfile,
+				outfile_name, &ni32_written
+			);
+		}
 
-		/* write PCM to outfile */
+		/* write (the rest of the) PCM to outfile */
 		dec_frame_write(
 			&decbuf, &dstat, &user, infile_name, outfile,
 			outfile_name, samplebytes, nchan, crc_read,
-			dec_retval, nsamples_flat_2pad, nbytes_tta_perframe
+			footer_len, dec_retval, nsamples_flat_2pad,
+			ni32_written
 		);
+		bulkio_update(&bulk_in, dstat.nbytes_decoded);
+		bulkio_update(&bulk_out, dstat.nsamples_flat * samplebytes);
 loop_entr:
 		if ( (! g_flag.quiet) && (nframes_read % SPINNER_FREQ == 0) ){
 			errprint_spinner();
@@ -282,8 +533,10 @@ loop_entr:
 	while ( nframes_target-- != 0 );
 
 	/* cleanup */
-	priv_free(priv);
-	codecbuf_free(&decbuf, CBM_SINGLE_THREADED);
+	bulkio_finish(&bulk_out);
+	bulkio_finish(&bulk_in);
+	codecbuf_free(&decbuf);
+	arena_free(&arena);
 
 	*dstat_out = dstat;
 	return;
@@ -313,56 +566,254 @@ decmt_loop(
 	const unsigned int nthreads
 )
 /*@globals	fileSystem,
-		internalState
+		internalState,
+		decmt_state
 @*/
 /*@modifies	fileSystem,
 		internalState,
+		decmt_state,
 		*dstat_out,
 		outfile,
 		infile
 @*/
 {
-	struct MTArg_DecIO io_state;
-	struct MTArg_Decoder decoder_state;
-	thread_p io_thread, decoder_thread;
-	struct FileStats_DecMT fstat_c;
+	struct DecMT_State *const RESTRICT state = &decmt_state;
+	const size_t samplebuf_len = fstat->buflen;
 	struct DecStats dstat;
-	const size_t        samplebuf_len = fstat->buflen;
-	const unsigned int framequeue_len = FRAMEQUEUE_LEN(nthreads);
-	unsigned int i;
+	struct FileMap pcmmap;
+	off_t pcm_off = 0, pcm_end;
+	union {	int d; } result;
 
 	assert(nthreads > 0);
+	assert((state->nthreads == 0) || (state->nthreads == nthreads));
 
 	/* setup/init */
 	memset(&dstat, 0x00, sizeof dstat);
-	decmt_fstat_init(&fstat_c, fstat);
-	decmt_state_init(
-		&io_state, &decoder_state, framequeue_len, samplebuf_len,
-		outfile, outfile_name, infile, infile_name, seektable, &dstat,
-		&fstat_c
+	if ( state->nthreads == 0 ){
+		decmt_crew_init(state, nthreads);
+	}
+	if ( (state->i32buf_len != 0)
+	    &&
+	     ((state->i32buf_len != samplebuf_len)
+	     ||
+	      (state->fstat.nchan != (unsigned int) fstat->nchan)
+	     ||
+	      (state->fstat.samplebytes != fstat->samplebytes)
+	     )
+	){
+		decmt_state_free(&state->io, &state->decoder);
+		state->i32buf_len = 0;
+	}
+	decmt_fstat_init(&state->fstat, fstat);
+	if ( state->i32buf_len == 0 ){
+		decmt_state_init(
+			&state->io, &state->decoder, nthreads, state->nspin,
+			samplebuf_len, &state->fstat
+		);
+		state->i32buf_len = samplebuf_len;
+	}
+	else {	decmt_state_rewind(
+			&state->io, &state->decoder, state->nspin
+		);
+	}
+	pcmmap.data = NULL;
+	if ( g_flag.mmap_out ){
+		(void) dec_pcm_map(
+			&pcmmap, outfile, outfile_name, fstat, &pcm_off
+		);
+	}
+	decmt_state_files(
+		&state->io, &state->decoder, outfile, outfile_name, infile,
+		infile_name, g_flag.pread, pcmmap.data, seektable, &dstat
+	);
+	bulkio_init(
+		&state->io.infile.bulk, infile, false, NULL, g_flag.bulk_io
+	);
+	bulkio_init(
+		&state->io.outfile.bulk, outfile, true, NULL,
+		g_flag.bulk_io && (pcmmap.data == NULL)
 	);
 
-	/* create coders */
-	thread_create(
-		&io_thread,
-		(START_ROUTINE_ABI start_routine_ret (*)(void *)) decmt_io,
-		&io_state
+	/* code the file */
+	crew_start(&state->crew);
+	affinity_set_coder(nthreads - 1u, nthreads);
+	(void) decmt_decoder(&state->decoder);
+	affinity_restore();
+
+	/* a coder may still be leaving a waitvar_wait() on its sentinel frame
+	     after the main thread is done, so wait for the whole crew before
+	     the state is touched again
+	*/
+	crew_wait(&state->crew);
+	mtfile_sync(&state->io.infile);
+	mtfile_sync(&state->io.outfile);
+
+	/* cut the mapped outfile down to what was decoded (truncated infile),
+	     and leave its position at the end
+	*/
+	if ( pcmmap.data != NULL ){
+		file_unmap(&pcmmap);
+		pcm_end = pcm_off + (off_t) (
+			dstat.nsamples_flat * fstat->samplebytes
+		);
+		if UNLIKELY ( ! file_truncate(outfile, pcm_end) ){
+			error_sys(errno, "ftruncate", outfile_name);
+		}
+		result.d = fseeko(outfile, pcm_end, SEEK_SET);
+		if UNLIKELY ( result.d != 0 ){
+			error_sys(errno, "fseeko", outfile_name);
+		}
+	}
+
+	/* stats */
+	framequeue_stats(&dstat.queue, &state->io.frames.queue);
+
+	*dstat_out = dstat;
+	return;
+}
+
+/**@fn decmt_loop_free
+ * @brief joins the multi-threaded decoder threads and frees its state
+ *
+ * @see encmt_loop_free()
+**/
+BUILD void
+decmt_loop_free(void)
+/*@globals	internalState,
+		decmt_state
+@*/
+/*@modifies	internalState,
+		decmt_state
+@*/
+{
+	struct DecMT_State *const RESTRICT state = &decmt_state;
+
+	if ( state->nthreads != 0 ){
+		crew_free(&state->crew);
+		state->nthreads = 0;
+	}
+	if ( state->i32buf_len != 0 ){
+		decmt_state_free(&state->io, &state->decoder);
+		state->i32buf_len = 0;
+	}
+	return;
+}
+
+/**@fn decmt_crew_init
+ * @brief makes the crew of the multi-threaded decoder
+ *
+ * @param state    - multi-threaded decoder state
+ * @param nthreads - number of decoder threads
+ *
+ * @see encmt_crew_init()
+**/
+static void
+decmt_crew_init(
+	struct DecMT_State *const RESTRICT state, const unsigned int nthreads
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*state
+@*/
+{
+	unsigned int i;
+
+	state->nthreads = nthreads;
+	state->nspin    = WAITVAR_NSPIN(nthreads + 2u, affinity_nprocessors());
+
+	crew_init(&state->crew, nthreads + 1u);
+	affinity_set_io(nthreads);
+	crew_add(
+		&state->crew,
+		(start_routine_ret (*)(void *)) decmt_reader, &state->io
+	);
+	crew_add(
+		&state->crew,
+		(start_routine_ret (*)(void *)) decmt_writer, &state->io
 	);
 	for ( i = 0; i < nthreads - 1u; ++i ){
-		thread_create(
-			&decoder_thread, decmt_decoder_wrapper, &decoder_state
+		affinity_set_coder(i, nthreads);
+		crew_add(
+			&state->crew, decmt_decoder_wrapper, &state->decoder
 		);
 	}
-	(void) decmt_decoder(&decoder_state);
+	affinity_restore();
 
-	/* wait for i/o */
-	thread_join(&io_thread);
+	return;
+}
 
-	/* cleanup */
-	decmt_state_free(&io_state, &decoder_state, framequeue_len);
+/**@fn dec_pcm_map
+ * @brief preallocates the PCM of the destination file, and maps it for the
+ *   decoder threads to write into (--mmap)
+ *
+ * @param map          - the mapping; empty if not mapped
+ * @param outfile      - destination file; the header is already written
+ * @param outfile_name - name of the destination file (errors)
+ * @param fstat        - bloated file stats struct
+ * @param pcm_off      - offset of the PCM in the destination file
+ *
+ * @return true if mapped
+ *
+ * @note falls back to writing for pipes, and if it cannot be mapped; the
+ *   file is left as it was
+ * @note the file's position is left at the start of the PCM
+**/
+static bool
+dec_pcm_map(
+	/*@out@*/ struct FileMap *const RESTRICT map,
+	FILE *const RESTRICT outfile, const char *const RESTRICT outfile_name,
+	const struct FileStats *const RESTRICT fstat,
+	/*@out@*/ off_t *const RESTRICT pcm_off
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*map,
+		outfile,
+		*pcm_off
+@*/
+{
+	const size_t size = (size_t) (
+		fstat->nsamples_enc * fstat->nchan * fstat->samplebytes
+	);
+	off_t filesize;
+	union {	int d; } result;
+
+	map->base = NULL;
+	map->size = 0;
+	map->data = NULL;
+	*pcm_off  = 0;
+	if ( (size == 0) || (! file_regsize(outfile, &filesize)) ){
+		return false;
+	}
 
-	*dstat_out = dstat;
-	return;
+	/* the header went through the FILE */
+	result.d = fflush(outfile);
+	if UNLIKELY ( result.d != 0 ){
+		error_sys(errno, "fflush", outfile_name);
+	}
+	*pcm_off = ftello(outfile);
+	if UNLIKELY ( *pcm_off < 0 ){
+		error_sys(errno, "ftello", outfile_name);
+	}
+
+	/* the whole PCM has to be in the file before it can be mapped */
+	(void) file_prealloc(outfile, *pcm_off + (off_t) size);
+	if ( file_truncate(outfile, *pcm_off + (off_t) size)
+	    &&
+	     file_map(map, outfile, *pcm_off, size, true)
+	){
+		return true;
+	}
+	if UNLIKELY ( ! file_truncate(outfile, *pcm_off) ){
+		error_sys(errno, "ftruncate", outfile_name);
+	}
+	return false;
 }
 
 /* ======================================================================== */
@@ -421,8 +872,9 @@ dec_frame_decode(
 	misc.samplebytes         = samplebytes;
 	misc.nchan               = nchan;
 	/* * */
-	status = libttaR_tta_decode(
-		decbuf->i32buf, decbuf->ttabuf, priv, &user, &misc
+	status = libttaR_tta_decode_kernel(
+		decbuf->i32buf, decbuf->ttabuf, priv, &user, &misc,
+		autotune_kernel(MODE_DECODE, samplebytes, nchan)
 	);
 	assert((status == LIBTTAr_DRV_OK_DONE)
 	      ||
@@ -433,6 +885,10 @@ dec_frame_decode(
 	if UNLIKELY ( status == LIBTTAr_DRV_FAIL_DECODE ){
 		pad_target     += ni32_perframe - user.ni32_total;
 		user.ni32_total = ni32_perframe;
+		/* re-calc CRC; in -M, the ttabuf is given back before the
+		     frame is written
+		*/
+		user.crc = libttaR_crc32(decbuf->ttabuf, nbytes_tta_perframe);
 	}
 
 	/* convert I32 to PCM */
@@ -446,49 +902,244 @@ dec_frame_decode(
 	return status;
 }
 
-/**@fn dec_frame_write
- * @brief write a PCM frame
+/**@fn dec_frame_decode_sub
+ * @brief decode a TTA frame a chunk at a time, writing the PCM of each
+ *   chunk as soon as it is decoded (--subframe)
  *
  * @param decbuf              - decode buffers struct
- * @param dstat_out           - decode stats return struct
- * @param user_in             - user state struct
- * @param infile_name         - name of the source file (warnings/errors)
- * @param outfile             - destination file
- * @param outfile_name        - name of the destination file (warnings/errors)
+ * @param priv                - private state struct
+ * @param user_out            - user state return struct
  * @param samplebytes         - number of bytes per PCM sample
  * @param nchan               - number of audio channels
- * @param crc_read            - CRC from source file (little-endian)
- * @param dec_retval          - return value from dec_frame_decode()
- * @param nsamples_flat_2pad  - number of i32 samples to zero-pad
+ * @param ni32_perframe total - number of i32 in a TTA frame
  * @param nbytes_tta_perframe - number of TTA bytes in the current frame
+ * @param nsamples_flat_2pad  - number of i32 samples to zero-pad
+ * @param ni32_sub            - number of i32 in a chunk
+ * @param outfile             - destination file
+ * @param outfile_name        - name of the destination file (errors)
+ * @param ni32_written        - number of i32 of the frame written
+ *
+ * @return what the last libttaR_tta_decode(3) returned
+ *
+ * @note what was not written (the zero-pad) is left for dec_frame_write()
 **/
-static NOINLINE void
-dec_frame_write(
+static NOINLINE enum LibTTAr_DecRetVal
+dec_frame_decode_sub(
 	struct DecBuf *const RESTRICT decbuf,
-	/*@in@*/ struct DecStats *const RESTRICT dstat_out,
-	struct LibTTAr_CodecState_User *const RESTRICT user_in,
-	const char *const RESTRICT infile_name,
-	FILE *const RESTRICT outfile, const char *const RESTRICT outfile_name,
+	/*@reldef@*/ struct LibTTAr_CodecState_Priv *const RESTRICT priv,
+	/*@out@*/ struct LibTTAr_CodecState_User *const RESTRICT user_out,
 	const enum LibTTAr_SampleBytes samplebytes, const unsigned int nchan,
-	const uint32_t crc_read /*little-endian*/, const int8_t dec_retval,
-	const size_t nsamples_flat_2pad, const size_t nbytes_tta_perframe
+	size_t ni32_perframe, const size_t nbytes_tta_perframe,
+	/*@out@*/ size_t *const RESTRICT nsamples_flat_2pad,
+	const size_t ni32_sub,
+	FILE *const RESTRICT outfile, const char *const RESTRICT outfile_name,
+	/*@out@*/ size_t *const RESTRICT ni32_written
 )
 /*@globals	fileSystem@*/
 /*@modifies	fileSystem,
+		*decbuf->i32buf,
 		*decbuf->pcmbuf,
-		*dstat_out,
-		outfile
+		*priv,
+		*user_out,
+		*nsamples_flat_2pad,
+		outfile,
+		*ni32_written
 @*/
 {
-	struct LibTTAr_CodecState_User user = *user_in;
-	struct DecStats dstat = *dstat_out;
-	uint32_t   crc_read_h = byteswap_letoh_u32(crc_read);
-	union { unsigned int	u;
-		size_t		z;
+	enum LibTTAr_DecRetVal status;
+	struct LibTTAr_CodecState_User user = LIBTTAr_CODECSTATE_USER_INIT;
+	struct LibTTAr_DecMisc misc;
+	enum LibTTAr_Kernel kernel;
+	size_t pad_target, ni32_done, ni32_new;
+	union {	size_t	z;
+		int	d;
 	} result;
 
-	/* failure check */
-	if UNLIKELY ( dec_retval != (int8_t) LIBTTAr_DRV_OK_DONE ){
+	assert((decbuf->i32buf != NULL) && (ni32_sub % nchan == 0));
+
+	/* check for truncated sample; as many i32 are held back from the
+	     decoded ones, in case they get zero-padded
+	*/
+	pad_target     = (ni32_perframe % nchan == 0
+		? 0 : (size_t) (nchan - (ni32_perframe % nchan))
+	);
+	ni32_perframe += pad_target;
+
+	misc.ni32_perframe       = ni32_perframe;
+	misc.nbytes_tta_perframe = nbytes_tta_perframe;
+	misc.samplebytes         = samplebytes;
+	misc.nchan               = nchan;
+	kernel                   = autotune_kernel(
+		MODE_DECODE, samplebytes, nchan
+	);
+
+	ni32_done = 0;
+	do {
+		/* decode a chunk of TTA to I32 */
+		misc.dest_len          = decbuf->i32buf_len - user.ni32_total;
+		misc.src_len           = (decbuf->ttabuf_len
+			- user.nbytes_tta_total
+		);
+		misc.ni32_target       = ni32_perframe - user.ni32_total;
+		if ( misc.ni32_target > ni32_sub ){
+			misc.ni32_target = ni32_sub;
+		}
+		misc.nbytes_tta_target = (nbytes_tta_perframe
+			- user.nbytes_tta_total
+		);
+		status = libttaR_tta_decode_kernel(
+			&decbuf->i32buf[user.ni32_total],
+			&decbuf->ttabuf[user.nbytes_tta_total],
+			priv, &user, &misc, kernel
+		);
+		assert((status == LIBTTAr_DRV_OK_DONE)
+		      ||
+		       (status == LIBTTAr_DRV_OK_AGAIN)
+		      ||
+		       (status == LIBTTAr_DRV_FAIL_DECODE)
+		);
+
+		/* convert I32 to PCM, and write it */
+		if ( user.ni32_total <= ni32_done + pad_target ){
+			continue;
+		}
+		ni32_new  = user.ni32_total - pad_target - ni32_done;
+		result.z  = libttaR_pcm_write(
+			&decbuf->pcmbuf[ni32_done * samplebytes],
+			&decbuf->i32buf[ni32_done], ni32_new, samplebytes
+		);
+		assert(result.z != 0);
+		result.z = fwrite(
+			&decbuf->pcmbuf[ni32_done * samplebytes], samplebytes,
+			ni32_new, outfile
+		);
+		if UNLIKELY ( result.z != ni32_new ){
+			error_sys(errno, "fwrite", outfile_name);
+		}
+		result.d = fflush(outfile);
+		if UNLIKELY ( result.d != 0 ){
+			error_sys(errno, "fflush", outfile_name);
+		}
+		ni32_done += ni32_new;
+	}
+	while ( status == LIBTTAr_DRV_OK_AGAIN );
+
+	if UNLIKELY ( status == LIBTTAr_DRV_FAIL_DECODE ){
+		pad_target     += ni32_perframe - user.ni32_total;
+		user.ni32_total = ni32_perframe;
+		user.crc = libttaR_crc32(decbuf->ttabuf, nbytes_tta_perframe);
+	}
+
+	/* convert the rest, so dec_frame_write() can zero-pad it */
+	if UNLIKELY ( user.ni32_total != ni32_done ){
+		result.z = libttaR_pcm_write(
+			&decbuf->pcmbuf[ni32_done * samplebytes],
+			&decbuf->i32buf[ni32_done],
+			user.ni32_total - ni32_done, samplebytes
+		);
+		assert(result.z != 0);
+	}
+
+	*user_out           = user;
+	*nsamples_flat_2pad = pad_target;
+	*ni32_written       = ni32_done;
+	return status;
+}
+
+/**@fn dec_frame_write
+ * @brief write a PCM frame
+ *
+ * @param decbuf              - decode buffers struct
+ * @param dstat_out           - decode stats return struct
+ * @param user_in             - user state struct
+ * @param infile_name         - name of the source file (warnings/errors)
+ * @param outfile             - destination file
+ * @param outfile_name        - name of the destination file (warnings/errors)
+ * @param samplebytes         - number of bytes per PCM sample
+ * @param nchan               - number of audio channels
+ * @param crc_read            - CRC from source file (little-endian)
+ * @param footer_len          - length of the frame footer
+ * @param dec_retval          - return value from dec_frame_decode()
+ * @param nsamples_flat_2pad  - number of i32 samples to zero-pad
+ * @param ni32_written        - number of i32 already written, which are
+ *   skipped
+**/
+static NOINLINE void
+dec_frame_write(
+	struct DecBuf *const RESTRICT decbuf,
+	/*@in@*/ struct DecStats *const RESTRICT dstat_out,
+	struct LibTTAr_CodecState_User *const RESTRICT user_in,
+	const char *const RESTRICT infile_name,
+	FILE *const RESTRICT outfile, const char *const RESTRICT outfile_name,
+	const enum LibTTAr_SampleBytes samplebytes, const unsigned int nchan,
+	const uint32_t crc_read /*little-endian*/, const size_t footer_len,
+	const int8_t dec_retval, const size_t nsamples_flat_2pad,
+	const size_t ni32_written
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*decbuf->pcmbuf,
+		*dstat_out,
+		outfile
+@*/
+{
+	const size_t ni32_total = user_in->ni32_total - ni32_written;
+	union {	size_t z; } result;
+
+	(void) dec_frame_check(
+		decbuf, dstat_out, user_in, infile_name, samplebytes, nchan,
+		crc_read, footer_len, dec_retval, nsamples_flat_2pad
+	);
+
+	/* write frame */
+	result.z = fwrite(
+		&decbuf->pcmbuf[ni32_written * samplebytes], samplebytes,
+		ni32_total, outfile
+	);
+	if UNLIKELY ( result.z != ni32_total ){
+		error_sys(errno, "fwrite", outfile_name);
+	}
+	return;
+}
+
+/**@fn dec_frame_check
+ * @brief checks a decoded frame, zero-pads it if need be, and adds it to
+ *   the stats
+ *
+ * @param decbuf              - decode buffers struct
+ * @param dstat_out           - decode stats return struct
+ * @param user                - user state struct
+ * @param infile_name         - name of the source file (warnings/errors)
+ * @param samplebytes         - number of bytes per PCM sample
+ * @param nchan               - number of audio channels
+ * @param crc_read            - CRC from source file (little-endian)
+ * @param footer_len          - length of the frame footer
+ * @param dec_retval          - return value from dec_frame_decode()
+ * @param nsamples_flat_2pad  - number of i32 samples to zero-pad
+ *
+ * @return number of bytes of PCM to write
+**/
+static size_t
+dec_frame_check(
+	struct DecBuf *const RESTRICT decbuf,
+	/*@in@*/ struct DecStats *const RESTRICT dstat_out,
+	const struct LibTTAr_CodecState_User *const RESTRICT user,
+	const char *const RESTRICT infile_name,
+	const enum LibTTAr_SampleBytes samplebytes, const unsigned int nchan,
+	const uint32_t crc_read /*little-endian*/, const size_t footer_len,
+	const int8_t dec_retval, const size_t nsamples_flat_2pad
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*decbuf->pcmbuf,
+		*dstat_out
+@*/
+{
+	struct DecStats dstat = *dstat_out;
+	uint32_t   crc_read_h = byteswap_letoh_u32(crc_read);
+
+	/* failure check */
+	if UNLIKELY ( dec_retval != (int8_t) LIBTTAr_DRV_OK_DONE ){
 		if ( dec_retval == (int8_t) LIBTTAr_DRV_FAIL_DECODE ){
 			warning_tta("%s: frame %zu: decoding failed",
 				infile_name, dstat.nframes
@@ -506,37 +1157,26 @@ dec_frame_write(
 		}
 		/* zero-pad */
 		dec_frame_zeropad(
-			decbuf->pcmbuf, user.ni32_total, nsamples_flat_2pad,
+			decbuf->pcmbuf, user->ni32_total, nsamples_flat_2pad,
 			samplebytes
 		);
-		/* re-calc CRC */
-		user.crc = libttaR_crc32(decbuf->ttabuf, nbytes_tta_perframe);
 	}
 
 	/* check frame CRC */
-	if UNLIKELY ( user.crc != crc_read_h ){
+	if UNLIKELY ( user->crc != crc_read_h ){
 		warning_tta("%s: frame %zu is corrupted; bad CRC",
 			infile_name, dstat.nframes
 		);
 	}
-	user.nbytes_tta_total += sizeof crc_read_h;
-
-	/* write frame */
-	result.z = fwrite(
-		decbuf->pcmbuf, samplebytes, user.ni32_total, outfile
-	);
-	if UNLIKELY ( result.z != user.ni32_total ){
-		error_sys(errno, "fwrite", outfile_name);
-	}
 
 	/* update dstat */
 	dstat.nframes          += 1u;
-	dstat.nsamples_flat    += user.ni32_total;
-	dstat.nsamples_perchan += (size_t) (user.ni32_total / nchan);
-	dstat.nbytes_decoded   += user.nbytes_tta_total;
+	dstat.nsamples_flat    += user->ni32_total;
+	dstat.nsamples_perchan += (size_t) (user->ni32_total / nchan);
+	dstat.nbytes_decoded   += user->nbytes_tta_total + footer_len;
 
 	*dstat_out = dstat;
-	return;
+	return (size_t) (user->ni32_total * samplebytes);
 }
 
 /**@fn dec_ni32_perframe
@@ -591,114 +1231,178 @@ dec_frame_zeropad(
 	return;
 }
 
+/**@fn dec_ttabuf_zerotail
+ * @brief zeros the TTA buffer past a short read (truncated last frame)
+ *
+ * @param decbuf - decode buffers struct
+ * @param nbytes - number of bytes read into the TTA buffer
+ *
+ * @note the decoder can read past the end of a truncated frame, into what
+ *   a reused buffer held before; this keeps its output deterministic
+**/
+COLD
+static NOINLINE void
+dec_ttabuf_zerotail(
+	const struct DecBuf *const RESTRICT decbuf, const size_t nbytes
+)
+/*@modifies	*decbuf->ttabuf@*/
+{
+	assert(nbytes <= decbuf->ttabuf_len);
+
+	memset(&decbuf->ttabuf[nbytes], 0x00, decbuf->ttabuf_len - nbytes);
+
+	return;
+}
+
 /* ======================================================================== */
 
-/**@fn decmt_io
- * @brief the I/O thread function for the multi-threaded decoder
+/**@fn decmt_reader
+ * @brief the reader thread function for the multi-threaded decoder
  *
  * @param arg - state for the thread
  *
- * @pre arg->frames->nmemb > the number of decoder threads
- *
  * @retval (start_routine_ret) 0
+ *
+ * @see encmt_reader note
 **/
 HOT
-START_ROUTINE_ABI
 static start_routine_ret
-decmt_io(struct MTArg_DecIO *const RESTRICT arg)
+decmt_reader(struct MTArg_DecIO *const RESTRICT arg)
 /*@globals	fileSystem,
 		internalState
 @*/
 /*@modifies	fileSystem,
 		internalState,
-		*arg->frames.navailable,
-		*arg->frames.post_decoder,
-		*arg->frames.ni32_perframe,
-		*arg->frames.decbuf,
-		*arg->frames.crc_read,
-		arg->outfile.handle,
-		arg->infile.handle,
-		*arg->seektable,
-		*arg->dstat_out
+		arg->frames.queue,
+		*arg->frames.frame,
+		arg->infile
 @*/
 {
 	struct MTArg_DecIO_Frames *const RESTRICT  frames  = &arg->frames;
-	struct MTArg_IO_File      *const RESTRICT  outfile = &arg->outfile;
 	struct MTArg_IO_File      *const RESTRICT  infile  = &arg->infile;
 	const struct FileStats_DecMT *const RESTRICT fstat =  arg->fstat;
 	const struct SeekTable *const RESTRICT seektable   =  arg->seektable;
 	/* * */
-	semaphore_p   *const RESTRICT nframes_avail = frames->navailable;
-	semaphore_p   *const RESTRICT post_decoder  = frames->post_decoder;
-	size_t        *const RESTRICT ni32_perframe = frames->ni32_perframe;
-	size_t        *const RESTRICT nbytes_tta_perframe  = (
-		frames->nbytes_tta_perframe
-	);
-	struct DecBuf *const RESTRICT decbuf             = frames->decbuf;
-	struct LibTTAr_CodecState_User *const RESTRICT user = frames->user;
-	size_t        *const RESTRICT nsamples_flat_2pad = (
-		frames->nsamples_flat_2pad
-	);
-	int8_t     *const RESTRICT dec_retval     = frames->dec_retval;
-	uint32_t   *const RESTRICT crc_read       = frames->crc_read;
+	struct DecFrame *const RESTRICT frame       =  frames->frame;
+	struct DecBuf   *const RESTRICT inbuf       =  frames->queue.in.buf;
 	/* * */
-	FILE       *const RESTRICT outfile_handle = outfile->handle;
-	const char *const RESTRICT outfile_name   = outfile->name;
 	FILE       *const RESTRICT infile_handle  = infile->handle;
 	const char *const RESTRICT infile_name    = infile->name;
 	/* * */
-	const unsigned int framequeue_len          = frames->nmemb;
+	const unsigned int reorder_len             = frames->nmemb;
+	const unsigned int ncoders                 = frames->ncoders;
 	const unsigned int nchan                   = fstat->nchan;
 	const enum LibTTAr_SampleBytes samplebytes = fstat->samplebytes;
 	const size_t nsamples_perframe             = fstat->nsamples_perframe;
 	const size_t nsamples_enc                  = fstat->nsamples_enc;
+	const size_t footer_len                    = fstat->framefooter_len;
 	/* * */
-	struct DecStats dstat = *arg->dstat_out;
+	struct TTA2FrameFooter footer;
 	size_t framesize_tta, nbytes_read;
 	size_t nsamples_perchan_dec_total = 0;
-	bool   start_writing  = false;
 	size_t nframes_target = seektable->nmemb, nframes_read = 0;
-	unsigned int idx = 0, last;
-	union {	unsigned int	u;
-		size_t		z;
-	} result;
+	/* a private copy, so the reader's writes to it stay off the cache
+	     lines that the other threads read the rest of *arg from
+	*/
+	struct FrameQueue queue = frames->queue;
+	struct DecFrame *entry;
+	unsigned int id, i;
+	union {	size_t z; } result;
 
-	goto loop0_entr;
+	goto loop_entr;
 	do {
-		/* xENCFMT_TTA1
+		/* wait for the writer to be done with the entry */
+		entry = &frame[nframes_read % reorder_len];
+		if ( nframes_read >= reorder_len ){
+			if ( ! waitvar_test(
+				&entry->seq,
+				FRAME_SEQ_WRITTEN(nframes_read - reorder_len)
+			) ){
+				decmt_read_drain(
+					infile, frame, inbuf, reorder_len
+				);
+			}
+			waitvar_wait(
+				&entry->seq,
+				FRAME_SEQ_WRITTEN(nframes_read - reorder_len)
+			);
+		}
+
+		/* xENCFMT_TTA1, xENCFMT_TTA2
 			- get size of tta-frame from seektable
 		*/
 		framesize_tta = (size_t) byteswap_letoh_u32(
 			seektable->table[nframes_read]
 		);
-		if ( framesize_tta <= (sizeof *crc_read) ){
+		if ( framesize_tta <= footer_len ){
 			warning_tta(
 				"%s: frame %zu: malformed seektable entry",
 				infile_name, nframes_read
 			);
-			nbytes_tta_perframe[idx] = 0;
 			break;
 		}
-		else {	framesize_tta -= (sizeof *crc_read); }
-		ni32_perframe[idx] = dec_ni32_perframe(
+		else {	framesize_tta -= footer_len; }
+		entry->ni32_perframe = dec_ni32_perframe(
 			nsamples_perchan_dec_total, nsamples_enc,
 			nsamples_perframe, nchan
 		);
-		if ( ni32_perframe[idx] == 0 ){
+		if ( entry->ni32_perframe == 0 ){
 			/* malformed seektable check */
 			break;
 		}
-		nsamples_perchan_dec_total += ni32_perframe[idx] / nchan;
+		nsamples_perchan_dec_total += entry->ni32_perframe / nchan;
+
+		/* get an output and an input buffer */
+		if ( (! bufpool_ready(&queue.out))
+		    ||
+		     (! bufpool_ready(&queue.in))
+		){
+			decmt_read_drain(infile, frame, inbuf, reorder_len);
+		}
+		entry->outbuf_id = bufpool_get(&queue.out);
+		id               = bufpool_get(&queue.in);
+		entry->inbuf_id  = id;
 
 		/* read TTA from infile */
 		decbuf_check_adjust(
-			&decbuf[idx], framesize_tta, nchan, samplebytes
+			&inbuf[id], framesize_tta, nchan, samplebytes
 		);
+		if ( infile->pread ){
+			/* the coder reads it */
+			if UNLIKELY (
+			     decmt_read_plan(
+				infile, entry, framesize_tta, footer_len,
+				nframes_read
+			     )
+			    !=
+			     framesize_tta + footer_len
+			){
+				nframes_target = 0;
+			}
+			goto loop_ready;
+		}
+		if ( infile->async ){
+			while ( infile->ring.nflight == URING_DEPTH ){
+				(void) decmt_read_done(
+					infile, frame, inbuf, reorder_len, true
+				);
+			}
+			if ( ! decmt_read_submit(
+				infile, entry, &inbuf[id], framesize_tta,
+				footer_len, nframes_read
+			) ){
+				nframes_target = 0;
+			}
+			while ( decmt_read_done(
+				infile, frame, inbuf, reorder_len, false
+			) ){;}
+			goto loop_tick;
+		}
 		nbytes_read = fread(
-			decbuf[idx].ttabuf, SIZE_C(1), framesize_tta,
+			inbuf[id].ttabuf, SIZE_C(1), framesize_tta,
 			infile_handle
 		);
-		nbytes_tta_perframe[idx] = nbytes_read;
+		entry->nbytes_tta_perframe = nbytes_read;
 		if UNLIKELY ( nbytes_read != framesize_tta ){
 			if UNLIKELY ( ferror(infile_handle) != 0 ){
 				error_sys(errno, "fread", infile_name);
@@ -707,14 +1411,16 @@ decmt_io(struct MTArg_DecIO *const RESTRICT arg)
 					infile_name, nframes_read
 				);
 			}
-			goto loop0_truncated;
+			dec_ttabuf_zerotail(&inbuf[id], nbytes_read);
+			goto loop_truncated;
 		}
 
 		/* read frame footer (crc); kept as little-endian */
 		result.z = fread(
-			&crc_read[idx], sizeof *crc_read, SIZE_C(1),
-			infile_handle
+			&((uint8_t *) &footer)[(sizeof footer) - footer_len],
+			footer_len, SIZE_C(1), infile_handle
 		);
+		entry->crc_read = footer.crc;
 		if UNLIKELY ( result.z != SIZE_C(1) ){
 			if UNLIKELY ( ferror(infile_handle) != 0 ){
 				error_sys(errno, "fread", infile_name);
@@ -723,87 +1429,528 @@ decmt_io(struct MTArg_DecIO *const RESTRICT arg)
 					infile_name, nframes_read
 				);
 			}
-loop0_truncated:
-			crc_read[idx]  = 0;
-			nframes_target = 0;
+loop_truncated:
+			entry->crc_read = 0;
+			nframes_target  = 0;
 		}
 
 		/* make frame available */
-		semaphore_post(nframes_avail);
+loop_ready:
+		waitvar_set(&entry->seq, FRAME_SEQ_READY(nframes_read));
+loop_tick:
+		framequeue_tick(&queue);
 
 		nframes_read += 1u;
-		idx = pqueue_next(idx, framequeue_len);
-		/* all frame ttabuf's are filled before writing out any PCM */
-		if ( ! start_writing ){
-			if ( idx != 0 ){
-				goto loop0_read;
-			}
-			start_writing = true;
-		}
-
-		/* wait for frame to finish decoding */
-		semaphore_wait(&post_decoder[idx]);
-
-		/* write pcm to outfile */
-		dec_frame_write(
-			&decbuf[idx], &dstat, &user[idx], infile_name,
-			outfile_handle, outfile_name, samplebytes, nchan,
-			crc_read[idx], dec_retval[idx],
-			nsamples_flat_2pad[idx], nbytes_tta_perframe[idx]
-		);
-loop0_entr:
+loop_entr:
 		if ( (! g_flag.quiet) && (nframes_read % SPINNER_FREQ == 0) ){
 			errprint_spinner();
 		}
-loop0_read:
-		;
 	}
 	while ( nframes_target-- != 0 );
-	nbytes_tta_perframe[idx] = 0;
-	last = idx;
 
-	/* write the remaining frames */
-	if ( start_writing ){
-		goto loop1_not_tiny;
-	}
-	else {	/* unlock any uninitialized frames (tiny infile) */
-		do {	semaphore_post(nframes_avail);
-			idx = pqueue_next(idx, framequeue_len);
+	/* one end-of-stream frame per coder; the first one also stops the
+	     writer
+	*/
+	decmt_read_drain(infile, frame, inbuf, reorder_len);
+	for ( i = 0; i < ncoders; ++i, ++nframes_read ){
+		entry = &frame[nframes_read % reorder_len];
+		if ( nframes_read >= reorder_len ){
+			waitvar_wait(
+				&entry->seq,
+				FRAME_SEQ_WRITTEN(nframes_read - reorder_len)
+			);
 		}
-		while ( idx != 0 );
+		entry->nbytes_tta_perframe = 0;
+		waitvar_set(&entry->seq, FRAME_SEQ_READY(nframes_read));
 	}
-	do {	/* wait for frame to finish encoding */
-		semaphore_wait(&post_decoder[idx]);
 
-		/* write pcm to outfile */
-		dec_frame_write(
-			&decbuf[idx], &dstat, &user[idx], infile_name,
-			outfile_handle, outfile_name, samplebytes, nchan,
-			crc_read[idx], dec_retval[idx],
-			nsamples_flat_2pad[idx], nbytes_tta_perframe[idx]
+	framequeue_writeback(&frames->queue, &queue);
+	return (start_routine_ret) 0;
+}
+
+/**@fn decmt_writer
+ * @brief the writer thread function for the multi-threaded decoder
+ *
+ * @param arg - state for the thread
+ *
+ * @retval (start_routine_ret) 0
+**/
+HOT
+static start_routine_ret
+decmt_writer(struct MTArg_DecIO *const RESTRICT arg)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*arg->frames.queue.nstall_writer,
+		*arg->frames.queue.out.fl.tail,
+		*arg->frames.queue.out.buf,
+		*arg->frames.frame,
+		arg->outfile,
+		arg->infile.bulk,
+		*arg->pcmmap,
+		*arg->dstat_out
+@*/
+{
+	struct MTArg_DecIO_Frames *const RESTRICT  frames  = &arg->frames;
+	struct MTArg_IO_File      *const RESTRICT  outfile = &arg->outfile;
+	const struct FileStats_DecMT *const RESTRICT fstat =  arg->fstat;
+	/* * */
+	struct FrameQueue *const RESTRICT queue          = &frames->queue;
+	/* * */
+	struct FreeList *const RESTRICT outlist          = &queue->out.fl;
+	size_t        *const RESTRICT nstall             = queue->nstall_writer;
+	struct DecBuf *const RESTRICT decbuf             = queue->out.buf;
+	struct DecFrame *const RESTRICT frame            = frames->frame;
+	/* * */
+	FILE       *const RESTRICT outfile_handle = outfile->handle;
+	const char *const RESTRICT outfile_name   = outfile->name;
+	const char *const RESTRICT infile_name    = arg->infile.name;
+	uint8_t    *const RESTRICT pcmmap         = arg->pcmmap;
+	/* * */
+	const unsigned int reorder_len             = frames->nmemb;
+	const unsigned int nchan                   = fstat->nchan;
+	const enum LibTTAr_SampleBytes samplebytes = fstat->samplebytes;
+	const size_t nbytes_pcm_perframe           = (size_t) (
+		fstat->nsamples_perframe * nchan * samplebytes
+	);
+	const size_t footer_len                    = fstat->framefooter_len;
+	/* * */
+	struct DecStats dstat = *arg->dstat_out;
+	size_t ticket = 0;
+	struct DecFrame *entry;
+	/* * */
+	struct DecMT_Write slot[URING_DEPTH];
+	struct DecBuf *outbuf, inplace;
+	size_t nbytes;
+	unsigned int i;
+
+	memset(slot, 0x00, sizeof slot);
+
+	goto loop_entr;
+	do {
+		outbuf = &decbuf[entry->outbuf_id];
+		if ( pcmmap != NULL ){
+			/* the PCM is already in the outfile (--mmap), so it
+			     is only checked, and zero-padded in place
+			*/
+			inplace        = *outbuf;
+			inplace.pcmbuf = &pcmmap[ticket * nbytes_pcm_perframe];
+			(void) dec_frame_check(
+				&inplace, &dstat, &entry->user, infile_name,
+				samplebytes, nchan, entry->crc_read,
+				footer_len, entry->dec_retval,
+				entry->nsamples_flat_2pad
+			);
+			goto loop_release;
+		}
+		if ( ! outfile->async ){
+			/* write pcm to outfile */
+			dec_frame_write(
+				outbuf, &dstat, &entry->user, infile_name,
+				outfile_handle, outfile_name, samplebytes,
+				nchan, entry->crc_read, footer_len,
+				entry->dec_retval, entry->nsamples_flat_2pad,
+				0
+			);
+			goto loop_release;
+		}
+
+		/* submit the write, in a free slot */
+		nbytes = dec_frame_check(
+			outbuf, &dstat, &entry->user, infile_name,
+			samplebytes, nchan, entry->crc_read, footer_len,
+			entry->dec_retval, entry->nsamples_flat_2pad
+		);
+		if ( nbytes == 0 ){
+			goto loop_release;
+		}
+		while ( outfile->ring.nflight == URING_DEPTH ){
+			(void) decmt_write_done(outfile, slot, outlist, true);
+		}
+		for ( i = 0; slot[i].entry != NULL; ++i ){;}
+		slot[i].entry   = entry;
+		slot[i].ticket  = ticket++;
+		slot[i].buf     = outbuf->pcmbuf;
+		slot[i].len     = nbytes;
+		slot[i].offset  = outfile->offset;
+		outfile->offset += (off_t) nbytes;
+		uring_rw(
+			&outfile->ring, true, outfile->fd, slot[i].buf,
+			slot[i].len, slot[i].offset, (uint64_t) i
+		);
+		if UNLIKELY ( ! uring_submit(&outfile->ring) ){
+			error_sys(errno, "io_uring_enter", outfile_name);
+		}
+		while ( decmt_write_done(outfile, slot, outlist, false) ){;}
+		goto loop_entr;
+loop_release:
+		/* give the output buffer and the entry back to the reader */
+		freelist_push(outlist, entry->outbuf_id);
+		waitvar_set(&entry->seq, FRAME_SEQ_WRITTEN(ticket++));
+loop_entr:
+		/* the frame's TTA is done with, and its PCM is on its way */
+		bulkio_update(&arg->infile.bulk, dstat.nbytes_decoded);
+		bulkio_update(
+			&outfile->bulk, dstat.nsamples_flat * samplebytes
 		);
 
-		/* mark frame as done and make available */
-		nbytes_tta_perframe[idx] = 0;
-		semaphore_post(nframes_avail);
-loop1_not_tiny:
-		idx = pqueue_next(idx, framequeue_len);
+		/* wait for the next frame in order to finish decoding; what
+		     is in flight is reaped first, since the reader may be
+		     waiting on its buffers
+		*/
+		entry = &frame[ticket % reorder_len];
+		while ( (outfile->ring.nflight != 0)
+		       &&
+			(! waitvar_test(&entry->seq, FRAME_SEQ_DONE(ticket)))
+		){
+			(void) decmt_write_done(outfile, slot, outlist, true);
+		}
+		if ( ! waitvar_test(&entry->seq, FRAME_SEQ_DONE(ticket)) ){
+			(void) atomic_fetch_inc_z(nstall);
+		}
+		waitvar_wait(&entry->seq, FRAME_SEQ_DONE(ticket));
 	}
-	while ( idx != last );
+	while ( entry->nbytes_tta_perframe != 0 );
+
+	while ( outfile->ring.nflight != 0 ){
+		(void) decmt_write_done(outfile, slot, outlist, true);
+	}
+	bulkio_finish(&outfile->bulk);
+	bulkio_finish(&arg->infile.bulk);
 
 	*arg->dstat_out = dstat;
 	return (start_routine_ret) 0;
 }
 
+/* ------------------------------------------------------------------------ */
+
+/**@fn decmt_read_plan
+ * @brief works out where a TTA frame and its footer (CRC) are, and how much
+ *   of them is in the infile
+ *
+ * @param infile        - the reader's infile
+ * @param entry         - the frame's entry
+ * @param framesize_tta - size of the frame, without the footer
+ * @param footer_len    - length of the frame footer
+ * @param ticket        - the frame's ticket
+ *
+ * @return number of bytes to read; with the footer, unless the file is
+ *   truncated
+ *
+ * @note the size of the file is known, so a truncated frame is cut down
+ *   here instead of coming back short with the frames after it already in
+ *   flight
+**/
+static size_t
+decmt_read_plan(
+	struct MTArg_IO_File *const RESTRICT infile,
+	struct DecFrame *const RESTRICT entry, const size_t framesize_tta,
+	const size_t footer_len, const size_t ticket
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		infile->offset,
+		*entry
+@*/
+{
+	const size_t avail = (infile->size > infile->offset
+		? (size_t) (infile->size - infile->offset) : 0
+	);
+	size_t nbytes      = framesize_tta + footer_len;
+
+	entry->nbytes_tta_perframe = framesize_tta;
+	if UNLIKELY ( avail < nbytes ){
+		warning_tta("%s: frame %zu: truncated file",
+			infile->name, ticket
+		);
+		nbytes                     = (avail < framesize_tta
+			? avail : framesize_tta
+		);
+		entry->nbytes_tta_perframe = nbytes;
+		entry->crc_read            = 0;
+	}
+	entry->offset      = infile->offset;
+	entry->nbytes_read = nbytes;
+	infile->offset    += (off_t) nbytes;
+	return nbytes;
+}
+
+/**@fn decmt_read_submit
+ * @brief submits the read of a TTA frame and its footer (CRC)
+ *
+ * @param infile        - the reader's infile
+ * @param entry         - the frame's entry
+ * @param inbuf         - the frame's input buffer
+ * @param framesize_tta - size of the frame, without the footer
+ * @param footer_len    - length of the frame footer
+ * @param ticket        - the frame's ticket
+ *
+ * @return false if the file is truncated, and this is the last frame
+ *
+ * @pre the ring has room for another request
+ *
+ * @note the footer is read into the ttabuf just past the frame, in its
+ *   safety margin, and copied out when done
+**/
+static bool
+decmt_read_submit(
+	struct MTArg_IO_File *const RESTRICT infile,
+	struct DecFrame *const RESTRICT entry,
+	const struct DecBuf *const RESTRICT inbuf, const size_t framesize_tta,
+	const size_t footer_len, const size_t ticket
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*infile,
+		*entry
+@*/
+{
+	const size_t nbytes = decmt_read_plan(
+		infile, entry, framesize_tta, footer_len, ticket
+	);
+	const uint64_t crc  = (uint64_t) (
+		nbytes != entry->nbytes_tta_perframe
+	);
+
+	assert(inbuf->ttabuf_len >= framesize_tta + footer_len);
+
+	/* nothing to read */
+	if UNLIKELY ( nbytes == 0 ){
+		dec_ttabuf_zerotail(inbuf, 0);
+		waitvar_set(&entry->seq, FRAME_SEQ_READY(ticket));
+		return false;
+	}
+
+	uring_rw(
+		&infile->ring, false, infile->fd, inbuf->ttabuf, nbytes,
+		entry->offset, (((uint64_t) ticket) << 1u) | crc
+	);
+	if UNLIKELY ( ! uring_submit(&infile->ring) ){
+		error_sys(errno, "io_uring_enter", infile->name);
+	}
+	return (crc != 0);
+}
+
+/**@fn decmt_read_done
+ * @brief takes a finished read off the ring, and makes its frame available
+ *
+ * @param infile      - the reader's infile
+ * @param frame       - the reorder buffer
+ * @param inbuf       - the input buffers
+ * @param reorder_len - length of the reorder buffer
+ * @param wait        - whether to wait for one
+ *
+ * @return whether there was one
+**/
+static bool
+decmt_read_done(
+	struct MTArg_IO_File *const RESTRICT infile,
+	struct DecFrame *const RESTRICT frame,
+	const struct DecBuf *const RESTRICT inbuf,
+	const unsigned int reorder_len, const bool wait
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*infile,
+		frame[]
+@*/
+{
+	struct DecFrame *entry;
+	uint64_t tag;
+	int32_t  res;
+	size_t   ticket, nbytes;
+
+	if ( ! uring_reap(&infile->ring, wait, &tag, &res) ){
+		if UNLIKELY ( wait ){
+			error_sys(errno, "io_uring_enter", infile->name);
+		}
+		return false;
+	}
+	ticket = (size_t) (tag >> 1u);
+	entry  = &frame[ticket % reorder_len];
+	nbytes = entry->nbytes_read;
+
+	if UNLIKELY ( res < 0 ){
+		error_sys(-res, "read", infile->name);
+	}
+	if UNLIKELY ( (size_t) res != nbytes ){
+		error_tta("%s: frame %zu: short read", infile->name, ticket);
+	}
+
+	/* footer (crc); kept as little-endian. it ends with the crc */
+	if ( (tag & 1u) != 0 ){
+		memcpy(&entry->crc_read,
+			&inbuf[entry->inbuf_id].ttabuf[
+				nbytes - (sizeof entry->crc_read)
+			], sizeof entry->crc_read
+		);
+	}
+	else {	dec_ttabuf_zerotail(&inbuf[entry->inbuf_id], nbytes); }
+
+	waitvar_set(&entry->seq, FRAME_SEQ_READY(ticket));
+	return true;
+}
+
+/**@fn decmt_read_drain
+ * @brief waits for every read in flight, and makes their frames available
+ *
+ * @see decmt_read_done()
+**/
+static void
+decmt_read_drain(
+	struct MTArg_IO_File *const RESTRICT infile,
+	struct DecFrame *const RESTRICT frame,
+	const struct DecBuf *const RESTRICT inbuf,
+	const unsigned int reorder_len
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*infile,
+		frame[]
+@*/
+{
+	while ( infile->ring.nflight != 0 ){
+		(void) decmt_read_done(infile, frame, inbuf, reorder_len, true);
+	}
+	return;
+}
+
+/**@fn decmt_write_done
+ * @brief takes a finished write off the ring, and gives its buffer and
+ *   entry back to the reader
+ *
+ * @param outfile - the writer's outfile
+ * @param slot    - the writes in flight
+ * @param outlist - free list of the output buffers
+ * @param wait    - whether to wait for one
+ *
+ * @return whether there was one
+ *
+ * @note a short write has the rest of it resubmitted
+**/
+static bool
+decmt_write_done(
+	struct MTArg_IO_File *const RESTRICT outfile,
+	struct DecMT_Write *const RESTRICT slot,
+	struct FreeList *const RESTRICT outlist, const bool wait
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*outfile,
+		slot[],
+		*outlist
+@*/
+{
+	struct DecMT_Write *w;
+	uint64_t tag;
+	int32_t  res;
+
+	if ( ! uring_reap(&outfile->ring, wait, &tag, &res) ){
+		if UNLIKELY ( wait ){
+			error_sys(errno, "io_uring_enter", outfile->name);
+		}
+		return false;
+	}
+	assert(tag < URING_DEPTH);
+	w = &slot[tag];
+	assert(w->entry != NULL);
+
+	if UNLIKELY ( res <= 0 ){
+		error_sys((res < 0 ? -res : EIO), "write", outfile->name);
+	}
+	if UNLIKELY ( (size_t) res < w->len ){
+		w->buf    = &w->buf[res];
+		w->len   -= (size_t) res;
+		w->offset += (off_t) res;
+		uring_rw(
+			&outfile->ring, true, outfile->fd, w->buf, w->len,
+			w->offset, tag
+		);
+		if UNLIKELY ( ! uring_submit(&outfile->ring) ){
+			error_sys(errno, "io_uring_enter", outfile->name);
+		}
+		return true;
+	}
+
+	freelist_push(outlist, w->entry->outbuf_id);
+	waitvar_set(&w->entry->seq, FRAME_SEQ_WRITTEN(w->ticket));
+	w->entry = NULL;
+	return true;
+}
+
+/**@fn decmt_frame_pread
+ * @brief reads a TTA frame and its footer (CRC) for a decoder thread
+ *
+ * @param infile      - source file
+ * @param infile_name - name of the source file (errors)
+ * @param entry       - the frame's entry
+ * @param inbuf       - the frame's input buffer
+ * @param ticket      - the frame's ticket
+ *
+ * @note the reader worked out the offset and size (decmt_read_plan()). like
+ *   the ring's, the footer is read into the ttabuf's safety margin
+**/
+static void
+decmt_frame_pread(
+	FILE *const RESTRICT infile, const char *const RESTRICT infile_name,
+	struct DecFrame *const RESTRICT entry,
+	const struct DecBuf *const RESTRICT inbuf, const size_t ticket
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		entry->crc_read,
+		*inbuf->ttabuf
+@*/
+{
+	union {	size_t z; } result;
+
+	assert(inbuf->ttabuf_len >= entry->nbytes_read);
+
+	result.z = file_pread(
+		infile, inbuf->ttabuf, entry->nbytes_read, entry->offset
+	);
+	if UNLIKELY ( result.z != entry->nbytes_read ){
+		if ( errno != 0 ){
+			error_sys(errno, "pread", infile_name);
+		}
+		error_tta("%s: frame %zu: short read", infile_name, ticket);
+	}
+
+	/* footer (crc); kept as little-endian. it ends with the crc. no
+	     footer means the frame was truncated
+	*/
+	if ( entry->nbytes_read != entry->nbytes_tta_perframe ){
+		memcpy(&entry->crc_read,
+			&inbuf->ttabuf[
+				entry->nbytes_read - (sizeof entry->crc_read)
+			], sizeof entry->crc_read
+		);
+	}
+	else {	dec_ttabuf_zerotail(inbuf, entry->nbytes_read); }
+	return;
+}
+
 /**@fn decmt_decoder_wrapper
- * @brief wraps the mt-decoder function. the thread detaches itself before
- *   returning
+ * @brief wraps the mt-decoder function for crew_add()
  *
  * @param arg - state for the thread
  *
  * @return whatever decmt_decoder() returns
 **/
-START_ROUTINE_ABI
 static start_routine_ret
 decmt_decoder_wrapper(void *const RESTRICT arg)
 /*@globals	fileSystem,
@@ -818,8 +1965,6 @@ decmt_decoder_wrapper(void *const RESTRICT arg)
 
 	retval = decmt_decoder(arg);
 
-	thread_detach_self();
-
 	return retval;
 }
 
@@ -838,69 +1983,95 @@ decmt_decoder(struct MTArg_Decoder *const RESTRICT arg)
 @*/
 /*@modifies	fileSystem,
 		internalState,
-		*arg->frames.navailable,
-		arg->frames.queue,
-		*arg->frames.post_decoder,
+		*arg->frames.ticket,
+		*arg->frames.nstall,
+		*arg->frames.bufs.id_next,
+		*arg->frames.freelist.tail,
 		*arg->frames.decbuf,
-		*arg->frames.dec_retval
+		*arg->frames.frame,
+		*arg->pcmmap
 @*/
 {
 	struct MTArg_Decoder_Frames  *const RESTRICT frames = &arg->frames;
 	const struct FileStats_DecMT *const RESTRICT fstat  =  arg->fstat;
 	/* * */
-	struct MTPQueue *const RESTRICT queue      = &frames->queue;
-	semaphore_p  *const RESTRICT nframes_avail =  frames->navailable;
-	semaphore_p  *const RESTRICT post_decoder  =  frames->post_decoder;
-	const size_t *const RESTRICT ni32_perframe =  frames->ni32_perframe;
-	const size_t *const RESTRICT nbytes_tta_perframe    = (
-		frames->nbytes_tta_perframe
-	);
-	struct DecBuf *const RESTRICT decbuf             = frames->decbuf;
-	struct LibTTAr_CodecState_User *const RESTRICT user = frames->user;
-	int8_t        *const RESTRICT dec_retval         = frames->dec_retval;
-	size_t        *const RESTRICT nsamples_flat_2pad = (
-		frames->nsamples_flat_2pad
-	);
+	size_t       *const RESTRICT ticket_next   =  frames->ticket;
+	size_t       *const RESTRICT nstall        =  frames->nstall;
+	struct FreeList *const RESTRICT freelist   = &frames->freelist;
+	const struct DecBuf *const RESTRICT inbuf  =  frames->inbuf;
+	struct DecBuf *const RESTRICT decbuf       =  frames->decbuf;
+	struct DecFrame *const RESTRICT frame      =  frames->frame;
+	/* * */
+	FILE       *const RESTRICT infile          = arg->infile;
+	const char *const RESTRICT infile_name     = arg->infile_name;
+	uint8_t    *const RESTRICT pcmmap          = arg->pcmmap;
 	/* * */
+	const unsigned int reorder_len             = frames->nmemb;
 	const unsigned int nchan                   = fstat->nchan;
 	const enum LibTTAr_SampleBytes samplebytes = fstat->samplebytes;
+	const size_t nbytes_pcm_perframe           = (size_t) (
+		fstat->nsamples_perframe * nchan * samplebytes
+	);
 	/* * */
-	int32_t *i32buf = NULL;
-	struct LibTTAr_CodecState_Priv *priv = NULL;
-	unsigned int idx;
+	const struct CoderBufs *own;
+	int32_t *i32buf;
+	struct LibTTAr_CodecState_Priv *priv;
+	struct DecBuf *outbuf;
+	uint8_t *pcmbuf;
+	struct DecFrame *entry;
+	size_t ticket;
 
 	/* setup */
-	i32buf = calloc_check(decbuf[0].i32buf_len, sizeof *i32buf);
-	priv   = priv_alloc(nchan);
+	own    = coderbufs_take(&frames->bufs, inbuf, decbuf);
+	i32buf = own->i32buf;
+	priv   = own->priv;
 
 	goto loop_entr;
 	do {
-		/* decode frame */
-		decbuf[idx].i32buf = i32buf;
-		dec_retval[idx] = (int8_t) dec_frame_decode(
-			&decbuf[idx], priv, &user[idx], samplebytes, nchan,
-			ni32_perframe[idx], nbytes_tta_perframe[idx],
-			&nsamples_flat_2pad[idx]
+		/* read frame (--pread) */
+		if ( infile != NULL ){
+			decmt_frame_pread(
+				infile, infile_name, entry,
+				&inbuf[entry->inbuf_id], ticket
+			);
+		}
+
+		/* decode frame; the ttabuf is borrowed from the input buffer,
+		     and with --mmap, the PCM goes straight to the frame's
+		     place in the outfile
+		*/
+		outbuf             = &decbuf[entry->outbuf_id];
+		outbuf->i32buf     = i32buf;
+		outbuf->ttabuf     = inbuf[entry->inbuf_id].ttabuf;
+		outbuf->ttabuf_len = inbuf[entry->inbuf_id].ttabuf_len;
+		pcmbuf             = outbuf->pcmbuf;
+		if ( pcmmap != NULL ){
+			outbuf->pcmbuf = &pcmmap[ticket * nbytes_pcm_perframe];
+		}
+		entry->dec_retval  = (int8_t) dec_frame_decode(
+			outbuf, priv, &entry->user, samplebytes, nchan,
+			entry->ni32_perframe, entry->nbytes_tta_perframe,
+			&entry->nsamples_flat_2pad
 		);
+		outbuf->ttabuf     = NULL;
+		outbuf->pcmbuf     = pcmbuf;
 
-		/* unlock frame */
-		semaphore_post(&post_decoder[idx]);
+		/* give back the input buffer, then unlock frame */
+		freelist_push(freelist, entry->inbuf_id);
+		waitvar_set(&entry->seq, FRAME_SEQ_DONE(ticket));
 loop_entr:
-		/* wait for a frame to be available */
-		semaphore_wait(nframes_avail);
-
-		/* get frame id from decode queue */
-		spinlock_lock(&queue->lock);
-		{
-			idx = pqueue_pop(&queue->q);
+		/* take the next ticket, and wait for its frame to be filled */
+		ticket = atomic_fetch_inc_z(ticket_next);
+		entry  = &frame[ticket % reorder_len];
+		if ( ! waitvar_test(&entry->seq, FRAME_SEQ_READY(ticket)) ){
+			(void) atomic_fetch_inc_z(nstall);
 		}
-		spinlock_unlock(&queue->lock);
+		waitvar_wait(&entry->seq, FRAME_SEQ_READY(ticket));
 	}
-	while ( nbytes_tta_perframe[idx] != 0 );
+	while ( entry->nbytes_tta_perframe != 0 );
 
-	/* cleanup */
-	priv_free(priv);
-	free(i32buf);
+	/* pass the end-of-stream frame on (only the writer's matters) */
+	waitvar_set(&entry->seq, FRAME_SEQ_DONE(ticket));
 
 	return (start_routine_ret) 0;
 }
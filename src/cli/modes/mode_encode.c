@@ -4,18 +4,21 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
 
 #include <assert.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "../affinity.h"
+#include "../autotune.h"
 #include "../cli.h"
 #include "../common.h"
 #include "../debug.h"
@@ -72,9 +75,14 @@ BUILD_EXTERN NOINLINE void encmt_loop(
 @*/
 ;
 
+BUILD_EXTERN void encmt_loop_free(void)
+/*@globals	internalState@*/
+/*@modifies	internalState@*/
+;
+
 /* ======================================================================== */
 
-static void enc_loop(const struct OpenedFilesMember *RESTRICT)
+static bool enc_loop(const struct OpenedFilesMember *RESTRICT)
 /*@globals	fileSystem,
 		internalState,
 		g_rm_on_sigint
@@ -112,6 +120,7 @@ mode_encode(
 	struct OpenedFiles openedfiles;
 	size_t nerrors_file = 0;
 	timestamp_p ts_start, ts_finish;
+	bool verified;
 	size_t i;
 	union {	int d; } result;
 
@@ -129,6 +138,7 @@ mode_encode(
 		nerrors_file += filestats_get(
 			openedfiles.file[i], MODE_ENCODE
 		);
+		openedfiles.file[i]->fstat.encfmt = g_flag.encfmt;
 	}
 
 	/* additional error check(s) */
@@ -152,19 +162,37 @@ mode_encode(
 		exit((int) nerrors_file);
 	}
 
+	/* kernel choices from --autotune */
+	autotune_load();
+
+	/* thread placement from --affinity */
+	if ( g_flag.affinity ){
+		affinity_load();
+	}
+
 	/* encode each file */
 	for ( i = 0; i < openedfiles.nmemb; ++i ){
 		if ( (i != 0) && (! g_flag.quiet) ){
 			(void) fputc('\n', stderr);
 		}
 
-		enc_loop(openedfiles.file[i]);
+		verified = enc_loop(openedfiles.file[i]);
 
 		result.d = fclose(openedfiles.file[i]->infile);
 		assert(result.d == 0);
 		openedfiles.file[i]->infile = NULL;
 
-		if ( g_flag.delete_src ){
+		if UNLIKELY ( g_flag.delete_src && (! verified) ){
+			warning_tta("%s: failed --verify, not deleted",
+				openedfiles.file[i]->infile_name
+			);
+		}
+		else if ( g_flag.delete_src
+		    &&
+		     (strcmp(openedfiles.file[i]->infile_name, STDIN_NAME)
+		      != 0
+		     )
+		){
 			result.d = remove(openedfiles.file[i]->infile_name);
 			if UNLIKELY ( result.d != 0 ){
 				error_sys_nf(
@@ -185,6 +213,7 @@ mode_encode(
 	}
 
 	/* cleanup */
+	encmt_loop_free();
 	openedfiles_close_free(&openedfiles);
 
 	return (int) g_nwarnings;
@@ -194,8 +223,10 @@ mode_encode(
  * @brief prepares for and calls the encode loop function
  *
  * @param ofm - source file struct
+ *
+ * @return false if any frame failed --verify
 **/
-static void
+static bool
 enc_loop(const struct OpenedFilesMember *const RESTRICT ofm)
 /*@globals	fileSystem,
 		internalState,
@@ -216,12 +247,13 @@ enc_loop(const struct OpenedFilesMember *const RESTRICT ofm)
 	);
 	/* * */
 	const unsigned int nthreads = (g_nthreads != 0
-		? g_nthreads : get_nprocessors_onln()
+		? g_nthreads : affinity_nthreads_default()
 	);
 	/* * */
 	struct EncStats estat;
 	struct SeekTable seektable;
 	timestamp_p ts_start, ts_finish;
+	off_t frames_off, frames_off_new, size;
 	union {	int	d; } result;
 	union {	size_t	z; } tmp;
 
@@ -238,18 +270,24 @@ enc_loop(const struct OpenedFilesMember *const RESTRICT ofm)
 		assert(false);
 		break;
 	case xENCFMT_TTA1:
-		/* seektable at start of file, size calculated in advance */
-		tmp.z = seektable_nframes(
-			fstat->decpcm_size, fstat->buflen,
-			(unsigned int) fstat->samplebytes
-		);
+	case xENCFMT_TTA2:
+		/* seektable at start of file, size calculated in advance; a
+		     stream of unknown size gets the default, and the frames
+		     are moved afterwards if it was not the right size
+		*/
+		tmp.z = 0;
+		if ( fstat->decpcm_size != DECPCM_SIZE_UNKNOWN ){
+			tmp.z = seektable_nframes(
+				fstat->decpcm_size, fstat->buflen,
+				(unsigned int) fstat->samplebytes
+			);
+		}
 		seektable_init(&seektable, tmp.z);
 		break;
 	}
-	/* MAYBE: handle file of unknown size */
 
-	/* open outfile */
-	outfile = fopen_check(outfile_name, "wb", FATAL);
+	/* open outfile; read too, in case the frames have to be moved */
+	outfile = fopen_check(outfile_name, "w+b", FATAL);
 	if UNLIKELY ( outfile == NULL ){
 		error_sys(errno, "fopen", outfile_name);
 	}
@@ -257,22 +295,37 @@ enc_loop(const struct OpenedFilesMember *const RESTRICT ofm)
 	g_rm_on_sigint = outfile_name;
 
 	/* save some space for the outfile header and seektable */
-	/* MAYBE: handle file of unknown size */
 	switch ( fstat->encfmt ){
 	default:
 		assert(false);
 		break;
 	case xENCFMT_TTA1:
-		prewrite_tta1_header_seektable(
-			outfile, &seektable, outfile_name
+	case xENCFMT_TTA2:
+		prewrite_tta_header_seektable(
+			outfile, &seektable, fstat->encfmt, outfile_name
 		);
 		break;
 	}
 
-	/* seek to start of PCM */
-	result.d = fseeko(infile, fstat->decpcm_off, SEEK_SET);
-	if UNLIKELY ( result.d != 0 ){
-		error_sys(errno, "fseeko", infile_name);
+	/* reserve the disk space up front; the PCM size is a safe guess, since
+	     the TTA is (almost always) smaller
+	*/
+	frames_off = ftello(outfile);
+	if UNLIKELY ( frames_off < 0 ){
+		error_sys(errno, "ftello", outfile_name);
+	}
+	if ( fstat->decpcm_size != DECPCM_SIZE_UNKNOWN ){
+		(void) file_prealloc(
+			outfile, frames_off + (off_t) fstat->decpcm_size
+		);
+	}
+
+	/* seek to start of PCM; a pipe is already there */
+	if ( fstat->decpcm_off >= 0 ){
+		result.d = fseeko(infile, fstat->decpcm_off, SEEK_SET);
+		if UNLIKELY ( result.d != 0 ){
+			error_sys(errno, "fseeko", infile_name);
+		}
 	}
 
 	if ( ! g_flag.quiet ){
@@ -304,20 +357,65 @@ encode_multi:
 		break;
 	}
 
-	/* write header and seektable */
+	/* write header and seektable in place */
 	switch ( fstat->encfmt ){
 	default:
 		assert(false);
 		break;
 	case xENCFMT_TTA1:
-		rewind(outfile);
-		seektable.off = write_tta1_header(
-			outfile, estat.nsamples_perchan, fstat, outfile_name
+	case xENCFMT_TTA2:
+		tmp.z = (	/* seektable + st-crc */
+			  (seektable.nmemb * (sizeof *seektable.table))
+			+ sizeof(uint32_t)
 		);
+		if ( fstat->encfmt == xENCFMT_TTA2 ){
+			seektable.off = write_tta2_header(
+				outfile, estat.nsamples_perchan,
+				  sizeof(struct TTA2SeekTableHeader) + tmp.z
+				+ estat.nbytes_encoded,
+				fstat, outfile_name
+			);
+		}
+		else {	seektable.off = write_tta1_header(
+				outfile, estat.nsamples_perchan, fstat,
+				outfile_name
+			);
+		}
+		/* the frames go right after the seektable, so they are moved
+		     if it came out bigger (unknown size) or smaller (truncated
+		     infile) than the space saved for it; nothing to move in
+		     /dev/null
+		*/
+		frames_off_new = seektable.off + (off_t) tmp.z;
+		if ( (frames_off_new != frames_off)
+		    &&
+		     file_regsize(outfile, &size)
+		){
+			if UNLIKELY (
+			     ! file_move(
+				outfile, frames_off_new, frames_off,
+				(off_t) estat.nbytes_encoded
+			     )
+			){
+				error_sys(
+					errno, "copy_file_range", outfile_name
+				);
+			}
+			frames_off = frames_off_new;
+		}
 		write_tta_seektable(outfile, &seektable, outfile_name);
 		break;
 	}
 
+	/* cut off what is left of the preallocation (and --direct padding) */
+	if UNLIKELY (
+	     ! file_truncate(
+		outfile, frames_off + (off_t) estat.nbytes_encoded
+	     )
+	){
+		error_sys(errno, "ftruncate", outfile_name);
+	}
+
 	if ( ! g_flag.quiet ){
 		(void) fputs("C\r", stderr);
 	}
@@ -343,7 +441,7 @@ encode_multi:
 	free(outfile_name);
 	seektable_free(&seektable);
 
-	return;
+	return estat.nframes_badverify == 0;
 }
 
 /* EOF //////////////////////////////////////////////////////////////////// */
@@ -4,7 +4,7 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
@@ -21,18 +21,56 @@
 
 #include "../../libttaR.h"
 
+#include "../affinity.h"
 #include "../alloc.h"
+#include "../autotune.h"
 #include "../byteswap.h"
 #include "../cli.h"
 #include "../common.h"
 #include "../debug.h"
 #include "../formats.h"
 #include "../main.h"
+#include "../system.h"
 
+#include "./arena.h"
+#include "./atomic.h"
+#include "./blockout.h"
+#include "./bulkio.h"
 #include "./bufs.h"
+#include "./crew.h"
+#include "./framequeue.h"
+#include "./freelist.h"
 #include "./mt-struct.h"
-#include "./pqueue.h"
 #include "./threads.h"
+#include "./uring.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/* max number of consecutive, already encoded frames the MT writer hands to
+     one writev
+*/
+#define ENCMT_WRITEV_NFRAME	8u
+
+/* gather list length for a writev of ENCMT_WRITEV_NFRAME frames */
+#define ENCMT_WRITEV_NIOV	(ENCMT_WRITEV_NFRAME * (TTABUF_NSEG_MAX + 2u))
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/* a batch of frames the MT writer hands to one writev; with a ring, the
+     batch stays in its slot until the write is done
+*/
+struct EncMT_Write {
+	unsigned int		nbatch;		/* 0 if the slot is free     */
+	unsigned int		niov;
+	unsigned int		iov_first;	/* what is left to write     */
+	size_t			ticket;		/* of the first frame        */
+	size_t			len;
+	off_t			offset;
+	/*@dependent@*/
+	struct EncFrame		*batch[ENCMT_WRITEV_NFRAME];
+	struct TTA2FrameFooter	footer[ENCMT_WRITEV_NFRAME];
+	iovec_p			iov[ENCMT_WRITEV_NIOV];
+};
 
 /* //////////////////////////////////////////////////////////////////////// */
 
@@ -40,7 +78,7 @@
 #undef user
 #undef encbuf
 static NOINLINE enum LibTTAr_EncRetVal enc_frame_encode(
-	struct EncBuf *RESTRICT encbuf,
+	struct EncBuf *RESTRICT encbuf, const uint8_t *RESTRICT,
 	/*@reldef@*/ struct LibTTAr_CodecState_Priv *RESTRICT priv,
 	/*@out@*/ struct LibTTAr_CodecState_User *RESTRICT user_out,
 	enum LibTTAr_SampleBytes, unsigned int, size_t
@@ -50,23 +88,48 @@ static NOINLINE enum LibTTAr_EncRetVal enc_frame_encode(
 @*/
 /*@modifies	fileSystem,
 		internalState,
-		encbuf->ttabuf_len,
 		*encbuf->i32buf,
-		encbuf->ttabuf,
 		*encbuf->ttabuf,
+		encbuf->ttabuf_used,
+		encbuf->nseg,
+		encbuf->seg,
 		*priv,
 		*user_out
 @*/
 ;
 
+#undef vfybuf
+#undef vfypcm
+#undef priv
+static NOINLINE bool enc_frame_verify(
+	const struct EncBuf *RESTRICT, const uint8_t *RESTRICT,
+	int32_t *RESTRICT vfybuf, uint8_t *RESTRICT vfypcm,
+	/*@reldef@*/ struct LibTTAr_CodecState_Priv *RESTRICT priv,
+	const struct LibTTAr_CodecState_User *RESTRICT,
+	enum LibTTAr_SampleBytes, unsigned int
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*vfybuf,
+		*vfypcm,
+		*priv
+@*/
+;
+
 #undef seektable
 #undef estat_out
 #undef outfile
+#undef block
 static NOINLINE void enc_frame_write(
-	struct EncBuf *RESTRICT, struct SeekTable *RESTRICT seektable,
+	const struct EncBuf *RESTRICT, struct SeekTable *RESTRICT seektable,
 	/*@in@*/ struct EncStats *RESTRICT estat_out,
-	struct LibTTAr_CodecState_User *RESTRICT, const char *RESTRICT,
-	FILE *RESTRICT outfile, const char *RESTRICT, unsigned int, int8_t
+	const struct LibTTAr_CodecState_User *RESTRICT, const char *RESTRICT,
+	FILE *RESTRICT outfile, const char *RESTRICT,
+	/*@null@*/ struct BlockOut *RESTRICT block, unsigned int, size_t,
+	int8_t, bool
 )
 /*@globals	fileSystem,
 		internalState
@@ -75,7 +138,50 @@ static NOINLINE void enc_frame_write(
 		internalState,
 		*seektable,
 		*estat_out,
-		outfile
+		outfile,
+		*block
+@*/
+;
+
+#undef seektable
+#undef estat_out
+static void enc_frame_account(
+	struct SeekTable *RESTRICT seektable,
+	/*@in@*/ struct EncStats *RESTRICT estat_out,
+	const struct LibTTAr_CodecState_User *RESTRICT, const char *RESTRICT,
+	const char *RESTRICT, unsigned int, size_t, int8_t, bool
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*seektable,
+		*estat_out
+@*/
+;
+
+#undef footer
+static const void *enc_frame_footer(
+	/*@out@*/ struct TTA2FrameFooter *RESTRICT footer,
+	const struct LibTTAr_CodecState_User *RESTRICT, size_t
+)
+/*@modifies	*footer@*/
+;
+
+#undef map
+#undef infile
+static bool enc_pcm_map(
+	/*@out@*/ struct FileMap *RESTRICT map, FILE *RESTRICT infile,
+	const struct FileStats *RESTRICT
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*map,
+		infile
 @*/
 ;
 
@@ -97,28 +203,83 @@ static NOINLINE unsigned int enc_frame_zeropad(
 
 /* ------------------------------------------------------------------------ */
 
+#undef state
+static void encmt_crew_init(struct EncMT_State *RESTRICT state, unsigned int)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*state
+@*/
+;
+
 #undef arg
 HOT
-START_ROUTINE_ABI
-static start_routine_ret encmt_io(struct MTArg_EncIO *RESTRICT arg)
+static start_routine_ret encmt_reader(struct MTArg_EncIO *RESTRICT arg)
 /*@globals	fileSystem,
 		internalState
 @*/
 /*@modifies	fileSystem,
 		internalState,
-		*arg->frames.navailable,
-		*arg->frames.post_encoder,
-		*arg->frames.ni32_perframe,
-		*arg->frames.encbuf,
-		arg->outfile.handle,
-		arg->infile.handle,
+		arg->frames.queue,
+		*arg->frames.frame,
+		arg->infile.handle
+@*/
+;
+
+#undef arg
+HOT
+static start_routine_ret encmt_writer(struct MTArg_EncIO *RESTRICT arg)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*arg->frames.queue.nstall_writer,
+		*arg->frames.queue.out.fl.tail,
+		*arg->frames.queue.out.buf,
+		*arg->frames.frame,
+		arg->outfile,
+		arg->infile.bulk,
+		*arg->block,
 		*arg->seektable,
 		*arg->estat_out
 @*/
 ;
 
+#undef w
+#undef outlist
+static void encmt_write_release(
+	struct EncMT_Write *RESTRICT w, struct FreeList *RESTRICT outlist
+)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*w,
+		*outlist
+@*/
+;
+
+#undef outfile
+#undef slot
+#undef outlist
+static bool encmt_write_done(
+	struct MTArg_IO_File *RESTRICT outfile,
+	struct EncMT_Write *RESTRICT slot, struct FreeList *RESTRICT outlist,
+	bool
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*outfile,
+		slot[],
+		*outlist
+@*/
+;
+
 #undef arg
-START_ROUTINE_ABI
 static start_routine_ret encmt_encoder_wrapper(void *const RESTRICT arg)
 /*@globals	fileSystem,
 		internalState
@@ -137,15 +298,25 @@ static start_routine_ret encmt_encoder(struct MTArg_Encoder *RESTRICT arg)
 @*/
 /*@modifies	fileSystem,
 		internalState,
-		*arg->frames.navailable,
-		arg->frames.queue,
-		*arg->frames.post_encoder,
-		*arg->frames.encbuf
+		*arg->frames.ticket,
+		*arg->frames.nstall,
+		*arg->frames.bufs.id_next,
+		*arg->frames.freelist.tail,
+		*arg->frames.encbuf,
+		*arg->frames.frame
 @*/
 ;
 
 /* //////////////////////////////////////////////////////////////////////// */
 
+/**@var encmt_state
+ * @brief the multi-threaded encoder, kept across files
+**/
+/*@checkmod@*/
+static struct EncMT_State encmt_state;
+
+/* //////////////////////////////////////////////////////////////////////// */
+
 /**@fn encst_loop
  * @brief the single-threaded encoder
  *
@@ -182,50 +353,103 @@ encst_loop(
 	const size_t buflen            = fstat->buflen;
 	const unsigned int nchan       = (unsigned int) fstat->nchan;
 	const enum LibTTAr_SampleBytes samplebytes =    fstat->samplebytes;
+	const size_t footer_len        = TTA_FRAMEFOOTER_LEN(fstat->encfmt);
+	const size_t ttabuf_len        = TTABUF_LEN_FRAME(
+		buflen, nchan, samplebytes
+	);
 	/* * */
 	struct LibTTAr_CodecState_Priv *priv = NULL;
 	struct LibTTAr_CodecState_User user;
+	struct Arena arena;
 	struct EncBuf encbuf;
+	int32_t *vfybuf = NULL;
+	uint8_t *vfypcm = NULL;
 	struct EncStats estat;
+	struct FileMap pcmmap;
+	struct BlockOut block;
+	struct BulkIO bulk_in, bulk_out;
+	const uint8_t *pcm;
 	/* * */
 	size_t readlen, nmemb_read;
 	size_t ni32_perframe, nsamples_flat_read_total = 0;
 	size_t nframes_read = 0;
 	int8_t enc_retval;
+	bool verified = true;
 	union { unsigned int u; } tmp;
 
 	/* setup */
 	memset(&estat, 0x00, sizeof estat);
+	arena_init(&arena,
+		  encbuf_arena_size(
+			buflen, ttabuf_len, nchan, samplebytes,
+			CBM_SINGLE_THREADED
+		)
+		+ priv_arena_size(nchan)
+		+ (g_flag.verify
+			? ARENA_SIZE(buflen * (sizeof *vfybuf))
+			  + ARENA_SIZE(buflen * (size_t) samplebytes)
+			: 0
+		)
+	);
 	encbuf_init(
-		&encbuf, buflen, TTABUF_LEN_DEFAULT, nchan, samplebytes,
+		&encbuf, &arena, buflen, ttabuf_len, nchan, samplebytes,
 		CBM_SINGLE_THREADED
 	);
-	priv = priv_alloc(nchan);
+	priv = priv_arena_alloc(&arena, nchan);
+	if ( g_flag.verify ){
+		vfybuf = arena_alloc(&arena, buflen * (sizeof *vfybuf));
+		vfypcm = arena_alloc(&arena, buflen * (size_t) samplebytes);
+	}
+	(void) pages_populate(arena.base, arena.used);
+	(void) enc_pcm_map(&pcmmap, infile, fstat);
+	block.buf = NULL;
+	if ( g_flag.direct ){
+		blockout_init(&block, outfile, outfile_name, true);
+	}
+	bulkio_init(&bulk_in, infile, false, pcmmap.data, g_flag.bulk_io);
+	bulkio_init(&bulk_out, outfile, true, NULL, g_flag.bulk_io);
 
 	goto loop_entr;
 	do {
-		nmemb_read = fread(
-			encbuf.pcmbuf, (size_t) samplebytes, readlen, infile
-		);
+		if ( pcmmap.data != NULL ){
+			/* the frame is read straight out of the mapping */
+			pcm        = &pcmmap.data[
+				nsamples_flat_read_total * samplebytes
+			];
+			nmemb_read = readlen;
+		}
+		else {	pcm        = encbuf.pcmbuf;
+			nmemb_read = fread(
+				encbuf.pcmbuf, (size_t) samplebytes, readlen,
+				infile
+			);
+		}
 		ni32_perframe             = nmemb_read;
 		nsamples_flat_read_total += nmemb_read;
 
 		if UNLIKELY ( nmemb_read != readlen ){
-			/* ???: not sure if the filechecks let us be here */
+			/* the end of a stream of unknown size, or a file
+			     shorter than its header says
+			*/
 			if UNLIKELY ( ferror(infile) != 0 ){
 				error_sys(errno, "fread", infile_name);
 			}
-			else {	warning_tta("%s: frame %zu: truncated file",
+			else if ( decpcm_size != DECPCM_SIZE_UNKNOWN ){
+				warning_tta("%s: frame %zu: truncated file",
 					infile_name, nframes_read
 				);
-			}
+			} else{;}
 			/* forces readlen to 0 */
 			nsamples_flat_read_total = SIZE_MAX;
+			if ( nmemb_read == 0 ){
+				break;
+			}
 		}
 
 		/* check for truncated sample */
 		tmp.u = (unsigned int) (nmemb_read % nchan);
 		if UNLIKELY ( tmp.u != 0 ){
+			assert(pcm == encbuf.pcmbuf);
 			warning_tta("%s: frame %zu: last sample truncated, "
 				"zero-padding", infile_name, nframes_read
 			);
@@ -238,15 +462,25 @@ encst_loop(
 
 		/* encode frame */
 		enc_retval = (int8_t) enc_frame_encode(
-			&encbuf, priv, &user, samplebytes, nchan,
+			&encbuf, pcm, priv, &user, samplebytes, nchan,
 			ni32_perframe
 		);
+		if ( vfybuf != NULL ){
+			verified = enc_frame_verify(
+				&encbuf, pcm, vfybuf, vfypcm, priv, &user,
+				samplebytes, nchan
+			);
+		}
 
 		/* write frame */
 		enc_frame_write(
 			&encbuf, seektable, &estat, &user, infile_name,
-			outfile, outfile_name, nchan, enc_retval
+			outfile, outfile_name,
+			(block.buf != NULL ? &block : NULL), nchan, footer_len,
+			enc_retval, verified
 		);
+		bulkio_update(&bulk_in, estat.nsamples_flat * samplebytes);
+		bulkio_update(&bulk_out, estat.nbytes_encoded);
 
 		nframes_read += 1u;
 loop_entr:
@@ -263,8 +497,12 @@ loop_entr:
 	while (	readlen != 0 );
 
 	/* cleanup */
-	priv_free(priv);
-	codecbuf_free(&encbuf, CBM_SINGLE_THREADED);
+	blockout_finish(&block, outfile, outfile_name);
+	bulkio_finish(&bulk_out);
+	bulkio_finish(&bulk_in);
+	file_unmap(&pcmmap);
+	codecbuf_free(&encbuf);
+	arena_free(&arena);
 
 	*estat_out = estat;
 	return;
@@ -283,12 +521,15 @@ loop_entr:
  * @param nthreads     - number of encoder threads to use
  *
  * @note threads layout:
- *     - the io thread is created first, so it can get a head start on filling
- *   up the framequeue
- *     - then (nthreads - 1u) coder threads are created
+ *     - the reader, the writer, and (nthreads - 1u) coder threads are made
+ *   for the first file, and kept for the rest (see "crew.h")
+ *     - each file is a job for them; the reader can get a head start on
+ *   filling up the framequeue
+ *     - the coders finish frames in any order; the writer writes them out
+ *   in order from the reorder buffer
  *     - the main thread then becomes the last coder thread
- *     - when a created coder thread is finished, it detaches itself
- *     - after the main thread finishes coding, the io thread is joined
+ *     - after the main thread finishes coding, it waits for the other
+ *   coder threads, the reader, and the writer to be done with the file
 **/
 BUILD NOINLINE void
 encmt_loop(
@@ -300,56 +541,168 @@ encmt_loop(
 	const unsigned int nthreads
 )
 /*@globals	fileSystem,
-		internalState
+		internalState,
+		encmt_state
 @*/
 /*@modifies	fileSystem,
 		internalState,
+		encmt_state,
 		*seektable,
 		*estat_out,
 		outfile,
 		infile
 @*/
 {
-	struct MTArg_EncIO io_state;
-	struct MTArg_Encoder encoder_state;
-	thread_p io_thread, encoder_thread;
-	struct FileStats_EncMT fstat_c;
+	struct EncMT_State *const RESTRICT state = &encmt_state;
+	const size_t samplebuf_len = fstat->buflen;
 	struct EncStats estat;
-	const size_t        samplebuf_len = fstat->buflen;
-	const unsigned int framequeue_len = FRAMEQUEUE_LEN(nthreads);
-	unsigned int i;
+	struct FileMap pcmmap;
+	struct BlockOut block;
 
 	assert(nthreads > 0);
+	assert((state->nthreads == 0) || (state->nthreads == nthreads));
 
 	/* setup/init */
 	memset(&estat, 0x00, sizeof estat);
-	encmt_fstat_init(&fstat_c, fstat);
-	encmt_state_init(
-		&io_state, &encoder_state, framequeue_len, samplebuf_len,
-		outfile, outfile_name, infile, infile_name, seektable, &estat,
-		&fstat_c
+	if ( state->nthreads == 0 ){
+		encmt_crew_init(state, nthreads);
+	}
+	if ( (state->i32buf_len != 0)
+	    &&
+	     ((state->i32buf_len != samplebuf_len)
+	     ||
+	      (state->fstat.nchan != (unsigned int) fstat->nchan)
+	     ||
+	      (state->fstat.samplebytes != fstat->samplebytes)
+	     )
+	){
+		encmt_state_free(&state->io, &state->encoder);
+		state->i32buf_len = 0;
+	}
+	encmt_fstat_init(&state->fstat, fstat);
+	if ( state->i32buf_len == 0 ){
+		encmt_state_init(
+			&state->io, &state->encoder, nthreads, state->nspin,
+			samplebuf_len, &state->fstat, g_flag.verify
+		);
+		state->i32buf_len = samplebuf_len;
+	}
+	else {	encmt_state_rewind(
+			&state->io, &state->encoder, state->nspin
+		);
+	}
+	(void) enc_pcm_map(&pcmmap, infile, fstat);
+	block.buf = NULL;
+	if ( g_flag.direct ){
+		blockout_init(&block, outfile, outfile_name, true);
+	}
+	encmt_state_files(
+		&state->io, outfile, outfile_name, infile, infile_name,
+		pcmmap.data, (block.buf != NULL ? &block : NULL), seektable,
+		&estat
 	);
+	bulkio_init(
+		&state->io.infile.bulk, infile, false, pcmmap.data,
+		g_flag.bulk_io
+	);
+	bulkio_init(
+		&state->io.outfile.bulk, outfile, true, NULL, g_flag.bulk_io
+	);
+
+	/* code the file */
+	crew_start(&state->crew);
+	affinity_set_coder(nthreads - 1u, nthreads);
+	(void) encmt_encoder(&state->encoder);
+	affinity_restore();
+
+	/* a coder may still be leaving a waitvar_wait() on its sentinel frame
+	     after the main thread is done, so wait for the whole crew before
+	     the state is touched again
+	*/
+	crew_wait(&state->crew);
+	file_unmap(&pcmmap);
+	mtfile_sync(&state->io.outfile);
+	blockout_finish(&block, outfile, outfile_name);
+
+	/* stats */
+	framequeue_stats(&estat.queue, &state->io.frames.queue);
+
+	*estat_out = estat;
+	return;
+}
+
+/**@fn encmt_loop_free
+ * @brief joins the multi-threaded encoder threads and frees its state
+ *
+ * @note call once after the last file; a no-op if encmt_loop() was never
+ *   called
+**/
+BUILD void
+encmt_loop_free(void)
+/*@globals	internalState,
+		encmt_state
+@*/
+/*@modifies	internalState,
+		encmt_state
+@*/
+{
+	struct EncMT_State *const RESTRICT state = &encmt_state;
+
+	if ( state->nthreads != 0 ){
+		crew_free(&state->crew);
+		state->nthreads = 0;
+	}
+	if ( state->i32buf_len != 0 ){
+		encmt_state_free(&state->io, &state->encoder);
+		state->i32buf_len = 0;
+	}
+	return;
+}
+
+/**@fn encmt_crew_init
+ * @brief makes the crew of the multi-threaded encoder
+ *
+ * @param state    - multi-threaded encoder state
+ * @param nthreads - number of encoder threads
+ *
+ * @note the threads only get the addresses of the state structs, which do
+ *   not move
+**/
+static void
+encmt_crew_init(
+	struct EncMT_State *const RESTRICT state, const unsigned int nthreads
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*state
+@*/
+{
+	unsigned int i;
+
+	state->nthreads = nthreads;
+	state->nspin    = WAITVAR_NSPIN(nthreads + 2u, affinity_nprocessors());
 
-	/* create coders */
-	thread_create(
-		&io_thread,
-		(START_ROUTINE_ABI start_routine_ret (*)(void *)) encmt_io,
-		&io_state
+	crew_init(&state->crew, nthreads + 1u);
+	affinity_set_io(nthreads);
+	crew_add(
+		&state->crew,
+		(start_routine_ret (*)(void *)) encmt_reader, &state->io
+	);
+	crew_add(
+		&state->crew,
+		(start_routine_ret (*)(void *)) encmt_writer, &state->io
 	);
 	for ( i = 0; i < nthreads - 1u; ++i ){
-		thread_create(
-			&encoder_thread, encmt_encoder_wrapper, &encoder_state
+		affinity_set_coder(i, nthreads);
+		crew_add(
+			&state->crew, encmt_encoder_wrapper, &state->encoder
 		);
 	}
-	(void) encmt_encoder(&encoder_state);
-
-	/* wait for i/o */
-	thread_join(&io_thread);
-
-	/* cleanup */
-	encmt_state_free(&io_state, &encoder_state, framequeue_len);
+	affinity_restore();
 
-	*estat_out = estat;
 	return;
 }
 
@@ -359,6 +712,8 @@ encmt_loop(
  * @brief encode a TTA frame
  *
  * @param encbuf        - encode buffers struct
+ * @param pcmbuf        - the frame's PCM; in a pcmbuf, or in the mapped
+ *   infile
  * @param priv          - private state struct
  * @param user_out      - user state return struct
  * @param samplebytes   - number of bytes per PCM sample
@@ -370,6 +725,7 @@ encmt_loop(
 static NOINLINE enum LibTTAr_EncRetVal
 enc_frame_encode(
 	struct EncBuf *const RESTRICT encbuf,
+	const uint8_t *const RESTRICT pcmbuf,
 	/*@reldef@*/ struct LibTTAr_CodecState_Priv *const RESTRICT priv,
 	/*@out@*/ struct LibTTAr_CodecState_User *const RESTRICT user_out,
 	const enum LibTTAr_SampleBytes samplebytes, const unsigned int nchan,
@@ -380,10 +736,11 @@ enc_frame_encode(
 @*/
 /*@modifies	fileSystem,
 		internalState,
-		encbuf->ttabuf_len,
 		*encbuf->i32buf,
-		encbuf->ttabuf,
 		*encbuf->ttabuf,
+		encbuf->ttabuf_used,
+		encbuf->nseg,
+		encbuf->seg,
 		*priv,
 		*user_out
 @*/
@@ -391,13 +748,18 @@ enc_frame_encode(
 	enum LibTTAr_EncRetVal status;
 	struct LibTTAr_CodecState_User user = LIBTTAr_CODECSTATE_USER_INIT;
 	struct LibTTAr_EncMisc misc;
+	enum LibTTAr_Kernel kernel;
+	uint8_t *dest     = encbuf->ttabuf;
+	size_t   dest_len = encbuf->ttabuf_len;
+	size_t  *used     = &encbuf->ttabuf_used;
+	struct TTASeg *seg;
 	UNUSED union {	size_t z; } result;
 
 	assert(encbuf->i32buf != NULL);
 
 	/* convert PCM to I32 */
 	result.z = libttaR_pcm_read(
-		encbuf->i32buf, encbuf->pcmbuf, ni32_perframe, samplebytes
+		encbuf->i32buf, pcmbuf, ni32_perframe, samplebytes
 	);
 	assert(result.z != 0);
 
@@ -405,23 +767,29 @@ enc_frame_encode(
 	misc.ni32_perframe = ni32_perframe;
 	misc.samplebytes   = samplebytes;
 	misc.nchan         = nchan;
+	kernel             = autotune_kernel(MODE_ENCODE, samplebytes, nchan);
+	encbuf->nseg       = 0;
 	goto loop_entr;
 	do {
-		encbuf_adjust(encbuf, TTABUF_LEN_DEFAULT, nchan);
+		/* the last call filled dest up; go on in a spill segment */
+		seg      = encbuf_spill(encbuf, samplebytes, nchan);
+		dest     = seg->buf;
+		dest_len = seg->len;
+		used     = &seg->used;
 loop_entr:
-		misc.dest_len    = encbuf->ttabuf_len - user.nbytes_tta_total;
+		misc.dest_len    = dest_len;
 		misc.src_len     = encbuf->i32buf_len - user.ni32_total;
 		misc.ni32_target = ni32_perframe - user.ni32_total;
 
-		status = libttaR_tta_encode(
-			&encbuf->ttabuf[user.nbytes_tta_total],
-			&encbuf->i32buf[user.ni32_total],
-			priv, &user, &misc
+		status = libttaR_tta_encode_kernel(
+			dest, &encbuf->i32buf[user.ni32_total], priv, &user,
+			&misc, kernel
 		);
 		assert((status == LIBTTAr_ERV_OK_DONE)
 		      ||
 		       (status == LIBTTAr_ERV_OK_AGAIN)
 		);
+		*used = user.nbytes_tta;
 	}
 	while ( status == LIBTTAr_ERV_OK_AGAIN );
 
@@ -429,28 +797,143 @@ loop_entr:
 	return status;
 }
 
+/**@fn enc_frame_verify
+ * @brief decodes an encoded frame again, and checks it against the source
+ *   PCM (--verify)
+ *
+ * @param encbuf      - encode buffers struct
+ * @param pcmbuf      - the frame's PCM; in a pcmbuf, or in the mapped
+ *   infile
+ * @param vfybuf      - buffer to decode into; as long as the i32buf
+ * @param vfypcm      - buffer to convert the decoded samples back into;
+ *   as long as a pcmbuf
+ * @param priv        - private state struct; the encoder's is reused
+ * @param user        - user state struct from enc_frame_encode()
+ * @param samplebytes - number of bytes per PCM sample
+ * @param nchan       - number of audio channels
+ *
+ * @return true if the frame decodes back to the same PCM and CRC
+ *
+ * @note the PCM is compared byte for byte, so libttaR_pcm_read(3) (bit
+ *   depth, endianness, 24-bit packing) is checked too
+ * @note the decoder may read a little past the frame, so it gets the
+ *   frame followed by a zeroed safety margin. a frame that spilled, or
+ *   that has no room for the margin, is joined into a scratch buffer
+**/
+static NOINLINE bool
+enc_frame_verify(
+	const struct EncBuf *const RESTRICT encbuf,
+	const uint8_t *const RESTRICT pcmbuf,
+	int32_t *const RESTRICT vfybuf, uint8_t *const RESTRICT vfypcm,
+	/*@reldef@*/ struct LibTTAr_CodecState_Priv *const RESTRICT priv,
+	const struct LibTTAr_CodecState_User *const RESTRICT user,
+	const enum LibTTAr_SampleBytes samplebytes, const unsigned int nchan
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*encbuf->ttabuf,
+		*vfybuf,
+		*vfypcm,
+		*priv
+@*/
+{
+	const size_t safety_margin = libttaR_ttabuf_safety_margin(
+		samplebytes, nchan
+	);
+	const size_t src_len       = user->nbytes_tta_total + safety_margin;
+	const size_t pcm_len       = user->ni32_total * (size_t) samplebytes;
+	/* * */
+	enum LibTTAr_DecRetVal status;
+	struct LibTTAr_CodecState_User dec = LIBTTAr_CODECSTATE_USER_INIT;
+	struct LibTTAr_DecMisc misc;
+	uint8_t *src    = encbuf->ttabuf;
+	uint8_t *joined = NULL;
+	size_t used;
+	unsigned int i;
+	UNUSED union {	size_t z; } result;
+
+	assert((encbuf->i32buf != NULL) && (encbuf->ttabuf != NULL));
+
+	/* join the spill segments */
+	if UNLIKELY ( (encbuf->nseg != 0) || (src_len > encbuf->ttabuf_len) ){
+		joined  = malloc_check(src_len);
+		used    = encbuf->ttabuf_used;
+		(void) memcpy(joined, encbuf->ttabuf, used);
+		for ( i = 0; i < encbuf->nseg; ++i ){
+			assert(encbuf->seg != NULL);
+			(void) memcpy(
+				&joined[used], encbuf->seg[i].buf,
+				encbuf->seg[i].used
+			);
+			used += encbuf->seg[i].used;
+		}
+		assert(used == user->nbytes_tta_total);
+		src = joined;
+	}
+	else {	assert(encbuf->ttabuf_used == user->nbytes_tta_total); }
+	memset(&src[user->nbytes_tta_total], 0x00, safety_margin);
+
+	/* decode TTA to I32; the whole frame in one call */
+	misc.dest_len            = encbuf->i32buf_len;
+	misc.src_len             = src_len;
+	misc.ni32_target         = user->ni32_total;
+	misc.nbytes_tta_target   = user->nbytes_tta_total;
+	misc.ni32_perframe       = user->ni32_total;
+	misc.nbytes_tta_perframe = user->nbytes_tta_total;
+	misc.samplebytes         = samplebytes;
+	misc.nchan               = nchan;
+	status = libttaR_tta_decode_kernel(
+		vfybuf, src, priv, &dec, &misc,
+		autotune_kernel(MODE_DECODE, samplebytes, nchan)
+	);
+	free(joined);
+	if UNLIKELY (
+		(status != LIBTTAr_DRV_OK_DONE) || (dec.crc != user->crc)
+	){
+		return false;
+	}
+
+	/* convert I32 back to PCM, and compare it with the source */
+	result.z = libttaR_pcm_write(
+		vfypcm, vfybuf, user->ni32_total, samplebytes
+	);
+	assert(result.z != 0);
+	return (memcmp(vfypcm, pcmbuf, pcm_len) == 0);
+}
+
 /**@fn enc_frame_write
  * @brief write a TTA frame
  *
  * @param encbuf       - encode buffers struct
  * @param seektable    - seektable struct
  * @param estat_out    - encode stats return struct
- * @param user_in      - user state struct
+ * @param user         - user state struct
  * @param infile_name  - name of the source file (warnings/errors)
  * @param outfile      - destination file
  * @param outfile_name - name of the destination file (warnings/errors)
+ * @param block        - block writer for outfile (--direct), or NULL
  * @param nchan        - number of audio channels
+ * @param footer_len   - length of the frame footer
  * @param enc_retval   - return value from enc_frame_encode()
+ * @param verified     - result of enc_frame_verify(), or true
+ *
+ * @note the frame, its spill segments, and its footer go out in one
+ *   writev, or are copied into the current block
 **/
 static NOINLINE void
 enc_frame_write(
-	struct EncBuf *const RESTRICT encbuf,
+	const struct EncBuf *const RESTRICT encbuf,
 	struct SeekTable *const RESTRICT seektable,
 	/*@in@*/ struct EncStats *const RESTRICT estat_out,
-	struct LibTTAr_CodecState_User *const RESTRICT user_in,
+	const struct LibTTAr_CodecState_User *const RESTRICT user,
 	const char *const RESTRICT infile_name,
 	FILE *const RESTRICT outfile, const char *const RESTRICT outfile_name,
-	const unsigned int nchan, const int8_t enc_retval
+	/*@null@*/ struct BlockOut *const RESTRICT block,
+	const unsigned int nchan, const size_t footer_len,
+	const int8_t enc_retval, const bool verified
 )
 /*@globals	fileSystem,
 		internalState
@@ -459,12 +942,66 @@ enc_frame_write(
 		internalState,
 		*seektable,
 		*estat_out,
-		outfile
+		outfile,
+		*block
+@*/
+{
+	struct TTA2FrameFooter footer;
+	iovec_p iov[TTABUF_NSEG_MAX + 2u];
+	unsigned int niov;
+
+	enc_frame_account(
+		seektable, estat_out, user, infile_name, outfile_name, nchan,
+		footer_len, enc_retval, verified
+	);
+
+	niov = encbuf_iovec(
+		iov, encbuf, enc_frame_footer(&footer, user, footer_len),
+		footer_len
+	);
+	if ( block != NULL ){
+		blockout_writev(block, outfile, outfile_name, iov, niov);
+		return;
+	}
+	if UNLIKELY ( ! file_writev(outfile, iov, (size_t) niov) ){
+		error_sys(errno, "writev", outfile_name);
+	}
+	return;
+}
+
+/**@fn enc_frame_account
+ * @brief checks an encoded frame, and adds it to the seektable and stats
+ *
+ * @param seektable    - seektable struct
+ * @param estat_out    - encode stats return struct
+ * @param user         - user state struct
+ * @param infile_name  - name of the source file (warnings/errors)
+ * @param outfile_name - name of the destination file (warnings/errors)
+ * @param nchan        - number of audio channels
+ * @param footer_len   - length of the frame footer
+ * @param enc_retval   - return value from enc_frame_encode()
+ * @param verified     - result of enc_frame_verify(), or true
+**/
+static void
+enc_frame_account(
+	struct SeekTable *const RESTRICT seektable,
+	/*@in@*/ struct EncStats *const RESTRICT estat_out,
+	const struct LibTTAr_CodecState_User *const RESTRICT user,
+	const char *const RESTRICT infile_name,
+	const char *const RESTRICT outfile_name, const unsigned int nchan,
+	const size_t footer_len, const int8_t enc_retval, const bool verified
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*seektable,
+		*estat_out
 @*/
 {
-	struct LibTTAr_CodecState_User user = *user_in;
 	struct EncStats estat = *estat_out;
-	union {	size_t z; } result;
+	const size_t nbytes_frame = user->nbytes_tta_total + footer_len;
 
 	/* failure check */
 	if UNLIKELY ( enc_retval != (int8_t) LIBTTAr_ERV_OK_DONE ){
@@ -474,35 +1011,100 @@ enc_frame_write(
 		);
 	}
 
-	/* write frame */
-	result.z = fwrite(
-		encbuf->ttabuf, user.nbytes_tta_total, SIZE_C(1), outfile
-	);
-	if UNLIKELY ( result.z != SIZE_C(1) ){
-		error_sys(errno, "fwrite", outfile_name);
-	}
-
-	/* write frame footer (CRC) */
-	user.crc = byteswap_htole_u32(user.crc);
-	result.z = fwrite(&user.crc, sizeof user.crc, SIZE_C(1), outfile);
-	if UNLIKELY ( result.z != SIZE_C(1) ){
-		error_sys(errno, "fwrite", outfile_name);
+	/* --verify */
+	if UNLIKELY ( ! verified ){
+		error_tta_nf("%s: frame %zu: verify failed",
+			outfile_name, estat.nframes
+		);
+		estat.nframes_badverify += 1u;
 	}
-	user.nbytes_tta_total += sizeof user.crc;
 
 	/* update seektable */
-	seektable_add(seektable, user.nbytes_tta_total, outfile_name);
+	seektable_add(seektable, nbytes_frame, outfile_name);
 
 	/* update estat */
 	estat.nframes          += 1u;
-	estat.nsamples_flat    += user.ni32_total;
-	estat.nsamples_perchan += (size_t) (user.ni32_total / nchan);
-	estat.nbytes_encoded   += user.nbytes_tta_total;
+	estat.nsamples_flat    += user->ni32_total;
+	estat.nsamples_perchan += (size_t) (user->ni32_total / nchan);
+	estat.nbytes_encoded   += nbytes_frame;
 
 	*estat_out = estat;
 	return;
 }
 
+/**@fn enc_frame_footer
+ * @brief fills in the footer of an encoded frame
+ *
+ * @param footer     - TTA2 frame footer
+ * @param user       - user state struct
+ * @param footer_len - length of the frame footer
+ *
+ * @return the footer to write; just the CRC for TTA1
+**/
+static const void *
+enc_frame_footer(
+	/*@out@*/ struct TTA2FrameFooter *const RESTRICT footer,
+	const struct LibTTAr_CodecState_User *const RESTRICT user,
+	const size_t footer_len
+)
+/*@modifies	*footer@*/
+{
+	memcpy(footer->sig, TTA2_FRAMEFOOTER_SIG, sizeof footer->sig);
+	footer->reserved = 0;
+	footer->size     = byteswap_htole_u32(
+		(uint32_t) user->nbytes_tta_total
+	);
+	footer->crc      = byteswap_htole_u32(user->crc);
+
+	return &((const uint8_t *) footer)[(sizeof *footer) - footer_len];
+}
+
+/**@fn enc_pcm_map
+ * @brief maps the PCM of the source file, if it can be
+ *
+ * @param map    - the mapping; empty if not mapped
+ * @param infile - source file
+ * @param fstat  - bloated file stats struct
+ *
+ * @return true if mapped
+ *
+ * @note falls back to fread for pipes, for files shorter than their
+ *   header says, and for a truncated last sample (which gets zero-padded
+ *   in a pcmbuf)
+**/
+static bool
+enc_pcm_map(
+	/*@out@*/ struct FileMap *const RESTRICT map,
+	FILE *const RESTRICT infile,
+	const struct FileStats *const RESTRICT fstat
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*map,
+		infile
+@*/
+{
+	const size_t samplesize = (size_t) (
+		fstat->samplebytes * fstat->nchan
+	);
+
+	if ( (fstat->decpcm_size == DECPCM_SIZE_UNKNOWN)
+	    ||
+	     (fstat->decpcm_size % samplesize != 0)
+	){
+		map->base = NULL;
+		map->size = 0;
+		map->data = NULL;
+		return false;
+	}
+	return file_map(
+		map, infile, fstat->decpcm_off, fstat->decpcm_size, false
+	);
+}
+
 /**@fn enc_readlen
  * @brief calculates nmemb for fread for the next frame
  *
@@ -513,6 +1115,9 @@ enc_frame_write(
  * @param nchan number - of audio channels
  *
  * @return nmemb for fread
+ *
+ * @note a decpcm_size of DECPCM_SIZE_UNKNOWN never runs out; the end of
+ *   the stream is found by fread
 **/
 CONST
 static size_t
@@ -574,128 +1179,142 @@ enc_frame_zeropad(
 
 /* ======================================================================== */
 
-/**@fn encmt_io
- * @brief the I/O thread function for the multi-threaded encoder
+/**@fn encmt_reader
+ * @brief the reader thread function for the multi-threaded encoder
  *
  * @param arg - state for the thread
  *
- * @pre arg->frames->nmemb > the number of encoder threads
- *
  * @retval (start_routine_ret) 0
+ *
+ * @note the reader is held back by the buffer pools (input buffers by the
+ *   coders, output buffers by the writer), but never waits on any one frame
 **/
 HOT
-START_ROUTINE_ABI
 static start_routine_ret
-encmt_io(struct MTArg_EncIO *const RESTRICT arg)
+encmt_reader(struct MTArg_EncIO *const RESTRICT arg)
 /*@globals	fileSystem,
 		internalState
 @*/
 /*@modifies	fileSystem,
 		internalState,
-		*arg->frames.navailable,
-		*arg->frames.post_encoder,
-		*arg->frames.ni32_perframe,
-		*arg->frames.encbuf,
-		arg->outfile.handle,
-		arg->infile.handle,
-		*arg->seektable,
-		*arg->estat_out
+		arg->frames.queue,
+		*arg->frames.frame,
+		arg->infile.handle
 @*/
 {
 	struct MTArg_EncIO_Frames *const RESTRICT  frames  = &arg->frames;
-	struct MTArg_IO_File      *const RESTRICT  outfile = &arg->outfile;
 	struct MTArg_IO_File      *const RESTRICT  infile  = &arg->infile;
 	const struct FileStats_EncMT *const RESTRICT fstat =  arg->fstat;
-	struct SeekTable *const RESTRICT         seektable =  arg->seektable;
 	/* * */
-	semaphore_p   *const RESTRICT nframes_avail =  frames->navailable;
-	semaphore_p   *const RESTRICT post_encoder  =  frames->post_encoder;
-	size_t        *const RESTRICT ni32_perframe =  frames->ni32_perframe;
-	struct EncBuf *const RESTRICT encbuf        =  frames->encbuf;
-	struct LibTTAr_CodecState_User *const RESTRICT user = frames->user;
-	int8_t        *const RESTRICT enc_retval    = frames->enc_retval;
+	struct EncFrame *const RESTRICT frame       =  frames->frame;
+	struct EncBuf   *const RESTRICT inbuf       =  frames->queue.in.buf;
 	/* * */
-	FILE       *const RESTRICT outfile_handle   = outfile->handle;
-	const char *const RESTRICT outfile_name     = outfile->name;
 	FILE       *const RESTRICT infile_handle    = infile->handle;
 	const char *const RESTRICT infile_name      = infile->name;
+	const uint8_t *const RESTRICT pcmmap        = arg->pcmmap;
 	/* * */
-	const unsigned int framequeue_len          = frames->nmemb;
+	const unsigned int reorder_len             = frames->nmemb;
+	const unsigned int ncoders                 = frames->ncoders;
 	const unsigned int nchan                   = fstat->nchan;
 	const enum LibTTAr_SampleBytes samplebytes = fstat->samplebytes;
 	const size_t nsamples_perframe             = fstat->nsamples_perframe;
 	const size_t decpcm_size                   = fstat->decpcm_size;
 	/* * */
-	struct EncStats estat = *arg->estat_out;
 	size_t readlen, nmemb_read;
 	size_t nsamples_flat_read_total = 0;
-	bool   start_writing  = false;
-	size_t nframes_read   = 0;
-	unsigned int idx = 0, last;
+	size_t nframes_read = 0;
+	/* a private copy, so the reader's writes to it stay off the cache
+	     lines that the other threads read the rest of *arg from
+	*/
+	struct FrameQueue queue = frames->queue;
+	struct EncFrame *entry;
+	unsigned int id, i;
 	union {	unsigned int u; } tmp;
 
-	goto loop0_entr;
+	goto loop_entr;
 	do {
-		/* read pcm from infile */
-		nmemb_read = fread(
-			encbuf[idx].pcmbuf, (size_t) samplebytes, readlen,
-			infile_handle
-		);
-		ni32_perframe[idx]        = nmemb_read;
+		/* wait for the writer to be done with the entry */
+		entry = &frame[nframes_read % reorder_len];
+		if ( nframes_read >= reorder_len ){
+			waitvar_wait(
+				&entry->seq,
+				FRAME_SEQ_WRITTEN(nframes_read - reorder_len)
+			);
+		}
+
+		/* get an output buffer */
+		entry->outbuf_id = bufpool_get(&queue.out);
+
+		if ( pcmmap != NULL ){
+			/* the coder reads the frame straight out of the
+			     mapping, so there is nothing to copy
+			*/
+			entry->inbuf_id = FRAME_INBUF_NONE;
+			entry->pcm      = &pcmmap[
+				nsamples_flat_read_total * samplebytes
+			];
+			nmemb_read      = readlen;
+		}
+		else {	/* get an input buffer, and read pcm from infile */
+			id              = bufpool_get(&queue.in);
+			entry->inbuf_id = id;
+			entry->pcm      = inbuf[id].pcmbuf;
+			nmemb_read      = fread(
+				inbuf[id].pcmbuf, (size_t) samplebytes,
+				readlen, infile_handle
+			);
+		}
+		entry->ni32_perframe      = nmemb_read;
 		nsamples_flat_read_total += nmemb_read;
 		if UNLIKELY ( nmemb_read != readlen ){
-			/* ???: not sure if the filechecks let us be here */
+			/* the end of a stream of unknown size, or a file
+			     shorter than its header says
+			*/
 			if UNLIKELY ( ferror(infile_handle) != 0 ){
 				error_sys(errno, "fread", infile_name);
 			}
-			else {	warning_tta("%s: frame %zu: truncated file",
+			else if ( decpcm_size != DECPCM_SIZE_UNKNOWN ){
+				warning_tta("%s: frame %zu: truncated file",
 					infile_name, nframes_read
 				);
-			}
+			} else{;}
 			/* forces readlen to 0 */
 			nsamples_flat_read_total = SIZE_MAX;
+			/* an empty frame would be taken for the end-of-stream
+			     one, so its buffers are given back instead
+			*/
+			if ( nmemb_read == 0 ){
+				assert(entry->inbuf_id != FRAME_INBUF_NONE);
+				freelist_push(&queue.out.fl, entry->outbuf_id);
+				freelist_push(&queue.in.fl, entry->inbuf_id);
+				break;
+			}
 		}
 
 		/* check for truncated sample */
 		tmp.u = (unsigned int) (nmemb_read % nchan);
 		if UNLIKELY ( tmp.u != 0 ){
+			assert(entry->inbuf_id != FRAME_INBUF_NONE);
 			warning_tta("%s: frame %zu: last sample truncated, "
 				"zero-padding", infile_name, nframes_read
 			);
 			tmp.u = enc_frame_zeropad(
-				encbuf[idx].pcmbuf, nmemb_read, tmp.u,
-				samplebytes, nchan
+				inbuf[entry->inbuf_id].pcmbuf, nmemb_read,
+				tmp.u, samplebytes, nchan
 			);
-			ni32_perframe[idx] += tmp.u;
+			entry->ni32_perframe += tmp.u;
 		}
 
 		/* make frame available */
-		semaphore_post(nframes_avail);
+		waitvar_set(&entry->seq, FRAME_SEQ_READY(nframes_read));
+		framequeue_tick(&queue);
 
 		nframes_read += 1u;
-		idx = pqueue_next(idx, framequeue_len);
-		/* all frame pcmbuf's are filled before writing out any TTA */
-		if ( ! start_writing ){
-			if ( idx != 0 ){
-				goto loop0_read;
-			}
-			start_writing = true;
-		}
-
-		/* wait for frame to finish encoding */
-		semaphore_wait(&post_encoder[idx]);
-
-		/* write tta to outfile */
-		enc_frame_write(
-			&encbuf[idx], seektable, &estat, &user[idx],
-			infile_name, outfile_handle, outfile_name, nchan,
-			enc_retval[idx]
-		);
-loop0_entr:
+loop_entr:
 		if ( (! g_flag.quiet) && (nframes_read % SPINNER_FREQ == 0) ){
 			errprint_spinner();
 		}
-loop0_read:
+
 		/* calc size of pcm to read from infile */
 		readlen = enc_readlen(
 			nsamples_perframe, nsamples_flat_read_total,
@@ -703,50 +1322,308 @@ loop0_read:
 		);
 	}
 	while ( readlen != 0 );
-	ni32_perframe[idx] = 0;
-	last = idx;
 
-	/* write the remaining frames */
-	if ( start_writing ){
-		goto loop1_not_tiny;
-	}
-	else {	/* unlock any uninitialized frames (tiny infile) */
-		do {	semaphore_post(nframes_avail);
-			idx = pqueue_next(idx, framequeue_len);
+	/* one end-of-stream frame per coder; the first one also stops the
+	     writer
+	*/
+	for ( i = 0; i < ncoders; ++i, ++nframes_read ){
+		entry = &frame[nframes_read % reorder_len];
+		if ( nframes_read >= reorder_len ){
+			waitvar_wait(
+				&entry->seq,
+				FRAME_SEQ_WRITTEN(nframes_read - reorder_len)
+			);
 		}
-		while ( idx != 0 );
+		entry->ni32_perframe = 0;
+		waitvar_set(&entry->seq, FRAME_SEQ_READY(nframes_read));
 	}
-	do {	/* wait for frame to finish encoding */
-		semaphore_wait(&post_encoder[idx]);
+
+	framequeue_writeback(&frames->queue, &queue);
+	return (start_routine_ret) 0;
+}
+
+/**@fn encmt_writer
+ * @brief the writer thread function for the multi-threaded encoder
+ *
+ * @param arg - state for the thread
+ *
+ * @retval (start_routine_ret) 0
+**/
+HOT
+static start_routine_ret
+encmt_writer(struct MTArg_EncIO *const RESTRICT arg)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*arg->frames.queue.nstall_writer,
+		*arg->frames.queue.out.fl.tail,
+		*arg->frames.queue.out.buf,
+		*arg->frames.frame,
+		arg->outfile,
+		arg->infile.bulk,
+		*arg->block,
+		*arg->seektable,
+		*arg->estat_out
+@*/
+{
+	struct MTArg_EncIO_Frames *const RESTRICT  frames  = &arg->frames;
+	struct MTArg_IO_File      *const RESTRICT  outfile = &arg->outfile;
+	struct SeekTable *const RESTRICT         seektable =  arg->seektable;
+	/* * */
+	struct FrameQueue *const RESTRICT queue     = &frames->queue;
+	/* * */
+	struct FreeList *const RESTRICT outlist     = &queue->out.fl;
+	size_t        *const RESTRICT nstall        =  queue->nstall_writer;
+	struct EncBuf *const RESTRICT encbuf        =  queue->out.buf;
+	struct EncFrame *const RESTRICT frame       =  frames->frame;
+	/* * */
+	FILE       *const RESTRICT outfile_handle   = outfile->handle;
+	const char *const RESTRICT outfile_name     = outfile->name;
+	struct BlockOut *const RESTRICT block       = arg->block;
+	const char *const RESTRICT infile_name      = arg->infile.name;
+	/* * */
+	const unsigned int reorder_len = frames->nmemb;
+	const unsigned int nchan       = arg->fstat->nchan;
+	const enum LibTTAr_SampleBytes samplebytes = arg->fstat->samplebytes;
+	const size_t footer_len        = arg->fstat->framefooter_len;
+	/* * */
+	struct EncStats estat = *arg->estat_out;
+	size_t ticket = 0;
+	struct EncFrame *entry;
+	/* * */
+	struct EncMT_Write slot[URING_DEPTH];
+	struct EncMT_Write *w;
+	const unsigned int nbatch_max = (reorder_len < ENCMT_WRITEV_NFRAME
+		? reorder_len : ENCMT_WRITEV_NFRAME
+	);
+	unsigned int nbatch, niov, i;
+
+	memset(slot, 0x00, sizeof slot);
+
+	for (;;){
+		/* wait for the next frame in order to finish encoding; what is
+		     in flight is reaped first, since the reader may be waiting
+		     on its buffers
+		*/
+		entry = &frame[ticket % reorder_len];
+		while ( (outfile->ring.nflight != 0)
+		       &&
+			(! waitvar_test(&entry->seq, FRAME_SEQ_DONE(ticket)))
+		){
+			(void) encmt_write_done(outfile, slot, outlist, true);
+		}
+		if ( ! waitvar_test(&entry->seq, FRAME_SEQ_DONE(ticket)) ){
+			(void) atomic_fetch_inc_z(nstall);
+		}
+		waitvar_wait(&entry->seq, FRAME_SEQ_DONE(ticket));
+		if ( entry->ni32_perframe == 0 ){
+			break;
+		}
+
+		/* a free slot */
+		while ( outfile->ring.nflight == URING_DEPTH ){
+			(void) encmt_write_done(outfile, slot, outlist, true);
+		}
+		for ( i = 0; slot[i].nbatch != 0; ++i ){;}
+		w = &slot[i];
+
+		/* take it and any frames after it that are already done */
+		nbatch = 0;
+		niov   = 0;
+		do {
+			enc_frame_account(
+				seektable, &estat, &entry->user, infile_name,
+				outfile_name, nchan, footer_len,
+				entry->enc_retval, entry->verified
+			);
+			niov += encbuf_iovec(
+				&w->iov[niov], &encbuf[entry->outbuf_id],
+				enc_frame_footer(
+					&w->footer[nbatch], &entry->user,
+					footer_len
+				),
+				footer_len
+			);
+			w->batch[nbatch++] = entry;
+			if ( nbatch == nbatch_max ){
+				break;
+			}
+			entry = &frame[(ticket + nbatch) % reorder_len];
+		}
+		while ( waitvar_test(
+				&entry->seq, FRAME_SEQ_DONE(ticket + nbatch)
+			)
+		       &&
+			(entry->ni32_perframe != 0)
+		);
+		w->nbatch    = nbatch;
+		w->niov      = niov;
+		w->iov_first = 0;
+		w->ticket    = ticket;
+		ticket      += nbatch;
+
+		/* the batch's PCM is done with, and its TTA is on its way */
+		bulkio_update(
+			&arg->infile.bulk, estat.nsamples_flat * samplebytes
+		);
+		bulkio_update(&outfile->bulk, estat.nbytes_encoded);
 
 		/* write tta to outfile */
-		enc_frame_write(
-			&encbuf[idx], seektable, &estat, &user[idx],
-			infile_name, outfile_handle, outfile_name, nchan,
-			enc_retval[idx]
+		if ( block != NULL ){
+			blockout_writev(
+				block, outfile_handle, outfile_name, w->iov,
+				(size_t) niov
+			);
+			encmt_write_release(w, outlist);
+			continue;
+		}
+		if ( ! outfile->async ){
+			if UNLIKELY ( ! file_writev(
+					outfile_handle, w->iov, (size_t) niov
+				)
+			){
+				error_sys(errno, "writev", outfile_name);
+			}
+			encmt_write_release(w, outlist);
+			continue;
+		}
+		w->len = 0;
+		for ( i = 0; i < niov; ++i ){
+			w->len += w->iov[i].iov_len;
+		}
+		w->offset        = outfile->offset;
+		outfile->offset += (off_t) w->len;
+		uring_writev(
+			&outfile->ring, outfile->fd, w->iov, niov, w->offset,
+			(uint64_t) (w - slot)
 		);
+		if UNLIKELY ( ! uring_submit(&outfile->ring) ){
+			error_sys(errno, "io_uring_enter", outfile_name);
+		}
+		while ( encmt_write_done(outfile, slot, outlist, false) ){;}
+	}
 
-		/* mark frame as done and make available */
-		ni32_perframe[idx] = 0;
-		semaphore_post(nframes_avail);
-loop1_not_tiny:
-		idx = pqueue_next(idx, framequeue_len);
+	while ( outfile->ring.nflight != 0 ){
+		(void) encmt_write_done(outfile, slot, outlist, true);
 	}
-	while ( idx != last );
+	bulkio_finish(&outfile->bulk);
+	bulkio_finish(&arg->infile.bulk);
 
 	*arg->estat_out = estat;
 	return (start_routine_ret) 0;
 }
 
+/**@fn encmt_write_release
+ * @brief gives the output buffers and the entries of a written batch back
+ *   to the reader, and frees its slot
+ *
+ * @param w       - the batch
+ * @param outlist - free list of the output buffers
+**/
+static void
+encmt_write_release(
+	struct EncMT_Write *const RESTRICT w,
+	struct FreeList *const RESTRICT outlist
+)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*w,
+		*outlist
+@*/
+{
+	unsigned int i;
+
+	for ( i = 0; i < w->nbatch; ++i ){
+		freelist_push(outlist, w->batch[i]->outbuf_id);
+		waitvar_set(
+			&w->batch[i]->seq, FRAME_SEQ_WRITTEN(w->ticket + i)
+		);
+	}
+	w->nbatch = 0;
+	return;
+}
+
+/**@fn encmt_write_done
+ * @brief takes a finished write off the ring, and releases its batch
+ *
+ * @param outfile - the writer's outfile
+ * @param slot    - the batches in flight
+ * @param outlist - free list of the output buffers
+ * @param wait    - whether to wait for one
+ *
+ * @return whether there was one
+ *
+ * @note a short write has the rest of it resubmitted
+**/
+static bool
+encmt_write_done(
+	struct MTArg_IO_File *const RESTRICT outfile,
+	struct EncMT_Write *const RESTRICT slot,
+	struct FreeList *const RESTRICT outlist, const bool wait
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*outfile,
+		slot[],
+		*outlist
+@*/
+{
+	struct EncMT_Write *w;
+	iovec_p *iov;
+	uint64_t tag;
+	int32_t  res;
+	size_t   nbytes;
+
+	if ( ! uring_reap(&outfile->ring, wait, &tag, &res) ){
+		if UNLIKELY ( wait ){
+			error_sys(errno, "io_uring_enter", outfile->name);
+		}
+		return false;
+	}
+	assert(tag < URING_DEPTH);
+	w = &slot[tag];
+	assert(w->nbatch != 0);
+
+	if UNLIKELY ( res <= 0 ){
+		error_sys((res < 0 ? -res : EIO), "writev", outfile->name);
+	}
+	if UNLIKELY ( (size_t) res < w->len ){
+		/* skip what got written */
+		nbytes     = (size_t) res;
+		w->len    -= nbytes;
+		w->offset += (off_t) nbytes;
+		while ( nbytes >= w->iov[w->iov_first].iov_len ){
+			nbytes -= w->iov[w->iov_first++].iov_len;
+		}
+		iov           = &w->iov[w->iov_first];
+		iov->iov_base = &((uint8_t *) iov->iov_base)[nbytes];
+		iov->iov_len -= nbytes;
+		uring_writev(
+			&outfile->ring, outfile->fd, iov,
+			w->niov - w->iov_first, w->offset, tag
+		);
+		if UNLIKELY ( ! uring_submit(&outfile->ring) ){
+			error_sys(errno, "io_uring_enter", outfile->name);
+		}
+		return true;
+	}
+
+	encmt_write_release(w, outlist);
+	return true;
+}
+
 /**@fn encmt_encoder_wrapper
- * @brief wraps the mt-encoder function. the thread detaches itself before
- *   returning
+ * @brief wraps the mt-encoder function for crew_add()
  *
  * @param arg - state for the thread
  *
  * @return whatever encmt_encoder() returns
 **/
-START_ROUTINE_ABI
 static start_routine_ret
 encmt_encoder_wrapper(void *const RESTRICT arg)
 /*@globals	fileSystem,
@@ -761,8 +1638,6 @@ encmt_encoder_wrapper(void *const RESTRICT arg)
 
 	retval = encmt_encoder(arg);
 
-	thread_detach_self();
-
 	return retval;
 }
 
@@ -781,61 +1656,80 @@ encmt_encoder(struct MTArg_Encoder *const RESTRICT arg)
 @*/
 /*@modifies	fileSystem,
 		internalState,
-		*arg->frames.navailable,
-		arg->frames.queue,
-		*arg->frames.post_encoder,
-		*arg->frames.encbuf
+		*arg->frames.ticket,
+		*arg->frames.nstall,
+		*arg->frames.bufs.id_next,
+		*arg->frames.freelist.tail,
+		*arg->frames.encbuf,
+		*arg->frames.frame
 @*/
 {
 	struct MTArg_Encoder_Frames  *const RESTRICT frames = &arg->frames;
 	const struct FileStats_EncMT *const RESTRICT fstat  =  arg->fstat;
 	/* * */
-	struct MTPQueue *const RESTRICT queue        = &frames->queue;
-	semaphore_p    *const RESTRICT nframes_avail =  frames->navailable;
-	semaphore_p    *const RESTRICT post_encoder  =  frames->post_encoder;
-	const size_t   *const RESTRICT ni32_perframe =  frames->ni32_perframe;
+	size_t         *const RESTRICT ticket_next   =  frames->ticket;
+	size_t         *const RESTRICT nstall        =  frames->nstall;
+	struct FreeList *const RESTRICT freelist     = &frames->freelist;
+	const struct EncBuf *const RESTRICT inbuf    =  frames->inbuf;
 	struct EncBuf  *const RESTRICT encbuf        =  frames->encbuf;
-	struct LibTTAr_CodecState_User *const RESTRICT user = frames->user;
-	int8_t         *const RESTRICT enc_retval    = frames->enc_retval;
+	struct EncFrame *const RESTRICT frame        =  frames->frame;
 	/* * */
+	const unsigned int reorder_len             = frames->nmemb;
 	const unsigned int nchan                   = fstat->nchan;
 	const enum LibTTAr_SampleBytes samplebytes = fstat->samplebytes;
 	/* * */
-	int32_t *i32buf = NULL;
-	struct LibTTAr_CodecState_Priv *priv = NULL;
-	unsigned int idx;
+	const struct CoderBufs *own;
+	int32_t *i32buf, *vfybuf;
+	uint8_t *vfypcm;
+	struct LibTTAr_CodecState_Priv *priv;
+	struct EncBuf *outbuf;
+	struct EncFrame *entry;
+	size_t ticket;
 
 	/* setup */
-	i32buf = calloc_check(encbuf[0].i32buf_len, sizeof *i32buf);
-	priv   = priv_alloc(nchan);
+	own    = coderbufs_take(&frames->bufs, inbuf, encbuf);
+	i32buf = own->i32buf;
+	priv   = own->priv;
+	vfybuf = own->vfybuf;
+	vfypcm = own->vfypcm;
 
 	goto loop_entr;
 	do {
 		/* encode frame */
-		encbuf[idx].i32buf = i32buf;
-		enc_retval[idx]    = (int8_t) enc_frame_encode(
-			&encbuf[idx], priv, &user[idx], samplebytes, nchan,
-			ni32_perframe[idx]
+		outbuf            = &encbuf[entry->outbuf_id];
+		outbuf->i32buf    = i32buf;
+		entry->enc_retval = (int8_t) enc_frame_encode(
+			outbuf, entry->pcm, priv, &entry->user, samplebytes,
+			nchan, entry->ni32_perframe
 		);
 
-		/* unlock frame */
-		semaphore_post(&post_encoder[idx]);
-loop_entr:
-		/* wait for a frame to be available */
-		semaphore_wait(nframes_avail);
+		/* decode it again while its samples are still at hand */
+		entry->verified = true;
+		if ( vfybuf != NULL ){
+			entry->verified = enc_frame_verify(
+				outbuf, entry->pcm, vfybuf, vfypcm, priv,
+				&entry->user, samplebytes, nchan
+			);
+		}
 
-		/* get frame id from encode queue */
-		spinlock_lock(&queue->lock);
-		{
-			idx = pqueue_pop(&queue->q);
+		/* give back the input buffer (if any), then unlock frame */
+		if ( entry->inbuf_id != FRAME_INBUF_NONE ){
+			freelist_push(freelist, entry->inbuf_id);
 		}
-		spinlock_unlock(&queue->lock);
+		waitvar_set(&entry->seq, FRAME_SEQ_DONE(ticket));
+loop_entr:
+		/* take the next ticket, and wait for its frame to be filled */
+		ticket = atomic_fetch_inc_z(ticket_next);
+		entry  = &frame[ticket % reorder_len];
+		if ( ! waitvar_test(&entry->seq, FRAME_SEQ_READY(ticket)) ){
+			(void) atomic_fetch_inc_z(nstall);
+		}
+		waitvar_wait(&entry->seq, FRAME_SEQ_READY(ticket));
 	}
-	while ( ni32_perframe[idx] != 0 );
+	while ( entry->ni32_perframe != 0 );
 
-	/* cleanup */
-	priv_free(priv);
-	free(i32buf);
+	/* pass the end-of-stream frame on (only the writer's matters) */
+	waitvar_set(&entry->seq, FRAME_SEQ_DONE(ticket));
 
 	return (start_routine_ret) 0;
 }
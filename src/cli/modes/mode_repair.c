@@ -0,0 +1,873 @@
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// modes/mode_repair.c                                                      //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2026, Shane Seelig                                         //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//      Rebuilds the seektable of a TTA1 file from its frames, for when the //
+// seektable is zeroed, corrupted, or cut off. A frame has no sync mark,    //
+// but the header says how many samples it holds, so trial-decoding that    //
+// many from where a frame should start gives where it ends; the CRC after  //
+// it says whether it really was one. The frames are walked like that from  //
+// the first. A damaged frame is stepped over by trying every byte after it //
+// as the start of the next frame, a block of candidates to a thread. The   //
+// candidates are tried nearest first to where the next frame should be,    //
+// one frame size on, as the ones further back can fall into step with the  //
+// damaged frame and decode up to the damage. Garbage is soon thrown out,   //
+// as it decodes to samples out of range. The frames are copied as is into  //
+// the repaired file, behind a new header and seektable; nothing is         //
+// re-encoded. A TTA2 file does not need any of that, as its frames can be  //
+// found by their footers (resync.c).                                       //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+#include <assert.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/types.h>
+
+#include "../../libttaR.h"
+
+#include "../affinity.h"
+#include "../alloc.h"
+#include "../autotune.h"
+#include "../byteswap.h"
+#include "../common.h"
+#include "../debug.h"
+#include "../formats.h"
+#include "../main.h"
+#include "../open.h"
+#include "../opts.h"
+#include "../system.h"
+
+#include "./arena.h"
+#include "./atomic.h"
+#include "./bufs.h"
+#include "./resync.h"
+#include "./threads.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/* suffix of a repaired file */
+#define REPAIR_SFX		".repaired.tta"
+
+/* number of samples per channel trial-decoded at a time; each chunk is
+     checked for samples out of range before the next one
+*/
+#ifndef REPAIR_PROBE_NSAMPLES
+#define REPAIR_PROBE_NSAMPLES	64u
+#endif
+
+/* number of candidate offsets a thread takes at a time */
+#ifndef REPAIR_SCAN_BLOCK
+#define REPAIR_SCAN_BLOCK	((size_t) 256u)
+#endif
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/* the frames of a file; offsets are from the first frame */
+struct RepairFile {
+	/*@temp@*/
+	const uint8_t			*data;
+	size_t				size;
+	size_t				ni32_perframe;
+	size_t				ni32_lastframe;
+	size_t				nframes;
+	size_t				safety_margin;
+	enum LibTTAr_SampleBytes	samplebytes;
+	unsigned int			nchan;
+	enum LibTTAr_Kernel		kernel;
+};
+
+/* a trial decoder; one per thread */
+struct RepairProbe {
+	struct Arena				arena;
+	struct DecBuf				decbuf;
+	/*@dependent@*/
+	struct LibTTAr_CodecState_Priv		*priv;
+};
+
+/* a scan for the good frame nearest to an offset; candidate 'j' is
+     'expect' + j/2 for even j, and 'expect' - (j+1)/2 for odd
+*/
+struct RepairScan {
+	/*@temp@*/
+	const struct RepairFile		*file;
+	size_t				ni32;	/* in the frame looked for */
+	size_t				expect;
+	size_t				start;
+	size_t				end;
+	size_t				ncand;
+	size_t				nblock;	/* next block to take      */
+	size_t				found;	/* SIZE_MAX until found    */
+};
+
+struct MTArg_Repair {
+	/*@temp@*/
+	struct RepairScan		*scan;
+	/*@temp@*/
+	struct RepairProbe		*probe;
+};
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+static void repair_file(struct OpenedFilesMember *RESTRICT, unsigned int)
+/*@globals	fileSystem,
+		internalState,
+		g_rm_on_sigint
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		g_rm_on_sigint
+@*/
+;
+
+#undef st
+static size_t repair_walk(
+	/*@out@*/ struct SeekTable *RESTRICT st,
+	const struct RepairFile *RESTRICT, struct RepairProbe *RESTRICT,
+	unsigned int, const char *RESTRICT
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*st
+@*/
+;
+
+static size_t repair_scan(
+	const struct RepairFile *RESTRICT, struct RepairProbe *RESTRICT,
+	unsigned int, size_t, size_t, size_t, size_t
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState
+@*/
+;
+
+#undef arg
+START_ROUTINE_ABI
+static start_routine_ret repair_scan_worker(struct MTArg_Repair *RESTRICT arg)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*arg->scan,
+		*arg->probe
+@*/
+;
+
+#undef probe
+HOT
+static size_t repair_probe(
+	struct RepairProbe *RESTRICT probe, const struct RepairFile *RESTRICT,
+	size_t, size_t
+)
+/*@modifies	*probe@*/
+;
+
+static void repair_write(
+	const struct SeekTable *RESTRICT, const struct RepairFile *RESTRICT,
+	size_t, size_t, const struct FileStats *RESTRICT, const char *RESTRICT
+)
+/*@globals	fileSystem,
+		internalState,
+		g_rm_on_sigint
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		g_rm_on_sigint
+@*/
+;
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/**@fn mode_repair
+ * @brief mode for rebuilding the seektables of TTA files
+ *
+ * @param optind - index of 'argv'
+ * @param argc   - argument count from main()
+ * @param argv   - argument vector from main()
+ *
+ * @return the number of warnings/errors
+**/
+BUILD NOINLINE int
+mode_repair(
+	const unsigned int optind, const unsigned int argc,
+	char *const *const argv
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState
+@*/
+{
+	struct OpenedFiles openedfiles;
+	size_t nerrors_file = 0;
+	unsigned int nthreads = (g_nthreads != 0
+		? g_nthreads : affinity_nthreads_default()
+	);
+	size_t i;
+	union {	int d; } result;
+
+	memset(&openedfiles, 0x00, sizeof openedfiles);
+
+	/* process opts/args */
+	nerrors_file = optargs_process(
+		&openedfiles, optind, argc, argv, &repair_optdict
+	);
+
+	/* get file stats */
+	for ( i = 0; i < openedfiles.nmemb; ++i ){
+		nerrors_file += filestats_get(
+			openedfiles.file[i], MODE_TEST
+		);
+	}
+
+	/* additional error check(s) */
+	if UNLIKELY (
+	     (openedfiles.nmemb > SIZE_C(1))
+	    &&
+	     (g_flag.outfile != NULL) && (! g_flag.outfile_is_dir)
+	){
+		warning_tta("multiple infiles, but outfile not a directory");
+	}
+	else if UNLIKELY ( openedfiles.nmemb == 0 ){
+		warning_tta("nothing to do");
+		nerrors_file += 1u;
+	} else{;}
+
+	/* exit if any errors */
+	if UNLIKELY ( nerrors_file != 0 ){
+		if ( nerrors_file > SIZE_C(255) ){
+			nerrors_file = SIZE_C(255);
+		}
+		exit((int) nerrors_file);
+	}
+
+	/* kernel choices from --autotune */
+	autotune_load();
+
+	/* repair each file */
+	if ( g_flag.threadmode == THREADMODE_SINGLE ){
+		nthreads = 1u;
+	}
+	for ( i = 0; i < openedfiles.nmemb; ++i ){
+		repair_file(openedfiles.file[i], nthreads);
+
+		result.d = fclose(openedfiles.file[i]->infile);
+		if UNLIKELY ( result.d != 0 ){
+			error_sys_nf(
+				errno, "fclose",
+				openedfiles.file[i]->infile_name
+			);
+		}
+		openedfiles.file[i]->infile = NULL;
+	}
+
+	/* cleanup */
+	openedfiles_close_free(&openedfiles);
+
+	return (int) g_nwarnings;
+}
+
+/**@fn repair_file
+ * @brief maps the frames of a file, walks them, and writes the repaired
+ *   file
+ *
+ * @param ofm      - the source file struct
+ * @param nthreads - number of threads for the scans
+**/
+static void
+repair_file(
+	struct OpenedFilesMember *const RESTRICT ofm,
+	const unsigned int nthreads
+)
+/*@globals	fileSystem,
+		internalState,
+		g_rm_on_sigint
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		g_rm_on_sigint
+@*/
+{
+	FILE *const RESTRICT   infile = ofm->infile;
+	const char *const infile_name = ofm->infile_name;
+	const struct FileStats *const RESTRICT fstat = &ofm->fstat;
+	/* a frame of noise can come out bigger than its PCM */
+	const size_t ttabuf_len_perchan = (size_t) (2u * TTABUF_LEN_FRAME(
+		fstat->buflen, fstat->nchan, fstat->samplebytes
+	));
+	/* * */
+	struct RepairFile file;
+	/*@only@*/ /*@null@*/
+	struct RepairProbe *probe;
+	struct SeekTable seektable;
+	struct FileMap map;
+	off_t data_off, size;
+	size_t nbytes, nsamples_perchan;
+	unsigned int i;
+	union {	enum FileCheck fc; } result;
+
+	/* the old seektable is only read past; its entries are not trusted */
+	file.nframes  = fstat->nsamples_enc + fstat->framelen - 1u;
+	file.nframes /= fstat->framelen;
+	result.fc = filecheck_tta_seektable(&seektable, file.nframes, infile);
+	seektable_free(&seektable);
+	switch ( result.fc ){
+	case FILECHECK_OK:
+		break;
+	case FILECHECK_CORRUPTED:
+		warning_tta("%s: corrupted seektable", infile_name);
+		break;
+	default:
+		error_filecheck(result.fc, errno, fstat, infile_name);
+		return;
+	}
+
+	/* map the frames */
+	data_off = ftello(infile);
+	if UNLIKELY (
+	     (data_off < 0) || (! file_regsize(infile, &size))
+	    ||
+	     (size <= data_off)
+	    ||
+	     (! file_map(
+		&map, infile, data_off, (size_t) (size - data_off), false
+	     ))
+	){
+		error_tta_nf("%s: no frames to map", infile_name);
+		return;
+	}
+	assert(map.data != NULL);
+
+	file.data           = map.data;
+	file.size           = (size_t) (size - data_off);
+	file.ni32_perframe  = fstat->buflen;
+	file.ni32_lastframe = (
+		fstat->nsamples_enc - ((file.nframes - 1u) * fstat->framelen)
+	) * fstat->nchan;
+	file.safety_margin  = libttaR_ttabuf_safety_margin(
+		fstat->samplebytes, (unsigned int) fstat->nchan
+	);
+	file.samplebytes    = fstat->samplebytes;
+	file.nchan          = (unsigned int) fstat->nchan;
+	file.kernel         = autotune_kernel(
+		MODE_DECODE, fstat->samplebytes, (unsigned int) fstat->nchan
+	);
+
+	/* TTA2 frames can be found by their footers */
+	if ( fstat->encfmt == xENCFMT_TTA2 ){
+		nbytes = tta2_resync(
+			&seektable, file.data, file.size, file.nframes,
+			(size_t) (2u * fstat->buflen * fstat->samplebytes),
+			nthreads, infile_name
+		);
+		probe = NULL;
+		goto write_repaired;
+	}
+
+	/* a trial decoder for each thread */
+	probe = calloc_check((size_t) nthreads, sizeof *probe);
+	for ( i = 0; i < nthreads; ++i ){
+		arena_init(&probe[i].arena,
+			  decbuf_arena_size(
+				fstat->buflen, ttabuf_len_perchan,
+				file.nchan, file.samplebytes,
+				CBM_SINGLE_THREADED
+			)
+			+ priv_arena_size(file.nchan)
+		);
+		decbuf_init(
+			&probe[i].decbuf, &probe[i].arena, fstat->buflen,
+			ttabuf_len_perchan, file.nchan,
+			file.samplebytes, CBM_SINGLE_THREADED
+		);
+		probe[i].priv = priv_arena_alloc(&probe[i].arena, file.nchan);
+	}
+
+	/* walk the frames */
+	nbytes = repair_walk(&seektable, &file, probe, nthreads, infile_name);
+write_repaired:
+	nsamples_perchan = 0;
+	if ( seektable.nmemb != 0 ){
+		nsamples_perchan = (seektable.nmemb == file.nframes
+			? fstat->nsamples_enc
+			: seektable.nmemb * fstat->framelen
+		);
+	}
+
+	/* write the repaired file */
+	if ( seektable.nmemb != 0 ){
+		repair_write(
+			&seektable, &file, nbytes, nsamples_perchan, fstat,
+			infile_name
+		);
+	}
+	else {	error_tta_nf("%s: no good frames", infile_name); }
+
+	/* cleanup */
+	if ( probe != NULL ){
+		for ( i = 0; i < nthreads; ++i ){
+			codecbuf_free(&probe[i].decbuf);
+			arena_free(&probe[i].arena);
+		}
+		free(probe);
+	}
+	seektable_free(&seektable);
+	file_unmap(&map);
+
+	return;
+}
+
+/**@fn repair_walk
+ * @brief walks the frames from the first, rebuilding the seektable
+ *
+ * @param st          - the new seektable
+ * @param file        - the frames
+ * @param probe       - a trial decoder for each thread
+ * @param nthreads    - number of threads for the scans
+ * @param infile_name - name of the source file (warnings)
+ *
+ * @return the size of the frames kept
+ *
+ * @note a damaged frame is kept as it is, as long as a good one is found
+ *   after it; the rest of the file after the last good frame is cut
+**/
+static size_t
+repair_walk(
+	/*@out@*/ struct SeekTable *const RESTRICT st,
+	const struct RepairFile *const RESTRICT file,
+	struct RepairProbe *const RESTRICT probe, const unsigned int nthreads,
+	const char *const RESTRICT infile_name
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*st
+@*/
+{
+	size_t pos = 0, framesize, next, ni32;
+	size_t framesize_last = file->size / file->nframes;
+	size_t i;
+
+	seektable_init(st, file->nframes);
+
+	for ( i = 0; i < file->nframes; ++i ){
+		ni32 = (i == file->nframes - 1u
+			? file->ni32_lastframe : file->ni32_perframe
+		);
+		framesize = repair_probe(&probe[0], file, pos, ni32);
+		if LIKELY ( framesize != 0 ){
+			seektable_add(st, framesize, infile_name);
+			pos           += framesize;
+			framesize_last = framesize;
+			continue;
+		}
+
+		/* damaged; look for the next frame after it */
+		next = SIZE_MAX;
+		if ( i + 1u < file->nframes ){
+			ni32 = (i + 1u == file->nframes - 1u
+				? file->ni32_lastframe : file->ni32_perframe
+			);
+			next = repair_scan(
+				file, probe, nthreads, ni32,
+				pos + framesize_last, pos + 1u, file->size
+			);
+		}
+		if ( next == SIZE_MAX ){
+			warning_tta("%s: frame %zu at byte %zu: damaged; "
+				"the file is cut there", infile_name, i, pos
+			);
+			break;
+		}
+		warning_tta("%s: frame %zu at byte %zu: damaged; resynced "
+			"at byte %zu", infile_name, i, pos, next
+		);
+		seektable_add(st, next - pos, infile_name);
+		pos = next;
+	}
+	return pos;
+}
+
+/**@fn repair_scan
+ * @brief finds the offset in a range nearest to 'expect' that a good frame
+ *   starts at, with the candidates split among the threads
+ *
+ * @param file     - the frames
+ * @param probe    - a trial decoder for each thread
+ * @param nthreads - number of threads
+ * @param ni32     - number of i32 in the frame looked for
+ * @param expect   - where the frame should be
+ * @param start    - first candidate
+ * @param end      - past the last candidate
+ *
+ * @return the offset, or SIZE_MAX if none
+**/
+static size_t
+repair_scan(
+	const struct RepairFile *const RESTRICT file,
+	struct RepairProbe *const RESTRICT probe, const unsigned int nthreads,
+	const size_t ni32, size_t expect, const size_t start, const size_t end
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState
+@*/
+{
+	struct RepairScan scan;
+	/*@only@*/
+	struct MTArg_Repair *arg;
+	/*@only@*/ /*@null@*/
+	thread_p *thread = NULL;
+	unsigned int i;
+
+	assert(start < end);
+
+	if ( expect < start ){
+		expect = start;
+	}
+	if ( expect >= end ){
+		expect = end - 1u;
+	}
+	scan.file   = file;
+	scan.ni32   = ni32;
+	scan.expect = expect;
+	scan.start  = start;
+	scan.end    = end;
+	scan.ncand  = 1u + (2u * (expect - start > end - 1u - expect
+		? expect - start : end - 1u - expect
+	));
+	scan.nblock = 0;
+	scan.found  = SIZE_MAX;
+
+	arg = malloc_check(nthreads * (sizeof *arg));
+	for ( i = 0; i < nthreads; ++i ){
+		arg[i].scan  = &scan;
+		arg[i].probe = &probe[i];
+	}
+	if ( nthreads > 1u ){
+		thread = malloc_check((nthreads - 1u) * (sizeof *thread));
+		for ( i = 1u; i < nthreads; ++i ){
+			thread_create(
+				&thread[i - 1u],
+				(start_routine_ret (*)(void *))
+					repair_scan_worker,
+				&arg[i]
+			);
+		}
+	}
+	(void) repair_scan_worker(&arg[0]);
+	if ( thread != NULL ){
+		for ( i = 1u; i < nthreads; ++i ){
+			thread_join(&thread[i - 1u]);
+		}
+		free(thread);
+	}
+	free(arg);
+
+	if ( scan.found == SIZE_MAX ){
+		return SIZE_MAX;
+	}
+	return ((scan.found & 0x1u) != 0
+		? expect - ((scan.found + 1u) / 2u) : expect + (scan.found / 2u)
+	);
+}
+
+/**@fn repair_scan_worker
+ * @brief tries blocks of candidates until the one a frame was found in,
+ *   or the last one
+ *
+ * @param arg - the scan, and the thread's trial decoder
+ *
+ * @return NULL
+ *
+ * @note the blocks are taken in order, and a thread only stops short of a
+ *   candidate after one before it was found, so the nearest good offset is
+ *   always the one found
+**/
+START_ROUTINE_ABI
+static start_routine_ret
+repair_scan_worker(struct MTArg_Repair *const RESTRICT arg)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*arg->scan,
+		*arg->probe
+@*/
+{
+	struct RepairScan *const RESTRICT scan = arg->scan;
+	const size_t nblocks = (
+		(scan->ncand + REPAIR_SCAN_BLOCK - 1u) / REPAIR_SCAN_BLOCK
+	);
+	/* * */
+	const size_t nback = scan->expect - scan->start;
+	const size_t nfwd  = scan->end - scan->expect;
+	/* * */
+	size_t block, j, j_end, off;
+
+	for ( block = atomic_fetch_inc_z(&scan->nblock); block < nblocks;
+	      block = atomic_fetch_inc_z(&scan->nblock)
+	){
+		j     = block * REPAIR_SCAN_BLOCK;
+		j_end = (scan->ncand - j > REPAIR_SCAN_BLOCK
+			? j + REPAIR_SCAN_BLOCK : scan->ncand
+		);
+		for ( ; j < j_end; ++j ){
+			if ( j >= atomic_load_z(&scan->found) ){
+				return NULL;
+			}
+
+			/* before or past the range */
+			if ( (j & 0x1u) != 0 ){
+				if ( (j + 1u) / 2u > nback ){
+					continue;
+				}
+				off = scan->expect - ((j + 1u) / 2u);
+			}
+			else {	if ( j / 2u >= nfwd ){
+					continue;
+				}
+				off = scan->expect + (j / 2u);
+			}
+
+			if ( repair_probe(
+				arg->probe, scan->file, off, scan->ni32
+			     ) != 0
+			){
+				atomic_min_z(&scan->found, j);
+				return NULL;
+			}
+		}
+	}
+	return NULL;
+}
+
+/**@fn repair_probe
+ * @brief trial-decodes a frame at an offset, and checks the CRC after it
+ *
+ * @param probe - the trial decoder
+ * @param file  - the frames
+ * @param off   - offset of the would-be frame
+ * @param ni32  - number of i32 in the frame
+ *
+ * @return the size of the frame with its CRC, or 0 if there is not a good
+ *   one there
+**/
+HOT
+static size_t
+repair_probe(
+	struct RepairProbe *const RESTRICT probe,
+	const struct RepairFile *const RESTRICT file, const size_t off,
+	const size_t ni32
+)
+/*@modifies	*probe@*/
+{
+	struct DecBuf *const RESTRICT decbuf = &probe->decbuf;
+	const size_t  avail     = file->size - off;
+	const size_t  ni32_sub  = REPAIR_PROBE_NSAMPLES * file->nchan;
+	const int32_t max_value = (int32_t) (
+		(UINT32_C(1) << ((8u * file->samplebytes) - 1u)) - 1u
+	);
+	/* * */
+	struct LibTTAr_CodecState_User user = LIBTTAr_CODECSTATE_USER_INIT;
+	struct LibTTAr_DecMisc misc;
+	enum LibTTAr_DecRetVal status;
+	const uint8_t *src;
+	size_t src_len, nbytes_tta_perframe, ni32_done;
+	uint32_t crc_read;	/* little-endian */
+	size_t i;
+
+	assert(off < file->size);
+
+	if ( avail <= sizeof crc_read ){
+		return 0;
+	}
+
+	/* straight out of the mapping, unless the safety margin would run
+	     past its end
+	*/
+	if ( avail >= decbuf->ttabuf_len ){
+		src                 = &file->data[off];
+		src_len             = avail;
+		nbytes_tta_perframe = avail - file->safety_margin;
+	}
+	else {	nbytes_tta_perframe = decbuf->ttabuf_len - file->safety_margin;
+		if ( nbytes_tta_perframe > avail ){
+			nbytes_tta_perframe = avail;
+		}
+		(void) memcpy(
+			decbuf->ttabuf, &file->data[off], nbytes_tta_perframe
+		);
+		memset(
+			&decbuf->ttabuf[nbytes_tta_perframe], 0x00,
+			decbuf->ttabuf_len - nbytes_tta_perframe
+		);
+		src     = decbuf->ttabuf;
+		src_len = decbuf->ttabuf_len;
+	}
+
+	misc.ni32_perframe       = ni32;
+	misc.nbytes_tta_perframe = nbytes_tta_perframe;
+	misc.samplebytes         = file->samplebytes;
+	misc.nchan               = file->nchan;
+
+	/* garbage soon decodes to samples out of range */
+	do {
+		ni32_done              = user.ni32_total;
+		misc.dest_len          = decbuf->i32buf_len - user.ni32_total;
+		misc.src_len           = src_len - user.nbytes_tta_total;
+		misc.ni32_target       = ni32 - user.ni32_total;
+		if ( misc.ni32_target > ni32_sub ){
+			misc.ni32_target = ni32_sub;
+		}
+		misc.nbytes_tta_target = (
+			nbytes_tta_perframe - user.nbytes_tta_total
+		);
+		status = libttaR_tta_decode_kernel(
+			&decbuf->i32buf[user.ni32_total],
+			&src[user.nbytes_tta_total], probe->priv, &user, &misc,
+			file->kernel
+		);
+		for ( i = ni32_done; i < user.ni32_total; ++i ){
+			if ( (decbuf->i32buf[i] > max_value)
+			    ||
+			     (decbuf->i32buf[i] < -max_value - 1)
+			){
+				return 0;
+			}
+		}
+	}
+	while ( status == LIBTTAr_DRV_OK_AGAIN );
+
+	/* it ran out of bytes first, or there is no room for the CRC */
+	if ( (user.ni32_total != ni32)
+	    ||
+	     (user.nbytes_tta_total > avail - sizeof crc_read)
+	){
+		return 0;
+	}
+
+	memcpy(&crc_read, &file->data[off + user.nbytes_tta_total],
+		sizeof crc_read
+	);
+	if ( user.crc != byteswap_letoh_u32(crc_read) ){
+		return 0;
+	}
+	return user.nbytes_tta_total + sizeof crc_read;
+}
+
+/**@fn repair_write
+ * @brief writes the repaired file: a new header and seektable, then the
+ *   frames as they are
+ *
+ * @param st               - the new seektable
+ * @param file             - the frames
+ * @param nbytes           - size of the frames kept
+ * @param nsamples_perchan - number of samples per channel kept
+ * @param fstat            - bloated file stats struct
+ * @param infile_name      - name of the source file
+**/
+static void
+repair_write(
+	const struct SeekTable *const RESTRICT st,
+	const struct RepairFile *const RESTRICT file, const size_t nbytes,
+	const size_t nsamples_perchan,
+	const struct FileStats *const RESTRICT fstat,
+	const char *const RESTRICT infile_name
+)
+/*@globals	fileSystem,
+		internalState,
+		g_rm_on_sigint
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		g_rm_on_sigint
+@*/
+{
+	char *const RESTRICT outfile_name = get_outfile_name(
+		infile_name, REPAIR_SFX
+	);
+	/* * */
+	FILE *RESTRICT outfile;
+	struct SeekTable st_out = *st;
+	union {	size_t	z;
+		int	d;
+	} result;
+	union {	size_t z; } tmp;
+
+	if UNLIKELY ( strcmp(outfile_name, infile_name) == 0 ){
+		error_tta_nf("%s: would be written over itself", infile_name);
+		free(outfile_name);
+		return;
+	}
+
+	outfile = fopen_check(outfile_name, "wb", FATAL);
+	if UNLIKELY ( outfile == NULL ){
+		error_sys(errno, "fopen", outfile_name);
+	}
+	assert(outfile != NULL);
+	g_rm_on_sigint = outfile_name;
+
+	/* header + seektable + st-crc */
+	tmp.z = (st_out.nmemb + 1u) * sizeof(uint32_t);
+	if ( fstat->encfmt == xENCFMT_TTA2 ){
+		st_out.off = write_tta2_header(
+			outfile, nsamples_perchan,
+			sizeof(struct TTA2SeekTableHeader) + tmp.z + nbytes,
+			fstat, outfile_name
+		);
+	}
+	else {	st_out.off = write_tta1_header(
+			outfile, nsamples_perchan, fstat, outfile_name
+		);
+	}
+	write_tta_seektable(outfile, &st_out, outfile_name);
+
+	/* frames */
+	result.d = fseeko(outfile, st_out.off + (off_t) tmp.z, SEEK_SET);
+	if UNLIKELY ( result.d != 0 ){
+		error_sys(errno, "fseeko", outfile_name);
+	}
+	result.z = fwrite(file->data, SIZE_C(1), nbytes, outfile);
+	if UNLIKELY ( result.z != nbytes ){
+		error_sys(errno, "fwrite", outfile_name);
+	}
+
+	result.d = fclose(outfile);
+	if UNLIKELY ( result.d != 0 ){
+		error_sys_nf(errno, "fclose", outfile_name);
+	}
+	g_rm_on_sigint = NULL;
+
+	if ( ! g_flag.quiet ){
+		(void) fprintf(stderr, "%s: %zu of %zu frames => %s\n",
+			infile_name, st->nmemb, file->nframes, outfile_name
+		);
+	}
+
+	free(outfile_name);
+	return;
+}
+
+/* EOF //////////////////////////////////////////////////////////////////// */
@@ -0,0 +1,442 @@
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// modes/mode_test.c                                                        //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2026, Shane Seelig                                         //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//      An integrity check that does not decode. The header and seektable   //
+// CRCs are checked while opening, and each frame's CRC covers its encoded  //
+// bytes, so a file is tested by walking the seektable and summing every    //
+// frame. A file is mapped if it can be, else it is read frame by frame.    //
+// The threads take whole files off of a shared counter.                    //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+#include <assert.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/types.h>
+
+#include "../../libttaR.h"
+
+#include "../affinity.h"
+#include "../alloc.h"
+#include "../byteswap.h"
+#include "../cli.h"
+#include "../common.h"
+#include "../debug.h"
+#include "../formats.h"
+#include "../main.h"
+#include "../open.h"
+#include "../opts.h"
+#include "../system.h"
+
+#include "./atomic.h"
+#include "./bulkio.h"
+#include "./threads.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+struct MTArg_Test {
+	/*@temp@*/
+	const struct OpenedFiles	*openedfiles;
+	/*@temp@*/
+	size_t				*next;	/* next file to take */
+};
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#undef arg
+START_ROUTINE_ABI
+static start_routine_ret test_worker(struct MTArg_Test *RESTRICT arg)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*arg->next
+@*/
+;
+
+static bool test_file(struct OpenedFilesMember *RESTRICT)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState
+@*/
+;
+
+#undef infile
+static bool test_frames(
+	const struct SeekTable *RESTRICT, const struct FileStats *RESTRICT,
+	FILE *RESTRICT infile, const char *RESTRICT
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		infile
+@*/
+;
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/**@fn mode_test
+ * @brief mode for testing the CRCs of TTA files without decoding them
+ *
+ * @param optind - index of 'argv'
+ * @param argc   - argument count from main()
+ * @param argv   - argument vector from main()
+ *
+ * @return the number of warnings/errors
+**/
+BUILD NOINLINE int
+mode_test(
+	const unsigned int optind, const unsigned int argc,
+	char *const *const argv
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState
+@*/
+{
+	struct OpenedFiles openedfiles;
+	unsigned int nthreads = (g_nthreads != 0
+		? g_nthreads : affinity_nthreads_default()
+	);
+	struct MTArg_Test arg;
+	size_t next = 0;
+	/*@only@*/ /*@null@*/
+	thread_p *thread = NULL;
+	timestamp_p ts_start, ts_finish;
+	size_t i;
+	union {	int d; } result;
+
+	memset(&openedfiles, 0x00, sizeof openedfiles);
+
+	timestamp_get(&ts_start);
+
+	/* process opts/args */
+	(void) optargs_process(
+		&openedfiles, optind, argc, argv, &test_optdict
+	);
+	if UNLIKELY ( openedfiles.nmemb == 0 ){
+		warning_tta("nothing to do");
+		exit((int) g_nwarnings);
+	}
+
+	/* check the headers; a bad file is reported and skipped, so the rest
+	     still get tested
+	*/
+	for ( i = 0; i < openedfiles.nmemb; ++i ){
+		if ( (filestats_get(openedfiles.file[i], MODE_TEST) != 0)
+		    &&
+		     (openedfiles.file[i]->infile != NULL)
+		){
+			result.d = fclose(openedfiles.file[i]->infile);
+			if UNLIKELY ( result.d != 0 ){
+				error_sys_nf(
+					errno, "fclose",
+					openedfiles.file[i]->infile_name
+				);
+			}
+			openedfiles.file[i]->infile = NULL;
+		}
+	}
+
+	/* test each file */
+	if ( g_flag.threadmode == THREADMODE_SINGLE ){
+		nthreads = 1u;
+	}
+	if ( (size_t) nthreads > openedfiles.nmemb ){
+		nthreads = (unsigned int) openedfiles.nmemb;
+	}
+	arg.openedfiles = &openedfiles;
+	arg.next        = &next;
+	if ( nthreads > 1u ){
+		thread = malloc_check((nthreads - 1u) * (sizeof *thread));
+		for ( i = 0; i < (size_t) (nthreads - 1u); ++i ){
+			thread_create(
+				&thread[i],
+				(start_routine_ret (*)(void *)) test_worker,
+				&arg
+			);
+		}
+	}
+	(void) test_worker(&arg);
+	if ( thread != NULL ){
+		for ( i = 0; i < (size_t) (nthreads - 1u); ++i ){
+			thread_join(&thread[i]);
+		}
+		free(thread);
+	}
+
+	/* print multifile stats */
+	if ( (! g_flag.quiet) && (openedfiles.nmemb > SIZE_C(1)) ){
+		timestamp_get(&ts_finish);
+		errprint_runtime(
+			timestamp_diff(&ts_start, &ts_finish),
+			openedfiles.nmemb, MODE_TEST
+		);
+	}
+
+	/* cleanup */
+	openedfiles_close_free(&openedfiles);
+
+	return (int) g_nwarnings;
+}
+
+/**@fn test_worker
+ * @brief tests files until there are none left
+ *
+ * @param arg - the opened files and the shared counter
+ *
+ * @return NULL
+**/
+START_ROUTINE_ABI
+static start_routine_ret
+test_worker(struct MTArg_Test *const RESTRICT arg)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*arg->next
+@*/
+{
+	const struct OpenedFiles *const RESTRICT of = arg->openedfiles;
+	/* * */
+	struct OpenedFilesMember *RESTRICT ofm;
+	size_t i;
+	union {	int d; } result;
+
+	for ( i = atomic_fetch_inc_z(arg->next); i < of->nmemb;
+	      i = atomic_fetch_inc_z(arg->next)
+	){
+		ofm = of->file[i];
+		if ( ofm->infile == NULL ){
+			continue;	/* already reported */
+		}
+
+		if ( test_file(ofm) && (! g_flag.quiet) ){
+			(void) fprintf(stderr, "%s: OK\n", ofm->infile_name);
+		}
+
+		/* each file is only ever taken by one thread */
+		result.d = fclose(ofm->infile);
+		if UNLIKELY ( result.d != 0 ){
+			error_sys_nf(errno, "fclose", ofm->infile_name);
+		}
+		ofm->infile = NULL;
+	}
+	return NULL;
+}
+
+/**@fn test_file
+ * @brief tests the seektable and the frames of a file
+ *
+ * @param ofm - the source file struct
+ *
+ * @return true if the file is good
+**/
+static bool
+test_file(struct OpenedFilesMember *const RESTRICT ofm)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState
+@*/
+{
+	FILE *const RESTRICT   infile = ofm->infile;
+	const char *const infile_name = ofm->infile_name;
+	const struct FileStats *const RESTRICT fstat = &ofm->fstat;
+	/* * */
+	bool retval = true;
+	struct SeekTable seektable;
+	union {	enum FileCheck fc; } result;
+	union {	size_t z; } tmp;
+
+	/* seek to seektable
+		- already there for TTA1/TTA2
+	*/
+
+	/* copy/check seektable */
+	tmp.z  = fstat->nsamples_enc + fstat->framelen - 1u;
+	tmp.z /= fstat->framelen;
+	result.fc = filecheck_tta_seektable(&seektable, tmp.z, infile);
+	if UNLIKELY ( result.fc != FILECHECK_OK ){
+		if ( result.fc != FILECHECK_CORRUPTED ){
+			error_filecheck(result.fc, errno, fstat, infile_name);
+			seektable_free(&seektable);
+			return false;
+		}
+		/* the frames are still walked; a bad entry throws off the
+		     ones after it, which then show up as bad CRCs
+		*/
+		error_tta_nf("%s: corrupted seektable", infile_name);
+		retval = false;
+	}
+
+	/* test frames */
+	if ( ! test_frames(&seektable, fstat, infile, infile_name) ){
+		retval = false;
+	}
+
+	seektable_free(&seektable);
+	return retval;
+}
+
+/**@fn test_frames
+ * @brief checks the CRC of every frame in the seektable
+ *
+ * @param seektable   - the seektable
+ * @param fstat       - bloated file stats struct
+ * @param infile      - source file; at the first frame
+ * @param infile_name - name of the source file (errors)
+ *
+ * @return true if every frame is good
+**/
+HOT
+static bool
+test_frames(
+	const struct SeekTable *const RESTRICT seektable,
+	const struct FileStats *const RESTRICT fstat,
+	FILE *const RESTRICT infile, const char *const RESTRICT infile_name
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		infile
+@*/
+{
+	const size_t footer_len = TTA_FRAMEFOOTER_LEN(fstat->encfmt);
+	/* * */
+	bool retval = true;
+	struct FileMap map;
+	struct BulkIO bulk_in;
+	off_t data_off, size;
+	size_t pos = 0, map_size = 0, framesize, nbytes_read;
+	const uint8_t *frame;
+	/*@only@*/ /*@null@*/
+	uint8_t *buf = NULL;
+	size_t buflen = 0;
+	uint32_t crc_read;	/* little-endian */
+	size_t i;
+
+	data_off = ftello(infile);
+	if ( data_off < 0 ){
+		/* a pipe; it has to start with the header */
+		data_off = (off_t) (	/* header + seektable + st-crc */
+			  (fstat->encfmt == xENCFMT_TTA2
+				?   sizeof(struct TTA2Header)
+				  + sizeof(struct TTA2SeekTableHeader)
+				: sizeof(struct TTA1Header)
+			  )
+			+ (seektable->nmemb * (sizeof *seektable->table))
+			+ sizeof(uint32_t)
+		);
+	}
+
+	/* map the frames, if it can be */
+	map.data = NULL;
+	if ( file_regsize(infile, &size) && (size > data_off) ){
+		map_size = (size_t) (size - data_off);
+		if ( ! file_map(&map, infile, data_off, map_size, false) ){
+			map_size = 0;
+		}
+	}
+	bulkio_init(&bulk_in, infile, false, map.data, g_flag.bulk_io);
+
+	for ( i = 0; i < seektable->nmemb; ++i ){
+		framesize = (size_t) byteswap_letoh_u32(seektable->table[i]);
+		if UNLIKELY ( framesize <= footer_len ){
+			error_tta_nf(
+				"%s: frame %zu: malformed seektable entry",
+				infile_name, i
+			);
+			retval = false;
+			break;
+		}
+
+		/* get the frame */
+		if ( map.data != NULL ){
+			if UNLIKELY ( framesize > map_size - pos ){
+				goto loop_truncated;
+			}
+			frame = &map.data[pos];
+		}
+		else {	if ( framesize > buflen ){
+				buf    = realloc_check(buf, framesize);
+				buflen = framesize;
+			}
+			assert(buf != NULL);
+			nbytes_read = fread(buf, SIZE_C(1), framesize, infile);
+			if UNLIKELY ( nbytes_read != framesize ){
+				if UNLIKELY ( ferror(infile) != 0 ){
+					error_sys_nf(
+						errno, "fread", infile_name
+					);
+					retval = false;
+					break;
+				}
+loop_truncated:
+				error_tta_nf("%s: frame %zu at byte %" PRIdMAX
+					": truncated file", infile_name, i,
+					(intmax_t) (data_off + (off_t) pos)
+				);
+				retval = false;
+				break;
+			}
+			frame = buf;
+		}
+
+		/* check frame CRC; the footer ends with it */
+		memcpy(&crc_read, &frame[framesize - (sizeof crc_read)],
+			sizeof crc_read
+		);
+		framesize -= footer_len;
+		if UNLIKELY (
+		     libttaR_crc32(frame, framesize)
+		    !=
+		     byteswap_letoh_u32(crc_read)
+		){
+			error_tta_nf("%s: frame %zu at byte %" PRIdMAX
+				": bad CRC", infile_name, i,
+				(intmax_t) (data_off + (off_t) pos)
+			);
+			retval = false;
+		}
+		pos += framesize + footer_len;
+		bulkio_update(&bulk_in, pos);
+	}
+
+	/* cleanup */
+	bulkio_finish(&bulk_in);
+	if ( map.data != NULL ){
+		file_unmap(&map);
+	}
+	free(buf);
+
+	return retval;
+}
+
+/* EOF //////////////////////////////////////////////////////////////////// */
@@ -4,13 +4,19 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
 
-#include <stdlib.h>
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <sys/types.h>
 
 #include "../../libttaR.h"
 
@@ -18,81 +24,204 @@
 #include "../common.h"
 #include "../debug.h"
 #include "../formats.h"
+#include "../system.h"
 
 #include "./align.h"
+#include "./arena.h"
+#include "./atomic.h"
+#include "./bufs.h"
+#include "./framequeue.h"
 #include "./mt-struct.h"
-#include "./pqueue.h"
 #include "./threads.h"
+#include "./uring.h"
 
 /* //////////////////////////////////////////////////////////////////////// */
 
+CONST
+static unsigned int framequeue_len_max(
+	unsigned int, size_t, enum LibTTAr_SampleBytes
+)
+/*@*/
+;
+
 #undef io
+#undef bufs
 static void encmt_state_init_allocs(
-	/*@out@*/ struct MTArg_EncIO *RESTRICT io, size_t
+	/*@out@*/ struct MTArg_EncIO *RESTRICT io,
+	/*@out@*/ struct MTArg_Coder_Bufs *RESTRICT bufs, size_t, size_t,
+	size_t, size_t
 )
 /*@globals	fileSystem,
 		internalState
 @*/
 /*@modifies	fileSystem,
 		internalState,
-		io->frames.navailable,
-		io->frames.post_encoder,
-		io->frames.ni32_perframe,
-		io->frames.encbuf,
-		io->frames.user
+		io->frames.arena,
+		io->frames.ticket,
+		io->frames.queue.nstall_coder,
+		io->frames.queue.nstall_writer,
+		io->frames.queue.in.fl.tail,
+		io->frames.queue.in.fl.cell,
+		io->frames.queue.in.spare,
+		io->frames.queue.in.buf,
+		io->frames.queue.out.fl.tail,
+		io->frames.queue.out.fl.cell,
+		io->frames.queue.out.spare,
+		io->frames.queue.out.buf,
+		io->frames.frame,
+		bufs->id_next,
+		bufs->coder
 @*/
-/*@allocates	io->frames.navailable@*/
+/*@allocates	io->frames.arena.base@*/
 ;
 
 #undef io
+#undef bufs
 static void decmt_state_init_allocs(
-	/*@out@*/ struct MTArg_DecIO *RESTRICT io, size_t
+	/*@out@*/ struct MTArg_DecIO *RESTRICT io,
+	/*@out@*/ struct MTArg_Coder_Bufs *RESTRICT bufs, size_t, size_t,
+	size_t, size_t
 )
 /*@globals	fileSystem,
 		internalState
 @*/
 /*@modifies	fileSystem,
 		internalState,
-		io->frames.navailable,
-		io->frames.post_decoder,
-		io->frames.ni32_perframe,
-		io->frames.nbytes_tta_perframe,
-		io->frames.decbuf,
-		io->frames.user,
-		io->frames.nsamples_flat_2pad,
-		io->frames.dec_retval,
-		io->frames.crc_read
+		io->frames.arena,
+		io->frames.ticket,
+		io->frames.queue.nstall_coder,
+		io->frames.queue.nstall_writer,
+		io->frames.queue.in.fl.tail,
+		io->frames.queue.in.fl.cell,
+		io->frames.queue.in.spare,
+		io->frames.queue.in.buf,
+		io->frames.queue.out.fl.tail,
+		io->frames.queue.out.fl.cell,
+		io->frames.queue.out.spare,
+		io->frames.queue.out.buf,
+		io->frames.frame,
+		bufs->id_next,
+		bufs->coder
+@*/
+/*@allocates	io->frames.arena.base@*/
+;
+
+#undef ring
+static bool decmt_ring_init(
+	/*@out@*/ struct URing *RESTRICT ring, const struct Arena *RESTRICT
+)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*ring
 @*/
-/*@allocates	io->frames.navailable@*/
 ;
 
 /* //////////////////////////////////////////////////////////////////////// */
 
+/**@fn framequeue_len_max
+ * @brief calculates the max number of buffers in either pool
+ *
+ * @param nthreads    - number of coder threads
+ * @param i32buf_len  - length of the i32buf
+ * @param samplebytes - number of bytes per PCM sample
+ *
+ * @return the max number of buffers
+ *
+ * @note a TTA frame is about the size of its PCM, so each buffer is counted
+ *   as the size of a frame of PCM
+**/
+CONST
+static unsigned int
+framequeue_len_max(
+	const unsigned int nthreads, const size_t i32buf_len,
+	const enum LibTTAr_SampleBytes samplebytes
+)
+/*@*/
+{
+	const size_t bufsize = i32buf_len * samplebytes;
+	size_t retval;
+
+	assert(bufsize != 0);
+
+	retval = FRAMEQUEUE_MEMBUDGET / (2u * bufsize);
+	if ( retval > (size_t) FRAMEQUEUE_LEN_MAX(nthreads) ){
+		retval = (size_t) FRAMEQUEUE_LEN_MAX(nthreads);
+	}
+	if ( retval < (size_t) FRAMEQUEUE_LEN_MIN(nthreads) ){
+		retval = (size_t) FRAMEQUEUE_LEN_MIN(nthreads);
+	}
+
+	return (unsigned int) retval;
+}
+
+/**@fn coderbufs_take
+ * @brief takes a coder thread's own buffers, and faults them in along with
+ *   its share of the pools' starting buffers
+ *
+ * @param arg    - the coders' buffers struct
+ * @param inbuf  - input buffer pool
+ * @param outbuf - output buffer pool
+ *
+ * @return the coder's own buffers
+ *
+ * @note call once per file at the start of each coder
+**/
+BUILD const struct CoderBufs *
+coderbufs_take(
+	const struct MTArg_Coder_Bufs *const RESTRICT arg,
+	const struct CodecBuf *const RESTRICT inbuf,
+	const struct CodecBuf *const RESTRICT outbuf
+)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*arg->id_next
+@*/
+{
+	const unsigned int id = (unsigned int) atomic_fetch_inc_z(
+		arg->id_next
+	);
+	const struct CoderBufs *const RESTRICT own = &arg->coder[id];
+	unsigned int i;
+
+	assert(id < arg->ncoders);
+
+	if ( ! arg->prefault ){
+		return own;
+	}
+	(void) pages_populate(own->i32buf, own->size);
+	for ( i = id; i < arg->depth_in; i += arg->ncoders ){
+		codecbuf_prefault(&inbuf[i]);
+	}
+	for ( i = id; i < arg->depth_out; i += arg->ncoders ){
+		codecbuf_prefault(&outbuf[i]);
+	}
+	return own;
+}
+
+/* ======================================================================== */
+
 /**@fn encmt_state_init
  * @brief initializes the multi-threaded encoder state structs
  *
- * @param io             - state struct for the io thread
- * @param encoder        - state struct for the encoder threads
- * @param framequeue_len - length of the framequeue
- * @param i32buf_len     - length of the encbuf->i32buf
- * @param outfile        - destination file
- * @param outfile_name   - name of the destination file (warnings/errors)
- * @param infile         - source file
- * @param infile_name    - name of the source file (warnings/errors)
- * @param seektable      - TTA seektable struct
- * @param estat_out      - encode stats return struct
- * @param fstat          - compacted file stats struct
+ * @param io            - state struct for the reader and writer threads
+ * @param encoder       - state struct for the encoder threads
+ * @param nthreads      - number of encoder threads
+ * @param waitvar_nspin - number of polls before a frame wait blocks
+ * @param i32buf_len    - length of the encbuf->i32buf
+ * @param fstat         - compacted file stats struct; only its nchan and
+ *   samplebytes are used here, but the pointer is kept
+ * @param verify        - whether each coder gets a vfybuf and a vfypcm
+ *   (--verify)
+ *
+ * @note the files are set with encmt_state_files()
 **/
 BUILD void
 encmt_state_init(
 	/*@out@*/ struct MTArg_EncIO *const RESTRICT io,
 	/*@out@*/ struct MTArg_Encoder *const RESTRICT encoder,
-	const unsigned int framequeue_len, const size_t i32buf_len,
-	FILE *const RESTRICT outfile, const char *const outfile_name,
-	FILE *const RESTRICT infile, const char *const infile_name,
-	const struct SeekTable *const RESTRICT seektable,
-	const struct EncStats *const RESTRICT estat_out,
-	const struct FileStats_EncMT *const RESTRICT fstat
+	const unsigned int nthreads, const unsigned int waitvar_nspin,
+	const size_t i32buf_len,
+	const struct FileStats_EncMT *const RESTRICT fstat, const bool verify
 )
 /*@globals	fileSystem,
 		internalState
@@ -100,61 +229,124 @@ encmt_state_init(
 /*@modifies	fileSystem,
 		internalState,
 		*io,
-		*io->frames.navailable,
-		io->frames.post_encoder[],
-		*encoder,
-		encoder->frames.queue.lock
+		*io->frames.ticket,
+		io->frames.frame[],
+		*encoder
 @*/
-/*@allocates	io->frames.navailable,
-		io->frames.encbuf[].pcmbuf,
-		io->frames.encbuf[].ttabuf
+/*@allocates	io->frames.arena.base,
+		io->frames.queue.in.buf[].ttabuf,
+		io->frames.queue.out.buf[].ttabuf
 @*/
 {
+	const unsigned int len_in  = FRAMEQUEUE_LEN(nthreads);
+	const unsigned int len_out = REORDER_LEN(nthreads);
+	const unsigned int len_max = framequeue_len_max(
+		nthreads, i32buf_len, fstat->samplebytes
+	);
+	const unsigned int depth_in  = (len_in  < len_max ? len_in  : len_max);
+	const unsigned int depth_out = (len_out < len_max ? len_out : len_max);
+	const size_t ttabuf_len = TTABUF_LEN_FRAME(
+		i32buf_len, fstat->nchan, fstat->samplebytes
+	);
+	const size_t i32buf_size = i32buf_len * (sizeof(int32_t));
+	const size_t pcmbuf_size = i32buf_len * (size_t) fstat->samplebytes;
+	const size_t vfybuf_size = (verify
+		? ARENA_SIZE(i32buf_size) + ARENA_SIZE(pcmbuf_size) : 0
+	);
+	/* * */
+	struct Arena *const RESTRICT arena = &io->frames.arena;
+	struct MTArg_Coder_Bufs *const RESTRICT bufs = &encoder->frames.bufs;
+	size_t bufs_size;
 	unsigned int i;
 
 	/* base allocations */
-	encmt_state_init_allocs(io, (size_t) framequeue_len);
+	bufs_size  = len_max * encbuf_arena_size(
+		i32buf_len, ttabuf_len, fstat->nchan, fstat->samplebytes,
+		CBM_MULTI_THREADED_INPUT
+	);
+	bufs_size += len_max * encbuf_arena_size(
+		i32buf_len, ttabuf_len, fstat->nchan, fstat->samplebytes,
+		CBM_MULTI_THREADED_OUTPUT
+	);
+	bufs_size += nthreads * (
+		ARENA_SIZE(i32buf_size) + priv_arena_size(fstat->nchan)
+		+ vfybuf_size
+	);
+	encmt_state_init_allocs(
+		io, bufs, (size_t) len_max, (size_t) len_max,
+		(size_t) nthreads, bufs_size
+	);
 
-	/* io->frames */
-	io->frames.nmemb	= framequeue_len;
-	/* * */
-	semaphore_init(io->frames.navailable, 0);
-	/* * */
-	for ( i = 0; i < framequeue_len; ++i ){
-		semaphore_init(&io->frames.post_encoder[i], 0);
+	/* buffers; the pools' first, then each coder's */
+	for ( i = 0; i < len_max; ++i ){
+		encbuf_init(
+			&io->frames.queue.in.buf[i], arena, i32buf_len,
+			ttabuf_len, fstat->nchan, fstat->samplebytes,
+			CBM_MULTI_THREADED_INPUT
+		);
 	}
-	for ( i = 0; i < framequeue_len; ++i ){
+	for ( i = 0; i < len_max; ++i ){
 		encbuf_init(
-			&io->frames.encbuf[i], i32buf_len,
-			TTABUF_LEN_DEFAULT, fstat->nchan, fstat->samplebytes,
-			CBM_MULTI_THREADED
+			&io->frames.queue.out.buf[i], arena, i32buf_len,
+			ttabuf_len, fstat->nchan, fstat->samplebytes,
+			CBM_MULTI_THREADED_OUTPUT
+		);
+	}
+	for ( i = 0; i < nthreads; ++i ){
+		bufs->coder[i].i32buf = arena_alloc(arena, i32buf_size);
+		bufs->coder[i].priv   = priv_arena_alloc(arena, fstat->nchan);
+		bufs->coder[i].vfybuf = (verify
+			? arena_alloc(arena, i32buf_size) : NULL
+		);
+		bufs->coder[i].vfypcm = (verify
+			? arena_alloc(arena, pcmbuf_size) : NULL
+		);
+		bufs->coder[i].size   = (
+			ARENA_SIZE(i32buf_size) + priv_arena_size(fstat->nchan)
+			+ vfybuf_size
 		);
 	}
 
-	/* io->outfile */
-	io->outfile.handle	= outfile;
-	io->outfile.name	= outfile_name;
-
-	/* io->infile */
-	io->infile.handle	= infile;
-	io->infile.name		= infile_name;
+	/* io->frames */
+	io->frames.nmemb		= len_max;
+	io->frames.ncoders		= nthreads;
+	/* * */
+	*io->frames.ticket		= 0;
+	*bufs->id_next			= 0;
+	/* * */
+	io->frames.queue.in.fl.nmemb	= len_max;
+	io->frames.queue.out.fl.nmemb	= len_max;
+	framequeue_init(
+		&io->frames.queue, FRAMEQUEUE_LEN_MIN(nthreads), depth_in,
+		depth_out, (size_t) len_in, waitvar_nspin
+	);
+	/* * */
+	for ( i = 0; i < len_max; ++i ){
+		waitvar_init(&io->frames.frame[i].seq, 0, waitvar_nspin);
+	}
 
-	/* io other */
+	/* io other; the gather writes of the writer have pieces outside of
+	     the arena, so its ring has no registered buffer
+	*/
 	io->fstat		= fstat;
-	io->seektable		= (struct SeekTable *) seektable;
-	io->estat_out		= (struct EncStats *) estat_out;
+	(void) uring_init(&io->outfile.ring);
+	io->infile.ring.fd	= -1;
+	io->frames.queue.in.pinned	= false;
+	io->frames.queue.out.pinned	= false;
 
 	/* encoder->frames */
-	spinlock_init(&encoder->frames.queue.lock);
-	pqueue_init(&encoder->frames.queue.q, framequeue_len);
-	/* * */
-	encoder->frames.navailable	= io->frames.navailable;
+	encoder->frames.nmemb		= len_max;
+	encoder->frames.ticket		= io->frames.ticket;
+	encoder->frames.nstall		= io->frames.queue.nstall_coder;
+	encoder->frames.bufs.ncoders	= nthreads;
+	encoder->frames.bufs.depth_in	= depth_in;
+	encoder->frames.bufs.depth_out	= depth_out;
+	encoder->frames.bufs.prefault	= true;
 	/* * */
-	encoder->frames.post_encoder	= io->frames.post_encoder;
-	encoder->frames.ni32_perframe	= io->frames.ni32_perframe;
-	encoder->frames.encbuf		= io->frames.encbuf;
-	encoder->frames.user		= io->frames.user;
-	encoder->frames.enc_retval	= io->frames.enc_retval;
+	encoder->frames.freelist	= io->frames.queue.in.fl;
+	encoder->frames.inbuf		= io->frames.queue.in.buf;
+	encoder->frames.encbuf		= io->frames.queue.out.buf;
+	encoder->frames.frame		= io->frames.frame;
 
 	/* encoder other */
 	encoder->fstat			= fstat;
@@ -166,44 +358,148 @@ encmt_state_init(
  * @brief frees any allocated pointers and destroys any objects in the
  *   multi-threaded encoder state structs
  *
- * @param io             - state struct for the io thread
- * @param encoder        - state struct for the encoder threads
- * @param framequeue_len - length of the framequeue
+ * @param io      - state struct for the reader and writer threads
+ * @param encoder - state struct for the encoder threads
 **/
 BUILD void
 encmt_state_free(
 	struct MTArg_EncIO *const RESTRICT io,
-	struct MTArg_Encoder *const RESTRICT encoder,
-	const unsigned int framequeue_len
+	struct MTArg_Encoder *const RESTRICT encoder
 )
 /*@globals	internalState@*/
 /*@modifies	internalState,
 		*io,
-		*io->frames.navailable,
-		io->frames.post_encoder[],
-		*encoder,
-		encoder->frames.queue.lock
+		*io->frames.ticket,
+		io->frames.frame[],
+		*encoder
 @*/
-/*@releases	io->frames.navailable,
-		io->frames.encbuf[].pcmbuf,
-		io->frames.encbuf[].ttabuf
+/*@releases	io->frames.arena.base,
+		io->frames.queue.in.buf[].ttabuf,
+		io->frames.queue.out.buf[].ttabuf
 @*/
 {
 	unsigned int i;
 
 	/* io */
-	semaphore_destroy(io->frames.navailable);
-	for ( i = 0; i < framequeue_len; ++i ){
-		semaphore_destroy(&io->frames.post_encoder[i]);
-	}
-	for ( i = 0; i < framequeue_len; ++i ){
-		codecbuf_free(&io->frames.encbuf[i], CBM_MULTI_THREADED);
+	bufpool_free(&io->frames.queue.in);
+	bufpool_free(&io->frames.queue.out);
+	for ( i = 0; i < io->frames.nmemb; ++i ){
+		waitvar_destroy(&io->frames.frame[i].seq);
 	}
 	/* * */
-	free(io->frames.navailable);
+	uring_free(&io->outfile.ring);
+	arena_free(&io->frames.arena);
+
+	/* encoder; nothing to destroy */
+	(void) encoder;
+
+	return;
+}
+
+/**@fn encmt_state_rewind
+ * @brief gets the multi-threaded encoder state structs ready for
+ *   another file with the same buffers
+ *
+ * @param io            - state struct for the reader and writer threads
+ * @param encoder       - state struct for the encoder threads
+ * @param waitvar_nspin - number of polls before a frame wait blocks
+ *
+ * @pre all the threads are done with the last file
+ *
+ * @note the waitvars still hold the last file's sequence numbers, and the
+ *   pools their adapted depths, so they are remade from the start
+**/
+BUILD void
+encmt_state_rewind(
+	struct MTArg_EncIO *const RESTRICT io,
+	struct MTArg_Encoder *const RESTRICT encoder,
+	const unsigned int waitvar_nspin
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*io,
+		*io->frames.ticket,
+		io->frames.frame[],
+		*encoder
+@*/
+{
+	struct MTArg_Coder_Bufs *const RESTRICT bufs = &encoder->frames.bufs;
+	unsigned int i;
+
+	freelist_destroy(&io->frames.queue.in.fl);
+	freelist_destroy(&io->frames.queue.out.fl);
+	for ( i = 0; i < io->frames.nmemb; ++i ){
+		waitvar_destroy(&io->frames.frame[i].seq);
+	}
+
+	*io->frames.ticket	= 0;
+	*bufs->id_next		= 0;
+	bufs->prefault		= false;
+	framequeue_init(
+		&io->frames.queue, FRAMEQUEUE_LEN_MIN(io->frames.ncoders),
+		bufs->depth_in, bufs->depth_out,
+		(size_t) FRAMEQUEUE_LEN(io->frames.ncoders), waitvar_nspin
+	);
+	for ( i = 0; i < io->frames.nmemb; ++i ){
+		waitvar_init(&io->frames.frame[i].seq, 0, waitvar_nspin);
+	}
 
-	/* encoder */
-	spinlock_destroy(&encoder->frames.queue.lock);
+	return;
+}
+
+/**@fn encmt_state_files
+ * @brief sets the files of the multi-threaded encoder state structs
+ *
+ * @param io           - state struct for the reader and writer threads
+ * @param outfile      - destination file
+ * @param outfile_name - name of the destination file (warnings/errors)
+ * @param infile       - source file
+ * @param infile_name  - name of the source file (warnings/errors)
+ * @param pcmmap       - the PCM in the mapped source file; NULL to fread it
+ * @param block        - block writer for outfile; NULL to writev
+ * @param seektable    - TTA seektable struct
+ * @param estat_out    - encode stats return struct
+**/
+BUILD void
+encmt_state_files(
+	struct MTArg_EncIO *const RESTRICT io,
+	FILE *const RESTRICT outfile, const char *const outfile_name,
+	FILE *const RESTRICT infile, const char *const infile_name,
+	/*@null@*/ const uint8_t *const pcmmap,
+	/*@null@*/ struct BlockOut *const block,
+	const struct SeekTable *const RESTRICT seektable,
+	const struct EncStats *const RESTRICT estat_out
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		io->outfile,
+		io->infile,
+		io->pcmmap,
+		io->block,
+		io->seektable,
+		io->estat_out
+@*/
+{
+	/* io->outfile; the block writer (--direct) does its own writes */
+	mtfile_set(&io->outfile, outfile, outfile_name, true);
+	io->block		= block;
+	if ( block != NULL ){
+		io->outfile.async = false;
+	}
+
+	/* io->infile; read by the reader through stdio or the mapping */
+	io->infile.handle	= infile;
+	io->infile.name		= infile_name;
+	io->infile.async	= false;
+	io->infile.pread	= false;
+	io->pcmmap		= pcmmap;
+
+	/* io other */
+	io->seektable		= (struct SeekTable *) seektable;
+	io->estat_out		= (struct EncStats *) estat_out;
 
 	return;
 }
@@ -211,69 +507,137 @@ encmt_state_free(
 /* ------------------------------------------------------------------------ */
 
 /**@fn encmt_state_init_allocs
- * @brief makes one large allocation and slices it up for the struct pointers
+ * @brief maps the arena, and slices the start of it up for the struct
+ *   pointers
+ *
+ * @param io         - state struct for the reader and writer threads
+ * @param bufs       - the coders' buffers struct
+ * @param inbuf_len  - max number of input buffers
+ * @param outbuf_len - max number of output buffers; length of the reorder
+ *   buffer
+ * @param ncoders    - number of coder threads
+ * @param bufs_size  - arena space for the rest of the buffers
  *
- * @param io             - state struct for the io thread
- * @param framequeue_len - length of the framequeue
+ * @note each atomic counter gets a cache line of its own
 **/
 static void
 encmt_state_init_allocs(
 	/*@out@*/ struct MTArg_EncIO *const RESTRICT io,
-	const size_t framequeue_len
+	/*@out@*/ struct MTArg_Coder_Bufs *const RESTRICT bufs,
+	const size_t inbuf_len, const size_t outbuf_len, const size_t ncoders,
+	const size_t bufs_size
 )
 /*@globals	fileSystem,
 		internalState
 @*/
 /*@modifies	fileSystem,
 		internalState,
-		io->frames.navailable,
-		io->frames.post_encoder,
-		io->frames.ni32_perframe,
-		io->frames.encbuf,
-		io->frames.user
+		io->frames.arena,
+		io->frames.ticket,
+		io->frames.queue.nstall_coder,
+		io->frames.queue.nstall_writer,
+		io->frames.queue.in.fl.tail,
+		io->frames.queue.in.fl.cell,
+		io->frames.queue.in.spare,
+		io->frames.queue.in.buf,
+		io->frames.queue.out.fl.tail,
+		io->frames.queue.out.fl.cell,
+		io->frames.queue.out.spare,
+		io->frames.queue.out.buf,
+		io->frames.frame,
+		bufs->id_next,
+		bufs->coder
 @*/
-/*@allocates	io->frames.navailable@*/
+/*@allocates	io->frames.arena.base@*/
 {
 	size_t size_total = 0;
-	size_t offset[5u];
+	size_t offset[13u];
 	uintptr_t base;
 
-	/* navailable */
-	size_total += sizeof *io->frames.navailable;
-	/* post_encoder */
-	size_total += ALIGN_FW_DIFF(
-		size_total, ALIGNOF(*io->frames.post_encoder)
-	);
+	/* ticket */
+	size_total += sizeof *io->frames.ticket;
+	/* queue.nstall_coder */
+	size_total += ALIGN_FW_DIFF(size_total, CACHE_LINE_SIZE);
 	offset[0u]  = size_total;
-	size_total += framequeue_len * (sizeof *io->frames.post_encoder);
-	/* ni32_perframe */
-	size_total += ALIGN_FW_DIFF(
-		size_total, ALIGNOF(*io->frames.ni32_perframe)
-	);
+	size_total += sizeof *io->frames.queue.nstall_coder;
+	/* queue.nstall_writer */
+	size_total += ALIGN_FW_DIFF(size_total, CACHE_LINE_SIZE);
 	offset[1u]  = size_total;
-	size_total += framequeue_len * (sizeof *io->frames.ni32_perframe);
-	/* encbuf */
-	size_total += ALIGN_FW_DIFF(size_total, ALIGNOF(*io->frames.encbuf));
+	size_total += sizeof *io->frames.queue.nstall_writer;
+	/* queue.in.fl.tail */
+	size_total += ALIGN_FW_DIFF(size_total, CACHE_LINE_SIZE);
 	offset[2u]  = size_total;
-	size_total += framequeue_len * (sizeof *io->frames.encbuf);
-	/* user */
-	size_total += ALIGN_FW_DIFF(size_total, ALIGNOF(*io->frames.user));
+	size_total += sizeof *io->frames.queue.in.fl.tail;
+	/* queue.in.fl.cell */
+	size_total += ALIGN_FW_DIFF(
+		size_total, ALIGNOF(*io->frames.queue.in.fl.cell)
+	);
 	offset[3u]  = size_total;
-	size_total += framequeue_len * (sizeof *io->frames.user);
-	/* enc_retval */
+	size_total += inbuf_len * (sizeof *io->frames.queue.in.fl.cell);
+	/* queue.in.spare */
 	size_total += ALIGN_FW_DIFF(
-		size_total, ALIGNOF(*io->frames.enc_retval)
+		size_total, ALIGNOF(*io->frames.queue.in.spare)
 	);
 	offset[4u]  = size_total;
-	size_total += framequeue_len * (sizeof *io->frames.enc_retval);
+	size_total += inbuf_len * (sizeof *io->frames.queue.in.spare);
+	/* queue.in.buf */
+	size_total += ALIGN_FW_DIFF(
+		size_total, ALIGNOF(*io->frames.queue.in.buf)
+	);
+	offset[5u]  = size_total;
+	size_total += inbuf_len * (sizeof *io->frames.queue.in.buf);
+	/* queue.out.fl.tail */
+	size_total += ALIGN_FW_DIFF(size_total, CACHE_LINE_SIZE);
+	offset[6u]  = size_total;
+	size_total += sizeof *io->frames.queue.out.fl.tail;
+	/* queue.out.fl.cell */
+	size_total += ALIGN_FW_DIFF(
+		size_total, ALIGNOF(*io->frames.queue.out.fl.cell)
+	);
+	offset[7u]  = size_total;
+	size_total += outbuf_len * (sizeof *io->frames.queue.out.fl.cell);
+	/* queue.out.spare */
+	size_total += ALIGN_FW_DIFF(
+		size_total, ALIGNOF(*io->frames.queue.out.spare)
+	);
+	offset[8u]  = size_total;
+	size_total += outbuf_len * (sizeof *io->frames.queue.out.spare);
+	/* queue.out.buf */
+	size_total += ALIGN_FW_DIFF(
+		size_total, ALIGNOF(*io->frames.queue.out.buf)
+	);
+	offset[9u]  = size_total;
+	size_total += outbuf_len * (sizeof *io->frames.queue.out.buf);
+	/* frame */
+	size_total += ALIGN_FW_DIFF(size_total, ALIGNOF(*io->frames.frame));
+	offset[10u] = size_total;
+	size_total += outbuf_len * (sizeof *io->frames.frame);
+	/* bufs->id_next */
+	size_total += ALIGN_FW_DIFF(size_total, CACHE_LINE_SIZE);
+	offset[11u] = size_total;
+	size_total += sizeof *bufs->id_next;
+	/* bufs->coder */
+	size_total += ALIGN_FW_DIFF(size_total, ALIGNOF(*bufs->coder));
+	offset[12u] = size_total;
+	size_total += ncoders * (sizeof *bufs->coder);
 
-	base = (uintptr_t) calloc_check(SIZE_C(1), size_total);
-	io->frames.navailable 		= (void *)  base;
-	io->frames.post_encoder		= (void *) (base + offset[0u]);
-	io->frames.ni32_perframe	= (void *) (base + offset[1u]);
-	io->frames.encbuf		= (void *) (base + offset[2u]);
-	io->frames.user			= (void *) (base + offset[3u]);
-	io->frames.enc_retval		= (void *) (base + offset[4u]);
+	/* the arena is page aligned */
+	arena_init(&io->frames.arena, ARENA_SIZE(size_total) + bufs_size);
+	base = (uintptr_t) arena_alloc(&io->frames.arena, size_total);
+	io->frames.ticket		= (void *)  base;
+	io->frames.queue.nstall_coder	= (void *) (base + offset[0u]);
+	io->frames.queue.nstall_writer	= (void *) (base + offset[1u]);
+	io->frames.queue.in.fl.tail	= (void *) (base + offset[2u]);
+	io->frames.queue.in.fl.cell	= (void *) (base + offset[3u]);
+	io->frames.queue.in.spare	= (void *) (base + offset[4u]);
+	io->frames.queue.in.buf		= (void *) (base + offset[5u]);
+	io->frames.queue.out.fl.tail	= (void *) (base + offset[6u]);
+	io->frames.queue.out.fl.cell	= (void *) (base + offset[7u]);
+	io->frames.queue.out.spare	= (void *) (base + offset[8u]);
+	io->frames.queue.out.buf	= (void *) (base + offset[9u]);
+	io->frames.frame		= (void *) (base + offset[10u]);
+	bufs->id_next			= (void *) (base + offset[11u]);
+	bufs->coder			= (void *) (base + offset[12u]);
 
 	return;
 }
@@ -283,27 +647,22 @@ encmt_state_init_allocs(
 /**@fn decmt_state_init
  * @brief initializes the multi-threaded decoder state structs
  *
- * @param io             - state struct for the io thread
- * @param decoder        - state struct for the decoder threads
- * @param framequeue_len - length of the framequeue
- * @param i32buf_len     - length of the encbuf->i32buf
- * @param outfile        - destination file
- * @param outfile_name   - name of the destination file (warnings/errors)
- * @param infile         - source file
- * @param infile_name    - name of the source file (warnings/errors)
- * @param seektable      - TTA seektable struct
- * @param dstat_out      - decode stats return struct
- * @param fstat          - compacted file stats struct
+ * @param io            - state struct for the reader and writer threads
+ * @param decoder       - state struct for the decoder threads
+ * @param nthreads      - number of decoder threads
+ * @param waitvar_nspin - number of polls before a frame wait blocks
+ * @param i32buf_len    - length of the decbuf->i32buf
+ * @param fstat         - compacted file stats struct; only its nchan and
+ *   samplebytes are used here, but the pointer is kept
+ *
+ * @note the files are set with decmt_state_files()
 **/
 BUILD void
 decmt_state_init(
 	/*@out@*/ struct MTArg_DecIO *const RESTRICT io,
 	/*@out@*/ struct MTArg_Decoder *const RESTRICT decoder,
-	const unsigned int framequeue_len, const size_t i32buf_len,
-	FILE *const RESTRICT outfile, const char *const outfile_name,
-	FILE *const RESTRICT infile, const char *const infile_name,
-	const struct SeekTable *const RESTRICT seektable,
-	const struct DecStats *const RESTRICT dstat_out,
+	const unsigned int nthreads, const unsigned int waitvar_nspin,
+	const size_t i32buf_len,
 	const struct FileStats_DecMT *const RESTRICT fstat
 )
 /*@globals	fileSystem,
@@ -312,63 +671,115 @@ decmt_state_init(
 /*@modifies	fileSystem,
 		internalState,
 		*io,
-		*io->frames.navailable,
-		io->frames.post_decoder[],
-		*decoder,
-		decoder->frames.queue.lock
+		*io->frames.ticket,
+		io->frames.frame[],
+		*decoder
 @*/
-/*@allocates	io->frames.navailable,
-		io->frames.decbuf[].pcmbuf,
-		io->frames.decbuf[].ttabuf
+/*@allocates	io->frames.arena.base,
+		io->frames.queue.in.buf[].ttabuf,
+		io->frames.queue.out.buf[].ttabuf
 @*/
 {
+	const unsigned int len_in  = FRAMEQUEUE_LEN(nthreads);
+	const unsigned int len_out = REORDER_LEN(nthreads);
+	const unsigned int len_max = framequeue_len_max(
+		nthreads, i32buf_len, fstat->samplebytes
+	);
+	const unsigned int depth_in  = (len_in  < len_max ? len_in  : len_max);
+	const unsigned int depth_out = (len_out < len_max ? len_out : len_max);
+	const size_t ttabuf_len = TTABUF_LEN_FRAME(
+		i32buf_len, fstat->nchan, fstat->samplebytes
+	);
+	const size_t i32buf_size = i32buf_len * (sizeof(int32_t));
+	/* * */
+	struct Arena *const RESTRICT arena = &io->frames.arena;
+	struct MTArg_Coder_Bufs *const RESTRICT bufs = &decoder->frames.bufs;
+	size_t bufs_size;
 	unsigned int i;
+	bool pinned;
 
 	/* base allocations */
-	decmt_state_init_allocs(io, (size_t) framequeue_len);
+	bufs_size  = len_max * decbuf_arena_size(
+		i32buf_len, ttabuf_len, fstat->nchan, fstat->samplebytes,
+		CBM_MULTI_THREADED_INPUT
+	);
+	bufs_size += len_max * decbuf_arena_size(
+		i32buf_len, ttabuf_len, fstat->nchan, fstat->samplebytes,
+		CBM_MULTI_THREADED_OUTPUT
+	);
+	bufs_size += nthreads * (
+		ARENA_SIZE(i32buf_size) + priv_arena_size(fstat->nchan)
+	);
+	decmt_state_init_allocs(
+		io, bufs, (size_t) len_max, (size_t) len_max,
+		(size_t) nthreads, bufs_size
+	);
 
-	/* io->frames */
-	io->frames.nmemb	= framequeue_len;
-	/* * */
-	semaphore_init(io->frames.navailable, 0);
-	/* * */
-	for ( i = 0; i < framequeue_len; ++i ){
-		semaphore_init(&io->frames.post_decoder[i], 0);
+	/* buffers; the pools' first, then each coder's */
+	for ( i = 0; i < len_max; ++i ){
+		decbuf_init(
+			&io->frames.queue.in.buf[i], arena, i32buf_len,
+			ttabuf_len, fstat->nchan, fstat->samplebytes,
+			CBM_MULTI_THREADED_INPUT
+		);
 	}
-	for ( i = 0; i < framequeue_len; ++i ){
+	for ( i = 0; i < len_max; ++i ){
 		decbuf_init(
-			&io->frames.decbuf[i], i32buf_len,
-			TTABUF_LEN_DEFAULT, fstat->nchan, fstat->samplebytes,
-			CBM_MULTI_THREADED
+			&io->frames.queue.out.buf[i], arena, i32buf_len,
+			ttabuf_len, fstat->nchan, fstat->samplebytes,
+			CBM_MULTI_THREADED_OUTPUT
+		);
+	}
+	for ( i = 0; i < nthreads; ++i ){
+		bufs->coder[i].i32buf = arena_alloc(arena, i32buf_size);
+		bufs->coder[i].priv   = priv_arena_alloc(arena, fstat->nchan);
+		bufs->coder[i].vfybuf = NULL;
+		bufs->coder[i].vfypcm = NULL;
+		bufs->coder[i].size   = (
+			ARENA_SIZE(i32buf_size) + priv_arena_size(fstat->nchan)
 		);
 	}
 
-	/* io->outfile */
-	io->outfile.handle	= outfile;
-	io->outfile.name	= outfile_name;
-
-	/* io->infile */
-	io->infile.handle	= infile;
-	io->infile.name		= infile_name;
+	/* io->frames */
+	io->frames.nmemb		= len_max;
+	io->frames.ncoders		= nthreads;
+	/* * */
+	*io->frames.ticket		= 0;
+	*bufs->id_next			= 0;
+	/* * */
+	io->frames.queue.in.fl.nmemb	= len_max;
+	io->frames.queue.out.fl.nmemb	= len_max;
+	framequeue_init(
+		&io->frames.queue, FRAMEQUEUE_LEN_MIN(nthreads), depth_in,
+		depth_out, (size_t) len_in, waitvar_nspin
+	);
+	/* * */
+	for ( i = 0; i < len_max; ++i ){
+		waitvar_init(&io->frames.frame[i].seq, 0, waitvar_nspin);
+	}
 
-	/* io other */
+	/* io other; the ttabuf's are read into, and the pcmbuf's written
+	     from, straight out of the registered arena
+	*/
 	io->fstat		= fstat;
-	io->seektable		= (struct SeekTable *) seektable;
-	io->dstat_out		= (struct DecStats *) dstat_out;
+	pinned  = decmt_ring_init(&io->infile.ring, arena);
+	pinned |= decmt_ring_init(&io->outfile.ring, arena);
+	io->frames.queue.in.pinned	= pinned;
+	io->frames.queue.out.pinned	= pinned;
 
 	/* decoder->frames */
-	spinlock_init(&decoder->frames.queue.lock);
-	pqueue_init(&decoder->frames.queue.q, framequeue_len);
+	decoder->frames.nmemb               = len_max;
+	decoder->frames.ticket              = io->frames.ticket;
+	decoder->frames.nstall              = io->frames.queue.nstall_coder;
+	decoder->frames.bufs.ncoders        = nthreads;
+	decoder->frames.bufs.depth_in       = depth_in;
+	decoder->frames.bufs.depth_out      = depth_out;
+	decoder->frames.bufs.prefault       = true;
 	/* * */
-	decoder->frames.navailable          = io->frames.navailable;
-	/* * */
-	decoder->frames.post_decoder        = io->frames.post_decoder;
-	decoder->frames.ni32_perframe       = io->frames.ni32_perframe;
-	decoder->frames.nbytes_tta_perframe = io->frames.nbytes_tta_perframe;
-	decoder->frames.decbuf              = io->frames.decbuf;
-	decoder->frames.user                = io->frames.user;
-	decoder->frames.dec_retval          = io->frames.dec_retval;
-	decoder->frames.nsamples_flat_2pad  = io->frames.nsamples_flat_2pad;
+	decoder->frames.freelist            = io->frames.queue.in.fl;
+	decoder->frames.inbuf               = io->frames.queue.in.buf;
+	decoder->frames.decbuf              = io->frames.queue.out.buf;
+	decoder->frames.frame               = io->frames.frame;
 
 	/* decoder other */
 	decoder->fstat                      = fstat;
@@ -380,44 +791,162 @@ decmt_state_init(
  * @brief frees any allocated pointers and destroys any objects in the
  *   multi-threaded decoder state structs
  *
- * @param io             - state struct for the io thread
- * @param decoder        - state struct for the decoder threads
- * @param framequeue_len - length of the framequeue
+ * @param io      - state struct for the reader and writer threads
+ * @param decoder - state struct for the decoder threads
 **/
 BUILD void
 decmt_state_free(
 	struct MTArg_DecIO *const RESTRICT io,
-	struct MTArg_Decoder *const RESTRICT decoder,
-	const unsigned int framequeue_len
+	struct MTArg_Decoder *const RESTRICT decoder
 )
 /*@globals	internalState@*/
 /*@modifies	internalState,
 		*io,
-		*io->frames.navailable,
-		io->frames.post_decoder[],
-		*decoder,
-		decoder->frames.queue.lock
+		*io->frames.ticket,
+		io->frames.frame[],
+		*decoder
 @*/
-/*@releases	io->frames.navailable,
-		io->frames.decbuf[].pcmbuf,
-		io->frames.decbuf[].ttabuf
+/*@releases	io->frames.arena.base,
+		io->frames.queue.in.buf[].ttabuf,
+		io->frames.queue.out.buf[].ttabuf
 @*/
 {
 	unsigned int i;
 
 	/* io */
-	semaphore_destroy(io->frames.navailable);
-	for ( i = 0; i < framequeue_len; ++i ){
-		semaphore_destroy(&io->frames.post_decoder[i]);
-	}
-	for ( i = 0; i < framequeue_len; ++i ){
-		codecbuf_free(&io->frames.decbuf[i], CBM_MULTI_THREADED);
+	bufpool_free(&io->frames.queue.in);
+	bufpool_free(&io->frames.queue.out);
+	for ( i = 0; i < io->frames.nmemb; ++i ){
+		waitvar_destroy(&io->frames.frame[i].seq);
 	}
 	/* * */
-	free(io->frames.navailable);
+	uring_free(&io->infile.ring);
+	uring_free(&io->outfile.ring);
+	arena_free(&io->frames.arena);
+
+	/* decoder; nothing to destroy */
+	(void) decoder;
+
+	return;
+}
+
+/**@fn decmt_state_rewind
+ * @brief gets the multi-threaded decoder state structs ready for
+ *   another file with the same buffers
+ *
+ * @param io            - state struct for the reader and writer threads
+ * @param decoder       - state struct for the decoder threads
+ * @param waitvar_nspin - number of polls before a frame wait blocks
+ *
+ * @pre all the threads are done with the last file
+ *
+ * @note the waitvars still hold the last file's sequence numbers, and the
+ *   pools their adapted depths, so they are remade from the start
+**/
+BUILD void
+decmt_state_rewind(
+	struct MTArg_DecIO *const RESTRICT io,
+	struct MTArg_Decoder *const RESTRICT decoder,
+	const unsigned int waitvar_nspin
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*io,
+		*io->frames.ticket,
+		io->frames.frame[],
+		*decoder
+@*/
+{
+	struct MTArg_Coder_Bufs *const RESTRICT bufs = &decoder->frames.bufs;
+	unsigned int i;
+
+	freelist_destroy(&io->frames.queue.in.fl);
+	freelist_destroy(&io->frames.queue.out.fl);
+	for ( i = 0; i < io->frames.nmemb; ++i ){
+		waitvar_destroy(&io->frames.frame[i].seq);
+	}
+
+	*io->frames.ticket	= 0;
+	*bufs->id_next		= 0;
+	bufs->prefault		= false;
+	framequeue_init(
+		&io->frames.queue, FRAMEQUEUE_LEN_MIN(io->frames.ncoders),
+		bufs->depth_in, bufs->depth_out,
+		(size_t) FRAMEQUEUE_LEN(io->frames.ncoders), waitvar_nspin
+	);
+	for ( i = 0; i < io->frames.nmemb; ++i ){
+		waitvar_init(&io->frames.frame[i].seq, 0, waitvar_nspin);
+	}
+
+	return;
+}
+
+/**@fn decmt_state_files
+ * @brief sets the files of the multi-threaded decoder state structs
+ *
+ * @param io           - state struct for the reader and writer threads
+ * @param decoder      - state struct for the decoder threads
+ * @param outfile      - destination file
+ * @param outfile_name - name of the destination file (warnings/errors)
+ * @param infile       - source file
+ * @param infile_name  - name of the source file (warnings/errors)
+ * @param pread        - whether the decoders read their own frames
+ * @param pcmmap       - the PCM in the mapped destination file; NULL to
+ *   write it
+ * @param seektable    - TTA seektable struct
+ * @param dstat_out    - decode stats return struct
+ *
+ * @note pread is only used for a regular infile
+**/
+BUILD void
+decmt_state_files(
+	struct MTArg_DecIO *const RESTRICT io,
+	struct MTArg_Decoder *const RESTRICT decoder,
+	FILE *const RESTRICT outfile, const char *const outfile_name,
+	FILE *const RESTRICT infile, const char *const infile_name,
+	const bool pread, /*@null@*/ uint8_t *const pcmmap,
+	const struct SeekTable *const RESTRICT seektable,
+	const struct DecStats *const RESTRICT dstat_out
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		io->outfile,
+		io->infile,
+		io->pcmmap,
+		io->seektable,
+		io->dstat_out,
+		decoder->infile,
+		decoder->infile_name,
+		decoder->pcmmap
+@*/
+{
+	/* io->outfile; with a mapping, the decoders write into it */
+	mtfile_set(&io->outfile, outfile, outfile_name, true);
+	io->pcmmap      = pcmmap;
+	decoder->pcmmap = pcmmap;
+	if ( pcmmap != NULL ){
+		io->outfile.async = false;
+	}
+
+	/* io->infile; with pread, the reader only hands out the offsets */
+	mtfile_set(&io->infile, infile, infile_name, false);
+	decoder->infile      = NULL;
+	decoder->infile_name = infile_name;
+	if ( pread && file_regsize(infile, &io->infile.size) ){
+		io->infile.offset = ftello(infile);
+		if ( io->infile.offset >= 0 ){
+			io->infile.async = false;
+			io->infile.pread = true;
+			decoder->infile  = infile;
+		}
+	}
 
-	/* decoder */
-	spinlock_destroy(&decoder->frames.queue.lock);
+	/* io other */
+	io->seektable		= (const struct SeekTable *) seektable;
+	io->dstat_out		= (struct DecStats *) dstat_out;
 
 	return;
 }
@@ -425,99 +954,233 @@ decmt_state_free(
 /* ------------------------------------------------------------------------ */
 
 /**@fn decmt_state_init_allocs
- * @brief makes one large allocation and slices it up for the struct pointers
+ * @brief maps the arena, and slices the start of it up for the struct
+ *   pointers
  *
- * @param io             - state struct for the io thread
- * @param framequeue_len - length of the framequeue
+ * @param io         - state struct for the reader and writer threads
+ * @param bufs       - the coders' buffers struct
+ * @param inbuf_len  - max number of input buffers
+ * @param outbuf_len - max number of output buffers; length of the reorder
+ *   buffer
+ * @param ncoders    - number of coder threads
+ * @param bufs_size  - arena space for the rest of the buffers
+ *
+ * @note each atomic counter gets a cache line of its own
 **/
 static void
 decmt_state_init_allocs(
 	/*@out@*/ struct MTArg_DecIO *const RESTRICT io,
-	const size_t framequeue_len
+	/*@out@*/ struct MTArg_Coder_Bufs *const RESTRICT bufs,
+	const size_t inbuf_len, const size_t outbuf_len, const size_t ncoders,
+	const size_t bufs_size
 )
 /*@globals	fileSystem,
 		internalState
 @*/
 /*@modifies	fileSystem,
 		internalState,
-		io->frames.navailable,
-		io->frames.post_decoder,
-		io->frames.ni32_perframe,
-		io->frames.nbytes_tta_perframe,
-		io->frames.decbuf,
-		io->frames.user,
-		io->frames.nsamples_flat_2pad,
-		io->frames.dec_retval,
-		io->frames.crc_read
+		io->frames.arena,
+		io->frames.ticket,
+		io->frames.queue.nstall_coder,
+		io->frames.queue.nstall_writer,
+		io->frames.queue.in.fl.tail,
+		io->frames.queue.in.fl.cell,
+		io->frames.queue.in.spare,
+		io->frames.queue.in.buf,
+		io->frames.queue.out.fl.tail,
+		io->frames.queue.out.fl.cell,
+		io->frames.queue.out.spare,
+		io->frames.queue.out.buf,
+		io->frames.frame,
+		bufs->id_next,
+		bufs->coder
 @*/
-/*@allocates	io->frames.navailable@*/
+/*@allocates	io->frames.arena.base@*/
 {
 	size_t size_total = 0;
-	size_t offset[8u];
+	size_t offset[13u];
 	uintptr_t base;
 
-	/* navailable */
-	size_total += sizeof *io->frames.navailable;
-	/* post_decoder */
-	size_total += ALIGN_FW_DIFF(
-		size_total, ALIGNOF(*io->frames.post_decoder)
-	);
+	/* ticket */
+	size_total += sizeof *io->frames.ticket;
+	/* queue.nstall_coder */
+	size_total += ALIGN_FW_DIFF(size_total, CACHE_LINE_SIZE);
 	offset[0u]  = size_total;
-	size_total += framequeue_len * (sizeof *io->frames.post_decoder);
-	/* ni32_perframe */
-	size_total += ALIGN_FW_DIFF(
-		size_total, ALIGNOF(*io->frames.ni32_perframe)
-	);
+	size_total += sizeof *io->frames.queue.nstall_coder;
+	/* queue.nstall_writer */
+	size_total += ALIGN_FW_DIFF(size_total, CACHE_LINE_SIZE);
 	offset[1u]  = size_total;
-	size_total += framequeue_len * (sizeof *io->frames.ni32_perframe);
-	/* nbytes_tta_perframe */
-	size_total += ALIGN_FW_DIFF(
-		size_total, ALIGNOF(*io->frames.nbytes_tta_perframe)
-	);
+	size_total += sizeof *io->frames.queue.nstall_writer;
+	/* queue.in.fl.tail */
+	size_total += ALIGN_FW_DIFF(size_total, CACHE_LINE_SIZE);
 	offset[2u]  = size_total;
-	size_total += (
-		framequeue_len * (sizeof *io->frames.nbytes_tta_perframe)
+	size_total += sizeof *io->frames.queue.in.fl.tail;
+	/* queue.in.fl.cell */
+	size_total += ALIGN_FW_DIFF(
+		size_total, ALIGNOF(*io->frames.queue.in.fl.cell)
 	);
-	/* decbuf */
-	size_total += ALIGN_FW_DIFF(size_total, ALIGNOF(*io->frames.decbuf));
 	offset[3u]  = size_total;
-	size_total += framequeue_len * (sizeof *io->frames.decbuf);
-	/* user */
-	size_total += ALIGN_FW_DIFF(size_total, ALIGNOF(*io->frames.user));
+	size_total += inbuf_len * (sizeof *io->frames.queue.in.fl.cell);
+	/* queue.in.spare */
+	size_total += ALIGN_FW_DIFF(
+		size_total, ALIGNOF(*io->frames.queue.in.spare)
+	);
 	offset[4u]  = size_total;
-	size_total += framequeue_len * (sizeof *io->frames.user);
-	/* nsamples_flat_2pad */
+	size_total += inbuf_len * (sizeof *io->frames.queue.in.spare);
+	/* queue.in.buf */
 	size_total += ALIGN_FW_DIFF(
-		size_total, ALIGNOF(*io->frames.nsamples_flat_2pad)
+		size_total, ALIGNOF(*io->frames.queue.in.buf)
 	);
 	offset[5u]  = size_total;
-	size_total += (
-		framequeue_len * (sizeof *io->frames.nsamples_flat_2pad)
+	size_total += inbuf_len * (sizeof *io->frames.queue.in.buf);
+	/* queue.out.fl.tail */
+	size_total += ALIGN_FW_DIFF(size_total, CACHE_LINE_SIZE);
+	offset[6u]  = size_total;
+	size_total += sizeof *io->frames.queue.out.fl.tail;
+	/* queue.out.fl.cell */
+	size_total += ALIGN_FW_DIFF(
+		size_total, ALIGNOF(*io->frames.queue.out.fl.cell)
 	);
-	/* dec_retval */
+	offset[7u]  = size_total;
+	size_total += outbuf_len * (sizeof *io->frames.queue.out.fl.cell);
+	/* queue.out.spare */
 	size_total += ALIGN_FW_DIFF(
-		size_total, ALIGNOF(*io->frames.dec_retval)
+		size_total, ALIGNOF(*io->frames.queue.out.spare)
 	);
-	offset[6u]  = size_total;
-	size_total += framequeue_len * (sizeof *io->frames.dec_retval);
-	/* crc_read */
+	offset[8u]  = size_total;
+	size_total += outbuf_len * (sizeof *io->frames.queue.out.spare);
+	/* queue.out.buf */
 	size_total += ALIGN_FW_DIFF(
-		size_total, ALIGNOF(*io->frames.crc_read)
+		size_total, ALIGNOF(*io->frames.queue.out.buf)
 	);
-	offset[7u]  = size_total;
-	size_total += framequeue_len * (sizeof *io->frames.crc_read);
-
-	base = (uintptr_t) calloc_check(SIZE_C(1), size_total);
-	io->frames.navailable 		= (void *)  base;
-	io->frames.post_decoder		= (void *) (base + offset[0u]);
-	io->frames.ni32_perframe	= (void *) (base + offset[1u]);
-	io->frames.nbytes_tta_perframe	= (void *) (base + offset[2u]);
-	io->frames.decbuf		= (void *) (base + offset[3u]);
-	io->frames.user			= (void *) (base + offset[4u]);
-	io->frames.nsamples_flat_2pad	= (void *) (base + offset[5u]);
-	io->frames.dec_retval		= (void *) (base + offset[6u]);
-	io->frames.crc_read		= (void *) (base + offset[7u]);
+	offset[9u]  = size_total;
+	size_total += outbuf_len * (sizeof *io->frames.queue.out.buf);
+	/* frame */
+	size_total += ALIGN_FW_DIFF(size_total, ALIGNOF(*io->frames.frame));
+	offset[10u] = size_total;
+	size_total += outbuf_len * (sizeof *io->frames.frame);
+	/* bufs->id_next */
+	size_total += ALIGN_FW_DIFF(size_total, CACHE_LINE_SIZE);
+	offset[11u] = size_total;
+	size_total += sizeof *bufs->id_next;
+	/* bufs->coder */
+	size_total += ALIGN_FW_DIFF(size_total, ALIGNOF(*bufs->coder));
+	offset[12u] = size_total;
+	size_total += ncoders * (sizeof *bufs->coder);
+
+	/* the arena is page aligned */
+	arena_init(&io->frames.arena, ARENA_SIZE(size_total) + bufs_size);
+	base = (uintptr_t) arena_alloc(&io->frames.arena, size_total);
+	io->frames.ticket		= (void *)  base;
+	io->frames.queue.nstall_coder	= (void *) (base + offset[0u]);
+	io->frames.queue.nstall_writer	= (void *) (base + offset[1u]);
+	io->frames.queue.in.fl.tail	= (void *) (base + offset[2u]);
+	io->frames.queue.in.fl.cell	= (void *) (base + offset[3u]);
+	io->frames.queue.in.spare	= (void *) (base + offset[4u]);
+	io->frames.queue.in.buf		= (void *) (base + offset[5u]);
+	io->frames.queue.out.fl.tail	= (void *) (base + offset[6u]);
+	io->frames.queue.out.fl.cell	= (void *) (base + offset[7u]);
+	io->frames.queue.out.spare	= (void *) (base + offset[8u]);
+	io->frames.queue.out.buf	= (void *) (base + offset[9u]);
+	io->frames.frame		= (void *) (base + offset[10u]);
+	bufs->id_next			= (void *) (base + offset[11u]);
+	bufs->coder			= (void *) (base + offset[12u]);
+
+	return;
+}
+
+/**@fn decmt_ring_init
+ * @brief sets up a ring of the multi-threaded decoder, with the arena as
+ *   its registered buffer
+ *
+ * @param ring  - the ring
+ * @param arena - arena
+ *
+ * @return true if the arena got registered (and so pinned)
+ *
+ * @note registering faults in the whole arena up front
+**/
+static bool
+decmt_ring_init(
+	/*@out@*/ struct URing *const RESTRICT ring,
+	const struct Arena *const RESTRICT arena
+)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*ring
+@*/
+{
+	if ( ! uring_init(ring) ){
+		return false;
+	}
+	return uring_register(ring, arena->base, arena->size);
+}
+
+/* ======================================================================== */
+
+/**@fn mtfile_set
+ * @brief sets a file of the reader or the writer thread, and goes async if
+ *   it has a ring and the file is a regular one
+ *
+ * @param file   - the thread's file struct
+ * @param handle - the file
+ * @param name   - name of the file (warnings/errors)
+ * @param output - whether it is written to
+ *
+ * @note an outfile is flushed first, since the ring writes around stdio
+**/
+BUILD void
+mtfile_set(
+	struct MTArg_IO_File *const RESTRICT file, FILE *const RESTRICT handle,
+	const char *const name, const bool output
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*file
+@*/
+{
+	file->handle = handle;
+	file->name   = name;
+	file->async  = false;
+	file->pread  = false;
+
+	if ( (file->ring.fd < 0) || (! file_regsize(handle, &file->size)) ){
+		return;
+	}
+	if ( output && (fflush(handle) != 0) ){
+		error_sys(errno, "fflush", name);
+	}
+	file->offset = ftello(handle);
+	if UNLIKELY ( file->offset < 0 ){
+		return;
+	}
+	file->fd    = uring_fd(handle);
+	file->async = true;
+
+	return;
+}
 
+/**@fn mtfile_sync
+ * @brief moves a file's position to the end of what its ring (or the
+ *   coders' preads) did
+ *
+ * @param file - the thread's file struct
+ *
+ * @pre the thread is done with the file
+**/
+BUILD void
+mtfile_sync(const struct MTArg_IO_File *const RESTRICT file)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		file->handle
+@*/
+{
+	if ( ! (file->async || file->pread) ){
+		return;
+	}
+	if UNLIKELY ( fseeko(file->handle, file->offset, SEEK_SET) != 0 ){
+		error_sys(errno, "fseeko", file->name);
+	}
 	return;
 }
 
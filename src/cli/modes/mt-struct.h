@@ -6,28 +6,78 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
 
+#include <limits.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
+
+#include <sys/types.h>
 
 #include "../../libttaR.h"
 
 #include "../common.h"
 #include "../formats.h"
 
+#include "./align.h"
+#include "./arena.h"
 #include "./bufs.h"
-#include "./pqueue.h"
+#include "./crew.h"
+#include "./framequeue.h"
+#include "./freelist.h"
 #include "./threads.h"
+#include "./blockout.h"
+#include "./bulkio.h"
+#include "./uring.h"
 
 /* //////////////////////////////////////////////////////////////////////// */
 
-/* multi-thread-ver. can deadlock or abort if (framequeue_len <= nthreads) */
+/* starting number of input buffers (PCM for encode, TTA for decode). a
+     coder only holds one while it codes, so less than two per coder mostly
+     just leaves the coders waiting on the reader
+*/
 #define FRAMEQUEUE_LEN(nthreads)	((2u * ((unsigned int) (nthreads))))
 
+/* starting number of output buffers. a frame holds one from when it is
+     read until it is written, so the window can be deeper than the
+     framequeue; a slow frame or a slow outfile then only holds up the
+     writer, not the reader or the other coders
+*/
+#define REORDER_LEN(nthreads)		(2u * FRAMEQUEUE_LEN(nthreads))
+
+/* bounds for the number of buffers in either pool; they adapt at runtime
+     (see "framequeue.h")
+*/
+#define FRAMEQUEUE_LEN_MIN(nthreads)	(((unsigned int) (nthreads)) + 1u)
+#define FRAMEQUEUE_LEN_MAX(nthreads)	(4u * FRAMEQUEUE_LEN(nthreads))
+
+/* memory for the buffers of both pools. lowers the max, but never below
+     the min, so for big frames it is a soft limit
+*/
+#ifndef FRAMEQUEUE_MEMBUDGET
+#define FRAMEQUEUE_MEMBUDGET		(SIZE_C(64) * 1024u * 1024u)
+#endif
+
+/* reorder buffer: ticket t lives in entry (t % nmemb). every ticket in
+     flight holds an output buffer, so nmemb is the output pool's max. the
+     entry's seq is READY(t) once the reader has filled it, DONE(t) once a
+     coder has coded it, and WRITTEN(t) once the writer is done with it.
+     the coders take tickets in order, but may finish them in any order;
+     the writer writes them out in order. the values only need to be unique
+     per entry, so wrapping is fine
+*/
+#define FRAME_SEQ_READY(x_ticket)	((uint32_t) (3u * (x_ticket) + 1u))
+#define FRAME_SEQ_DONE(x_ticket)	((uint32_t) (3u * (x_ticket) + 2u))
+#define FRAME_SEQ_WRITTEN(x_ticket)	((uint32_t) (3u * (x_ticket) + 3u))
+
+/* the inbuf_id of an encode frame whose PCM is in the mapped infile */
+#define FRAME_INBUF_NONE		UINT_MAX
+
 /* //////////////////////////////////////////////////////////////////////// */
 
 struct FileStats_EncMT {
@@ -35,6 +85,7 @@ struct FileStats_EncMT {
 	enum LibTTAr_SampleBytes	samplebytes;
 	size_t				nsamples_perframe;
 	size_t				decpcm_size;
+	size_t				framefooter_len;
 };
 
 struct FileStats_DecMT {
@@ -42,108 +93,163 @@ struct FileStats_DecMT {
 	enum LibTTAr_SampleBytes	samplebytes;
 	size_t				nsamples_perframe;
 	size_t				nsamples_enc;
+	size_t				framefooter_len;
 };
 
 /* ======================================================================== */
 
-struct MTPQueue {
-	spinlock_p	lock;
-	struct PQueue	q;
+/* an entry of the reorder buffer. the entries in flight are filled and
+     coded by different threads at the same time, so each one starts on its
+     own cache line
+*/
+struct EncFrame {
+	waitvar_p			seq;
+	unsigned int			inbuf_id;
+	unsigned int			outbuf_id;
+	/*@dependent@*/
+	const uint8_t			*pcm;	/* inbuf's, or mapped */
+	size_t				ni32_perframe;
+	struct LibTTAr_CodecState_User	user;
+	int8_t				enc_retval;
+	bool				verified;	/* or no --verify */
+} ALIGNED(CACHE_LINE_SIZE);
+
+struct DecFrame {
+	waitvar_p			seq;
+	unsigned int			inbuf_id;
+	unsigned int			outbuf_id;
+	off_t				offset;	/* of the TTA, for pread */
+	size_t				nbytes_read;	/* pread, ring */
+	size_t				ni32_perframe;
+	size_t				nbytes_tta_perframe;
+	struct LibTTAr_CodecState_User	user;
+	size_t				nsamples_flat_2pad;
+	uint32_t			crc_read;	/* little-endian */
+	int8_t				dec_retval;
+} ALIGNED(CACHE_LINE_SIZE);
+
+/* ------------------------------------------------------------------------ */
+
+/* a coder thread's own buffers, next to each other in the arena */
+struct CoderBufs {
+	/*@dependent@*/
+	int32_t				*i32buf;
+	/*@dependent@*/
+	struct LibTTAr_CodecState_Priv	*priv;
+	/*@dependent@*/ /*@null@*/
+	int32_t				*vfybuf;	/* enc: --verify */
+	/*@dependent@*/ /*@null@*/
+	uint8_t				*vfypcm;	/* enc: --verify */
+	size_t				size;	/* of all, from i32buf */
+};
+
+/* each coder takes the next id, and with it its own buffers. it then
+     faults in those, and its share (every ncoders'th id) of the pools'
+     starting buffers, so that the page faults of a run are spread over the
+     coders instead of all hitting whoever touches a page first. a file
+     after the first that reuses the buffers finds them already faulted in
+*/
+struct MTArg_Coder_Bufs {
+	/*@dependent@*/
+	size_t				*id_next;	/* atomic */
+	/*@temp@*/
+	struct CoderBufs		*coder;
+	unsigned int			ncoders;
+	unsigned int			depth_in;
+	unsigned int			depth_out;
+	bool				prefault;
 };
 
 /* ------------------------------------------------------------------------ */
 
 struct MTArg_EncIO_Frames {
 	unsigned int			nmemb;
-	/*@owned@*/
-	semaphore_p			*navailable;
+	unsigned int			ncoders;
+	struct Arena			arena;
+	/*@dependent@*/
+	size_t				*ticket;
+
+	/* buffer pools; in: only the pcmbuf's, out: only the ttabuf's */
+	struct FrameQueue		queue;
 
-	/* parallel arrays */
-	/*@temp@*/
-	semaphore_p			*post_encoder;
-	/*@temp@*/
-	size_t				*ni32_perframe;
-	/*@temp@*/
-	struct EncBuf			*encbuf;
-	/*@temp@*/
-	struct LibTTAr_CodecState_User	*user;
 	/*@temp@*/
-	int8_t				*enc_retval;
+	struct EncFrame			*frame;
 };
 
 struct MTArg_Encoder_Frames {
-	struct MTPQueue			queue;
+	unsigned int			nmemb;
+	/*@dependent@*/
+	size_t				*ticket;
 	/*@dependent@*/
-	semaphore_p			*navailable;
+	size_t				*nstall;	/* atomic */
+	struct MTArg_Coder_Bufs		bufs;
 
-	/* parallel arrays */
+	/* buffer pools */
+	struct FreeList			freelist;	/* inbuf's */
 	/*@temp@*/
-	semaphore_p			*post_encoder;
-	/*@temp@*/
-	const size_t			*ni32_perframe;
+	const struct EncBuf		*inbuf;
 	/*@temp@*/
 	struct EncBuf			*encbuf;
+
 	/*@temp@*/
-	struct LibTTAr_CodecState_User	*user;
-	/*@temp@*/
-	int8_t				*enc_retval;
+	struct EncFrame			*frame;
 };
 
 /* ------------------------------------------------------------------------ */
 
 struct MTArg_DecIO_Frames {
 	unsigned int			nmemb;
-	/*@owned@*/
-	semaphore_p			*navailable;
+	unsigned int			ncoders;
+	struct Arena			arena;
+	/*@dependent@*/
+	size_t				*ticket;
+
+	/* buffer pools; in: only the ttabuf's, out: only the pcmbuf's */
+	struct FrameQueue		queue;
 
-	/* parallel arrays */
-	/*@temp@*/
-	semaphore_p			*post_decoder;
-	/*@temp@*/
-	size_t				*ni32_perframe;
-	/*@temp@*/
-	size_t				*nbytes_tta_perframe;
-	/*@temp@*/
-	struct DecBuf			*decbuf;
-	/*@temp@*/
-	struct LibTTAr_CodecState_User	*user;
-	/*@temp@*/
-	size_t				*nsamples_flat_2pad;
-	/*@temp@*/
-	int8_t				*dec_retval;
 	/*@temp@*/
-	uint32_t			*crc_read;	/* little-endian */
+	struct DecFrame			*frame;
 };
 
 struct MTArg_Decoder_Frames {
-	struct MTPQueue			queue;
+	unsigned int			nmemb;
 	/*@dependent@*/
-	semaphore_p			*navailable;
+	size_t				*ticket;
+	/*@dependent@*/
+	size_t				*nstall;	/* atomic */
+	struct MTArg_Coder_Bufs		bufs;
 
-	/* parallel arrays */
-	/*@temp@*/
-	semaphore_p			*post_decoder;
+	/* buffer pools */
+	struct FreeList			freelist;	/* inbuf's */
 	/*@temp@*/
-	size_t				*ni32_perframe;
-	/*@temp@*/
-	size_t				*nbytes_tta_perframe;
+	const struct DecBuf		*inbuf;
 	/*@temp@*/
 	struct DecBuf			*decbuf;
+
 	/*@temp@*/
-	struct LibTTAr_CodecState_User	*user;
-	/*@temp@*/
-	size_t				*nsamples_flat_2pad;
-	/*@temp@*/
-	int8_t				*dec_retval;
+	struct DecFrame			*frame;
 };
 
 /* ------------------------------------------------------------------------ */
 
+/* when async, the reader or writer thread does its I/O through the ring,
+     at offset, and the FILE is only synced up with it after the loop (see
+     mtfile_set). with pread (--pread, decode infile), the coders read
+     their own frames at the offsets the reader gives them, so offset is
+     only kept by the reader
+*/
 struct MTArg_IO_File {
 	/*@temp@*/
 	FILE		*handle;
 	/*@temp@*/
 	const char	*name;
+	struct URing	ring;		/* ring.fd is -1 if none     */
+	int		fd;
+	bool		async;
+	bool		pread;
+	off_t		offset;		/* of the next read/write    */
+	off_t		size;		/* infile only               */
+	struct BulkIO	bulk;		/* --bulk-io; the writer's   */
 };
 
 /* ======================================================================== */
@@ -152,6 +258,10 @@ struct MTArg_EncIO {
 	struct MTArg_EncIO_Frames	frames;
 	struct MTArg_IO_File		outfile;
 	struct MTArg_IO_File 		infile;
+	/*@temp@*/ /*@null@*/
+	const uint8_t			*pcmmap;	/* NULL: fread */
+	/*@temp@*/ /*@null@*/
+	struct BlockOut			*block;		/* NULL: writev */
 	/*@temp@*/
 	const struct FileStats_EncMT	*fstat;
 	/*@temp@*/
@@ -172,6 +282,8 @@ struct MTArg_DecIO {
 	struct MTArg_DecIO_Frames	frames;
 	struct MTArg_IO_File		outfile;
 	struct MTArg_IO_File 		infile;
+	/*@temp@*/ /*@null@*/
+	uint8_t				*pcmmap;	/* NULL: write */
 	/*@temp@*/
 	const struct FileStats_DecMT	*fstat;
 	/*@temp@*/
@@ -184,10 +296,55 @@ struct MTArg_Decoder {
 	struct MTArg_Decoder_Frames	frames;
 	/*@temp@*/
 	const struct FileStats_DecMT	*fstat;
+	/*@temp@*/ /*@null@*/
+	FILE				*infile;	/* NULL: no pread */
+	/*@temp@*/
+	const char			*infile_name;
+	/*@temp@*/ /*@null@*/
+	uint8_t				*pcmmap;	/* NULL: pcmbuf */
+};
+
+/* ======================================================================== */
+
+/* the multi-threaded coders, kept across the files of a run. the crew is
+     made for the first file; the buffers are remade only when the frame
+     geometry (i32buf_len, nchan, samplebytes) changes, and otherwise just
+     rewound
+*/
+struct EncMT_State {
+	struct MTArg_EncIO		io;
+	struct MTArg_Encoder		encoder;
+	struct FileStats_EncMT		fstat;
+	struct Crew			crew;
+	unsigned int			nthreads;	/* 0 if no crew    */
+	unsigned int			nspin;
+	size_t				i32buf_len;	/* 0 if no buffers */
+};
+
+struct DecMT_State {
+	struct MTArg_DecIO		io;
+	struct MTArg_Decoder		decoder;
+	struct FileStats_DecMT		fstat;
+	struct Crew			crew;
+	unsigned int			nthreads;	/* 0 if no crew    */
+	unsigned int			nspin;
+	size_t				i32buf_len;	/* 0 if no buffers */
 };
 
 /* //////////////////////////////////////////////////////////////////////// */
 
+#undef arg
+BUILD_EXTERN const struct CoderBufs *coderbufs_take(
+	const struct MTArg_Coder_Bufs *RESTRICT arg,
+	const struct CodecBuf *RESTRICT, const struct CodecBuf *RESTRICT
+)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*arg->id_next
+@*/
+;
+
+/* ------------------------------------------------------------------------ */
 
 #undef fstat_c
 INLINE void encmt_fstat_init(
@@ -202,10 +359,8 @@ INLINE void encmt_fstat_init(
 BUILD_EXTERN void encmt_state_init(
 	/*@out@*/ struct MTArg_EncIO *RESTRICT io,
 	/*@out@*/ struct MTArg_Encoder *RESTRICT encoder,
-	unsigned int, size_t, FILE *RESTRICT, const char *,
-	FILE *RESTRICT, const char *, const struct SeekTable *RESTRICT,
-	const struct EncStats *RESTRICT,
-	const struct FileStats_EncMT *RESTRICT
+	unsigned int, unsigned int, size_t,
+	const struct FileStats_EncMT *RESTRICT, bool
 )
 /*@globals	fileSystem,
 		internalState
@@ -213,14 +368,13 @@ BUILD_EXTERN void encmt_state_init(
 /*@modifies	fileSystem,
 		internalState,
 		*io,
-		*io->frames.navailable,
-		io->frames.post_encoder[],
-		*encoder,
-		encoder->frames.queue.lock
+		*io->frames.ticket,
+		io->frames.frame[],
+		*encoder
 @*/
-/*@allocates	io->frames.navailable,
-		io->frames.encbuf[].pcmbuf,
-		io->frames.encbuf[].ttabuf
+/*@allocates	io->frames.arena.base,
+		io->frames.queue.in.buf[].ttabuf,
+		io->frames.queue.out.buf[].ttabuf
 @*/
 ;
 
@@ -228,19 +382,54 @@ BUILD_EXTERN void encmt_state_init(
 #undef encoder
 BUILD_EXTERN void encmt_state_free(
 	struct MTArg_EncIO *RESTRICT io,
-	struct MTArg_Encoder *RESTRICT encoder, unsigned int
+	struct MTArg_Encoder *RESTRICT encoder
 )
 /*@globals	internalState@*/
 /*@modifies	internalState,
 		*io,
-		*io->frames.navailable,
-		io->frames.post_encoder[],
-		*encoder,
-		encoder->frames.queue.lock
+		*io->frames.ticket,
+		io->frames.frame[],
+		*encoder
+@*/
+/*@releases	io->frames.arena.base,
+		io->frames.queue.in.buf[].ttabuf,
+		io->frames.queue.out.buf[].ttabuf
+@*/
+;
+
+#undef io
+#undef encoder
+BUILD_EXTERN void encmt_state_rewind(
+	struct MTArg_EncIO *RESTRICT io,
+	struct MTArg_Encoder *RESTRICT encoder, unsigned int
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*io,
+		*io->frames.ticket,
+		io->frames.frame[],
+		*encoder
 @*/
-/*@releases	io->frames.navailable,
-		io->frames.encbuf[].pcmbuf,
-		io->frames.encbuf[].ttabuf
+;
+
+#undef io
+BUILD_EXTERN void encmt_state_files(
+	struct MTArg_EncIO *RESTRICT io, FILE *RESTRICT, const char *,
+	FILE *RESTRICT, const char *, /*@null@*/ const uint8_t *,
+	/*@null@*/ struct BlockOut *, const struct SeekTable *RESTRICT,
+	const struct EncStats *RESTRICT
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		io->outfile,
+		io->infile,
+		io->pcmmap,
+		io->block,
+		io->seektable,
+		io->estat_out
 @*/
 ;
 
@@ -259,9 +448,7 @@ INLINE void decmt_fstat_init(
 BUILD_EXTERN void decmt_state_init(
 	/*@out@*/ struct MTArg_DecIO *RESTRICT io,
 	/*@out@*/ struct MTArg_Decoder *RESTRICT decoder,
-	unsigned int, size_t, FILE *RESTRICT, const char *,
-	FILE *RESTRICT, const char *, const struct SeekTable *RESTRICT,
-	const struct DecStats *RESTRICT,
+	unsigned int, unsigned int, size_t,
 	const struct FileStats_DecMT *RESTRICT
 )
 /*@globals	fileSystem,
@@ -270,14 +457,13 @@ BUILD_EXTERN void decmt_state_init(
 /*@modifies	fileSystem,
 		internalState,
 		*io,
-		*io->frames.navailable,
-		io->frames.post_decoder[],
-		*decoder,
-		decoder->frames.queue.lock
+		*io->frames.ticket,
+		io->frames.frame[],
+		*decoder
 @*/
-/*@allocates	io->frames.navailable,
-		io->frames.decbuf[].pcmbuf,
-		io->frames.decbuf[].ttabuf
+/*@allocates	io->frames.arena.base,
+		io->frames.queue.in.buf[].ttabuf,
+		io->frames.queue.out.buf[].ttabuf
 @*/
 ;
 
@@ -285,19 +471,78 @@ BUILD_EXTERN void decmt_state_init(
 #undef decoder
 BUILD_EXTERN void decmt_state_free(
 	struct MTArg_DecIO *RESTRICT io,
-	struct MTArg_Decoder *RESTRICT decoder, unsigned int
+	struct MTArg_Decoder *RESTRICT decoder
 )
 /*@globals	internalState@*/
 /*@modifies	internalState,
 		*io,
-		*io->frames.navailable,
-		io->frames.post_decoder[],
-		*decoder,
-		decoder->frames.queue.lock
+		*io->frames.ticket,
+		io->frames.frame[],
+		*decoder
+@*/
+/*@releases	io->frames.arena.base,
+		io->frames.queue.in.buf[].ttabuf,
+		io->frames.queue.out.buf[].ttabuf
 @*/
-/*@releases	io->frames.navailable,
-		io->frames.decbuf[].pcmbuf,
-		io->frames.decbuf[].ttabuf
+;
+
+#undef io
+#undef decoder
+BUILD_EXTERN void decmt_state_rewind(
+	struct MTArg_DecIO *RESTRICT io,
+	struct MTArg_Decoder *RESTRICT decoder, unsigned int
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*io,
+		*io->frames.ticket,
+		io->frames.frame[],
+		*decoder
+@*/
+;
+
+#undef io
+#undef decoder
+BUILD_EXTERN void decmt_state_files(
+	struct MTArg_DecIO *RESTRICT io,
+	struct MTArg_Decoder *RESTRICT decoder, FILE *RESTRICT, const char *,
+	FILE *RESTRICT, const char *, bool, /*@null@*/ uint8_t *,
+	const struct SeekTable *RESTRICT, const struct DecStats *RESTRICT
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		io->outfile,
+		io->infile,
+		io->pcmmap,
+		io->seektable,
+		io->dstat_out,
+		decoder->infile,
+		decoder->infile_name,
+		decoder->pcmmap
+@*/
+;
+
+/* ------------------------------------------------------------------------ */
+
+#undef file
+BUILD_EXTERN void mtfile_set(
+	struct MTArg_IO_File *RESTRICT file, FILE *RESTRICT, const char *,
+	bool
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*file
+@*/
+;
+
+#undef file
+BUILD_EXTERN void mtfile_sync(const struct MTArg_IO_File *RESTRICT file)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		file->handle
 @*/
 ;
 
@@ -321,6 +566,7 @@ encmt_fstat_init(
 	fstat_c->samplebytes		= fstat->samplebytes;
 	fstat_c->nsamples_perframe	= fstat->framelen;
 	fstat_c->decpcm_size		= fstat->decpcm_size;
+	fstat_c->framefooter_len	= TTA_FRAMEFOOTER_LEN(fstat->encfmt);
 
 	return;
 }
@@ -342,6 +588,7 @@ decmt_fstat_init(
 	fstat_c->samplebytes		= fstat->samplebytes;
 	fstat_c->nsamples_perframe	= fstat->framelen;
 	fstat_c->nsamples_enc		= fstat->nsamples_enc;
+	fstat_c->framefooter_len	= TTA_FRAMEFOOTER_LEN(fstat->encfmt);
 
 	return;
 }
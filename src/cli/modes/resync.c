@@ -0,0 +1,268 @@
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// modes/resync.c                                                           //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2026, Shane Seelig                                         //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//      Rebuilds the seektable of a TTA2 file from its frame footers. Each  //
+// footer starts with a signature and holds the size of the frame before    //
+// it, so the frames can be found without the seektable. The mapped frames  //
+// are split into even pieces, a piece to a thread, and each thread looks   //
+// for the signature in its piece and checks the CRC of the frame that the  //
+// footer says is before it. The footers are then chained in order from    //
+// the first frame; a damaged frame with a good footer is kept where it is, //
+// and one with a damaged footer is stepped over up to the next good frame. //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../libttaR.h"
+
+#include "../alloc.h"
+#include "../byteswap.h"
+#include "../common.h"
+#include "../debug.h"
+#include "../formats.h"
+
+#include "./resync.h"
+#include "./threads.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/* a footer that was found; offsets are from the first frame */
+struct ResyncHit {
+	size_t				start;	/* of its frame            */
+	size_t				end;	/* past the footer         */
+	bool				good;	/* the frame's CRC matches */
+};
+
+/* a thread's piece of the frames, and the footers found in it */
+struct MTArg_Resync {
+	/*@temp@*/
+	const uint8_t			*data;
+	size_t				size;
+	size_t				framesize_max;
+	size_t				lo;	/* first footer offset     */
+	size_t				hi;	/* past the last one       */
+	/*@only@*/ /*@null@*/
+	struct ResyncHit		*hit;
+	size_t				nhit;
+	size_t				limit;
+};
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#undef arg
+START_ROUTINE_ABI
+static start_routine_ret resync_worker(struct MTArg_Resync *RESTRICT arg)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*arg
+@*/
+;
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/**@fn tta2_resync
+ * @brief rebuilds the seektable of a TTA2 file from its frame footers
+ *
+ * @param st            - the new seektable
+ * @param data          - the frames
+ * @param size          - size of 'data'
+ * @param nframes       - number of frames from the header
+ * @param framesize_max - largest believable frame size, without the footer
+ * @param nthreads      - number of threads for the search
+ * @param infile_name   - name of the source file (warnings)
+ *
+ * @return the size of the frames in the new seektable
+ *
+ * @note whatever is after the last footer that could be chained is cut
+**/
+BUILD size_t
+tta2_resync(
+	/*@out@*/ struct SeekTable *const RESTRICT st,
+	const uint8_t *const RESTRICT data, const size_t size,
+	const size_t nframes, const size_t framesize_max,
+	unsigned int nthreads, const char *const RESTRICT infile_name
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*st
+@*/
+{
+	/*@only@*/
+	struct MTArg_Resync *arg;
+	/*@only@*/ /*@null@*/
+	thread_p *thread = NULL;
+	const struct ResyncHit *hit;
+	size_t piece, pos = 0, k;
+	unsigned int i;
+
+	if ( nthreads == 0 ){
+		nthreads = 1u;
+	}
+	piece = (size + nthreads - 1u) / nthreads;
+
+	/* find the footers */
+	arg = calloc_check((size_t) nthreads, sizeof *arg);
+	for ( i = 0; i < nthreads; ++i ){
+		arg[i].data          = data;
+		arg[i].size          = size;
+		arg[i].framesize_max = framesize_max;
+		arg[i].lo            = (piece * i < size ? piece * i : size);
+		arg[i].hi            = (size - arg[i].lo > piece
+			? arg[i].lo + piece : size
+		);
+	}
+	if ( nthreads > 1u ){
+		thread = malloc_check((nthreads - 1u) * (sizeof *thread));
+		for ( i = 1u; i < nthreads; ++i ){
+			thread_create(
+				&thread[i - 1u],
+				(start_routine_ret (*)(void *)) resync_worker,
+				&arg[i]
+			);
+		}
+	}
+	(void) resync_worker(&arg[0]);
+	if ( thread != NULL ){
+		for ( i = 1u; i < nthreads; ++i ){
+			thread_join(&thread[i - 1u]);
+		}
+		free(thread);
+	}
+
+	/* chain them; the pieces are in order, and so is each piece */
+	seektable_init(st, nframes);
+	for ( i = 0; (i < nthreads) && (st->nmemb < nframes); ++i ){
+		for ( k = 0; (k < arg[i].nhit) && (st->nmemb < nframes); ++k ){
+			assert(arg[i].hit != NULL);
+			hit = &arg[i].hit[k];
+			if ( hit->start < pos ){
+				continue;	/* in a frame already taken */
+			}
+			if ( hit->start != pos ){
+				if ( ! hit->good ){
+					continue;
+				}
+				warning_tta("%s: frame %zu at byte %zu: "
+					"damaged footer; resynced at byte %zu",
+					infile_name, st->nmemb, pos, hit->start
+				);
+				seektable_add(
+					st, hit->start - pos, infile_name
+				);
+				pos = hit->start;
+				if ( st->nmemb == nframes ){
+					break;
+				}
+			}
+			seektable_add(st, hit->end - pos, infile_name);
+			pos = hit->end;
+		}
+	}
+
+	/* cleanup */
+	for ( i = 0; i < nthreads; ++i ){
+		free(arg[i].hit);
+	}
+	free(arg);
+
+	return pos;
+}
+
+/**@fn resync_worker
+ * @brief finds the frame footers in a piece of the frames
+ *
+ * @param arg - the piece, and where to put what is found
+ *
+ * @return NULL
+ *
+ * @note the footer can run past the end of the piece, and the frame before
+ *   it nearly always starts in an earlier piece
+**/
+START_ROUTINE_ABI
+static start_routine_ret
+resync_worker(struct MTArg_Resync *const RESTRICT arg)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*arg
+@*/
+{
+	const uint8_t *const RESTRICT data = arg->data;
+	const size_t size                  = arg->size;
+	const size_t framesize_max         = arg->framesize_max;
+	/* * */
+	struct TTA2FrameFooter footer;
+	const uint8_t *found;
+	size_t pos = arg->lo, framesize;
+	struct ResyncHit hit;
+
+	while ( pos < arg->hi ){
+		found = memchr(
+			&data[pos], (int) TTA2_FRAMEFOOTER_SIG[0],
+			arg->hi - pos
+		);
+		if ( found == NULL ){
+			break;
+		}
+		pos = (size_t) (found - data);
+
+		/* check that it is a footer */
+		if ( (size - pos < sizeof footer)
+		    ||
+		     (memcmp(found, TTA2_FRAMEFOOTER_SIG, sizeof footer.sig)
+		      != 0
+		     )
+		){
+			pos += 1u;
+			continue;
+		}
+		memcpy(&footer, found, sizeof footer);
+		framesize = (size_t) byteswap_letoh_u32(footer.size);
+		if ( (framesize == 0) || (framesize > pos)
+		    ||
+		     (framesize > framesize_max)
+		){
+			pos += 1u;
+			continue;
+		}
+
+		/* check the frame before it */
+		hit.start = pos - framesize;
+		hit.end   = pos + sizeof footer;
+		hit.good  = (
+			libttaR_crc32(&data[hit.start], framesize)
+		       ==
+			byteswap_letoh_u32(footer.crc)
+		);
+		if ( arg->nhit == arg->limit ){
+			arg->limit += SEEKTABLE_INIT_DEFAULT;
+			arg->hit    = realloc_check(
+				arg->hit, arg->limit * (sizeof *arg->hit)
+			);
+		}
+		assert(arg->hit != NULL);
+		arg->hit[arg->nhit++] = hit;
+
+		/* the next footer cannot start inside a good one */
+		pos = (hit.good ? hit.end : pos + 1u);
+	}
+	return NULL;
+}
+
+/* EOF //////////////////////////////////////////////////////////////////// */
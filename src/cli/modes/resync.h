@@ -0,0 +1,37 @@
+#ifndef H_TTA_MODES_RESYNC_H
+#define H_TTA_MODES_RESYNC_H
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// modes/resync.h                                                           //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2026, Shane Seelig                                         //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../common.h"
+#include "../formats.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#undef st
+BUILD_EXTERN size_t tta2_resync(
+	/*@out@*/ struct SeekTable *RESTRICT st, const uint8_t *RESTRICT,
+	size_t, size_t, size_t, unsigned int, const char *RESTRICT
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*st
+@*/
+;
+
+/* EOF //////////////////////////////////////////////////////////////////// */
+#endif	/* H_TTA_MODES_RESYNC_H */
@@ -6,16 +6,27 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-//      error checking or asserting threading function wrappers             //
+//      error checking or asserting threading function wrappers. the *_nf   //
+// ones return the error instead of exiting; libttaR_mt uses those, along   //
+// with the rest of "threads.posix.h"                                       //
+//                                                                          //
+//      A waitvar is a 32-bit word that threads can wait on to reach a      //
+// value. The waiter may spin for a bit, then blocks (futex on Linux,       //
+// condvar elsewhere), so a handoff that is already done costs no syscalls, //
+// and the setter only makes a syscall when there is a sleeping waiter.     //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #include "../common.h"
+#include "../debug.h"
 
 /* //////////////////////////////////////////////////////////////////////// */
 
@@ -39,23 +50,22 @@
 /* ------------------------------------------------------------------------ */
 
 #undef thread
-/**@fn thread_create
- * @brief create a thread + error check
+/**@fn thread_create_nf
+ * @brief create a thread
  *
  * @param thread        - pointer to the thread object
  * @param start_routine - function the thread will run
  * @param arg           - argument for the thread function
+ *
+ * @return 0, or the error number
 **/
-INLINE void thread_create(
+INLINE int thread_create_nf(
 	/*@out@*/ thread_p *RESTRICT thread,
 	start_routine_ret (*) (void *) START_ROUTINE_ABI,
 	/*@null@*/ void *RESTRICT
 )
-/*@globals	fileSystem,
-		internalState
-@*/
-/*@modifies	fileSystem,
-		internalState,
+/*@globals	internalState@*/
+/*@modifies	internalState,
 		*thread
 @*/
 ;
@@ -70,29 +80,20 @@ INLINE void thread_join(const thread_p *RESTRICT)
 /*@modifies	internalState@*/
 ;
 
-/**@fn thread_detach_self
- * @brief the calling thread detaches itself
-**/
-INLINE void thread_detach_self(void)
-/*@globals	internalState@*/
-/*@modifies	internalState@*/
-;
-
 /* ------------------------------------------------------------------------ */
 
 #undef sem
-/**@fn semaphore_init
- * @brief initialize a semaphore + error check
+/**@fn semaphore_init_nf
+ * @brief initialize a semaphore
  *
  * @param sem   - pointer to the semaphore
  * @param value - initial value for the semaphore
+ *
+ * @return 0, or the error number
 **/
-INLINE void semaphore_init(/*@out@*/ semaphore_p *RESTRICT sem, unsigned int)
-/*@globals	fileSystem,
-		internalState
-@*/
-/*@modifies	fileSystem,
-		internalState,
+INLINE int semaphore_init_nf(/*@out@*/ semaphore_p *RESTRICT sem, unsigned int)
+/*@globals	internalState@*/
+/*@modifies	internalState,
 		*sem
 @*/
 ;
@@ -138,64 +139,166 @@ ALWAYS_INLINE void semaphore_wait(semaphore_p *RESTRICT sem)
 
 /* ------------------------------------------------------------------------ */
 
-#undef lock
-/**@fn spinlock_init
- * @brief initialize a spinlock + error check
+#undef var
+/**@fn waitvar_init_nf
+ * @brief initialize a waitvar
+ *
+ * @param var   - pointer to the waitvar
+ * @param value - initial value for the waitvar
+ * @param nspin - number of polls before blocking in waitvar_wait()
  *
- * @param lock - pointer to the spinlock
+ * @return 0, or the error number
 **/
-INLINE void spinlock_init(/*@out@*/ spinlock_p *RESTRICT lock)
-/*@globals	fileSystem,
-		internalState
-@*/
-/*@modifies	fileSystem,
-		internalState,
-		*lock
+INLINE int waitvar_init_nf(
+	/*@out@*/ waitvar_p *RESTRICT var, uint32_t, unsigned int
+)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*var
 @*/
 ;
 
-#undef lock
-/**@fn spinlock_destroy
- * @brief destroy a spinlock
+#undef var
+/**@fn waitvar_destroy
+ * @brief destroy a waitvar
  *
- * @param lock - pointer to the spinlock
+ * @param var - pointer to the waitvar
 **/
-INLINE void spinlock_destroy(spinlock_p *RESTRICT lock)
+INLINE void waitvar_destroy(waitvar_p *RESTRICT var)
 /*@globals	internalState@*/
 /*@modifies	internalState,
-		*lock
+		*var
 @*/
 ;
 
-#undef lock
-/**@fn spinlock_lock
- * @brief lock a spinlock
+#undef var
+/**@fn waitvar_set
+ * @brief set a waitvar (release), and wake any blocked waiters
  *
- * @param lock - pointer to the spinlock
+ * @param var   - pointer to the waitvar
+ * @param value - new value for the waitvar
 **/
-ALWAYS_INLINE void spinlock_lock(spinlock_p *RESTRICT lock)
+ALWAYS_INLINE void waitvar_set(waitvar_p *RESTRICT var, uint32_t)
 /*@globals	internalState@*/
 /*@modifies	internalState,
-		*lock
+		*var
 @*/
 ;
 
-#undef lock
-/**@fn spinlock_unlock
- * @brief unlock a spinlock
+#undef var
+/**@fn waitvar_wait
+ * @brief wait for a waitvar to be set to a value (acquire)
  *
- * @param lock - pointer to the spinlock
+ * @param var   - pointer to the waitvar
+ * @param value - value to wait for
 **/
-ALWAYS_INLINE void spinlock_unlock(spinlock_p *RESTRICT lock)
+ALWAYS_INLINE void waitvar_wait(waitvar_p *RESTRICT var, uint32_t)
 /*@globals	internalState@*/
 /*@modifies	internalState,
-		*lock
+		*var
 @*/
 ;
 
+/**@fn waitvar_test
+ * @brief check if a waitvar is set to a value without waiting (acquire)
+ *
+ * @param var   - pointer to the waitvar
+ * @param value - value to check for
+ *
+ * @return true if the waitvar has the value
+**/
+ALWAYS_INLINE bool waitvar_test(const waitvar_p *RESTRICT, uint32_t)
+/*@*/
+;
+
 /* ------------------------------------------------------------------------ */
 
 /*@=redecl@*/
 
+/* //////////////////////////////////////////////////////////////////////// */
+
+/**@fn thread_create
+ * @brief create a thread + error check
+ *
+ * @param thread        - pointer to the thread object
+ * @param start_routine - function the thread will run
+ * @param arg           - argument for the thread function
+**/
+INLINE void
+thread_create(
+	/*@out@*/ thread_p *const RESTRICT thread,
+	start_routine_ret (*const start_routine) (void *) START_ROUTINE_ABI,
+	/*@null@*/ void *const RESTRICT arg
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*thread
+@*/
+{
+	const int err = thread_create_nf(thread, start_routine, arg);
+
+	if UNLIKELY ( err != 0 ){
+		error_sys(err, "thread_create", NULL);
+	}
+	return;
+}
+
+/**@fn semaphore_init
+ * @brief initialize a semaphore + error check
+ *
+ * @param sem   - pointer to the semaphore
+ * @param value - initial value for the semaphore
+**/
+INLINE void
+semaphore_init(
+	/*@out@*/ semaphore_p *const RESTRICT sem, const unsigned int value
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*sem
+@*/
+{
+	const int err = semaphore_init_nf(sem, value);
+
+	if UNLIKELY ( err != 0 ){
+		error_sys(err, "semaphore_init", NULL);
+	}
+	return;
+}
+
+/**@fn waitvar_init
+ * @brief initialize a waitvar + error check
+ *
+ * @param var   - pointer to the waitvar
+ * @param value - initial value for the waitvar
+ * @param nspin - number of polls before blocking in waitvar_wait()
+**/
+INLINE void
+waitvar_init(
+	/*@out@*/ waitvar_p *const RESTRICT var, const uint32_t value,
+	const unsigned int nspin
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*var
+@*/
+{
+	const int err = waitvar_init_nf(var, value, nspin);
+
+	if UNLIKELY ( err != 0 ){
+		error_sys(err, "waitvar_init", NULL);
+	}
+	return;
+}
+
 /* EOF //////////////////////////////////////////////////////////////////// */
 #endif	/* H_TTA_MODES_THREADS_H */
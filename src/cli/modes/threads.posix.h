@@ -6,19 +6,30 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
 
 #include <assert.h>
 #include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
 
 #include <pthread.h>
 #include <semaphore.h>
 
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define X_WAITVAR_FUTEX
+#endif	/* __linux__ */
+
 #include "../common.h"
-#include "../debug.h"
+
+#include "./atomic.h"
 
 /* //////////////////////////////////////////////////////////////////////// */
 
@@ -27,31 +38,33 @@
 typedef /*@null@*/ void *	start_routine_ret;
 typedef pthread_t		thread_p;
 typedef sem_t			semaphore_p;
-typedef pthread_spinlock_t	spinlock_p;
+
+struct WaitVar {
+	uint32_t		value;
+	uint32_t		nwaiters;
+	unsigned int		nspin;
+#ifndef X_WAITVAR_FUTEX
+	pthread_mutex_t		mutex;
+	pthread_cond_t		cond;
+#endif	/* X_WAITVAR_FUTEX */
+};
+typedef struct WaitVar		waitvar_p;
 
 /* //////////////////////////////////////////////////////////////////////// */
 
 /**@see "threads.h" **/
-INLINE void
-thread_create(
+INLINE int
+thread_create_nf(
 	/*@out@*/ thread_p *const RESTRICT thread,
 	start_routine_ret (*const start_routine) (void *) START_ROUTINE_ABI,
 	/*@null@*/ void *const RESTRICT arg
 )
-/*@globals	fileSystem,
-		internalState
-@*/
-/*@modifies	fileSystem,
-		internalState,
+/*@globals	internalState@*/
+/*@modifies	internalState,
 		*thread
 @*/
 {
-	const int err = pthread_create(thread, NULL, start_routine, arg);
-
-	if UNLIKELY ( err != 0 ){
-		error_sys(err, "pthread_create", NULL);
-	}
-	return;
+	return pthread_create(thread, NULL, start_routine, arg);
 }
 
 /**@see "threads.h" **/
@@ -67,41 +80,21 @@ thread_join(const thread_p *const RESTRICT thread)
 	return;
 }
 
-/**@see "threads.h" **/
-INLINE void
-thread_detach_self(void)
-/*@globals	internalState@*/
-/*@modifies	internalState@*/
-{
-	UNUSED const int err = pthread_detach(pthread_self());
-
-	assert(err == 0);
-
-	return;
-
-}
-
 /* ======================================================================== */
 
 /**@see "threads.h" **/
-INLINE void
-semaphore_init(
+INLINE int
+semaphore_init_nf(
 	/*@out@*/ semaphore_p *const RESTRICT sem, const unsigned int value
 )
-/*@globals	fileSystem,
-		internalState
-@*/
-/*@modifies	fileSystem,
-		internalState,
+/*@globals	internalState@*/
+/*@modifies	internalState,
 		*sem
 @*/
 {
 	const int err = sem_init(sem, 0, value);
 
-	if UNLIKELY ( err != 0 ){
-		error_sys(errno, "sem_init", NULL);
-	}
-	return;
+	return (err == 0 ? 0 : errno);
 }
 
 /**@see "threads.h" **/
@@ -159,68 +152,147 @@ try_again:
 /* ======================================================================== */
 
 /**@see "threads.h" **/
-INLINE void
-spinlock_init(/*@out@*/ spinlock_p *const RESTRICT lock)
-/*@globals	fileSystem,
-		internalState
-@*/
-/*@modifies	fileSystem,
-		internalState,
-		*lock
+INLINE int
+waitvar_init_nf(
+	/*@out@*/ waitvar_p *const RESTRICT var, const uint32_t value,
+	const unsigned int nspin
+)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*var
 @*/
 {
-	const int err = pthread_spin_init(lock, PTHREAD_PROCESS_PRIVATE);
+#ifndef X_WAITVAR_FUTEX
+	int err;
+#endif	/* X_WAITVAR_FUTEX */
 
+	var->value    = value;
+	var->nwaiters = 0;
+	var->nspin    = nspin;
+#ifndef X_WAITVAR_FUTEX
+	err = pthread_mutex_init(&var->mutex, NULL);
 	if UNLIKELY ( err != 0 ){
-		error_sys(err, "pthread_spin_init", NULL);
+		return err;
 	}
-	return;
+	err = pthread_cond_init(&var->cond, NULL);
+	if UNLIKELY ( err != 0 ){
+		(void) pthread_mutex_destroy(&var->mutex);
+		return err;
+	}
+#endif	/* X_WAITVAR_FUTEX */
+	return 0;
 }
 
 /**@see "threads.h" **/
 INLINE void
-spinlock_destroy(spinlock_p *const RESTRICT lock)
+waitvar_destroy(waitvar_p *const RESTRICT var)
 /*@globals	internalState@*/
 /*@modifies	internalState,
-		*lock
+		*var
 @*/
 {
-	UNUSED const int err = pthread_spin_destroy(lock);
-
-	assert(err == 0);
-
+	assert(var->nwaiters == 0);
+#ifndef X_WAITVAR_FUTEX
+	{
+		UNUSED int err;
+
+		err = pthread_cond_destroy(&var->cond);
+		assert(err == 0);
+		err = pthread_mutex_destroy(&var->mutex);
+		assert(err == 0);
+	}
+#else
+	(void) var;
+#endif	/* X_WAITVAR_FUTEX */
 	return;
 }
 
 /**@see "threads.h" **/
 ALWAYS_INLINE void
-spinlock_lock(spinlock_p *const RESTRICT lock)
+waitvar_set(waitvar_p *const RESTRICT var, const uint32_t value)
 /*@globals	internalState@*/
 /*@modifies	internalState,
-		*lock
+		*var
 @*/
 {
-	UNUSED const int err = pthread_spin_lock(lock);
-
-	assert(err == 0);
-
+	/* seq_cst on both sides, so either the setter sees the waiter, or
+	     the waiter sees the new value before it sleeps
+	*/
+	atomic_store_u32(&var->value, value);
+	if LIKELY ( atomic_load_u32(&var->nwaiters) == 0 ){
+		return;
+	}
+#ifdef X_WAITVAR_FUTEX
+	(void) syscall(
+		SYS_futex, &var->value, FUTEX_WAKE_PRIVATE, INT_MAX,
+		NULL, NULL, 0
+	);
+#else
+	(void) pthread_mutex_lock(&var->mutex);
+	(void) pthread_cond_broadcast(&var->cond);
+	(void) pthread_mutex_unlock(&var->mutex);
+#endif	/* X_WAITVAR_FUTEX */
 	return;
 }
 
 /**@see "threads.h" **/
 ALWAYS_INLINE void
-spinlock_unlock(spinlock_p *const RESTRICT lock)
+waitvar_wait(waitvar_p *const RESTRICT var, const uint32_t value)
 /*@globals	internalState@*/
 /*@modifies	internalState,
-		*lock
+		*var
 @*/
 {
-	UNUSED const int err = pthread_spin_unlock(lock);
+	uint32_t curr;
+	unsigned int i;
 
-	assert(err == 0);
+	if LIKELY ( atomic_load_acq_u32(&var->value) == value ){
+		return;
+	}
+	for ( i = 0; i < var->nspin; ++i ){
+		cpu_relax();
+		if ( atomic_load_acq_u32(&var->value) == value ){
+			return;
+		}
+	}
 
+#ifdef X_WAITVAR_FUTEX
+	atomic_inc_u32(&var->nwaiters);
+	for (;;){
+		curr = atomic_load_u32(&var->value);
+		if ( curr == value ){
+			break;
+		}
+		/* returns early if the value changed; EINTR is fine too */
+		(void) syscall(
+			SYS_futex, &var->value, FUTEX_WAIT_PRIVATE, curr,
+			NULL, NULL, 0
+		);
+	}
+	atomic_dec_u32(&var->nwaiters);
+#else
+	(void) pthread_mutex_lock(&var->mutex);
+	atomic_inc_u32(&var->nwaiters);
+	for (;;){
+		curr = atomic_load_u32(&var->value);
+		if ( curr == value ){
+			break;
+		}
+		(void) pthread_cond_wait(&var->cond, &var->mutex);
+	}
+	atomic_dec_u32(&var->nwaiters);
+	(void) pthread_mutex_unlock(&var->mutex);
+#endif	/* X_WAITVAR_FUTEX */
 	return;
 }
 
+/**@see "threads.h" **/
+ALWAYS_INLINE bool
+waitvar_test(const waitvar_p *const RESTRICT var, const uint32_t value)
+/*@*/
+{
+	return (atomic_load_acq_u32(&var->value) == value);
+}
+
 /* EOF //////////////////////////////////////////////////////////////////// */
 #endif	/* H_TTA_MODES_THREADS_POSIX_H */
@@ -6,17 +6,20 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
 
 #include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
 
 #include <windows.h>
 
 #include "../common.h"
-#include "../debug.h"
+
+#include "./atomic.h"
 
 /* //////////////////////////////////////////////////////////////////////// */
 
@@ -49,22 +52,27 @@
 typedef DWORD			start_routine_ret;
 typedef HANDLE			thread_p;
 typedef HANDLE			semaphore_p;
-typedef CRITICAL_SECTION	spinlock_p;
+
+struct WaitVar {
+	uint32_t		value;
+	uint32_t		nwaiters;
+	unsigned int		nspin;
+	SRWLOCK			lock;
+	CONDITION_VARIABLE	cond;
+};
+typedef struct WaitVar		waitvar_p;
 
 /* //////////////////////////////////////////////////////////////////////// */
 
 /**@see "threads.h" **/
-INLINE void
-thread_create(
+INLINE int
+thread_create_nf(
 	/*@out@*/ thread_p *const RESTRICT thread,
 	start_routine_ret (*const start_routine) (void *) START_ROUTINE_ABI,
 	/*@null@*/ void *const RESTRICT arg
 )
-/*@globals	fileSystem,
-		internalState
-@*/
-/*@modifies	fileSystem,
-		internalState,
+/*@globals	internalState@*/
+/*@modifies	internalState,
 		*thread
 @*/
 {
@@ -72,10 +80,7 @@ thread_create(
 		NULL, 0, start_routine, arg, 0, NULL
 	);
 
-	if UNLIKELY ( *thread == NULL ){
-		error_sys((int) GetLastError(), "CreateThread", NULL);
-	}
-	return;
+	return (*thread != NULL ? 0 : (int) GetLastError());
 }
 
 /**@see "threads.h" **/
@@ -91,40 +96,21 @@ thread_join(const thread_p *const RESTRICT thread)
 	return;
 }
 
-/**@see "threads.h" **/
-INLINE void
-thread_detach_self(void)
-/*@globals	internalState@*/
-/*@modifies	internalState@*/
-{
-	UNUSED const BOOL err = CloseHandle(GetCurrentThread());
-
-	assert(err != 0);
-
-	return;
-}
-
 /* ======================================================================== */
 
 /**@see "threads.h" **/
-INLINE void
-semaphore_init(
+INLINE int
+semaphore_init_nf(
 	/*@out@*/ semaphore_p *const RESTRICT sem, const unsigned int value
 )
-/*@globals	fileSystem,
-		internalState
-@*/
-/*@modifies	fileSystem,
-		internalState,
+/*@globals	internalState@*/
+/*@modifies	internalState,
 		*sem
 @*/
 {
 	*sem = CreateSemaphoreA(NULL, (LONG) value, LONG_MAX, NULL);
 
-	if UNLIKELY ( *sem == NULL ){
-		error_sys((int) GetLastError(), "CreateSemaphoreA", NULL);
-	}
-	return;
+	return (*sem != NULL ? 0 : (int) GetLastError());
 }
 
 /**@see "threads.h" **/
@@ -175,59 +161,99 @@ semaphore_wait(semaphore_p *const RESTRICT sem)
 //==========================================================================//
 
 /**@see "threads.h" **/
-INLINE void
-spinlock_init(/*@out@*/ spinlock_p *const RESTRICT lock)
-/*@globals	fileSystem,
-		internalState
-@*/
-/*@modifies	fileSystem,
-		internalState,
-		*lock
+INLINE int
+waitvar_init_nf(
+	/*@out@*/ waitvar_p *const RESTRICT var, const uint32_t value,
+	const unsigned int nspin
+)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*var
 @*/
 {
-	InitializeCriticalSection(lock);
+	var->value    = value;
+	var->nwaiters = 0;
+	var->nspin    = nspin;
+	InitializeSRWLock(&var->lock);
+	InitializeConditionVariable(&var->cond);
 
-	return;
+	return 0;
 }
 
 /**@see "threads.h" **/
 INLINE void
-spinlock_destroy(spinlock_p *const RESTRICT lock)
+waitvar_destroy(waitvar_p *const RESTRICT var)
 /*@globals	internalState@*/
 /*@modifies	internalState,
-		*lock
+		*var
 @*/
 {
-	DeleteCriticalSection(lock);
+	/* SRW locks and condition variables have nothing to free */
+	assert(var->nwaiters == 0);
+	(void) var;
 
 	return;
 }
 
 /**@see "threads.h" **/
 ALWAYS_INLINE void
-spinlock_lock(spinlock_p *const RESTRICT lock)
+waitvar_set(waitvar_p *const RESTRICT var, const uint32_t value)
 /*@globals	internalState@*/
 /*@modifies	internalState,
-		*lock
+		*var
 @*/
 {
-	EnterCriticalSection(lock);
+	atomic_store_u32(&var->value, value);
+	if LIKELY ( atomic_load_u32(&var->nwaiters) == 0 ){
+		return;
+	}
+	AcquireSRWLockExclusive(&var->lock);
+	WakeAllConditionVariable(&var->cond);
+	ReleaseSRWLockExclusive(&var->lock);
 
 	return;
 }
 
 /**@see "threads.h" **/
 ALWAYS_INLINE void
-spinlock_unlock(spinlock_p *const RESTRICT lock)
+waitvar_wait(waitvar_p *const RESTRICT var, const uint32_t value)
 /*@globals	internalState@*/
 /*@modifies	internalState,
-		*lock
+		*var
 @*/
 {
-	LeaveCriticalSection(lock);
+	unsigned int i;
+
+	if LIKELY ( atomic_load_acq_u32(&var->value) == value ){
+		return;
+	}
+	for ( i = 0; i < var->nspin; ++i ){
+		cpu_relax();
+		if ( atomic_load_acq_u32(&var->value) == value ){
+			return;
+		}
+	}
+
+	AcquireSRWLockExclusive(&var->lock);
+	atomic_inc_u32(&var->nwaiters);
+	while ( atomic_load_u32(&var->value) != value ){
+		(void) SleepConditionVariableSRW(
+			&var->cond, &var->lock, INFINITE, 0
+		);
+	}
+	atomic_dec_u32(&var->nwaiters);
+	ReleaseSRWLockExclusive(&var->lock);
 
 	return;
 }
 
+/**@see "threads.h" **/
+ALWAYS_INLINE bool
+waitvar_test(const waitvar_p *const RESTRICT var, const uint32_t value)
+/*@*/
+{
+	return (atomic_load_acq_u32(&var->value) == value);
+}
+
 /* EOF //////////////////////////////////////////////////////////////////// */
 #endif	/* H_TTA_MODES_THREADS_WIN32_H */
@@ -0,0 +1,552 @@
+#ifndef H_TTA_MODES_URING_H
+#define H_TTA_MODES_URING_H
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// modes/uring.h                                                            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//      A bare io_uring for the reader and writer threads of the multi-     //
+// threaded coders, so that they can keep several reads or writes in flight //
+// instead of one blocking stdio call at a time. Only what they need is     //
+// here, straight on top of the syscalls (no liburing). A ring belongs to   //
+// one thread. Each request is a read or a write at an explicit offset,     //
+// tagged with a number that comes back with its completion; completions    //
+// come in any order. A buffer in the range registered with uring_register  //
+// goes through the _FIXED ops, which skips pinning its pages every time.   //
+// Anything other than Linux 5.6+ gets a ring that fails to init, and the   //
+// callers fall back to stdio.                                              //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <sys/types.h>
+
+#if defined(__linux__) && (! defined(URING_DISABLE))
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) \
+ && defined(__NR_io_uring_enter) \
+ && defined(__NR_io_uring_register)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#ifdef IORING_FEAT_RW_CUR_POS
+#define X_URING_LINUX
+#endif	/* IORING_FEAT_RW_CUR_POS */
+#endif	/* __NR_io_uring_setup */
+#endif	/* __linux__ */
+
+#include "../common.h"
+#include "../system.h"
+
+#include "./atomic.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/* max number of requests a ring has in flight. a few frames ahead is
+     enough to keep a deep device queue busy; more just ties up buffers
+*/
+#ifndef URING_DEPTH
+#define URING_DEPTH		8u
+#endif
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+struct URing {
+	int		fd;		/* -1 if not in use          */
+	unsigned int	nflight;	/* prepared, not reaped      */
+	unsigned int	nprep;		/* prepared, not submitted   */
+	uint32_t	sq_tail;	/* published on submit       */
+	/*@dependent@*/
+	uint32_t	*sq_ktail;
+	/*@dependent@*/
+	const uint32_t	*sq_mask;
+	/*@dependent@*/
+	uint32_t	*sq_array;
+	/*@dependent@*/
+	uint32_t	*cq_khead;
+	/*@dependent@*/
+	const uint32_t	*cq_ktail;
+	/*@dependent@*/
+	const uint32_t	*cq_mask;
+	/*@dependent@*/
+	void		*sqes;
+	/*@dependent@*/
+	const void	*cqes;
+	/*@null@*/ /*@owned@*/
+	void		*sq_ring;
+	/*@null@*/ /*@owned@*/
+	void		*cq_ring;	/* sq_ring if a single mmap  */
+	/*@null@*/ /*@owned@*/
+	void		*sqes_map;
+	size_t		sq_ring_size;
+	size_t		cq_ring_size;
+	size_t		sqes_size;
+	/*@null@*/ /*@dependent@*/
+	const uint8_t	*fixed_base;	/* registered buffer 0       */
+	size_t		fixed_size;
+};
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#undef ring
+INLINE void uring_free(struct URing *RESTRICT ring)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*ring
+@*/
+;
+
+#ifdef X_URING_LINUX
+#undef ring
+ALWAYS_INLINE struct io_uring_sqe *uring_sqe_get(struct URing *RESTRICT ring)
+/*@modifies	*ring@*/
+;
+#endif	/* X_URING_LINUX */
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/**@fn uring_init
+ * @brief sets up a ring
+ *
+ * @param ring - the ring
+ *
+ * @return true on success; false if io_uring is not supported or is not
+ *   allowed, and then ring->fd is -1
+**/
+INLINE bool
+uring_init(/*@out@*/ struct URing *const RESTRICT ring)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*ring
+@*/
+{
+#ifdef X_URING_LINUX
+	struct io_uring_params p;
+	uint8_t *sq, *cq;
+	long fd;
+
+	memset(ring, 0x00, sizeof *ring);
+	ring->fd = -1;
+
+	memset(&p, 0x00, sizeof p);
+	fd = syscall(__NR_io_uring_setup, URING_DEPTH, &p);
+	if ( fd < 0 ){
+		return false;
+	}
+	ring->fd = (int) fd;
+
+	/* IORING_OP_READ/WRITE came with the same kernel (5.6) */
+	if ( (p.features & IORING_FEAT_RW_CUR_POS) == 0 ){
+		goto fail;
+	}
+
+	ring->sq_ring_size = p.sq_off.array + (p.sq_entries * sizeof(uint32_t));
+	ring->cq_ring_size = p.cq_off.cqes + (
+		p.cq_entries * sizeof(struct io_uring_cqe)
+	);
+	if ( (p.features & IORING_FEAT_SINGLE_MMAP) != 0 ){
+		if ( ring->cq_ring_size > ring->sq_ring_size ){
+			ring->sq_ring_size = ring->cq_ring_size;
+		}
+		ring->cq_ring_size = ring->sq_ring_size;
+	}
+
+	sq = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE,
+		MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING
+	);
+	if UNLIKELY ( sq == MAP_FAILED ){
+		goto fail;
+	}
+	ring->sq_ring = sq;
+
+	if ( (p.features & IORING_FEAT_SINGLE_MMAP) != 0 ){
+		cq = sq;
+	}
+	else {	cq = mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_POPULATE, ring->fd,
+			IORING_OFF_CQ_RING
+		);
+		if UNLIKELY ( cq == MAP_FAILED ){
+			goto fail;
+		}
+	}
+	ring->cq_ring = cq;
+
+	ring->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+	ring->sqes_map  = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+		MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES
+	);
+	if UNLIKELY ( ring->sqes_map == MAP_FAILED ){
+		ring->sqes_map = NULL;
+		goto fail;
+	}
+
+	ring->sq_ktail  = (uint32_t *) &sq[p.sq_off.tail];
+	ring->sq_mask   = (uint32_t *) &sq[p.sq_off.ring_mask];
+	ring->sq_array  = (uint32_t *) &sq[p.sq_off.array];
+	ring->sqes      = ring->sqes_map;
+	ring->cq_khead  = (uint32_t *) &cq[p.cq_off.head];
+	ring->cq_ktail  = (uint32_t *) &cq[p.cq_off.tail];
+	ring->cq_mask   = (uint32_t *) &cq[p.cq_off.ring_mask];
+	ring->cqes      = &cq[p.cq_off.cqes];
+	ring->sq_tail   = *ring->sq_ktail;
+
+	return true;
+fail:
+	uring_free(ring);
+	return false;
+#else
+	memset(ring, 0x00, sizeof *ring);
+	ring->fd = -1;
+	return false;
+#endif	/* X_URING_LINUX */
+}
+
+/**@fn uring_free
+ * @brief tears down a ring; a no-op if it is not in use
+ *
+ * @param ring - the ring
+**/
+INLINE void
+uring_free(struct URing *const RESTRICT ring)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*ring
+@*/
+{
+#ifdef X_URING_LINUX
+	if ( ring->sqes_map != NULL ){
+		(void) munmap(ring->sqes_map, ring->sqes_size);
+	}
+	if ( (ring->cq_ring != NULL) && (ring->cq_ring != ring->sq_ring) ){
+		(void) munmap(ring->cq_ring, ring->cq_ring_size);
+	}
+	if ( ring->sq_ring != NULL ){
+		(void) munmap(ring->sq_ring, ring->sq_ring_size);
+	}
+	if ( ring->fd >= 0 ){
+		(void) close(ring->fd);
+	}
+#endif	/* X_URING_LINUX */
+	memset(ring, 0x00, sizeof *ring);
+	ring->fd = -1;
+	return;
+}
+
+/**@fn uring_register
+ * @brief registers the one fixed buffer of a ring
+ *
+ * @param ring - the ring
+ * @param base - start of the buffer
+ * @param size - size of the buffer
+ *
+ * @return true on success; false if, say, it is over RLIMIT_MEMLOCK, and
+ *   then the ring just uses the plain ops
+ *
+ * @note the pages of the buffer are pinned until the ring is torn down, so
+ *   they must not be given back (pages_discard) in the meantime
+**/
+INLINE bool
+uring_register(
+	struct URing *const RESTRICT ring, const void *const base,
+	const size_t size
+)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*ring
+@*/
+{
+#ifdef X_URING_LINUX
+	struct iovec iov;
+
+	assert(ring->fd >= 0);
+
+	iov.iov_base = (void *) base;
+	iov.iov_len  = size;
+	if ( syscall(__NR_io_uring_register, ring->fd,
+		IORING_REGISTER_BUFFERS, &iov, 1u) != 0
+	){
+		return false;
+	}
+	ring->fixed_base = base;
+	ring->fixed_size = size;
+	return true;
+#else
+	(void) ring;
+	(void) base;
+	(void) size;
+	return false;
+#endif	/* X_URING_LINUX */
+}
+
+/**@fn uring_fd
+ * @brief the file descriptor of a FILE, for the requests
+ *
+ * @param file - the FILE
+ *
+ * @return the file descriptor; -1 where there is no ring
+**/
+PURE
+ALWAYS_INLINE int
+uring_fd(FILE *const RESTRICT file)
+/*@*/
+{
+#ifdef X_URING_LINUX
+	return fileno(file);
+#else
+	(void) file;
+	return -1;
+#endif	/* X_URING_LINUX */
+}
+
+/* ------------------------------------------------------------------------ */
+
+#ifdef X_URING_LINUX
+/**@fn uring_sqe_get
+ * @brief takes the next submission queue entry, and clears it
+ *
+ * @param ring - the ring
+ *
+ * @return the entry
+**/
+ALWAYS_INLINE struct io_uring_sqe *
+uring_sqe_get(struct URing *const RESTRICT ring)
+/*@modifies	*ring@*/
+{
+	const uint32_t idx = ring->sq_tail & *ring->sq_mask;
+	struct io_uring_sqe *const sqe = &((struct io_uring_sqe *)
+		ring->sqes
+	)[idx];
+
+	assert(ring->nflight < URING_DEPTH);
+
+	memset(sqe, 0x00, sizeof *sqe);
+	ring->sq_array[idx] = idx;
+	ring->sq_tail      += 1u;
+	ring->nprep        += 1u;
+	ring->nflight      += 1u;
+	return sqe;
+}
+#endif	/* X_URING_LINUX */
+
+/**@fn uring_rw
+ * @brief prepares a read or a write
+ *
+ * @param ring  - the ring
+ * @param write - whether it is a write
+ * @param fd    - file descriptor
+ * @param buf   - the buffer
+ * @param len   - number of bytes
+ * @param off   - offset in the file
+ * @param tag   - comes back with the completion
+**/
+ALWAYS_INLINE void
+uring_rw(
+	struct URing *const RESTRICT ring, const bool write, const int fd,
+	const void *const buf, const size_t len, const off_t off,
+	const uint64_t tag
+)
+/*@modifies	*ring@*/
+{
+#ifdef X_URING_LINUX
+	struct io_uring_sqe *const sqe = uring_sqe_get(ring);
+	const bool fixed = ((ring->fixed_base != NULL)
+	                   &&
+	                    ((const uint8_t *) buf >= ring->fixed_base)
+	                   &&
+	                    ((const uint8_t *) buf + len
+	                     <= ring->fixed_base + ring->fixed_size
+	                    )
+	);
+
+	assert(len <= UINT32_MAX);
+
+	if ( fixed ){
+		sqe->opcode    = (uint8_t) (write
+			? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED
+		);
+		sqe->buf_index = 0;
+	}
+	else {	sqe->opcode    = (uint8_t) (write
+			? IORING_OP_WRITE : IORING_OP_READ
+		);
+	}
+	sqe->fd        = fd;
+	sqe->addr      = (uint64_t) (uintptr_t) buf;
+	sqe->len       = (uint32_t) len;
+	sqe->off       = (uint64_t) off;
+	sqe->user_data = tag;
+#else
+	(void) ring;
+	(void) write;
+	(void) fd;
+	(void) buf;
+	(void) len;
+	(void) off;
+	(void) tag;
+	assert(false);
+#endif	/* X_URING_LINUX */
+	return;
+}
+
+/**@fn uring_writev
+ * @brief prepares a gather write
+ *
+ * @param ring - the ring
+ * @param fd   - file descriptor
+ * @param iov  - the gather list; kept until the completion
+ * @param niov - number of entries in iov
+ * @param off  - offset in the file
+ * @param tag  - comes back with the completion
+**/
+ALWAYS_INLINE void
+uring_writev(
+	struct URing *const RESTRICT ring, const int fd,
+	const iovec_p *const iov, const unsigned int niov, const off_t off,
+	const uint64_t tag
+)
+/*@modifies	*ring@*/
+{
+#ifdef X_URING_LINUX
+	struct io_uring_sqe *const sqe = uring_sqe_get(ring);
+
+	sqe->opcode    = (uint8_t) IORING_OP_WRITEV;
+	sqe->fd        = fd;
+	sqe->addr      = (uint64_t) (uintptr_t) iov;
+	sqe->len       = (uint32_t) niov;
+	sqe->off       = (uint64_t) off;
+	sqe->user_data = tag;
+#else
+	(void) ring;
+	(void) fd;
+	(void) iov;
+	(void) niov;
+	(void) off;
+	(void) tag;
+	assert(false);
+#endif	/* X_URING_LINUX */
+	return;
+}
+
+/**@fn uring_submit
+ * @brief submits what has been prepared
+ *
+ * @param ring - the ring
+ *
+ * @return true on success, else false (errno is set)
+**/
+INLINE bool
+uring_submit(struct URing *const RESTRICT ring)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*ring
+@*/
+{
+#ifdef X_URING_LINUX
+	long result;
+
+	if ( ring->nprep == 0 ){
+		return true;
+	}
+	atomic_store_u32(ring->sq_ktail, ring->sq_tail);
+
+	while ( ring->nprep != 0 ){
+		result = syscall(__NR_io_uring_enter, ring->fd,
+			ring->nprep, 0u, 0u, NULL, (size_t) 0
+		);
+		if UNLIKELY ( result < 0 ){
+			if ( errno == EINTR ){
+				continue;
+			}
+			return false;
+		}
+		ring->nprep -= (unsigned int) result;
+	}
+	return true;
+#else
+	(void) ring;
+	return true;
+#endif	/* X_URING_LINUX */
+}
+
+/**@fn uring_reap
+ * @brief takes the next completion
+ *
+ * @param ring - the ring
+ * @param wait - whether to wait for one
+ * @param tag  - the tag of the request
+ * @param res  - its result; bytes done, or a negated errno
+ *
+ * @return true if there was one; false if there was none and not waiting,
+ *   or on failure (errno is set)
+ *
+ * @pre when waiting, something is in flight
+**/
+INLINE bool
+uring_reap(
+	struct URing *const RESTRICT ring, const bool wait,
+	/*@out@*/ uint64_t *const RESTRICT tag,
+	/*@out@*/ int32_t *const RESTRICT res
+)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*ring,
+		*tag,
+		*res
+@*/
+{
+#ifdef X_URING_LINUX
+	const struct io_uring_cqe *cqe;
+	uint32_t head;
+	long result;
+
+	assert((! wait) || (ring->nflight != 0));
+
+	for (;;){
+		head = *ring->cq_khead;
+		if ( head != atomic_load_acq_u32(ring->cq_ktail) ){
+			cqe  = &((const struct io_uring_cqe *) ring->cqes)[
+				head & *ring->cq_mask
+			];
+			*tag = cqe->user_data;
+			*res = cqe->res;
+			atomic_store_u32(ring->cq_khead, head + 1u);
+			ring->nflight -= 1u;
+			return true;
+		}
+		if ( ! wait ){
+			return false;
+		}
+		result = syscall(__NR_io_uring_enter, ring->fd, 0u, 1u,
+			(unsigned int) IORING_ENTER_GETEVENTS, NULL,
+			(size_t) 0
+		);
+		if UNLIKELY ( (result < 0) && (errno != EINTR) ){
+			return false;
+		}
+	}
+#else
+	(void) ring;
+	(void) wait;
+	*tag = 0;
+	*res = 0;
+	return false;
+#endif	/* X_URING_LINUX */
+}
+
+/* EOF //////////////////////////////////////////////////////////////////// */
+#endif	/* H_TTA_MODES_URING_H */
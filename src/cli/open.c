@@ -4,7 +4,7 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
@@ -142,7 +142,7 @@ try_fdlimit(void)
  * @brief add a file to the opened files struct array
  *
  * @param of   - opened files struct array
- * @param name - name of the opened file (from argv)
+ * @param name - name of the opened file (from argv); "-" for stdin
  *
  * @return 0 on success, else errno
 **/
@@ -171,9 +171,13 @@ openedfiles_add(
 	 added = &of->file[of->nmemb - 1u];
 	*added = calloc_check(SIZE_C(1), sizeof **added);
 
-	(*added)->infile = fopen_check(name, "rb", NONFATAL);
-	if ( (*added)->infile == NULL ){
-		retval = errno;
+	if ( strcmp(name, STDIN_NAME) == 0 ){
+		(*added)->infile = stdin;
+	}
+	else {	(*added)->infile = fopen_check(name, "rb", NONFATAL);
+		if ( (*added)->infile == NULL ){
+			retval = errno;
+		}
 	}
 	(*added)->infile_name = name;
 
@@ -218,7 +222,7 @@ openedfiles_close_free(struct OpenedFiles *const RESTRICT of)
  * @brief gets/set the file stats of an opened file
  *
  * @param ofm  - opened files struct array member
- * @param mode - encode or decode
+ * @param mode - encode, decode, or test
  *
  * @return 0 on success, else number of errors
 **/
@@ -233,6 +237,7 @@ filestats_get(
 @*/
 {
 	unsigned int retval = 0;
+	off_t size;
 	union {	int		d;
 		enum FileCheck	fc;
 	} result;
@@ -245,13 +250,17 @@ filestats_get(
 	/* check for supported filetypes and fill most of fstat */
 	if ( (mode == MODE_ENCODE) && g_flag.rawpcm ){
 		rawpcm_statcopy(&ofm->fstat);
-		/* MAYBE: mode for 'stdin' reading */
+		ofm->fstat.decpcm_off  = 0;
 		result.d = fseeko(ofm->infile, 0, SEEK_END);
-		if UNLIKELY ( result.d != 0 ){
+		if ( (result.d != 0) && (errno == ESPIPE) ){
+			/* read until it ends */
+			ofm->fstat.decpcm_off  = -1;
+			ofm->fstat.decpcm_size = DECPCM_SIZE_UNKNOWN;
+		}
+		else if UNLIKELY ( result.d != 0 ){
 			error_sys(errno, "fseeko", ofm->infile_name);
 		}
-		ofm->fstat.decpcm_off  = 0;
-		ofm->fstat.decpcm_size = (size_t) ftello(ofm->infile);
+		else {	ofm->fstat.decpcm_size = (size_t) ftello(ofm->infile); }
 	}
 	else {	result.fc = filecheck_codecfmt(
 			&ofm->fstat, ofm->infile, ofm->infile_name, mode
@@ -259,6 +268,19 @@ filestats_get(
 		if ( result.fc != FILECHECK_OK ){
 			return 1u;
 		}
+		/* the size of the data was not known when it was written, but
+		     the file has one now
+		*/
+		if ( (ofm->fstat.decpcm_size == DECPCM_SIZE_UNKNOWN)
+		    &&
+		     file_regsize(ofm->infile, &size)
+		    &&
+		     (size >= ofm->fstat.decpcm_off)
+		){
+			ofm->fstat.decpcm_size = (size_t) (
+				size - ofm->fstat.decpcm_off
+			);
+		}
 	}
 
 	/* the rest of fstat */
@@ -291,6 +313,25 @@ filestats_get(
 		retval += 1u;
 	}
 
+	/* the coded region will be read through once; the read ahead and the
+	     drop-behind are done window by window as it is coded (bulkio.h)
+	*/
+	if ( g_flag.bulk_io && (retval == 0) && (ofm->fstat.decpcm_off >= 0) ){
+		if ( mode == MODE_ENCODE ){
+			file_advise(
+				ofm->infile, ofm->fstat.decpcm_off,
+				(off_t) ofm->fstat.decpcm_size,
+				FILE_ADVICE_SEQUENTIAL
+			);
+		}
+		else {	file_advise(
+				ofm->infile, ofm->fstat.enctta_off,
+				(off_t) ofm->fstat.enctta_size,
+				FILE_ADVICE_SEQUENTIAL
+			);
+		}
+	}
+
 	return retval;
 }
 
@@ -302,7 +343,7 @@ filestats_get(
  * @param fstat    - bloated file stats struct
  * @param file     - source file
  * @param filename - the name of the source file (errors)
- * @param mode     - encode or decode
+ * @param mode     - encode, decode, or test
  *
  * @return FILECHECK_OK on success
 **/
@@ -320,10 +361,14 @@ filecheck_codecfmt(
 {
 	union {	enum FileCheck	fc; } result;
 
-	/* seek past any metadata on the input file */
-	result.fc = metatags_skip(file);
-	if ( result.fc != FILECHECK_MISMATCH ){
-		goto end_error;
+	/* seek past any metadata on the input file; a pipe cannot be put
+	     back after a mismatch, so it has to start with the WAV
+	*/
+	if ( ftello(file) >= 0 ){
+		result.fc = metatags_skip(file);
+		if ( result.fc != FILECHECK_MISMATCH ){
+			goto end_error;
+		}
 	}
 
 	switch ( mode ){
@@ -343,11 +388,20 @@ filecheck_codecfmt(
 		}
 		goto end_error;
 	case MODE_DECODE:
+	case MODE_TEST:
 		/* tta1 */
 		result.fc = filecheck_tta1(fstat, file);
 		if ( result.fc == FILECHECK_OK ){
 			break;
 		}
+		if ( result.fc != FILECHECK_MISMATCH ){
+			goto end_error;
+		}
+		/* tta2 */
+		result.fc = filecheck_tta2(fstat, file);
+		if ( result.fc == FILECHECK_OK ){
+			break;
+		}
 		goto end_error;
 	}
 
@@ -419,7 +473,7 @@ get_decfmt_sfx(const enum DecFormat fmt)
 **/
 /*@only@*/
 BUILD NOINLINE char *
-get_outfile_name(const char *const infile_name, const char *const sfx)
+get_outfile_name(const char *infile_name, const char *const sfx)
 /*@globals	internalState,
 		fileSystem
 @*/
@@ -432,6 +486,11 @@ get_outfile_name(const char *const infile_name, const char *const sfx)
 	const char *outfile_dir  = NULL;
 	const char *outfile_sfx  = NULL;
 
+	/* stdin has no name to go off of */
+	if ( strcmp(infile_name, STDIN_NAME) == 0 ){
+		infile_name = STDIN_OUTFILE_NAME;
+	}
+
 	if ( g_flag.outfile != NULL ){
 		if ( g_flag.outfile_is_dir ){
 			outfile_dir  = g_flag.outfile;
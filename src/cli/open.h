@@ -6,7 +6,7 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
@@ -18,6 +18,15 @@
 
 /* //////////////////////////////////////////////////////////////////////// */
 
+/* infile name for stdin, and the name its outfile is made from */
+#define STDIN_NAME		"-"
+#define STDIN_OUTFILE_NAME	"stdin"
+
+/* outfile name for stdout */
+#define STDOUT_NAME		"-"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
 struct OpenedFilesMember {
 	/*@dependent@*/ /*@relnull@*/
 	FILE			*infile;
@@ -6,7 +6,7 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
@@ -26,6 +26,10 @@ BUILD_EXTERN const struct OptDict encode_optdict;
 /*@unchecked@*/
 BUILD_EXTERN const struct OptDict decode_optdict;
 
+/*@unchecked@*/
+BUILD_EXTERN const struct OptDict test_optdict;
+BUILD_EXTERN const struct OptDict repair_optdict;
+
 /*@=redef@*/
 
 /* //////////////////////////////////////////////////////////////////////// */
@@ -4,7 +4,7 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
@@ -100,6 +100,56 @@ opt_common_multi_threaded(
 	return 0;
 }
 
+/**@fn opt_common_affinity
+ * @brief enables pinning the threads to processors
+ *
+ * @param optind0 - unused
+ * @param optind1 - unused
+ * @param argc    - unused
+ * @param argv    - unused
+ * @param mode    - unused
+ *
+ * @return 0
+**/
+BUILD int
+opt_common_affinity(
+	UNUSED const unsigned int optind0, UNUSED const unsigned int optind1,
+	UNUSED const unsigned int argc, UNUSED char *const *const argv,
+	UNUSED const enum OptMode mode
+)
+/*@globals	g_flag@*/
+/*@modifies	g_flag.affinity@*/
+{
+	g_flag.affinity = true;
+
+	return 0;
+}
+
+/**@fn opt_common_bulk_io
+ * @brief enables the page cache hints and drop-behind for bulk jobs
+ *
+ * @param optind0 - unused
+ * @param optind1 - unused
+ * @param argc    - unused
+ * @param argv    - unused
+ * @param mode    - unused
+ *
+ * @return 0
+**/
+BUILD int
+opt_common_bulk_io(
+	UNUSED const unsigned int optind0, UNUSED const unsigned int optind1,
+	UNUSED const unsigned int argc, UNUSED char *const *const argv,
+	UNUSED const enum OptMode mode
+)
+/*@globals	g_flag@*/
+/*@modifies	g_flag.bulk_io@*/
+{
+	g_flag.bulk_io = true;
+
+	return 0;
+}
+
 /**@fn opt_common_delete_src
  * @brief enables the delete source files flag
  *
@@ -6,7 +6,7 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
@@ -38,6 +38,20 @@ BUILD_EXTERN int opt_common_multi_threaded(
 /*@modifies	g_flag.threadmode@*/
 ;
 
+BUILD_EXTERN int opt_common_affinity(
+	unsigned int, unsigned int, unsigned int, char *const *, enum OptMode
+)
+/*@globals	g_flag@*/
+/*@modifies	g_flag.affinity@*/
+;
+
+BUILD_EXTERN int opt_common_bulk_io(
+	unsigned int, unsigned int, unsigned int, char *const *, enum OptMode
+)
+/*@globals	g_flag@*/
+/*@modifies	g_flag.bulk_io@*/
+;
+
 BUILD_EXTERN int opt_common_delete_src(
 	unsigned int, unsigned int, unsigned int, char *const *, enum OptMode
 )
@@ -4,7 +4,7 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
@@ -40,6 +40,38 @@ static int opt_decode_format(
 @*/
 ;
 
+static int opt_decode_mmap(
+	unsigned int, unsigned int, unsigned int, char *const *, enum OptMode
+)
+/*@globals	g_flag@*/
+/*@modifies	g_flag.mmap_out@*/
+;
+
+static int opt_decode_pread(
+	unsigned int, unsigned int, unsigned int, char *const *, enum OptMode
+)
+/*@globals	g_flag@*/
+/*@modifies	g_flag.pread@*/
+;
+
+#undef argv
+static int opt_decode_subframe(
+	unsigned int, unsigned int, unsigned int, char *const *argv,
+	enum OptMode
+)
+/*@globals	fileSystem,
+		internalState,
+		g_flag,
+		g_subframe
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		g_flag.threadmode,
+		g_subframe,
+		**argv
+@*/
+;
+
 static int
 opt_decode_help(
 	unsigned int, unsigned int, unsigned int, char *const *, enum OptMode
@@ -50,7 +82,7 @@ opt_decode_help(
 
 /* //////////////////////////////////////////////////////////////////////// */
 
-#define DECODE_OPTDICT_NMEMB	8u
+#define DECODE_OPTDICT_NMEMB	13u
 
 /**@var decode_optdict_longopt
  * @brief array of longopts
@@ -59,10 +91,15 @@ opt_decode_help(
 static const char *decode_optdict_longopt[DECODE_OPTDICT_NMEMB] = {
 	"single-threaded",
 	"multi-threaded",
+	"affinity",
+	"bulk-io",
 	"delete-src",
 	"format",
+	"mmap",
 	"outfile",
+	"pread",
 	"quiet",
+	"subframe",
 	"threads",
 	"help"
 };
@@ -74,10 +111,15 @@ static const char *decode_optdict_longopt[DECODE_OPTDICT_NMEMB] = {
 static const int decode_optdict_shortopt[DECODE_OPTDICT_NMEMB] = {
 	'S',	/* single-threaded */
 	'M',	/* multi-threaded  */
+	-1 ,	/* affinity        */
+	-1 ,	/* bulk-io         */
 	'd',	/* delete-src      */
 	'f',	/* format          */
+	-1 ,	/* mmap            */
 	'o',	/* outfile         */
+	-1 ,	/* pread           */
 	'q',	/* quiet           */
+	-1 ,	/* subframe        */
 	't',	/* threads         */
 	'?'	/* help            */
 };
@@ -89,10 +131,15 @@ static const int decode_optdict_shortopt[DECODE_OPTDICT_NMEMB] = {
 static optdict_fnptr decode_optdict_fn[DECODE_OPTDICT_NMEMB] = {
 	opt_common_single_threaded,
 	opt_common_multi_threaded,
+	opt_common_affinity,
+	opt_common_bulk_io,
 	opt_common_delete_src,
 	opt_decode_format,
+	opt_decode_mmap,
 	opt_common_outfile,
+	opt_decode_pread,
 	opt_common_quiet,
+	opt_decode_subframe,
 	opt_common_threads,
 	opt_decode_help,
 };
@@ -189,6 +236,114 @@ opt_decode_format(
 	return retval;
 }
 
+/**@fn opt_decode_mmap
+ * @brief enables the multi-threaded decoder threads writing their frames
+ *   straight into the memory-mapped outfile
+ *
+ * @param optind0 - unused
+ * @param optind1 - unused
+ * @param argc    - unused
+ * @param argv    - unused
+ * @param mode    - unused
+ *
+ * @return 0
+**/
+static int
+opt_decode_mmap(
+	UNUSED const unsigned int optind0, UNUSED const unsigned int optind1,
+	UNUSED const unsigned int argc, UNUSED char *const *const argv,
+	UNUSED const enum OptMode mode
+)
+/*@globals	g_flag@*/
+/*@modifies	g_flag.mmap_out@*/
+{
+	g_flag.mmap_out = true;
+
+	return 0;
+}
+
+/**@fn opt_decode_pread
+ * @brief enables the multi-threaded decoder threads reading their own
+ *   frames with pread
+ *
+ * @param optind0 - unused
+ * @param optind1 - unused
+ * @param argc    - unused
+ * @param argv    - unused
+ * @param mode    - unused
+ *
+ * @return 0
+**/
+static int
+opt_decode_pread(
+	UNUSED const unsigned int optind0, UNUSED const unsigned int optind1,
+	UNUSED const unsigned int argc, UNUSED char *const *const argv,
+	UNUSED const enum OptMode mode
+)
+/*@globals	g_flag@*/
+/*@modifies	g_flag.pread@*/
+{
+	g_flag.pread = true;
+
+	return 0;
+}
+
+/**@fn opt_decode_subframe
+ * @brief sets the number of samples per channel to decode and write at a
+ *   time, for a lower latency to stdout/pipes; implies single-threaded
+ *
+ * @param optind0 - index of  'argv'
+ * @param optind1 - index of *'argv'
+ * @param argc    - unused
+ * @param argv    - argument vector from main()
+ * @param mode    - unused
+ *
+ * @return 0
+**/
+/* --subframe=samples */
+static int
+opt_decode_subframe(
+	const unsigned int optind0, const unsigned int optind1,
+	UNUSED const unsigned int argc, char *const *const argv,
+	UNUSED const enum OptMode mode
+)
+/*@globals	fileSystem,
+		internalState,
+		g_flag,
+		g_subframe
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		g_flag.threadmode,
+		g_subframe,
+		**argv
+@*/
+{
+	char *const opt = &argv[optind0][optind1];
+	/* * */
+	char *subopt = NULL;
+	union {	int d; } result;
+
+	(void) strtok(opt, "=");
+	subopt = strtok(NULL, "");
+	if UNLIKELY ( subopt == NULL ){
+		error_tta("%s: missing argument", "--subframe");
+	}
+	assert(subopt != NULL);
+
+	result.d = atoi(subopt);
+	if UNLIKELY ( result.d <= 0 ){
+		error_tta("%s: argument out of range: %d", "--subframe",
+			result.d
+		);
+	}
+
+	g_subframe        = (unsigned int) result.d;
+	g_flag.threadmode = THREADMODE_SINGLE;
+
+	return 0;
+}
+
 /**@fn opt_decode_help
  * @brief print the mode_decode help to stderr and exit
  *
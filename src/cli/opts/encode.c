@@ -4,7 +4,7 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
@@ -25,6 +25,29 @@
 
 /* //////////////////////////////////////////////////////////////////////// */
 
+static int opt_encode_direct(
+	unsigned int, unsigned int, unsigned int, char *const *, enum OptMode
+)
+/*@globals	g_flag@*/
+/*@modifies	g_flag.direct@*/
+;
+
+#undef argv
+static int opt_encode_format(
+	unsigned int, unsigned int, unsigned int, char *const *argv,
+	enum OptMode
+)
+/*@globals	fileSystem,
+		internalState,
+		g_flag
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		g_flag.encfmt,
+		**argv
+@*/
+;
+
 #undef argv
 static int opt_encode_rawpcm(
 	unsigned int, unsigned int, unsigned int, char *const *argv,
@@ -39,6 +62,13 @@ static int opt_encode_rawpcm(
 @*/
 ;
 
+static int opt_encode_verify(
+	unsigned int, unsigned int, unsigned int, char *const *, enum OptMode
+)
+/*@globals	g_flag@*/
+/*@modifies	g_flag.verify@*/
+;
+
 static int opt_encode_help(
 	unsigned int, unsigned int, unsigned int, char *const *, enum OptMode
 )
@@ -48,7 +78,7 @@ static int opt_encode_help(
 
 /* //////////////////////////////////////////////////////////////////////// */
 
-#define xENCODE_OPTDICT_NMEMB	8u
+#define xENCODE_OPTDICT_NMEMB	13u
 
 /**@var encode_optdict_longopt
  * @brief array of longopts
@@ -57,11 +87,16 @@ static int opt_encode_help(
 static const char *encode_optdict_longopt[xENCODE_OPTDICT_NMEMB] = {
 	"single-threaded",
 	"multi-threaded",
+	"affinity",
+	"bulk-io",
 	"delete-src",
+	"direct",
+	"format",
 	"outfile",
 	"quiet",
 	"rawpcm",
 	"threads",
+	"verify",
 	"help"
 };
 
@@ -72,11 +107,16 @@ static const char *encode_optdict_longopt[xENCODE_OPTDICT_NMEMB] = {
 static const int encode_optdict_shortopt[xENCODE_OPTDICT_NMEMB] = {
 	'S',	/* single-threaded */
 	'M',	/* multi-threaded  */
+	-1 ,	/* affinity        */
+	-1 ,	/* bulk-io         */
 	'd',	/* delete-src      */
+	-1 ,	/* direct          */
+	'f',	/* format          */
 	'o',	/* outfile         */
 	'q',	/* quiet           */
 	-1 ,	/* rawpcm          */
 	't',	/* threads         */
+	-1 ,	/* verify          */
 	'?'	/* help            */
 };
 
@@ -87,11 +127,16 @@ static const int encode_optdict_shortopt[xENCODE_OPTDICT_NMEMB] = {
 static optdict_fnptr encode_optdict_fn[xENCODE_OPTDICT_NMEMB] = {
 	opt_common_single_threaded,
 	opt_common_multi_threaded,
+	opt_common_affinity,
+	opt_common_bulk_io,
 	opt_common_delete_src,
+	opt_encode_direct,
+	opt_encode_format,
 	opt_common_outfile,
 	opt_common_quiet,
 	opt_encode_rawpcm,
 	opt_common_threads,
+	opt_encode_verify,
 	opt_encode_help
 };
 
@@ -147,6 +192,106 @@ rawpcm_statcopy(/*@out@*/ struct FileStats *const RESTRICT fstat)
 
 /* ======================================================================== */
 
+/**@fn opt_encode_direct
+ * @brief enables writing the outfile in aligned blocks with O_DIRECT
+ *
+ * @param optind0 - unused
+ * @param optind1 - unused
+ * @param argc    - unused
+ * @param argv    - unused
+ * @param mode    - unused
+ *
+ * @return 0
+**/
+static int
+opt_encode_direct(
+	UNUSED const unsigned int optind0, UNUSED const unsigned int optind1,
+	UNUSED const unsigned int argc, UNUSED char *const *const argv,
+	UNUSED const enum OptMode mode
+)
+/*@globals	g_flag@*/
+/*@modifies	g_flag.direct@*/
+{
+	g_flag.direct = true;
+
+	return 0;
+}
+
+/**@fn opt_encode_format
+ * @brief sets the destination file format
+ *
+ * @param optind0 - index of  'argv'
+ * @param optind1 - index of *'argv'
+ * @param argc    - argument count from main()
+ * @param argv    - argument vector from main()
+ * @param mode    - short or long
+ *
+ * @return number of args used (long), or number of char's read (short)
+**/
+static int
+opt_encode_format(
+	const unsigned int optind0, const unsigned int optind1,
+	const unsigned int argc, char *const *const argv,
+	const enum OptMode mode
+)
+/*@globals	fileSystem,
+		internalState,
+		g_flag
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		g_flag.encfmt,
+		**argv
+@*/
+{
+	/*@observer@*/
+	const char *const encfmt_name[] = xENCFMT_NAME_ARRAY;
+	char *const opt = &argv[optind0][optind1];
+	/* * */
+	int retval   = 0;
+	char *subopt = NULL;
+	unsigned int i;
+
+	switch ( mode ){
+	default:
+		assert(false);
+		break;
+	case OPTMODE_SHORT:
+		if ( opt[1u] == '\0' ){
+			optsget_argcheck(optind0, argc, 1u, opt);
+			subopt = argv[optind0 + 1u];
+			retval = -1;
+		}
+		else {	subopt = &opt[1u];
+			retval = (int) strlen(subopt);
+		}
+		break;
+	case OPTMODE_LONG:
+		(void) strtok(opt, "=");
+		subopt = strtok(NULL, "");
+		if UNLIKELY ( subopt == NULL ){
+			error_tta("%s: missing argument", "--format");
+		}
+		retval = 0;
+		break;
+	}
+	assert(subopt != NULL);
+
+	for ( i = 0; i < xENCFMT_NMEMB; ++i ){
+		if ( strcmp(subopt, encfmt_name[i]) == 0 ){
+			g_flag.encfmt = (enum EncFormat) i;
+			break;
+		}
+		else if UNLIKELY ( i == xENCFMT_NMEMB - 1u ){
+			error_tta("%s: bad argument: %s",
+				mode == OPTMODE_SHORT ? "-f" : "--format",
+				subopt
+			);
+		} else{;}
+	}
+	return retval;
+}
+
 /**@fn opt_encode_rawpcm
  * @brief set raw PCM encoding
  *
@@ -245,6 +390,32 @@ opt_encode_rawpcm(
 	return 0;
 }
 
+/**@fn opt_encode_verify
+ * @brief enables decoding each frame again right after it is encoded, and
+ *   checking it against its PCM
+ *
+ * @param optind0 - unused
+ * @param optind1 - unused
+ * @param argc    - unused
+ * @param argv    - unused
+ * @param mode    - unused
+ *
+ * @return 0
+**/
+static int
+opt_encode_verify(
+	UNUSED const unsigned int optind0, UNUSED const unsigned int optind1,
+	UNUSED const unsigned int argc, UNUSED char *const *const argv,
+	UNUSED const enum OptMode mode
+)
+/*@globals	g_flag@*/
+/*@modifies	g_flag.verify@*/
+{
+	g_flag.verify = true;
+
+	return 0;
+}
+
 /**@fn opt_encode_help
  * @brief print the mode_encode help to stderr and exit
  *
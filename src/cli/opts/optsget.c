@@ -4,7 +4,7 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
@@ -113,7 +113,10 @@ optargs_process(
 	int  optrv  = 0;
 
 	while ( optind < argc ){
-		if ( (optrv >= 0) && (argv[optind][0] == '-') ){
+		if ( (optrv >= 0)
+		    &&
+		     (argv[optind][0] == '-') && (argv[optind][1u] != '\0')
+		){
 			/* opt */
 			optrv   = optsget(optind, argc, argv, optdict);
 			optind += (optrv >= 0 ? optrv : -optrv);
@@ -158,7 +161,8 @@ optsget(
 
 	for ( i = 0; optind + i < argc; i += optrv + 1 ){
 		arg = argv[optind + i];
-		if ( arg[0] != '-' ){	/* return at first non-opt */
+		/* return at first non-opt; a lone "-" is stdin */
+		if ( (arg[0] != '-') || (arg[1u] == '\0') ){
 			break;
 		}
 		else if ( (arg[0] == '-') && (arg[1u] != '-') ){
@@ -0,0 +1,114 @@
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// opts/repair.c                                                            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2026, Shane Seelig                                         //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+#include <stdlib.h>
+
+#include "../common.h"
+#include "../help.h"
+#include "../main.h"
+
+#include "./common.h"
+#include "./optsget.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+static int
+opt_repair_help(
+	unsigned int, unsigned int, unsigned int, char *const *, enum OptMode
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem@*/
+;
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#define REPAIR_OPTDICT_NMEMB	6u
+
+/**@var repair_optdict_longopt
+ * @brief array of longopts
+**/
+/*@observer@*/ /*@unchecked@*/
+static const char *repair_optdict_longopt[REPAIR_OPTDICT_NMEMB] = {
+	"single-threaded",
+	"multi-threaded",
+	"outfile",
+	"quiet",
+	"threads",
+	"help"
+};
+
+/**@var repair_optdict_shortopt
+ * @brief array of shortopts
+**/
+/*@unchecked@*/
+static const int repair_optdict_shortopt[REPAIR_OPTDICT_NMEMB] = {
+	'S',	/* single-threaded */
+	'M',	/* multi-threaded  */
+	'o',	/* outfile         */
+	'q',	/* quiet           */
+	't',	/* threads         */
+	'?'	/* help            */
+};
+
+/**@var repair_optdict_fn
+ * @brief array of option function pointers
+**/
+/*@unchecked@*/
+static optdict_fnptr repair_optdict_fn[REPAIR_OPTDICT_NMEMB] = {
+	opt_common_single_threaded,
+	opt_common_multi_threaded,
+	opt_common_outfile,
+	opt_common_quiet,
+	opt_common_threads,
+	opt_repair_help
+};
+
+/**@var repair_optdict
+ * @brief option dictionary for optargs_process
+**/
+/*@-redef@*/
+/*@unchecked@*/
+BUILD const struct OptDict repair_optdict = {
+	.nmemb    = REPAIR_OPTDICT_NMEMB,
+	.longopt  = repair_optdict_longopt,
+	.shortopt = repair_optdict_shortopt,
+	.fn       = repair_optdict_fn
+};
+/*@=redef@*/
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/**@fn opt_repair_help
+ * @brief print the mode_repair help to stderr and exit
+ *
+ * @param optind0 - unused
+ * @param optind1 - unused
+ * @param argc    - unused
+ * @param argv    - unused
+ * @param mode    - unused
+ *
+ * @return does not return
+**/
+NORETURN COLD
+int
+opt_repair_help(
+	UNUSED const unsigned int optind0, UNUSED const unsigned int optind1,
+	UNUSED const unsigned int argc, UNUSED char *const *const argv,
+	UNUSED const enum OptMode mode
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem@*/
+{
+	errprint_help_mode_repair();
+	exit(EXIT_SUCCESS);
+}
+
+/* EOF //////////////////////////////////////////////////////////////////// */
@@ -0,0 +1,114 @@
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// opts/test.c                                                              //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2026, Shane Seelig                                         //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+#include <stdlib.h>
+
+#include "../common.h"
+#include "../help.h"
+#include "../main.h"
+
+#include "./common.h"
+#include "./optsget.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+static int
+opt_test_help(
+	unsigned int, unsigned int, unsigned int, char *const *, enum OptMode
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem@*/
+;
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#define TEST_OPTDICT_NMEMB	6u
+
+/**@var test_optdict_longopt
+ * @brief array of longopts
+**/
+/*@observer@*/ /*@unchecked@*/
+static const char *test_optdict_longopt[TEST_OPTDICT_NMEMB] = {
+	"single-threaded",
+	"multi-threaded",
+	"bulk-io",
+	"quiet",
+	"threads",
+	"help"
+};
+
+/**@var test_optdict_shortopt
+ * @brief array of shortopts
+**/
+/*@unchecked@*/
+static const int test_optdict_shortopt[TEST_OPTDICT_NMEMB] = {
+	'S',	/* single-threaded */
+	'M',	/* multi-threaded  */
+	-1 ,	/* bulk-io         */
+	'q',	/* quiet           */
+	't',	/* threads         */
+	'?'	/* help            */
+};
+
+/**@var test_optdict_fn
+ * @brief array of option function pointers
+**/
+/*@unchecked@*/
+static optdict_fnptr test_optdict_fn[TEST_OPTDICT_NMEMB] = {
+	opt_common_single_threaded,
+	opt_common_multi_threaded,
+	opt_common_bulk_io,
+	opt_common_quiet,
+	opt_common_threads,
+	opt_test_help
+};
+
+/**@var test_optdict
+ * @brief option dictionary for optargs_process
+**/
+/*@-redef@*/
+/*@unchecked@*/
+BUILD const struct OptDict test_optdict = {
+	.nmemb    = TEST_OPTDICT_NMEMB,
+	.longopt  = test_optdict_longopt,
+	.shortopt = test_optdict_shortopt,
+	.fn       = test_optdict_fn
+};
+/*@=redef@*/
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/**@fn opt_test_help
+ * @brief print the mode_test help to stderr and exit
+ *
+ * @param optind0 - unused
+ * @param optind1 - unused
+ * @param argc    - unused
+ * @param argv    - unused
+ * @param mode    - unused
+ *
+ * @return does not return
+**/
+NORETURN COLD
+int
+opt_test_help(
+	UNUSED const unsigned int optind0, UNUSED const unsigned int optind1,
+	UNUSED const unsigned int argc, UNUSED char *const *const argv,
+	UNUSED const enum OptMode mode
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem@*/
+{
+	errprint_help_mode_test();
+	exit(EXIT_SUCCESS);
+}
+
+/* EOF //////////////////////////////////////////////////////////////////// */
@@ -7,7 +7,7 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
@@ -42,7 +42,6 @@ struct timespec {
 /*@-redef@*/
 typedef int	pthread_t;
 typedef int	pthread_attr_t;
-typedef int	pthread_spinlock_t;
 typedef int	sem_t;
 /*@=redef@*/
 
@@ -254,66 +253,6 @@ extern int pthread_join(pthread_t, /*@null@*/ void **retval)
 ;
 /*@=protoparammatch@*/
 
-/*@-protoparammatch@*/
-/*@external@*/ /*@unused@*/
-extern int pthread_detach(pthread_t)
-/*@globals	internalState@*/
-/*@modifies	internalState@*/
-;
-/*@=protoparammatch@*/
-
-/*@-protoparammatch@*/
-/*@external@*/ /*@unused@*/
-extern pthread_t pthread_self(void)
-/*@globals	internalState@*/
-/*@modifies	nothing@*/
-;
-/*@=protoparammatch@*/
-
-/*@-protoparammatch@*/
-#undef lock
-/*@external@*/ /*@unused@*/
-extern int pthread_spin_destroy(pthread_spinlock_t *lock)
-/*@globals	internalState@*/
-/*@modifies	internalState,
-		*lock
-@*/
-;
-/*@=protoparammatch@*/
-
-/*@-protoparammatch@*/
-#undef lock
-/*@external@*/ /*@unused@*/
-extern int pthread_spin_init(/*@out@*/ pthread_spinlock_t *lock, int)
-/*@globals	internalState@*/
-/*@modifies	internalState,
-		*lock
-@*/
-;
-/*@=protoparammatch@*/
-
-/*@-protoparammatch@*/
-#undef lock
-/*@external@*/ /*@unused@*/
-extern int pthread_spin_lock(pthread_spinlock_t *lock)
-/*@globals	internalState@*/
-/*@modifies	internalState,
-		*lock
-@*/
-;
-/*@=protoparammatch@*/
-
-/*@-protoparammatch@*/
-#undef lock
-/*@external@*/ /*@unused@*/
-extern int pthread_spin_unlock(pthread_spinlock_t *lock)
-/*@globals	internalState@*/
-/*@modifies	internalState,
-		*lock
-@*/
-;
-/*@=protoparammatch@*/
-
 /*@-protoparammatch@*/
 #undef sem
 /*@external@*/ /*@unused@*/
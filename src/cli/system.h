@@ -6,7 +6,7 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
@@ -16,10 +16,50 @@
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
 
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <sys/types.h>
+
 #include "./common.h"
 
 /* //////////////////////////////////////////////////////////////////////// */
 
+/* same as glibc's CPU_SETSIZE */
+#define CPUSET_NCPU	1024u
+
+/* a set of CPUs, one bit each; the layout of the Linux kernel's cpumask */
+struct CPUSet {
+	unsigned long	word[CPUSET_NCPU / (CHAR_BIT * sizeof(unsigned long))];
+};
+
+/* alignment of the buffer, offset, and length of a write to a file with
+     file_direct() on; the logical block size of most disks
+*/
+#define FILE_DIRECT_ALIGN	((size_t) 4096u)
+
+/* size of the bounce buffer of a file_move() not done in the kernel */
+#define FILE_MOVE_CHUNK		((size_t) (1u * 1024u * 1024u))
+
+/* for file_advise() */
+enum FileAdvice {
+	FILE_ADVICE_SEQUENTIAL,		/* will be read through once   */
+	FILE_ADVICE_WILLNEED,		/* start reading it in         */
+	FILE_ADVICE_DONTNEED		/* drop it from the page cache */
+};
+
+/* a mapping of a range of a file; read-only unless asked for */
+struct FileMap {
+	/*@null@*/ /*@only@*/
+	void		*base;		/* page aligned              */
+	size_t		size;		/* of the whole mapping      */
+	/*@null@*/ /*@dependent@*/
+	uint8_t		*data;		/* the range that was asked for */
+};
+
+/* //////////////////////////////////////////////////////////////////////// */
+
 #if 0	/* system-type */
 
 #elif defined(__unix__) || defined(S_SPLINT_S)
@@ -100,6 +140,256 @@ ALWAYS_INLINE void file_unlock(FILE *RESTRICT filehandle)
 @*/
 ;
 
+#undef filehandle
+#undef iov
+/**@fn file_writev
+ * @brief writes a gather list to a file in as few syscalls as it can
+ *   (writev wrapper)
+ *
+ * @param filehandle - FILE pointer
+ * @param iov        - the gather list; clobbered
+ * @param niov       - number of entries in iov
+ *
+ * @return true on success, else false (errno is set)
+ *
+ * @note flushes the stdio buffer first, and writes past it
+**/
+INLINE bool file_writev(
+	FILE *RESTRICT filehandle, iovec_p *RESTRICT iov, size_t
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		filehandle,
+		*iov
+@*/
+;
+
+#undef filehandle
+#undef size
+/**@fn file_regsize
+ * @brief gets the size of a regular file (fstat wrapper)
+ *
+ * @param filehandle - FILE pointer
+ * @param size       - size of the file
+ *
+ * @return true if it is a regular file, else false
+**/
+INLINE bool file_regsize(
+	FILE *RESTRICT filehandle, /*@out@*/ off_t *RESTRICT size
+)
+/*@globals	fileSystem@*/
+/*@modifies	*size@*/
+;
+
+#undef filehandle
+/**@fn file_pwrite
+ * @brief writes a buffer to a file at an offset (pwrite wrapper)
+ *
+ * @param filehandle - FILE pointer
+ * @param buf        - the buffer
+ * @param len        - length of buf
+ * @param offset     - where in the file to write it
+ *
+ * @return true on success, else false (errno is set)
+ *
+ * @note flushes the stdio buffer first; the file's position is left alone
+**/
+INLINE bool file_pwrite(
+	FILE *RESTRICT filehandle, const void *RESTRICT, size_t, off_t
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		filehandle
+@*/
+;
+
+#undef buf
+/**@fn file_pread
+ * @brief reads a file into a buffer from an offset (pread wrapper)
+ *
+ * @param filehandle - FILE pointer
+ * @param buf        - the buffer
+ * @param len        - number of bytes to read
+ * @param offset     - where in the file to read from
+ *
+ * @return number of bytes read; less than len at the end of the file
+ *   (errno is 0), or on an error (errno is set)
+ *
+ * @note the stdio buffer and the file's position are left alone, so it
+ *   can be called from several threads at once
+**/
+INLINE size_t file_pread(
+	FILE *RESTRICT filehandle, /*@out@*/ void *RESTRICT buf, size_t, off_t
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*buf
+@*/
+;
+
+#undef filehandle
+/**@fn file_prealloc
+ * @brief reserves disk space for a file that is about to be written
+ *   (fallocate wrapper)
+ *
+ * @param filehandle - FILE pointer
+ * @param size       - expected size of the file
+ *
+ * @return true on success, else false
+ *
+ * @note advisory; the file may grow to 'size', so it should be truncated
+ *   to its real size once written (file_truncate)
+**/
+INLINE bool file_prealloc(FILE *RESTRICT filehandle, off_t size)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		filehandle
+@*/
+;
+
+#undef filehandle
+/**@fn file_truncate
+ * @brief sets the size of a file (ftruncate wrapper)
+ *
+ * @param filehandle - FILE pointer
+ * @param size       - the new size
+ *
+ * @return true on success or if the file cannot be truncated (/dev/null),
+ *   else false (errno is set)
+**/
+INLINE bool file_truncate(FILE *RESTRICT filehandle, off_t size)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		filehandle
+@*/
+;
+
+#undef filehandle
+/**@fn file_move
+ * @brief moves a range of a file to another offset in the same file
+ *   (copy_file_range wrapper)
+ *
+ * @param filehandle - FILE pointer
+ * @param dst        - where the range goes
+ * @param src        - where the range is
+ * @param len        - length of the range
+ *
+ * @return true on success, else false (errno is set)
+ *
+ * @note the ranges may overlap; what is left of the old range that the new
+ *   one does not cover is not cleared
+ * @note flushes the stdio buffer first; the file's position is left alone
+**/
+INLINE bool file_move(FILE *RESTRICT filehandle, off_t dst, off_t, off_t)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		filehandle
+@*/
+;
+
+#undef filehandle
+/**@fn file_direct
+ * @brief turns unbuffered (O_DIRECT) I/O on or off for a file
+ *
+ * @param filehandle - FILE pointer
+ * @param on         - on or off
+ *
+ * @return true on success, else false
+ *
+ * @note while on, the buffer, offset, and length of each write should be
+ *   aligned to FILE_DIRECT_ALIGN
+**/
+INLINE bool file_direct(FILE *RESTRICT filehandle, bool on)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		filehandle
+@*/
+;
+
+#undef filehandle
+/**@fn file_advise
+ * @brief tells the system how a range of a file will be used
+ *   (posix_fadvise wrapper)
+ *
+ * @param filehandle - FILE pointer
+ * @param offset     - start of the range
+ * @param len        - length of the range; 0 for to the end of the file
+ * @param advice     - the advice
+ *
+ * @note advisory; a no-op where unsupported
+**/
+INLINE void file_advise(
+	FILE *RESTRICT filehandle, off_t, off_t, enum FileAdvice
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem@*/
+;
+
+#undef filehandle
+/**@fn file_writeback
+ * @brief starts writing out the dirty pages of a range of a file, and
+ *   optionally waits for them (sync_file_range wrapper)
+ *
+ * @param filehandle - FILE pointer
+ * @param offset     - start of the range
+ * @param len        - length of the range
+ * @param wait       - whether to wait for the range to be written out
+ *
+ * @note advisory, and not a sync: the metadata is left alone; a no-op
+ *   where unsupported
+**/
+INLINE void file_writeback(FILE *RESTRICT filehandle, off_t, off_t, bool)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem@*/
+;
+
+#undef map
+#undef filehandle
+/**@fn file_map
+ * @brief maps a range of a file, read-only for reading it through once,
+ *   or shared and writable for writing it in place (mmap wrapper)
+ *
+ * @param map        - the mapping
+ * @param filehandle - FILE pointer
+ * @param offset     - start of the range
+ * @param size       - size of the range
+ * @param write      - whether to map it writable
+ *
+ * @return true on success; false if the file is not a regular file at
+ *   least that long, or on failure
+ *
+ * @note the file's position is left alone
+ * @note for write, the file has to be open for reading too
+**/
+INLINE bool file_map(
+	/*@out@*/ struct FileMap *RESTRICT map, FILE *RESTRICT filehandle,
+	off_t, size_t, bool write
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*map
+@*/
+;
+
+#undef map
+/**@fn file_unmap
+ * @brief unmaps a mapping from file_map()
+ *
+ * @param map - the mapping
+**/
+INLINE void file_unmap(struct FileMap *RESTRICT map)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*map
+@*/
+;
+
 /**@fn fdlimit_check
  * @brief attempt to increase the open-file limit with error checking
 **/
@@ -121,6 +411,134 @@ INLINE unsigned int get_nprocessors_onln(void)
 /*@globals	internalState*/
 ;
 
+#undef set
+/**@fn cpuset_get
+ * @brief gets the calling thread's CPU affinity mask
+ *
+ * @param set - destination
+ *
+ * @return false if unsupported or on failure
+**/
+INLINE bool cpuset_get(/*@out@*/ struct CPUSet *RESTRICT set)
+/*@globals	internalState@*/
+/*@modifies	*set@*/
+;
+
+/**@fn cpuset_set
+ * @brief sets the calling thread's CPU affinity mask; threads it creates
+ *   afterwards inherit it
+ *
+ * @param set - CPU set
+ *
+ * @return false if unsupported or on failure
+**/
+INLINE bool cpuset_set(const struct CPUSet *RESTRICT)
+/*@globals	internalState@*/
+/*@modifies	internalState@*/
+;
+
+#undef package
+#undef core
+/**@fn cpu_topology
+ * @brief gets which physical core a logical CPU is on
+ *
+ * @param cpu     - logical CPU number
+ * @param package - destination for the package (socket) id
+ * @param core    - destination for the core id within the package
+ *
+ * @return false if unknown
+**/
+INLINE bool cpu_topology(
+	unsigned int, /*@out@*/ unsigned int *RESTRICT package,
+	/*@out@*/ unsigned int *RESTRICT core
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*package,
+		*core
+@*/
+;
+
+#undef dest
+/**@fn cpu_model
+ * @brief gets the name of the CPU model
+ *
+ * @param dest - destination buffer
+ * @param size - size of 'dest'
+ *
+ * @return false if unknown
+**/
+INLINE bool cpu_model(/*@out@*/ char *RESTRICT dest, size_t)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*dest
+@*/
+;
+
+#undef size
+/**@fn pages_map
+ * @brief maps zeroed, private memory straight from the system
+ *
+ * @param size    - size of the mapping; rounded up to what was mapped
+ * @param hugetlb - whether to try explicit huge pages first
+ *
+ * @return the mapping, or NULL on failure (errno is set)
+ *
+ * @note asks for transparent huge pages where there are such
+**/
+/*@null@*/ /*@only@*/
+INLINE void *pages_map(size_t *RESTRICT size, bool)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*size
+@*/
+;
+
+#undef ptr
+/**@fn pages_unmap
+ * @brief unmaps memory from pages_map()
+ *
+ * @param ptr  - the mapping
+ * @param size - size of the mapping
+**/
+INLINE void pages_unmap(/*@only@*/ void *ptr, size_t)
+/*@globals	internalState@*/
+/*@modifies	internalState@*/
+/*@releases	ptr@*/
+;
+
+/**@fn pages_populate
+ * @brief faults in the pages of a range of a mapping, without touching
+ *   what is in them; safe while other threads use the range
+ *
+ * @param ptr  - start of the range
+ * @param size - size of the range
+ *
+ * @return false if unsupported or on failure
+**/
+INLINE bool pages_populate(const void *, size_t)
+/*@globals	internalState@*/
+/*@modifies	internalState@*/
+;
+
+/**@fn pages_discard
+ * @brief gives the whole pages of a range of a mapping back to the system;
+ *   their contents are lost
+ *
+ * @param ptr  - start of the range
+ * @param size - size of the range
+**/
+INLINE void pages_discard(const void *, size_t)
+/*@globals	internalState@*/
+/*@modifies	internalState@*/
+;
+
 #undef errnum
 #undef buf
 #undef buflen
@@ -6,22 +6,32 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
 
 #include <assert.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
 #include <signal.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 
+#include <sys/mman.h>
 #include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
 #include <time.h>
 #include <unistd.h>
 
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif	/* __linux__ */
+
 #include "./common.h"
 #include "./debug.h"
 #include "./main.h"
@@ -30,7 +40,45 @@
 
 #define PATH_DELIM	'/'
 
+/* cache directory: $XDG_CACHE_HOME, else $HOME/.cache */
+#define CACHEDIR_ENV		"XDG_CACHE_HOME"
+#define CACHEDIR_ENV_FALLBACK	"HOME"
+#define CACHEDIR_SFX_FALLBACK	"/.cache"
+
+/* size of an explicit (MAP_HUGETLB) huge page; the system's default */
+#ifndef HUGEPAGE_SIZE
+#define HUGEPAGE_SIZE		((size_t) (2u * 1024u * 1024u))
+#endif
+
+#if ! defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS		MAP_ANON
+#endif
+
+/* glibc only shows O_DIRECT to _GNU_SOURCE */
+#if ! defined(O_DIRECT) && defined(__O_DIRECT)
+#define O_DIRECT		__O_DIRECT
+#endif
+
+/* glibc only shows these to _GNU_SOURCE */
+#ifdef __linux__
+#ifndef SYNC_FILE_RANGE_WAIT_BEFORE
+#define SYNC_FILE_RANGE_WAIT_BEFORE	1u
+#endif
+#ifndef SYNC_FILE_RANGE_WRITE
+#define SYNC_FILE_RANGE_WRITE		2u
+#endif
+#ifndef SYNC_FILE_RANGE_WAIT_AFTER
+#define SYNC_FILE_RANGE_WAIT_AFTER	4u
+#endif
+#endif	/* __linux__ */
+
+/* POSIX only promises 16 */
+#ifndef IOV_MAX
+#define IOV_MAX			16
+#endif
+
 typedef struct timespec	timestamp_p;
+typedef struct iovec	iovec_p;
 
 /* //////////////////////////////////////////////////////////////////////// */
 
@@ -231,6 +279,357 @@ file_unlock(FILE *const RESTRICT filehandle)
 	return;
 }
 
+/**@see "system.h" **/
+INLINE bool
+file_writev(
+	FILE *const RESTRICT filehandle, iovec_p *RESTRICT iov, size_t niov
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		filehandle,
+		*iov
+@*/
+{
+	const int fd = fileno(filehandle);
+	ssize_t nwritten;
+
+	if UNLIKELY ( fflush(filehandle) != 0 ){
+		return false;
+	}
+
+	while ( niov != 0 ){
+		nwritten = writev(
+			fd, iov, (int) (niov < IOV_MAX ? niov : IOV_MAX)
+		);
+		if UNLIKELY ( nwritten < 0 ){
+			if ( errno == EINTR ){
+				continue;
+			}
+			return false;
+		}
+
+		/* skip what was written; a short write stops mid entry */
+		while ( (niov != 0) && ((size_t) nwritten >= iov->iov_len) ){
+			nwritten -= (ssize_t) iov->iov_len;
+			iov      += 1u;
+			niov     -= 1u;
+		}
+		if ( nwritten != 0 ){
+			iov->iov_base  = &((uint8_t *) iov->iov_base)[nwritten];
+			iov->iov_len  -= (size_t) nwritten;
+		}
+	}
+	return true;
+}
+
+/**@see "system.h" **/
+INLINE bool
+file_regsize(
+	FILE *const RESTRICT filehandle, /*@out@*/ off_t *const RESTRICT size
+)
+/*@globals	fileSystem@*/
+/*@modifies	*size@*/
+{
+	const int fd = fileno(filehandle);
+	struct stat st;
+
+	*size = 0;
+	if ( (fd < 0) || (fstat(fd, &st) != 0) || (! S_ISREG(st.st_mode)) ){
+		return false;
+	}
+	*size = st.st_size;
+	return true;
+}
+
+/**@see "system.h" **/
+INLINE bool
+file_pwrite(
+	FILE *const RESTRICT filehandle, const void *const RESTRICT buf,
+	const size_t len, const off_t offset
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		filehandle
+@*/
+{
+	const int fd = fileno(filehandle);
+	size_t  done = 0;
+	ssize_t nwritten;
+
+	if UNLIKELY ( fflush(filehandle) != 0 ){
+		return false;
+	}
+
+	while ( done < len ){
+		nwritten = pwrite(
+			fd, &((const uint8_t *) buf)[done], len - done,
+			offset + (off_t) done
+		);
+		if UNLIKELY ( nwritten <= 0 ){
+			if ( (nwritten < 0) && (errno == EINTR) ){
+				continue;
+			}
+			if ( nwritten == 0 ){
+				errno = EIO;
+			}
+			return false;
+		}
+		done += (size_t) nwritten;
+	}
+	return true;
+}
+
+/**@see "system.h" **/
+INLINE size_t
+file_pread(
+	FILE *const RESTRICT filehandle, /*@out@*/ void *const RESTRICT buf,
+	const size_t len, const off_t offset
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*buf
+@*/
+{
+	const int fd = fileno(filehandle);
+	size_t  done = 0;
+	ssize_t nread;
+
+	while ( done < len ){
+		nread = pread(
+			fd, &((uint8_t *) buf)[done], len - done,
+			offset + (off_t) done
+		);
+		if UNLIKELY ( nread <= 0 ){
+			if ( (nread < 0) && (errno == EINTR) ){
+				continue;
+			}
+			if ( nread == 0 ){
+				errno = 0;
+			}
+			break;
+		}
+		done += (size_t) nread;
+	}
+	return done;
+}
+
+/**@see "system.h" **/
+INLINE bool
+file_prealloc(FILE *const RESTRICT filehandle, const off_t size)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		filehandle
+@*/
+{
+	off_t cur;
+
+	if ( (size <= 0)
+	    ||
+	     (! file_regsize(filehandle, &cur)) || (cur >= size)
+	){
+		return false;
+	}
+#if defined(__linux__) && defined(SYS_fallocate)
+	/* not posix_fallocate(), which glibc falls back to writing zeros for
+	     on filesystems that cannot do it
+	*/
+	return syscall(
+		SYS_fallocate, fileno(filehandle), 0, (off_t) 0, size
+	) == 0;
+#else
+	return posix_fallocate(fileno(filehandle), 0, size) == 0;
+#endif
+}
+
+/**@see "system.h" **/
+INLINE bool
+file_truncate(FILE *const RESTRICT filehandle, const off_t size)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		filehandle
+@*/
+{
+	if UNLIKELY ( fflush(filehandle) != 0 ){
+		return false;
+	}
+	return ((ftruncate(fileno(filehandle), size) == 0)
+		|| (errno == EINVAL)
+	);
+}
+
+/**@see "system.h" **/
+INLINE bool
+file_direct(FILE *const RESTRICT filehandle, const bool on)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		filehandle
+@*/
+{
+#ifdef O_DIRECT
+	const int fd = fileno(filehandle);
+	int flags;
+
+	if UNLIKELY ( fflush(filehandle) != 0 ){
+		return false;
+	}
+	flags = fcntl(fd, F_GETFL);
+	if UNLIKELY ( flags == -1 ){
+		return false;
+	}
+	flags = (on ? flags | O_DIRECT : flags & ~O_DIRECT);
+	return fcntl(fd, F_SETFL, flags) == 0;
+#else
+	(void) filehandle;
+	return ! on;
+#endif
+}
+
+/**@see "system.h" **/
+INLINE void
+file_advise(
+	FILE *const RESTRICT filehandle, const off_t offset, const off_t len,
+	const enum FileAdvice advice
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem@*/
+{
+#ifdef POSIX_FADV_SEQUENTIAL
+	int adv;
+
+	switch ( advice ){
+	case FILE_ADVICE_SEQUENTIAL:
+		adv = POSIX_FADV_SEQUENTIAL;
+		break;
+	case FILE_ADVICE_WILLNEED:
+		adv = POSIX_FADV_WILLNEED;
+		break;
+	case FILE_ADVICE_DONTNEED:
+		adv = POSIX_FADV_DONTNEED;
+		break;
+	default:
+		return;
+	}
+	(void) posix_fadvise(fileno(filehandle), offset, len, adv);
+#else
+	(void) filehandle;
+	(void) offset;
+	(void) len;
+	(void) advice;
+#endif	/* POSIX_FADV_SEQUENTIAL */
+	return;
+}
+
+/**@see "system.h" **/
+INLINE void
+file_writeback(
+	FILE *const RESTRICT filehandle, const off_t offset, const off_t len,
+	const bool wait
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem@*/
+{
+/* the 64-bit offsets would be split across registers on 32-bit targets,
+     which syscall() cannot be trusted to do
+*/
+#if defined(__linux__) && defined(SYS_sync_file_range) \
+ && (defined(__LP64__) || defined(_LP64))
+	const unsigned int flags = (wait
+		? SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE
+		  | SYNC_FILE_RANGE_WAIT_AFTER
+		: SYNC_FILE_RANGE_WRITE
+	);
+
+	(void) syscall(
+		SYS_sync_file_range, fileno(filehandle), offset, len, flags
+	);
+#else
+	(void) filehandle;
+	(void) offset;
+	(void) len;
+	(void) wait;
+#endif
+	return;
+}
+
+/**@see "system.h" **/
+INLINE bool
+file_map(
+	/*@out@*/ struct FileMap *const RESTRICT map,
+	FILE *const RESTRICT filehandle, const off_t offset, const size_t size,
+	const bool write
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*map
+@*/
+{
+	const off_t page = (off_t) sysconf(_SC_PAGESIZE);
+	const int   fd   = fileno(filehandle);
+	struct stat st;
+	off_t start;
+	void *ptr;
+
+	map->base = NULL;
+	map->size = 0;
+	map->data = NULL;
+
+	if ( (size == 0) || (offset < 0) || (page <= 0) || (fd < 0) ){
+		return false;
+	}
+	if ( (fstat(fd, &st) != 0) || (! S_ISREG(st.st_mode))
+	    ||
+	     (st.st_size < offset)
+	    ||
+	     ((uintmax_t) (st.st_size - offset) < (uintmax_t) size)
+	){
+		return false;
+	}
+
+	/* mmap wants a page aligned offset */
+	start = offset - (offset % page);
+	if ( size > SIZE_MAX - (size_t) (offset - start) ){
+		return false;
+	}
+	map->size = (size_t) (offset - start) + size;
+
+	ptr = mmap(
+		NULL, map->size, (write ? PROT_READ | PROT_WRITE : PROT_READ),
+		MAP_SHARED, fd, start
+	);
+	if UNLIKELY ( ptr == MAP_FAILED ){
+		map->size = 0;
+		return false;
+	}
+#ifdef MADV_SEQUENTIAL
+	if ( ! write ){
+		(void) madvise(ptr, map->size, MADV_SEQUENTIAL);
+	}
+#endif
+	map->base = ptr;
+	map->data = &((uint8_t *) ptr)[offset - start];
+	return true;
+}
+
+/**@see "system.h" **/
+INLINE void
+file_unmap(struct FileMap *const RESTRICT map)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*map
+@*/
+{
+	if ( map->base != NULL ){
+		(void) munmap(map->base, map->size);
+	}
+	map->base = NULL;
+	map->size = 0;
+	map->data = NULL;
+	return;
+}
+
 /* ======================================================================== */
 
 /**@see "system.h" **/
@@ -270,6 +669,355 @@ get_nprocessors_onln(void)
 	return (unsigned int) sysconf(_SC_NPROCESSORS_ONLN);
 }
 
+/* ------------------------------------------------------------------------ */
+
+/* POSIX has no affinity interface; the raw syscalls avoid needing
+     _GNU_SOURCE, which would swap in the GNU strerror_r
+*/
+
+/**@see "system.h" **/
+INLINE bool
+cpuset_get(/*@out@*/ struct CPUSet *const RESTRICT set)
+/*@globals	internalState@*/
+/*@modifies	*set@*/
+{
+	memset(set, 0x00, sizeof *set);
+#ifdef __linux__
+	/* returns the number of bytes written */
+	return (syscall(SYS_sched_getaffinity, 0, sizeof set->word, set->word)
+		> 0
+	);
+#else
+	return false;
+#endif	/* __linux__ */
+}
+
+/**@see "system.h" **/
+INLINE bool
+cpuset_set(const struct CPUSet *const RESTRICT set)
+/*@globals	internalState@*/
+/*@modifies	internalState@*/
+{
+#ifdef __linux__
+	return (syscall(SYS_sched_setaffinity, 0, sizeof set->word, set->word)
+		== 0
+	);
+#else
+	(void) set;
+	return false;
+#endif	/* __linux__ */
+}
+
+/**@see "system.h" **/
+INLINE bool
+cpu_topology(
+	const unsigned int cpu, /*@out@*/ unsigned int *const RESTRICT package,
+	/*@out@*/ unsigned int *const RESTRICT core
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*package,
+		*core
+@*/
+{
+#ifdef __linux__
+	const char *const name[2u] = {
+		"physical_package_id", "core_id"
+	};
+	unsigned int *const value[2u] = { package, core };
+	char path[64u];
+	FILE *file;
+	size_t i;
+	union {	int d; } result;
+
+	*package = 0;
+	*core    = 0;
+	for ( i = 0; i < (size_t) 2u; ++i ){
+		(void) snprintf(path, sizeof path,
+			"/sys/devices/system/cpu/cpu%u/topology/%s",
+			cpu, name[i]
+		);
+		file = fopen(path, "r");
+		if ( file == NULL ){
+			return false;
+		}
+		result.d = fscanf(file, "%u", value[i]);
+		(void) fclose(file);
+		if ( result.d != 1 ){
+			return false;
+		}
+	}
+	return true;
+#else
+	(void) cpu;
+	*package = 0;
+	*core    = 0;
+	return false;
+#endif	/* __linux__ */
+}
+
+/**@see "system.h" **/
+INLINE bool
+cpu_model(/*@out@*/ char *const RESTRICT dest, const size_t size)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*dest
+@*/
+{
+#ifdef __linux__
+	/* x86 has "model name"; the others have one of the rest */
+	const char *const key[4u] = {
+		"model name", "cpu model", "Hardware", "CPU part"
+	};
+	char line[256u];
+	const char *value;
+	FILE *file;
+	size_t i, len;
+	bool found = false;
+
+	dest[0] = '\0';
+	file = fopen("/proc/cpuinfo", "r");
+	if ( file == NULL ){
+		return false;
+	}
+	while ( (! found) && (fgets(line, (int) sizeof line, file) != NULL) ){
+		for ( i = 0; i < (size_t) 4u; ++i ){
+			len = strlen(key[i]);
+			if ( strncmp(line, key[i], len) != 0 ){
+				continue;
+			}
+			value = strchr(&line[len], ':');
+			if ( value == NULL ){
+				continue;
+			}
+			value += strspn(&value[1u], " \t") + 1u;
+			(void) snprintf(
+				dest, size, "%.*s", (int) strcspn(value, "\n"),
+				value
+			);
+			found = true;
+			break;
+		}
+	}
+	(void) fclose(file);
+	return found;
+#else
+	dest[0] = '\0';
+	(void) size;
+	return false;
+#endif	/* __linux__ */
+}
+
+/* ======================================================================== */
+
+/**@see "system.h" **/
+/*@null@*/ /*@only@*/
+INLINE void *
+pages_map(size_t *const RESTRICT size, const bool hugetlb)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*size
+@*/
+{
+	void *ptr;
+#ifdef MAP_HUGETLB
+	size_t size_huge;
+
+	if ( hugetlb ){
+		size_huge  = *size + (HUGEPAGE_SIZE - 1u);
+		size_huge -= size_huge % HUGEPAGE_SIZE;
+		ptr = mmap(NULL, size_huge, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0
+		);
+		if ( ptr != MAP_FAILED ){
+			*size = size_huge;
+			return ptr;
+		}
+	}
+#else
+	(void) hugetlb;
+#endif	/* MAP_HUGETLB */
+
+	ptr = mmap(NULL, *size, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS, -1, 0
+	);
+	if UNLIKELY ( ptr == MAP_FAILED ){
+		return NULL;
+	}
+#ifdef MADV_HUGEPAGE
+	(void) madvise(ptr, *size, MADV_HUGEPAGE);
+#endif
+	return ptr;
+}
+
+/**@see "system.h" **/
+INLINE void
+pages_unmap(/*@only@*/ void *const ptr, const size_t size)
+/*@globals	internalState@*/
+/*@modifies	internalState@*/
+/*@releases	ptr@*/
+{
+	(void) munmap(ptr, size);
+	return;
+}
+
+/**@see "system.h" **/
+INLINE bool
+pages_populate(const void *const ptr, const size_t size)
+/*@globals	internalState@*/
+/*@modifies	internalState@*/
+{
+#ifdef MADV_POPULATE_WRITE
+	const uintptr_t page  = (uintptr_t) sysconf(_SC_PAGESIZE);
+	const uintptr_t start = (uintptr_t) ptr - ((uintptr_t) ptr % page);
+
+	if ( size == 0 ){
+		return true;
+	}
+	return (madvise((void *) start, ((uintptr_t) ptr - start) + size,
+		MADV_POPULATE_WRITE) == 0
+	);
+#else
+	(void) ptr;
+	(void) size;
+	return false;
+#endif	/* MADV_POPULATE_WRITE */
+}
+
+/**@see "system.h" **/
+INLINE void
+pages_discard(const void *const ptr, const size_t size)
+/*@globals	internalState@*/
+/*@modifies	internalState@*/
+{
+#ifdef MADV_DONTNEED
+	const uintptr_t page  = (uintptr_t) sysconf(_SC_PAGESIZE);
+	uintptr_t start = (uintptr_t) ptr;
+	uintptr_t end   = (uintptr_t) ptr + size;
+
+	/* only the pages wholly in the range */
+	start += (start % page != 0 ? page - (start % page) : 0);
+	end   -= end % page;
+	if ( end > start ){
+		(void) madvise((void *) start, end - start, MADV_DONTNEED);
+	}
+#else
+	(void) ptr;
+	(void) size;
+#endif	/* MADV_DONTNEED */
+	return;
+}
+
+/* ------------------------------------------------------------------------ */
+
+/* after pages_map(), which it uses */
+/**@see "system.h" **/
+INLINE bool
+file_move(
+	FILE *const RESTRICT filehandle, const off_t dst, const off_t src,
+	const off_t len
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		filehandle
+@*/
+{
+	const int fd = fileno(filehandle);
+	off_t done = 0;
+	off_t at;
+	uint8_t *buf;
+	size_t bufsize = FILE_MOVE_CHUNK;
+	size_t chunk, nread;
+	ssize_t nbytes;
+	bool retval = true;
+#if defined(__linux__) && defined(SYS_copy_file_range)
+	long long off_in, off_out;
+#endif
+
+	if ( (len == 0) || (dst == src) ){
+		return true;
+	}
+	if UNLIKELY ( fflush(filehandle) != 0 ){
+		return false;
+	}
+
+#if defined(__linux__) && defined(SYS_copy_file_range)
+	/* in the kernel, and maybe without copying (reflinks), if the ranges
+	     do not overlap; else, or if unsupported, through a buffer
+	*/
+	if ( (dst > src ? dst - src : src - dst) >= len ){
+		off_in  = (long long) src;
+		off_out = (long long) dst;
+		while ( done < len ){
+			nbytes = (ssize_t) syscall(
+				SYS_copy_file_range, fd, &off_in, fd, &off_out,
+				(size_t) (len - done), 0u
+			);
+			if ( nbytes <= 0 ){
+				if ( (nbytes < 0) && (errno == EINTR) ){
+					continue;
+				}
+				break;
+			}
+			done += (off_t) nbytes;
+		}
+		if ( done == len ){
+			return true;
+		}
+		done = 0;	/* the source is still whole */
+	}
+#endif
+
+	buf = pages_map(&bufsize, false);
+	if UNLIKELY ( buf == NULL ){
+		return false;
+	}
+
+	/* front to back when moving down, back to front when moving up, so a
+	     chunk is never written over before it is read
+	*/
+	while ( done < len ){
+		chunk = (size_t) (len - done < (off_t) bufsize
+			? len - done : (off_t) bufsize
+		);
+		at    = (dst < src ? done : len - done - (off_t) chunk);
+		for ( nread = 0; nread < chunk; nread += (size_t) nbytes ){
+			nbytes = pread(
+				fd, &buf[nread], chunk - nread,
+				src + at + (off_t) nread
+			);
+			if UNLIKELY ( nbytes <= 0 ){
+				if ( (nbytes < 0) && (errno == EINTR) ){
+					nbytes = 0;
+					continue;
+				}
+				if ( nbytes == 0 ){
+					errno = EIO;
+				}
+				retval = false;
+				goto end;
+			}
+		}
+		if UNLIKELY ( ! file_pwrite(filehandle, buf, chunk, dst + at) ){
+			retval = false;
+			goto end;
+		}
+		done += (off_t) chunk;
+	}
+end:
+	pages_unmap(buf, bufsize);
+	return retval;
+}
+
 /* ======================================================================== */
 
 /**@see "system.h" **/
@@ -6,7 +6,7 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
@@ -15,7 +15,9 @@
 #include <errno.h>
 #include <signal.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <io.h>
@@ -29,8 +31,20 @@
 
 #define PATH_DELIM	'\\'
 
+/* cache directory: %LOCALAPPDATA%, else %USERPROFILE%\AppData\Local */
+#define CACHEDIR_ENV		"LOCALAPPDATA"
+#define CACHEDIR_ENV_FALLBACK	"USERPROFILE"
+#define CACHEDIR_SFX_FALLBACK	"\\AppData\\Local"
+
 typedef LARGE_INTEGER	timestamp_p;
 
+/* same layout as POSIX's */
+struct IOVec {
+	void	*iov_base;
+	size_t	iov_len;
+};
+typedef struct IOVec	iovec_p;
+
 /* //////////////////////////////////////////////////////////////////////// */
 
 /*@unused@*/
@@ -204,6 +218,336 @@ file_unlock(FILE *const RESTRICT filehandle)
 	return;
 }
 
+/**@see "system.h" **/
+INLINE bool
+file_writev(
+	FILE *const RESTRICT filehandle, iovec_p *RESTRICT iov, size_t niov
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		filehandle,
+		*iov
+@*/
+{
+	/* no writev; stdio coalesces the small entries */
+	for ( ; niov != 0; ++iov, --niov ){
+		if ( iov->iov_len == 0 ){
+			continue;
+		}
+		if UNLIKELY (
+		     fwrite(iov->iov_base, iov->iov_len, (size_t) 1u,
+			filehandle
+		     ) != (size_t) 1u
+		){
+			return false;
+		}
+	}
+	return true;
+}
+
+/**@see "system.h" **/
+INLINE bool
+file_regsize(
+	FILE *const RESTRICT filehandle, /*@out@*/ off_t *const RESTRICT size
+)
+/*@globals	fileSystem@*/
+/*@modifies	*size@*/
+{
+	const HANDLE file = (HANDLE) _get_osfhandle(_fileno(filehandle));
+	LARGE_INTEGER file_size;
+
+	*size = 0;
+	if ( (file == INVALID_HANDLE_VALUE)
+	    ||
+	     (GetFileType(file) != FILE_TYPE_DISK)
+	    ||
+	     (GetFileSizeEx(file, &file_size) == 0)
+	){
+		return false;
+	}
+	*size = (off_t) file_size.QuadPart;
+	return true;
+}
+
+/**@see "system.h" **/
+INLINE bool
+file_pwrite(
+	FILE *const RESTRICT filehandle, const void *const RESTRICT buf,
+	const size_t len, const off_t offset
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		filehandle
+@*/
+{
+	const HANDLE file = (HANDLE) _get_osfhandle(_fileno(filehandle));
+	OVERLAPPED ov;
+	uint64_t at;
+	size_t done = 0;
+	DWORD  chunk, nwritten;
+
+	if UNLIKELY ( fflush(filehandle) != 0 ){
+		return false;
+	}
+	if UNLIKELY ( file == INVALID_HANDLE_VALUE ){
+		errno = EBADF;
+		return false;
+	}
+
+	/* NOTE: unlike pwrite, this moves the file pointer */
+	while ( done < len ){
+		at    = (uint64_t) offset + done;
+		chunk = (DWORD) (len - done < (size_t) 0x40000000u
+			? len - done : (size_t) 0x40000000u
+		);
+		memset(&ov, 0x00, sizeof ov);
+		ov.Offset     = (DWORD) (at & 0xFFFFFFFFu);
+		ov.OffsetHigh = (DWORD) (at >> 32u);
+		if UNLIKELY (
+		     (WriteFile(
+			file, &((const uint8_t *) buf)[done], chunk,
+			&nwritten, &ov
+		     ) == 0)
+		    ||
+		     (nwritten == 0)
+		){
+			errno = EIO;
+			return false;
+		}
+		done += (size_t) nwritten;
+	}
+	return true;
+}
+
+/**@see "system.h" **/
+INLINE size_t
+file_pread(
+	FILE *const RESTRICT filehandle, /*@out@*/ void *const RESTRICT buf,
+	const size_t len, const off_t offset
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		*buf
+@*/
+{
+	const HANDLE file = (HANDLE) _get_osfhandle(_fileno(filehandle));
+	OVERLAPPED ov;
+	uint64_t at;
+	size_t done = 0;
+	DWORD  chunk, nread;
+
+	if UNLIKELY ( file == INVALID_HANDLE_VALUE ){
+		errno = EBADF;
+		return 0;
+	}
+
+	/* NOTE: unlike pread, this moves the file pointer */
+	while ( done < len ){
+		at    = (uint64_t) offset + done;
+		chunk = (DWORD) (len - done < (size_t) 0x40000000u
+			? len - done : (size_t) 0x40000000u
+		);
+		memset(&ov, 0x00, sizeof ov);
+		ov.Offset     = (DWORD) (at & 0xFFFFFFFFu);
+		ov.OffsetHigh = (DWORD) (at >> 32u);
+		if ( ReadFile(
+			file, &((uint8_t *) buf)[done], chunk, &nread, &ov
+		     ) == 0
+		){
+			errno = (GetLastError() == ERROR_HANDLE_EOF ? 0 : EIO);
+			break;
+		}
+		if ( nread == 0 ){
+			errno = 0;
+			break;
+		}
+		done += (size_t) nread;
+	}
+	return done;
+}
+
+/**@see "system.h" **/
+INLINE bool
+file_prealloc(FILE *const RESTRICT filehandle, const off_t size)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		filehandle
+@*/
+{
+	const HANDLE file = (HANDLE) _get_osfhandle(_fileno(filehandle));
+	FILE_ALLOCATION_INFO info;
+	off_t cur;
+
+	if ( (size <= 0)
+	    ||
+	     (! file_regsize(filehandle, &cur)) || (cur >= size)
+	){
+		return false;
+	}
+	/* only reserves the clusters; the size is left alone */
+	info.AllocationSize.QuadPart = (LONGLONG) size;
+	return SetFileInformationByHandle(
+		file, FileAllocationInfo, &info, (DWORD) sizeof info
+	) != 0;
+}
+
+/**@see "system.h" **/
+INLINE bool
+file_truncate(FILE *const RESTRICT filehandle, const off_t size)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		filehandle
+@*/
+{
+	off_t cur;
+
+	if UNLIKELY ( fflush(filehandle) != 0 ){
+		return false;
+	}
+	if ( ! file_regsize(filehandle, &cur) ){
+		return true;	/* NUL */
+	}
+	return _chsize_s(_fileno(filehandle), (__int64) size) == 0;
+}
+
+/**@see "system.h" **/
+INLINE bool
+file_direct(FILE *const RESTRICT filehandle, const bool on)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem,
+		filehandle
+@*/
+{
+	/* FILE_FLAG_NO_BUFFERING can only be had when the file is opened */
+	(void) filehandle;
+	return ! on;
+}
+
+/**@see "system.h" **/
+INLINE void
+file_advise(
+	FILE *const RESTRICT filehandle, const off_t offset, const off_t len,
+	const enum FileAdvice advice
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem@*/
+{
+	/* only at CreateFile time (FILE_FLAG_SEQUENTIAL_SCAN) */
+	(void) filehandle;
+	(void) offset;
+	(void) len;
+	(void) advice;
+	return;
+}
+
+/**@see "system.h" **/
+INLINE void
+file_writeback(
+	FILE *const RESTRICT filehandle, const off_t offset, const off_t len,
+	const bool wait
+)
+/*@globals	fileSystem@*/
+/*@modifies	fileSystem@*/
+{
+	/* FlushFileBuffers is the whole file, and a sync */
+	(void) filehandle;
+	(void) offset;
+	(void) len;
+	(void) wait;
+	return;
+}
+
+/**@see "system.h" **/
+INLINE bool
+file_map(
+	/*@out@*/ struct FileMap *const RESTRICT map,
+	FILE *const RESTRICT filehandle, const off_t offset, const size_t size,
+	const bool write
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*map
+@*/
+{
+	const HANDLE file = (HANDLE) _get_osfhandle(_fileno(filehandle));
+	SYSTEM_INFO info;
+	LARGE_INTEGER file_size;
+	uint64_t start;
+	HANDLE mapping;
+	void *ptr;
+
+	map->base = NULL;
+	map->size = 0;
+	map->data = NULL;
+
+	if ( (size == 0) || (offset < 0) || (file == INVALID_HANDLE_VALUE)
+	    ||
+	     (GetFileType(file) != FILE_TYPE_DISK)
+	    ||
+	     (GetFileSizeEx(file, &file_size) == 0)
+	    ||
+	     ((uint64_t) file_size.QuadPart < (uint64_t) offset)
+	    ||
+	     ((uint64_t) file_size.QuadPart - (uint64_t) offset
+	      < (uint64_t) size
+	     )
+	){
+		return false;
+	}
+
+	/* a view starts on an allocation-granularity boundary */
+	GetSystemInfo(&info);
+	start  = (uint64_t) offset;
+	start -= start % info.dwAllocationGranularity;
+	if ( size > SIZE_MAX - (size_t) ((uint64_t) offset - start) ){
+		return false;
+	}
+	map->size = (size_t) ((uint64_t) offset - start) + size;
+
+	mapping = CreateFileMapping(
+		file, NULL, (write ? PAGE_READWRITE : PAGE_READONLY), 0, 0,
+		NULL
+	);
+	if UNLIKELY ( mapping == NULL ){
+		map->size = 0;
+		return false;
+	}
+	ptr = MapViewOfFile(
+		mapping, (write ? FILE_MAP_WRITE : FILE_MAP_READ),
+		(DWORD) (start >> 32u),
+		(DWORD) (start & 0xFFFFFFFFu), map->size
+	);
+	/* the view keeps the mapping object alive */
+	(void) CloseHandle(mapping);
+	if UNLIKELY ( ptr == NULL ){
+		map->size = 0;
+		return false;
+	}
+	map->base = ptr;
+	map->data = &((uint8_t *) ptr)[(uint64_t) offset - start];
+	return true;
+}
+
+/**@see "system.h" **/
+INLINE void
+file_unmap(struct FileMap *const RESTRICT map)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*map
+@*/
+{
+	if ( map->base != NULL ){
+		(void) UnmapViewOfFile(map->base);
+	}
+	map->base = NULL;
+	map->size = 0;
+	map->data = NULL;
+	return;
+}
+
 /* ======================================================================== */
 
 /**@see "system.h" **/
@@ -239,6 +583,205 @@ get_nprocessors_onln(void)
 	return (unsigned int) info.dwNumberOfProcessors;
 }
 
+/* ------------------------------------------------------------------------ */
+
+/**@see "system.h" **/
+INLINE bool
+cpuset_get(/*@out@*/ struct CPUSet *const RESTRICT set)
+/*@globals	internalState@*/
+/*@modifies	*set@*/
+{
+	memset(set, 0x00, sizeof *set);
+	return false;
+}
+
+/**@see "system.h" **/
+INLINE bool
+cpuset_set(const struct CPUSet *const RESTRICT set)
+/*@globals	internalState@*/
+/*@modifies	internalState@*/
+{
+	(void) set;
+	return false;
+}
+
+/**@see "system.h" **/
+INLINE bool
+cpu_topology(
+	const unsigned int cpu, /*@out@*/ unsigned int *const RESTRICT package,
+	/*@out@*/ unsigned int *const RESTRICT core
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*package,
+		*core
+@*/
+{
+	(void) cpu;
+	*package = 0;
+	*core    = 0;
+	return false;
+}
+
+/**@see "system.h" **/
+INLINE bool
+cpu_model(/*@out@*/ char *const RESTRICT dest, const size_t size)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		*dest
+@*/
+{
+	const char *const value = getenv("PROCESSOR_IDENTIFIER");
+
+	if ( value == NULL ){
+		dest[0] = '\0';
+		return false;
+	}
+	(void) snprintf(dest, size, "%s", value);
+	return true;
+}
+
+
+/* ======================================================================== */
+
+/**@see "system.h" **/
+/*@null@*/ /*@only@*/
+INLINE void *
+pages_map(size_t *const RESTRICT size, const bool hugetlb)
+/*@globals	internalState@*/
+/*@modifies	internalState,
+		*size
+@*/
+{
+	void *ptr;
+
+	/* large pages need a privilege that most users do not have */
+	(void) hugetlb;
+
+	ptr = VirtualAlloc(
+		NULL, *size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE
+	);
+	if UNLIKELY ( ptr == NULL ){
+		errno = ENOMEM;
+	}
+	return ptr;
+}
+
+/**@see "system.h" **/
+INLINE void
+pages_unmap(/*@only@*/ void *const ptr, const size_t size)
+/*@globals	internalState@*/
+/*@modifies	internalState@*/
+/*@releases	ptr@*/
+{
+	(void) size;
+	(void) VirtualFree(ptr, 0, MEM_RELEASE);
+	return;
+}
+
+/**@see "system.h" **/
+INLINE bool
+pages_populate(const void *const ptr, const size_t size)
+/*@globals	internalState@*/
+/*@modifies	internalState@*/
+{
+	(void) ptr;
+	(void) size;
+	return false;
+}
+
+/**@see "system.h" **/
+INLINE void
+pages_discard(const void *const ptr, const size_t size)
+/*@globals	internalState@*/
+/*@modifies	internalState@*/
+{
+	(void) ptr;
+	(void) size;
+	return;
+}
+
+/* ------------------------------------------------------------------------ */
+
+/* after pages_map(), which it uses */
+/**@see "system.h" **/
+INLINE bool
+file_move(
+	FILE *const RESTRICT filehandle, const off_t dst, const off_t src,
+	const off_t len
+)
+/*@globals	fileSystem,
+		internalState
+@*/
+/*@modifies	fileSystem,
+		internalState,
+		filehandle
+@*/
+{
+	const HANDLE file = (HANDLE) _get_osfhandle(_fileno(filehandle));
+	OVERLAPPED ov;
+	uint64_t from;
+	off_t done = 0;
+	off_t at;
+	uint8_t *buf;
+	size_t bufsize = FILE_MOVE_CHUNK;
+	size_t chunk;
+	DWORD nread;
+	bool retval = true;
+
+	if ( (len == 0) || (dst == src) ){
+		return true;
+	}
+	if UNLIKELY ( fflush(filehandle) != 0 ){
+		return false;
+	}
+	if UNLIKELY ( file == INVALID_HANDLE_VALUE ){
+		errno = EBADF;
+		return false;
+	}
+
+	buf = pages_map(&bufsize, false);
+	if UNLIKELY ( buf == NULL ){
+		return false;
+	}
+
+	/* front to back when moving down, back to front when moving up, so a
+	     chunk is never written over before it is read
+	*/
+	while ( done < len ){
+		chunk = (size_t) (len - done < (off_t) bufsize
+			? len - done : (off_t) bufsize
+		);
+		at    = (dst < src ? done : len - done - (off_t) chunk);
+		from  = (uint64_t) (src + at);
+		memset(&ov, 0x00, sizeof ov);
+		ov.Offset     = (DWORD) (from & 0xFFFFFFFFu);
+		ov.OffsetHigh = (DWORD) (from >> 32u);
+		if UNLIKELY (
+		     (ReadFile(file, buf, (DWORD) chunk, &nread, &ov) == 0)
+		    ||
+		     ((size_t) nread != chunk)
+		){
+			errno  = EIO;
+			retval = false;
+			break;
+		}
+		if UNLIKELY ( ! file_pwrite(filehandle, buf, chunk, dst + at) ){
+			retval = false;
+			break;
+		}
+		done += (off_t) chunk;
+	}
+
+	pages_unmap(buf, bufsize);
+	return retval;
+}
 
 /* ======================================================================== */
 
@@ -4,7 +4,7 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
@@ -32,6 +32,134 @@ struct LibTTAr_VersionInfo {
 
 /* //////////////////////////////////////////////////////////////////////// */
 
+/* compiler; options (LIBTTAr_OPT_SLOW_CPU is already split up); target */
+
+#if defined(__clang__)
+#define BUILDINFO_CC	"clang " __clang_version__
+#elif defined(__GNUC__)
+#define BUILDINFO_CC	"gcc " __VERSION__
+#else
+#define BUILDINFO_CC	"cc"
+#endif	/* BUILDINFO_CC */
+
+#ifdef NDEBUG
+#define BUILDINFO_NDEBUG	"NDEBUG"
+#else
+#define BUILDINFO_NDEBUG	"DEBUG"
+#endif	/* NDEBUG */
+
+#ifdef LIBTTAr_OPT_DISABLE_UNROLLED_1CH
+#define BUILDINFO_DISABLE_UNROLLED_1CH	" DISABLE_UNROLLED_1CH"
+#else
+#define BUILDINFO_DISABLE_UNROLLED_1CH	""
+#endif	/* LIBTTAr_OPT_DISABLE_UNROLLED_1CH */
+
+#ifdef LIBTTAr_OPT_DISABLE_UNROLLED_2CH
+#define BUILDINFO_DISABLE_UNROLLED_2CH	" DISABLE_UNROLLED_2CH"
+#else
+#define BUILDINFO_DISABLE_UNROLLED_2CH	""
+#endif	/* LIBTTAr_OPT_DISABLE_UNROLLED_2CH */
+
+#ifdef LIBTTAr_OPT_DISABLE_MCH
+#define BUILDINFO_DISABLE_MCH	" DISABLE_MCH"
+#else
+#define BUILDINFO_DISABLE_MCH	""
+#endif	/* LIBTTAr_OPT_DISABLE_MCH */
+
+#ifdef LIBTTAr_OPT_DISABLE_ZERORUN
+#define BUILDINFO_DISABLE_ZERORUN	" DISABLE_ZERORUN"
+#else
+#define BUILDINFO_DISABLE_ZERORUN	""
+#endif	/* LIBTTAr_OPT_DISABLE_ZERORUN */
+
+#ifdef LIBTTAr_OPT_DISABLE_SIMD_INTRINSICS
+#define BUILDINFO_DISABLE_SIMD_INTRINSICS	" DISABLE_SIMD_INTRINSICS"
+#else
+#define BUILDINFO_DISABLE_SIMD_INTRINSICS	""
+#endif	/* LIBTTAr_OPT_DISABLE_SIMD_INTRINSICS */
+
+#ifdef LIBTTAr_OPT_I16_FILTER
+#define BUILDINFO_I16_FILTER	" I16_FILTER"
+#else
+#define BUILDINFO_I16_FILTER	""
+#endif	/* LIBTTAr_OPT_I16_FILTER */
+
+#ifdef LIBTTAr_OPT_NO_NATIVE_TZCNT
+#define BUILDINFO_NO_NATIVE_TZCNT	" NO_NATIVE_TZCNT"
+#else
+#define BUILDINFO_NO_NATIVE_TZCNT	""
+#endif	/* LIBTTAr_OPT_NO_NATIVE_TZCNT */
+
+#ifdef LIBTTAr_OPT_FEWER_FAST_TYPES
+#define BUILDINFO_FEWER_FAST_TYPES	" FEWER_FAST_TYPES"
+#else
+#define BUILDINFO_FEWER_FAST_TYPES	""
+#endif	/* LIBTTAr_OPT_FEWER_FAST_TYPES */
+
+#ifdef LIBTTAr_OPT_ONLY_NECESSARY_FAST_TYPES
+#define BUILDINFO_ONLY_NECESSARY_FAST_TYPES	" ONLY_NECESSARY_FAST_TYPES"
+#else
+#define BUILDINFO_ONLY_NECESSARY_FAST_TYPES	""
+#endif	/* LIBTTAr_OPT_ONLY_NECESSARY_FAST_TYPES */
+
+#ifdef LIBTTAr_OPT_PREFER_CONDITIONAL_MOVES
+#define BUILDINFO_PREFER_CONDITIONAL_MOVES	" PREFER_CONDITIONAL_MOVES"
+#else
+#define BUILDINFO_PREFER_CONDITIONAL_MOVES	""
+#endif	/* LIBTTAr_OPT_PREFER_CONDITIONAL_MOVES */
+
+#ifdef LIBTTAr_OPT_PREFER_LOOKUP_TABLES
+#define BUILDINFO_PREFER_LOOKUP_TABLES	" PREFER_LOOKUP_TABLES"
+#else
+#define BUILDINFO_PREFER_LOOKUP_TABLES	""
+#endif	/* LIBTTAr_OPT_PREFER_LOOKUP_TABLES */
+
+/* ------------------------------------------------------------------------ */
+
+#ifdef __SSE2__
+#define BUILDINFO_ISA_SSE2	" SSE2"
+#else
+#define BUILDINFO_ISA_SSE2	""
+#endif	/* __SSE2__ */
+
+#ifdef __SSSE3__
+#define BUILDINFO_ISA_SSSE3	" SSSE3"
+#else
+#define BUILDINFO_ISA_SSSE3	""
+#endif	/* __SSSE3__ */
+
+#ifdef __SSE4_1__
+#define BUILDINFO_ISA_SSE4_1	" SSE4_1"
+#else
+#define BUILDINFO_ISA_SSE4_1	""
+#endif	/* __SSE4_1__ */
+
+#ifdef __AVX2__
+#define BUILDINFO_ISA_AVX2	" AVX2"
+#else
+#define BUILDINFO_ISA_AVX2	""
+#endif	/* __AVX2__ */
+
+#ifdef __BMI__
+#define BUILDINFO_ISA_BMI	" BMI"
+#else
+#define BUILDINFO_ISA_BMI	""
+#endif	/* __BMI__ */
+
+#ifdef __ARM_NEON
+#define BUILDINFO_ISA_NEON	" NEON"
+#else
+#define BUILDINFO_ISA_NEON	""
+#endif	/* __ARM_NEON */
+
+#ifdef __ALTIVEC__
+#define BUILDINFO_ISA_ALTIVEC	" ALTIVEC"
+#else
+#define BUILDINFO_ISA_ALTIVEC	""
+#endif	/* __ALTIVEC__ */
+
+/* //////////////////////////////////////////////////////////////////////// */
+
 /**@struct libttaR_info
  * @brief library version, copyright, and license info
  *
@@ -49,4 +177,33 @@ const struct LibTTAr_VersionInfo libttaR_info = {
 	LIB_LICENSE_STR
 };
 
+/**@var libttaR_buildinfo
+ * @brief how the library was built; for telling builds apart
+ *
+ * @note read the manpage for more info
+**/
+BUILD_EXPORT
+const char *const libttaR_buildinfo = (
+	BUILDINFO_CC "; " BUILDINFO_NDEBUG
+	BUILDINFO_DISABLE_UNROLLED_1CH
+	BUILDINFO_DISABLE_UNROLLED_2CH
+	BUILDINFO_DISABLE_MCH
+	BUILDINFO_DISABLE_ZERORUN
+	BUILDINFO_DISABLE_SIMD_INTRINSICS
+	BUILDINFO_I16_FILTER
+	BUILDINFO_NO_NATIVE_TZCNT
+	BUILDINFO_FEWER_FAST_TYPES
+	BUILDINFO_ONLY_NECESSARY_FAST_TYPES
+	BUILDINFO_PREFER_CONDITIONAL_MOVES
+	BUILDINFO_PREFER_LOOKUP_TABLES
+	";"
+	BUILDINFO_ISA_SSE2
+	BUILDINFO_ISA_SSSE3
+	BUILDINFO_ISA_SSE4_1
+	BUILDINFO_ISA_AVX2
+	BUILDINFO_ISA_BMI
+	BUILDINFO_ISA_NEON
+	BUILDINFO_ISA_ALTIVEC
+);
+
 /* EOF //////////////////////////////////////////////////////////////////// */
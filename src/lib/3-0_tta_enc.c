@@ -5,7 +5,7 @@
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
 // Copyright (C) 2007, Aleksander Djuric                                    //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
@@ -154,14 +154,15 @@ ALWAYS_INLINE size_t tta_encode_2ch_loop(
 
 /* //////////////////////////////////////////////////////////////////////// */
 
-/**@fn libttaR_tta_encode
+/**@fn libttaR_tta_encode_kernel
  * @brief a reentrant TTA encoder
  *
- * @param dest - destination buffer
- * @param src  - source buffer
- * @param priv - private state struct
- * @param user - user readable state struct
- * @param misc - other values/properties
+ * @param dest   - destination buffer
+ * @param src    - source buffer
+ * @param priv   - private state struct
+ * @param user   - user readable state struct
+ * @param misc   - other values/properties
+ * @param kernel - which codec loop to use
  *
  * @return the state of the encoder
  * @retval LIBTTAr_ERV_OK_DONE       - frame finished
@@ -176,12 +177,13 @@ ALWAYS_INLINE size_t tta_encode_2ch_loop(
 **/
 BUILD_EXPORT
 enum LibTTAr_EncRetVal
-libttaR_tta_encode(
+libttaR_tta_encode_kernel(
 	/*@reldef@*/ uint8_t *RESTRICT const dest,
 	/*@in@*/ const int32_t *RESTRICT const src,
 	/*@reldef@*/ struct LibTTAr_CodecState_Priv *const RESTRICT priv,
 	/*@in@*/ struct LibTTAr_CodecState_User *const RESTRICT user,
-	/*@in@*/ const struct LibTTAr_EncMisc *const RESTRICT misc
+	/*@in@*/ const struct LibTTAr_EncMisc *const RESTRICT misc,
+	const enum LibTTAr_Kernel kernel
 )
 /*@modifies	*dest,
 		*priv,
@@ -193,6 +195,8 @@ libttaR_tta_encode(
 	     ((unsigned int) misc->samplebytes == 0)
 	    ||
 	     ((unsigned int) misc->samplebytes > LIBTTAr_SAMPLEBYTES_MAX)
+	    ||
+	     ((unsigned int) kernel > LIBTTAr_KERNEL_MAX)
 	){
 		return LIBTTAr_ERV_INVAL_RANGE;
 	}
@@ -204,9 +208,16 @@ libttaR_tta_encode(
 
 	/* init private state */
 	if ( user->ncalls_codec == 0 ){
-		state_priv_init_enc(priv, misc->nchan);
+		state_priv_init_enc(priv, misc->nchan, misc->samplebytes);
 	}
 
+#ifndef LIBTTAr_OPT_DISABLE_MCH
+	/* general loop for any nchan */
+	if ( kernel == LIBTTAr_KERNEL_MCH ){
+		return tta_encode_mch(dest, src, priv, user, misc);
+	}
+#endif	/* LIBTTAr_OPT_DISABLE_MCH */
+
 	switch ( misc->nchan ){
 	default:
 #ifndef LIBTTAr_OPT_DISABLE_MCH
@@ -233,6 +244,30 @@ libttaR_tta_encode(
 #endif	/* misconfig check */
 }
 
+/**@fn libttaR_tta_encode
+ * @brief a reentrant TTA encoder, with the default kernel
+ *
+ * @see libttaR_tta_encode_kernel()
+**/
+BUILD_EXPORT
+enum LibTTAr_EncRetVal
+libttaR_tta_encode(
+	/*@reldef@*/ uint8_t *RESTRICT const dest,
+	/*@in@*/ const int32_t *RESTRICT const src,
+	/*@reldef@*/ struct LibTTAr_CodecState_Priv *const RESTRICT priv,
+	/*@in@*/ struct LibTTAr_CodecState_User *const RESTRICT user,
+	/*@in@*/ const struct LibTTAr_EncMisc *const RESTRICT misc
+)
+/*@modifies	*dest,
+		*priv,
+		*user
+@*/
+{
+	return libttaR_tta_encode_kernel(
+		dest, src, priv, user, misc, LIBTTAr_KERNEL_DEFAULT
+	);
+}
+
 /* ------------------------------------------------------------------------ */
 
 #ifndef LIBTTAr_OPT_DISABLE_MCH
@@ -382,10 +417,10 @@ tta_encode_mch_loop(
 		if ( nbytes_enc > write_soft_limit ){
 			break;
 		}
+		TTAENC_ZERORUN(nchan);
 
-#ifdef LIBTTAr_OPT_DISABLE_UNROLLED_1CH
+		/* only matters for mono */
 		prev = 0;
-#endif	/* LIBTTAr_OPT_DISABLE_UNROLLED_1CH */
 
 		for ( j = 0; j < nchan - 1u; ++j ){
 			curr.i = src[i + j + 1u] - src[i + j + 0u];
@@ -437,6 +472,7 @@ tta_encode_1ch_loop(
 		if ( nbytes_enc > write_soft_limit ){
 			break;
 		}
+		TTAENC_ZERORUN(1u);
 		curr.i = src[i];
 		TTAENC_ENCODE(0);
 	}
@@ -483,6 +519,7 @@ tta_encode_2ch_loop(
 		if ( nbytes_enc > write_soft_limit ){
 			break;
 		}
+		TTAENC_ZERORUN(2u);
 	/* 0 */
 		curr.i = (next = src[i + 1u]) - src[i + 0u];
 		TTAENC_ENCODE(0u);
@@ -5,7 +5,7 @@
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
 // Copyright (C) 2007, Aleksander Djuric                                    //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
@@ -157,14 +157,15 @@ ALWAYS_INLINE size_t tta_decode_2ch_loop(
 
 /* //////////////////////////////////////////////////////////////////////// */
 
-/**@fn libttaR_tta_decode
+/**@fn libttaR_tta_decode_kernel
  * @brief a reentrant TTA decoder
  *
- * @param dest - destination buffer
- * @param src  - source buffer
- * @param priv - private state struct
- * @param user - user readable state struct
- * @param misc - other values/properties
+ * @param dest   - destination buffer
+ * @param src    - source buffer
+ * @param priv   - private state struct
+ * @param user   - user readable state struct
+ * @param misc   - other values/properties
+ * @param kernel - which codec loop to use
  *
  * @return the state of the decoder
  * @retval LIBTTAr_DRV_OK_DONE       - frame finished
@@ -180,12 +181,13 @@ ALWAYS_INLINE size_t tta_decode_2ch_loop(
 **/
 BUILD_EXPORT
 enum LibTTAr_DecRetVal
-libttaR_tta_decode(
+libttaR_tta_decode_kernel(
 	/*@reldef@*/ int32_t *RESTRICT const dest,
 	/*@in@*/ const uint8_t *RESTRICT const src,
 	/*@reldef@*/ struct LibTTAr_CodecState_Priv *const RESTRICT priv,
 	/*@in@*/ struct LibTTAr_CodecState_User *const RESTRICT user,
-	/*@in@*/ const struct LibTTAr_DecMisc *const RESTRICT misc
+	/*@in@*/ const struct LibTTAr_DecMisc *const RESTRICT misc,
+	const enum LibTTAr_Kernel kernel
 )
 /*@modifies	*dest,
 		*priv,
@@ -197,6 +199,8 @@ libttaR_tta_decode(
 	     ((unsigned int) misc->samplebytes == 0)
 	    ||
 	     ((unsigned int) misc->samplebytes > LIBTTAr_SAMPLEBYTES_MAX)
+	    ||
+	     ((unsigned int) kernel > LIBTTAr_KERNEL_MAX)
 	){
 		return LIBTTAr_DRV_INVAL_RANGE;
 	}
@@ -208,8 +212,15 @@ libttaR_tta_decode(
 
 	/* init private state */
 	if ( user->ncalls_codec == 0 ){
-		state_priv_init_dec(priv, misc->nchan);
+		state_priv_init_dec(priv, misc->nchan, misc->samplebytes);
+	}
+
+#ifndef LIBTTAr_OPT_DISABLE_MCH
+	/* general loop for any nchan */
+	if ( kernel == LIBTTAr_KERNEL_MCH ){
+		return tta_decode_mch(dest, src, priv, user, misc);
 	}
+#endif	/* LIBTTAr_OPT_DISABLE_MCH */
 
 	switch ( misc->nchan ){
 	default:
@@ -237,6 +248,30 @@ libttaR_tta_decode(
 #endif	/* misconfig check */
 }
 
+/**@fn libttaR_tta_decode
+ * @brief a reentrant TTA decoder, with the default kernel
+ *
+ * @see libttaR_tta_decode_kernel()
+**/
+BUILD_EXPORT
+enum LibTTAr_DecRetVal
+libttaR_tta_decode(
+	/*@reldef@*/ int32_t *RESTRICT const dest,
+	/*@in@*/ const uint8_t *RESTRICT const src,
+	/*@reldef@*/ struct LibTTAr_CodecState_Priv *const RESTRICT priv,
+	/*@in@*/ struct LibTTAr_CodecState_User *const RESTRICT user,
+	/*@in@*/ const struct LibTTAr_DecMisc *const RESTRICT misc
+)
+/*@modifies	*dest,
+		*priv,
+		*user
+@*/
+{
+	return libttaR_tta_decode_kernel(
+		dest, src, priv, user, misc, LIBTTAr_KERNEL_DEFAULT
+	);
+}
+
 /* ------------------------------------------------------------------------ */
 
 #ifndef LIBTTAr_OPT_DISABLE_MCH
@@ -387,6 +422,7 @@ tta_decode_mch_loop(
 		if ( nbytes_dec > read_soft_limit ){
 			break;
 		}
+		TTADEC_ZERORUN(nchan);
 		j = 0;
 		goto loop1_entr;
 		do {	/* decorrelate (1st pass, forwards) */
@@ -444,6 +480,7 @@ tta_decode_1ch_loop(
 		if ( nbytes_dec > read_soft_limit ){
 			break;
 		}
+		TTADEC_ZERORUN(1u);
 		TTADEC_DECODE(0);
 		dest[i] = curr.i;
 	}
@@ -490,6 +527,7 @@ tta_decode_2ch_loop(
 		if ( nbytes_dec > read_soft_limit ){
 			break;
 		}
+		TTADEC_ZERORUN(2u);
 	/* 0 */
 		TTADEC_DECODE(0u);
 		prev = curr.i;
@@ -44,6 +44,16 @@ ALWAYS_INLINE __m128i mullo_vi32(__m128i, __m128i) /*@*/;
 CONST
 ALWAYS_INLINE int32_t sum_vi32(__m128i) /*@*/;
 
+#ifdef USING_I16_FILTER
+CONST
+ALWAYS_INLINE int fits_i16_vi32(__m128i, __m128i, __m128i, __m128i) /*@*/;
+
+CONST
+ALWAYS_INLINE int32_t dot_i16_vi32(__m128i, __m128i, __m128i, __m128i)
+/*@*/
+;
+#endif	/* USING_I16_FILTER */
+
 CONST
 ALWAYS_INLINE __m128i update_m_hi(__m128i) /*@*/;
 
@@ -86,7 +96,7 @@ ALWAYS_INLINE __m128i update_mb_lo(__m128i, __m128i) /*@*/;
 	v_error  = _mm_set1_epi32(*error); \
 }
 
-#define FILTER_SUM_UPDATE_A { \
+#define FILTER_UPDATE_A { \
 	t_lo     = predictz_vi32(m_lo, v_error); \
 	t_hi     = predictz_vi32(m_hi, v_error); \
 	\
@@ -94,13 +104,44 @@ ALWAYS_INLINE __m128i update_mb_lo(__m128i, __m128i) /*@*/;
 	a_lo     = _mm_add_epi32(a_lo, t_lo); \
 	t_hi     = cneg_izaz_vi32(t_hi, v_error); \
 	a_hi     = _mm_add_epi32(a_hi, t_hi); \
-	\
+}
+
+#define FILTER_SUM_I32 { \
 	r_lo     = mullo_vi32(a_lo, b_lo); \
 	r_hi     = mullo_vi32(a_hi, b_hi); \
 	round   += sum_vi32(r_lo); \
 	round   += sum_vi32(r_hi); \
 }
 
+#ifndef USING_I16_FILTER
+
+#define FILTER_SUM_UPDATE_A { \
+	FILTER_UPDATE_A; \
+	FILTER_SUM_I32; \
+}
+
+#else	/* defined(USING_I16_FILTER) */
+
+/* the sum is mod 2^32 either way, so the 16-bit-lane sum is bit-exact as
+     long as every 'a' and 'b' fits in an int16. if not, then the 32-bit sum
+     is used for the rest of the frame (the flag is re-set per frame)
+*/
+#define FILTER_SUM_UPDATE_A { \
+	FILTER_UPDATE_A; \
+	if LIKELY ( \
+	     (filter->i16 != 0) \
+	    && \
+	     (fits_i16_vi32(a_lo, a_hi, b_lo, b_hi) != 0) \
+	){ \
+		round   += dot_i16_vi32(a_lo, a_hi, b_lo, b_hi); \
+	} \
+	else {	filter->i16 = 0; \
+		FILTER_SUM_I32; \
+	} \
+}
+
+#endif	/* USING_I16_FILTER */
+
 #define FILTER_UPDATE_MB(x_value) { \
 	m_hi_out = update_m_hi(b_hi); \
 	b_hi_out = update_b_hi(b_hi, (x_value)); \
@@ -259,6 +300,73 @@ sum_vi32(__m128i x)
 	return (int32_t) _mm_cvtsi128_si32(x);
 }
 
+#ifdef USING_I16_FILTER
+/**@fn fits_i16_vi32
+ * @brief checks if every item in the vectors fits in an int16
+ *
+ * @param a_lo - low half of 'a'
+ * @param a_hi - high half of 'a'
+ * @param b_lo - low half of 'b'
+ * @param b_hi - high half of 'b'
+ *
+ * @return nonzero if every item is in [INT16_MIN, INT16_MAX]
+**/
+CONST
+ALWAYS_INLINE int
+fits_i16_vi32(
+	const __m128i a_lo, const __m128i a_hi, const __m128i b_lo,
+	const __m128i b_hi
+)
+/*@*/
+{
+	const __m128i v_bias = _mm_set1_epi32(0x00008000);
+	const __m128i v_mask = _mm_set1_epi32((int32_t) 0xFFFF0000);
+	/* * */
+	__m128i x;
+
+	/* (x + 0x8000) < 0x10000 (unsigned) */
+	x = _mm_or_si128(
+		_mm_or_si128(
+			_mm_add_epi32(a_lo, v_bias), _mm_add_epi32(a_hi, v_bias)
+		),
+		_mm_or_si128(
+			_mm_add_epi32(b_lo, v_bias), _mm_add_epi32(b_hi, v_bias)
+		)
+	);
+#ifdef __SSE4_1__
+	return _mm_testz_si128(x, v_mask);	/* SSE4.1 */
+#else
+	x = _mm_cmpeq_epi32(_mm_and_si128(x, v_mask), _mm_setzero_si128());
+	return (int) (_mm_movemask_epi8(x) == 0xFFFF);
+#endif	/* __SSE4_1__ */
+}
+
+/**@fn dot_i16_vi32
+ * @brief dot product of 'a' and 'b' with 16-bit lanes (pmaddwd)
+ *
+ * @param a_lo - low half of 'a'
+ * @param a_hi - high half of 'a'
+ * @param b_lo - low half of 'b'
+ * @param b_hi - high half of 'b'
+ *
+ * @return the dot product (mod 2^32)
+ *
+ * @pre fits_i16_vi32(a_lo, a_hi, b_lo, b_hi)
+**/
+CONST
+ALWAYS_INLINE int32_t
+dot_i16_vi32(
+	const __m128i a_lo, const __m128i a_hi, const __m128i b_lo,
+	const __m128i b_hi
+)
+/*@*/
+{
+	return sum_vi32(_mm_madd_epi16(
+		_mm_packs_epi32(a_lo, a_hi), _mm_packs_epi32(b_lo, b_hi)
+	));
+}
+#endif	/* USING_I16_FILTER */
+
 /**@fn update_m_hi
  * @brief updates the high half of 'm'
  *
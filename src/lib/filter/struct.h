@@ -42,6 +42,11 @@
 
 #endif	/* arch-type */
 
+/* experimental 16-bit-lane sum; 8/16-bit only */
+#if defined(X86_SIMD_INTRINSICS) && defined(LIBTTAr_OPT_I16_FILTER)
+#define USING_I16_FILTER
+#endif	/* LIBTTAr_OPT_I16_FILTER */
+
 /* //////////////////////////////////////////////////////////////////////// */
 
 #ifdef USING_SIMD_INTRINSICS
@@ -51,6 +56,9 @@ struct ALIGNED(LIBTTAr_CODECSTATE_PRIV_ALIGN) Filter {
 	int32_t	dx[8u];
 	int32_t	dl[8u];
 	int32_t	error;	/* the full error */
+#ifdef USING_I16_FILTER
+	int32_t	i16;	/* nonzero: try the 16-bit-lane sum (in the padding) */
+#endif	/* USING_I16_FILTER */
 };
 
 #else	/* !defined(USING_SIMD_INTRINSICS) */
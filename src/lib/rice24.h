@@ -143,6 +143,19 @@ ALWAYS_INLINE size_t rice24_encode_cacheflush(
 @*/
 ;
 
+#undef dest
+#undef bitcache
+#undef crc
+ALWAYS_INLINE size_t rice24_encode_zeros(
+	/*@reldef@*/ uint8_t *RESTRICT dest, size_t, size_t,
+	struct BitCache_Enc *RESTRICT bitcache, crc32_enc *RESTRICT crc
+)
+/*@modifies	*dest,
+		*bitcache,
+		*crc
+@*/
+;
+
 #undef dest
 #undef cache
 #undef count
@@ -220,6 +233,25 @@ ALWAYS_INLINE size_t rice24_decode(
 @*/
 ;
 
+PURE
+ALWAYS_INLINE size_t rice24_peek_zeros(
+	const uint8_t *RESTRICT, size_t, size_t,
+	const struct BitCache_Dec *RESTRICT, size_t
+)
+/*@*/
+;
+
+#undef bitcache
+#undef crc
+ALWAYS_INLINE size_t rice24_decode_zeros(
+	const uint8_t *RESTRICT, size_t, size_t,
+	struct BitCache_Dec *RESTRICT bitcache, crc32_dec *RESTRICT crc
+)
+/*@modifies	*bitcache,
+		*crc
+@*/
+;
+
 #undef unary
 #undef cache
 #undef count
@@ -600,6 +632,49 @@ rice24_encode_cacheflush(
 	return nbytes_enc;
 }
 
+/**@fn rice24_encode_zeros
+ * @brief encode a run of zeros with an idle rice state (rice->k[0u] == 0)
+ *   each zero is just a zero unary code
+ *
+ * @param dest       - destination buffer
+ * @param nzeros     - number of zeros to encode
+ * @param nbytes_enc - total number of bytes encoded so far; index of 'dest'
+ * @param bitcache   - bitcache data
+ * @param crc        - current CRC
+ *
+ * @return number of bytes written to 'dest' + 'nbytes_enc'
+ *
+ * @note max write size: (nzeros / 8u) + 8u
+**/
+ALWAYS_INLINE size_t
+rice24_encode_zeros(
+	/*@reldef@*/ uint8_t *const RESTRICT dest, size_t nzeros,
+	size_t nbytes_enc, struct BitCache_Enc *const RESTRICT bitcache,
+	crc32_enc *const RESTRICT crc
+)
+/*@modifies	*dest,
+		*bitcache,
+		*crc
+@*/
+{
+	cache64    *const RESTRICT cache = &bitcache->cache;
+	bitcnt_enc *const RESTRICT count = &bitcache->count;
+
+	assert(*count <= (bitcnt_enc) 63u);
+
+	/* the bits above '*count' are already zero */
+	nzeros += *count;
+	while ( nzeros >= (size_t) 8u ){
+		dest[nbytes_enc++] = rice24_crc32_enc((uint8_t) *cache, crc);
+		*cache >>= 8u;
+		nzeros  -= 8u;
+	}
+	*count = (bitcnt_enc) nzeros;
+
+	assert(*count <= (bitcnt_enc)  7u);
+	return nbytes_enc;
+}
+
 /* ------------------------------------------------------------------------ */
 
 /**@fn rice24_write_unary
@@ -848,6 +923,102 @@ rice24_decode(
 	return nbytes_dec;
 }
 
+/**@fn rice24_peek_zeros
+ * @brief count the zero unary codes at the start of the bitstream, without
+ *   reading them
+ *
+ * @param src        - source buffer
+ * @param nbytes_dec - total number of bytes decoded so far; idx of 'src'
+ * @param limit      - do not look at 'src' at or past this index
+ * @param bitcache   - bitcache data
+ * @param nzeros_max - stop counting at this number
+ *
+ * @return number of zero unary codes (may be a bit more than 'nzeros_max')
+**/
+PURE
+ALWAYS_INLINE size_t
+rice24_peek_zeros(
+	const uint8_t *const RESTRICT src, size_t nbytes_dec,
+	const size_t limit, const struct BitCache_Dec *const RESTRICT bitcache,
+	const size_t nzeros_max
+)
+/*@*/
+{
+	size_t nzeros;
+
+	assert(bitcache->count <= (bitcnt_dec) 7u);
+
+	/* the bits above 'count' are already zero */
+	if ( bitcache->cache != 0 ){
+		return (size_t) TBCNT8((uint8_t) ~bitcache->cache);
+	}
+	nzeros = (size_t) bitcache->count;
+
+	while ( (nzeros < nzeros_max) && (nbytes_dec < limit) ){
+		if ( src[nbytes_dec] != 0 ){
+			nzeros += (size_t) TBCNT8((uint8_t) ~src[nbytes_dec]);
+			break;
+		}
+		nbytes_dec += 1u;
+		nzeros     += 8u;
+	}
+	return nzeros;
+}
+
+/**@fn rice24_decode_zeros
+ * @brief decode a run of zeros with an idle rice state (rice->k[0u] == 0)
+ *
+ * @param src        - source buffer
+ * @param nzeros     - number of zeros to decode
+ * @param nbytes_dec - total number of bytes decoded so far; idx of 'src'
+ * @param bitcache   - bitcache data
+ * @param crc        - current CRC
+ *
+ * @return number of bytes read from 'src' + 'nbytes_dec'
+ *
+ * @pre (rice24_peek_zeros() >= nzeros)
+**/
+ALWAYS_INLINE size_t
+rice24_decode_zeros(
+	const uint8_t *const RESTRICT src, size_t nzeros, size_t nbytes_dec,
+	struct BitCache_Dec *const RESTRICT bitcache,
+	crc32_dec *const RESTRICT crc
+)
+/*@modifies	*bitcache,
+		*crc
+@*/
+{
+	cache32    *const RESTRICT cache = &bitcache->cache;
+	bitcnt_dec *const RESTRICT count = &bitcache->count;
+	/* * */
+	uint8_t inbyte;
+
+	assert(*count <= (bitcnt_dec) 7u);
+
+	if ( nzeros <= (size_t) *count ){
+		*cache >>= nzeros;
+		*count  -= (bitcnt_dec) nzeros;
+		return nbytes_dec;
+	}
+	nzeros -= (size_t) *count;
+
+	while ( nzeros >= (size_t) 8u ){
+		(void) rice24_crc32_dec(src[nbytes_dec++], crc);
+		nzeros -= 8u;
+	}
+	if ( nzeros != 0 ){
+		inbyte = rice24_crc32_dec(src[nbytes_dec++], crc);
+		*cache = ((cache32) inbyte) >> nzeros;
+		*count = (bitcnt_dec) (8u - nzeros);
+	}
+	else {	*cache = 0;
+		*count = 0;
+	}
+
+	assert(*count <= (bitcnt_dec) 7u);
+	return nbytes_dec;
+}
+
 /* ------------------------------------------------------------------------ */
 
 /**@fn rice24_read_unary
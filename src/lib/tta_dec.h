@@ -22,6 +22,7 @@
 #include "./rice24.h"
 #include "./tta.h"
 #include "./types.h"
+#include "./zerorun.h"
 
 /* //////////////////////////////////////////////////////////////////////// */
 
@@ -65,10 +66,18 @@
 
 /* @see TTAENC_PARAMCHECKS */
 
+/* nbytes_tta_target may be 0 once every byte of the frame has been read;
+     the last few samples can still be in the bitcache
+*/
 #define TTADEC_PARAMCHECK_0_INVAL_RANGE ( \
 	 (dest_len == 0) || (src_len == 0) \
 	|| \
-	 (ni32_target == 0) || (nbytes_tta_target == 0) \
+	 (ni32_target == 0) \
+	|| \
+	 ( (nbytes_tta_target == 0) \
+	  && \
+	   (user->nbytes_tta_total != nbytes_tta_perframe) \
+	 ) \
 	|| \
 	 (ni32_perframe == 0) || (nbytes_tta_perframe == 0) \
 	|| \
@@ -138,9 +147,12 @@
 	x_overflow_1 = add_usize_overflow( \
 		&user->nbytes_tta_total, user->nbytes_tta_total, nbytes_dec \
 	); \
+	/* reading the last byte does not end the frame; its last samples \
+	     may still be in the bitcache \
+	*/ \
 	if ( (user->ni32_total >= ni32_perframe) \
 	    || \
-	     (user->nbytes_tta_total >= nbytes_tta_perframe) \
+	     (user->nbytes_tta_total > nbytes_tta_perframe) \
 	){ \
 		user->crc       = CRC32_FINI(user->crc); \
 		if ( (user->ni32_total == ni32_perframe) \
@@ -193,6 +205,29 @@
 	codec[(x_chan)].prev = curr.i; \
 }
 
+/* @see TTAENC_ZERORUN */
+#ifndef LIBTTAr_OPT_DISABLE_ZERORUN
+#define TTADEC_ZERORUN(x_nchan) { \
+	size_t x_ni32, x_j; \
+	\
+	if UNLIKELY ( codec_isidle_dec(codec, (x_nchan)) != 0 ){ \
+		x_ni32 = rice24_peek_zeros( \
+			src, nbytes_dec, read_soft_limit, bitcache, \
+			ni32_target - i \
+		); \
+		x_ni32 = zerorun_ni32_bulk(x_ni32, ni32_target - i, (x_nchan)); \
+		nbytes_dec = rice24_decode_zeros( \
+			src, x_ni32, nbytes_dec, bitcache, &crc \
+		); \
+		for ( x_j = 0; x_j < x_ni32; ++x_j ){ \
+			dest[i++] = 0; \
+		} \
+	} \
+}
+#else
+#define TTADEC_ZERORUN(x_nchan)
+#endif	/* LIBTTAr_OPT_DISABLE_ZERORUN */
+
 /* curly braces were messing up the compiler */
 #define TTADEC_DECODE(x_chan) \
 	TTADEC_RICE(x_chan); \
@@ -22,6 +22,7 @@
 #include "./rice24.h"
 #include "./tta.h"
 #include "./types.h"
+#include "./zerorun.h"
 
 /* //////////////////////////////////////////////////////////////////////// */
 
@@ -178,6 +179,30 @@
 }
 #endif	/* NDEBUG */
 
+/* codes the start of a run of zero-groups in bulk. leaves the rest of the
+     run (ZERORUN_NTAIL groups) to the general path
+*/
+#ifndef LIBTTAr_OPT_DISABLE_ZERORUN
+#define TTAENC_ZERORUN(x_nchan) { \
+	size_t x_ni32; \
+	\
+	if UNLIKELY ( \
+	     (src[i] == 0) && (codec_isidle_enc(codec, (x_nchan)) != 0) \
+	){ \
+		x_ni32 = zerorun_ni32_enc( \
+			&src[i], ni32_target - i, (x_nchan), \
+			write_soft_limit - nbytes_enc \
+		); \
+		nbytes_enc = rice24_encode_zeros( \
+			dest, x_ni32, nbytes_enc, bitcache, &crc \
+		); \
+		i += x_ni32; \
+	} \
+}
+#else
+#define TTAENC_ZERORUN(x_nchan)
+#endif	/* LIBTTAr_OPT_DISABLE_ZERORUN */
+
 /* curly braces were messing up the compiler */
 #define TTAENC_ENCODE(x_chan) \
 	TTAENC_PREDICT(x_chan); \
@@ -21,28 +21,32 @@
 
 #undef priv
 ALWAYS_INLINE void state_priv_init_enc(
-	/*@out@*/ struct LibTTAr_CodecState_Priv *RESTRICT priv, unsigned int
+	/*@out@*/ struct LibTTAr_CodecState_Priv *RESTRICT priv, unsigned int,
+	enum LibTTAr_SampleBytes
 )
 /*@modifies	*priv@*/
 ;
 
 #undef priv
 ALWAYS_INLINE void state_priv_init_dec(
-	/*@out@*/ struct LibTTAr_CodecState_Priv *RESTRICT priv, unsigned int
+	/*@out@*/ struct LibTTAr_CodecState_Priv *RESTRICT priv, unsigned int,
+	enum LibTTAr_SampleBytes
 )
 /*@modifies	*priv@*/
 ;
 
 #undef codec
 ALWAYS_INLINE void codec_init_enc(
-	/*@out@*/ struct Codec *RESTRICT codec, unsigned int
+	/*@out@*/ struct Codec *RESTRICT codec, unsigned int,
+	enum LibTTAr_SampleBytes
 )
 /*@modifies	*codec@*/
 ;
 
 #undef codec
 ALWAYS_INLINE void codec_init_dec(
-	/*@out@*/ struct Codec *RESTRICT codec, unsigned int
+	/*@out@*/ struct Codec *RESTRICT codec, unsigned int,
+	enum LibTTAr_SampleBytes
 )
 /*@modifies	*codec@*/
 ;
@@ -52,18 +56,19 @@ ALWAYS_INLINE void codec_init_dec(
 /**@fn state_priv_init_enc
  * @brief initializes a private state struct; encode version
  *
- * @param priv  - private state struct
- * @param nchan - number of audio channels
+ * @param priv        - private state struct
+ * @param nchan       - number of audio channels
+ * @param samplebytes - number of bytes per PCM sample
 **/
 ALWAYS_INLINE void
 state_priv_init_enc(
 	/*@out@*/ struct LibTTAr_CodecState_Priv *const RESTRICT priv,
-	const unsigned int nchan
+	const unsigned int nchan, const enum LibTTAr_SampleBytes samplebytes
 )
 /*@modifies	*priv@*/
 {
 	MEMSET(&priv->bitcache, 0x00, sizeof priv->bitcache);
-	codec_init_enc((struct Codec *) &priv->codec, nchan);
+	codec_init_enc((struct Codec *) &priv->codec, nchan, samplebytes);
 
 	return;
 }
@@ -76,12 +81,12 @@ state_priv_init_enc(
 ALWAYS_INLINE void
 state_priv_init_dec(
 	/*@out@*/ struct LibTTAr_CodecState_Priv *const RESTRICT priv,
-	const unsigned int nchan
+	const unsigned int nchan, const enum LibTTAr_SampleBytes samplebytes
 )
 /*@modifies	*priv@*/
 {
 	MEMSET(&priv->bitcache, 0x00, sizeof priv->bitcache);
-	codec_init_dec((struct Codec *) &priv->codec, nchan);
+	codec_init_dec((struct Codec *) &priv->codec, nchan, samplebytes);
 
 	return;
 }
@@ -101,12 +106,14 @@ state_priv_init_dec(
 /**@fn codec_init_enc
  * @brief initializes an array of 'struct Codec'; encode version
  *
- * @param codec - struct array to initialize
- * @param nchan - number of audio channels
+ * @param codec       - struct array to initialize
+ * @param nchan       - number of audio channels
+ * @param samplebytes - number of bytes per PCM sample
 **/
 ALWAYS_INLINE void
 codec_init_enc(
-	/*@out@*/ struct Codec *const RESTRICT codec, const unsigned int nchan
+	/*@out@*/ struct Codec *const RESTRICT codec, const unsigned int nchan,
+	UNUSED const enum LibTTAr_SampleBytes samplebytes
 )
 /*@modifies	*codec@*/
 {
@@ -120,6 +127,11 @@ codec_init_enc(
 		MEMSET(&codec_a[i].filter, 0x00, sizeof codec_a[i].filter);
 		codec_a[i].rice.enc = RICE_INIT_ENC;
 		codec_a[i].prev     = 0;
+#ifdef USING_I16_FILTER
+		codec_a[i].filter.i16 = (int32_t) (
+			samplebytes != LIBTTAr_SAMPLEBYTES_3
+		);
+#endif	/* USING_I16_FILTER */
 	}
 	return;
 }
@@ -131,7 +143,8 @@ codec_init_enc(
 **/
 ALWAYS_INLINE void
 codec_init_dec(
-	/*@out@*/ struct Codec *const RESTRICT codec, const unsigned int nchan
+	/*@out@*/ struct Codec *const RESTRICT codec, const unsigned int nchan,
+	UNUSED const enum LibTTAr_SampleBytes samplebytes
 )
 /*@modifies	*codec@*/
 {
@@ -145,6 +158,11 @@ codec_init_dec(
 		MEMSET(&codec_a[i].filter, 0x00, sizeof codec_a[i].filter);
 		codec_a[i].rice.dec = RICE_INIT_DEC;
 		codec_a[i].prev     = 0;
+#ifdef USING_I16_FILTER
+		codec_a[i].filter.i16 = (int32_t) (
+			samplebytes != LIBTTAr_SAMPLEBYTES_3
+		);
+#endif	/* USING_I16_FILTER */
 	}
 	return;
 }
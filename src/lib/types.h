@@ -7,7 +7,7 @@
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
 // Copyright (C) 2007, Aleksander Djuric                                    //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 /////////////////////////////////////////////////////////////////////////// */
@@ -42,6 +42,12 @@ enum LibTTAr_SampleBytes {
 	); \
 }
 
+enum LibTTAr_Kernel {
+	LIBTTAr_KERNEL_DEFAULT	= 0u,
+	LIBTTAr_KERNEL_MCH	= 1u
+};
+#define LIBTTAr_KERNEL_MAX	((unsigned int) LIBTTAr_KERNEL_MCH)
+
 /* ======================================================================== */
 
 #ifndef LIBTTAr_OPT_FEWER_FAST_TYPES
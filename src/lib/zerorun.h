@@ -0,0 +1,188 @@
+#ifndef H_TTA_CODEC_ZERORUN_H
+#define H_TTA_CODEC_ZERORUN_H
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// codec/zerorun.h                                                          //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+/* digital silence: once every channel's filter has flushed its 'dl' history,
+     the error is zero, and rice.k[0] has bottomed out, a zero input encodes
+     to a single 0-bit and leaves the state unchanged except for 'dx'. so a
+     run of zeros can be coded in bulk. 'dx' only depends on the last few
+     'dl's, so the last ZERORUN_NTAIL groups of a run go through the general
+     path to bring it up to date
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "./common.h"
+#include "./types.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/* number of trailing zero-groups left to the general path */
+#define ZERORUN_NTAIL		8u
+
+/* (sum >> 4u) == 0, so rice24_update does not change the state */
+#define ZERORUN_RICE_SUM_LIMIT	UINT32_C(0x10)
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#undef codec
+PURE
+ALWAYS_INLINE int codec_isidle_enc(
+	const struct Codec *RESTRICT codec, unsigned int
+)
+/*@*/
+;
+
+#undef codec
+PURE
+ALWAYS_INLINE int codec_isidle_dec(
+	const struct Codec *RESTRICT codec, unsigned int
+)
+/*@*/
+;
+
+#undef src
+PURE
+ALWAYS_INLINE size_t zerorun_ni32_enc(
+	const int32_t *RESTRICT src, size_t, unsigned int, size_t
+)
+/*@*/
+;
+
+CONST
+ALWAYS_INLINE size_t zerorun_ni32_bulk(size_t, size_t, unsigned int) /*@*/;
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#define CODEC_ISIDLE_BODY(x_rice) { \
+	unsigned int x_i, x_j; \
+	\
+	for ( x_i = 0; x_i < nchan; ++x_i ){ \
+		if ( (codec[x_i].rice.x_rice.k[0u] != 0) \
+		    || \
+		     (codec[x_i].rice.x_rice.sum[0u] \
+		      >= \
+		      ZERORUN_RICE_SUM_LIMIT \
+		     ) \
+		    || \
+		     (codec[x_i].prev != 0) || (codec[x_i].filter.error != 0) \
+		){ \
+			return 0; \
+		} \
+		for ( x_j = 0; x_j < 8u; ++x_j ){ \
+			if ( codec[x_i].filter.dl[x_j] != 0 ){ \
+				return 0; \
+			} \
+		} \
+	} \
+	return 1; \
+}
+
+/**@fn codec_isidle_enc
+ * @brief checks if a zero input would leave the codec state unchanged
+ *   (besides 'dx'); encode version
+ *
+ * @param codec - codec struct array
+ * @param nchan - number of audio channels
+ *
+ * @return nonzero if idle
+**/
+PURE
+ALWAYS_INLINE int
+codec_isidle_enc(
+	const struct Codec *const RESTRICT codec, const unsigned int nchan
+)
+/*@*/
+{
+	CODEC_ISIDLE_BODY(enc);
+}
+
+/**@fn codec_isidle_dec
+ * @brief checks if a zero input would leave the codec state unchanged
+ *   (besides 'dx'); decode version
+ *
+ * @see codec_isidle_enc()
+**/
+PURE
+ALWAYS_INLINE int
+codec_isidle_dec(
+	const struct Codec *const RESTRICT codec, const unsigned int nchan
+)
+/*@*/
+{
+	CODEC_ISIDLE_BODY(dec);
+}
+
+/* ------------------------------------------------------------------------ */
+
+/**@fn zerorun_ni32_enc
+ * @brief number of i32 the encoder can code in bulk
+ *
+ * @param src          - source buffer at the current index
+ * @param ni32_avail   - number of i32 left in 'src' (multiple of 'nchan')
+ * @param nchan        - number of audio channels
+ * @param nbytes_avail - number of bytes before the write soft limit
+ *
+ * @return number of i32 to code in bulk (multiple of 'nchan')
+**/
+PURE
+ALWAYS_INLINE size_t
+zerorun_ni32_enc(
+	const int32_t *const RESTRICT src, size_t ni32_avail,
+	const unsigned int nchan, const size_t nbytes_avail
+)
+/*@*/
+{
+	size_t i;
+
+	/* one bit per i32, and the bitcache can hold up to 8 bytes */
+	if ( nbytes_avail <= (size_t) 8u ){
+		return 0;
+	}
+	if ( ni32_avail / 8u >= nbytes_avail - 8u ){
+		ni32_avail = (nbytes_avail - 8u) * 8u;
+	}
+
+	for ( i = 0; (i < ni32_avail) && (src[i] == 0); ++i ){;}
+
+	return zerorun_ni32_bulk(i, ni32_avail, nchan);
+}
+
+/**@fn zerorun_ni32_bulk
+ * @brief number of i32 in a run of zeros that can be coded in bulk
+ *
+ * @param nzeros     - number of zero i32/codes in the run
+ * @param ni32_avail - number of i32 left to code
+ * @param nchan      - number of audio channels
+ *
+ * @return number of i32 to code in bulk (multiple of 'nchan')
+**/
+CONST
+ALWAYS_INLINE size_t
+zerorun_ni32_bulk(
+	size_t nzeros, const size_t ni32_avail, const unsigned int nchan
+)
+/*@*/
+{
+	const size_t ntail = (size_t) (ZERORUN_NTAIL * nchan);
+
+	if ( nzeros > ni32_avail ){
+		nzeros = ni32_avail;
+	}
+	nzeros -= nzeros % nchan;
+
+	return (nzeros > ntail ? nzeros - ntail : 0);
+}
+
+/* EOF //////////////////////////////////////////////////////////////////// */
+#endif	/* H_TTA_CODEC_ZERORUN_H */
@@ -7,7 +7,7 @@
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
 // Copyright (C) 2007, Aleksander Djuric                                    //
-// Copyright (C) 2023-2025, Shane Seelig                                    //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
 // SPDX-License-Identifier: GPL-3.0-or-later                                //
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
@@ -103,6 +103,18 @@ enum LibTTAr_SampleBytes {
 #define LIBTTAr_SAMPLEBYTES_MAX		  3u
 #define LIBTTAr_SAMPLEBITS_MAX		 24u
 
+/* which codec loop to use; runtime alternative to the UNROLLED opts. only
+     these two can be picked at runtime: FEWER_FAST_TYPES and the SIMD
+     filter/rice variants are still fixed when the library is built, and
+     there is no libttaR_autotune(); ttaR's --autotune only chooses
+     between these
+*/
+enum LibTTAr_Kernel {
+	LIBTTAr_KERNEL_DEFAULT		= 0u,
+	LIBTTAr_KERNEL_MCH		= 1u
+};
+#define LIBTTAr_KERNEL_MAX		  1u
+
 /* //////////////////////////////////////////////////////////////////////// */
 
 struct LibTTAr_CodecState_Priv;
@@ -169,6 +181,9 @@ struct LibTTAr_VersionInfo {
 /*@unchecked@*/ /*@unused@*/
 extern const struct LibTTAr_VersionInfo libttaR_info;
 
+/*@unchecked@*/ /*@unused@*/ /*@observer@*/
+extern const char *const libttaR_buildinfo;
+
 /* //////////////////////////////////////////////////////////////////////// */
 
 #undef dest
@@ -195,6 +210,32 @@ extern enum LibTTAr_EncRetVal libttaR_tta_encode(
 @*/
 ;
 
+#undef dest
+#undef src
+#undef priv
+#undef user
+#undef misc
+#undef kernel
+/*@external@*/ /*@unused@*/
+extern enum LibTTAr_EncRetVal libttaR_tta_encode_kernel(
+	/*@reldef@*/
+	uint8_t *X_LIBTTAr_RESTRICT dest,
+	/*@in@*/
+	const int32_t *X_LIBTTAr_RESTRICT src,
+	/*@reldef@*/
+	struct LibTTAr_CodecState_Priv *X_LIBTTAr_RESTRICT priv,
+	/*@in@*/
+	struct LibTTAr_CodecState_User *X_LIBTTAr_RESTRICT user,
+	/*@in@*/
+	const struct LibTTAr_EncMisc *X_LIBTTAr_RESTRICT misc,
+	enum LibTTAr_Kernel kernel
+)
+/*@modifies	*dest,
+		*priv,
+		*user
+@*/
+;
+
 #undef dest
 #undef src
 #undef priv
@@ -219,6 +260,32 @@ extern enum LibTTAr_DecRetVal libttaR_tta_decode(
 @*/
 ;
 
+#undef dest
+#undef src
+#undef priv
+#undef user
+#undef misc
+#undef kernel
+/*@external@*/ /*@unused@*/
+extern enum LibTTAr_DecRetVal libttaR_tta_decode_kernel(
+	/*@reldef@*/
+	int32_t *X_LIBTTAr_RESTRICT dest,
+	/*@in@*/
+	const uint8_t *X_LIBTTAr_RESTRICT src,
+	/*@reldef@*/
+	struct LibTTAr_CodecState_Priv *X_LIBTTAr_RESTRICT priv,
+	/*@in@*/
+	struct LibTTAr_CodecState_User *X_LIBTTAr_RESTRICT user,
+	/*@in@*/
+	const struct LibTTAr_DecMisc *X_LIBTTAr_RESTRICT misc,
+	enum LibTTAr_Kernel kernel
+)
+/*@modifies	*dest,
+		*priv,
+		*user
+@*/
+;
+
 /* ------------------------------------------------------------------------ */
 
 #undef dest
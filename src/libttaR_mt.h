@@ -0,0 +1,141 @@
+#ifndef H_LIBTTAr_MT_H
+#define H_LIBTTAr_MT_H
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// libttaR_mt.h - 0.1                                                       //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//      Multi-threaded frame coder; a companion to libttaR. Unlike the      //
+// core library, it needs libc and pthreads. For usage information, read   //
+// the manpage libttaR_mt(3).                                               //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "./libttaR.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#if __STDC_VERSION__ >= 199901L
+#define X_LIBTTAr_MT_RESTRICT		restrict
+#elif defined(__GNUC__)
+#define X_LIBTTAr_MT_RESTRICT		__restrict__
+#else
+#define X_LIBTTAr_MT_RESTRICT
+#endif	/* X_LIBTTAr_MT_RESTRICT */
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+enum LibTTAr_MT_RetVal {
+	LIBTTAr_MT_OK			=  0,
+	LIBTTAr_MT_ERR_INVAL		= -1,
+	LIBTTAr_MT_ERR_ALLOC		= -2,
+	LIBTTAr_MT_ERR_THREAD		= -3,
+	LIBTTAr_MT_ERR_CALLBACK		= -4
+};
+
+enum LibTTAr_MT_Mode {
+	LIBTTAr_MT_ENCODE		= 0u,
+	LIBTTAr_MT_DECODE		= 1u
+};
+
+enum LibTTAr_MT_FrameStatus {
+	LIBTTAr_MT_FRAME_OK		= 0u,
+	LIBTTAr_MT_FRAME_BADCRC		= 1u,	/* decode only */
+	LIBTTAr_MT_FRAME_FAIL		= 2u
+};
+
+/* ------------------------------------------------------------------------ */
+
+struct LibTTAr_MT;
+
+/* ------------------------------------------------------------------------ */
+
+struct LibTTAr_MT_Config {
+	enum LibTTAr_MT_Mode		mode;
+	unsigned int			nthreads;	/* 0: nprocessors  */
+	unsigned int			queue_len;	/* 0: 2 * nthreads */
+	size_t				nsamples_perframe;
+	enum LibTTAr_SampleBytes	samplebytes;
+	unsigned int			nchan;
+	enum LibTTAr_Kernel		kernel;
+};
+
+struct LibTTAr_MT_Frame {
+	size_t				idx;
+	/*@observer@*/
+	const void			*data;	/* enc: TTA + CRC, dec: PCM */
+	size_t				len;
+	size_t				nsamples;
+	enum LibTTAr_MT_FrameStatus	status;
+};
+
+/* nonzero return stops the submit/flush that called it */
+typedef int (*LibTTAr_MT_Callback)(
+	/*@null@*/ void *udata, const struct LibTTAr_MT_Frame *frame
+);
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#undef mt_out
+#undef config
+#undef callback
+#undef udata
+/*@external@*/ /*@unused@*/
+extern enum LibTTAr_MT_RetVal libttaR_mt_create(
+	/*@out@*/
+	struct LibTTAr_MT **X_LIBTTAr_MT_RESTRICT mt_out,
+	const struct LibTTAr_MT_Config *X_LIBTTAr_MT_RESTRICT config,
+	LibTTAr_MT_Callback callback,
+	/*@null@*/
+	void *udata
+)
+/*@modifies	*mt_out@*/
+;
+
+#undef mt
+#undef buf
+#undef len
+#undef nsamples
+/*@external@*/ /*@unused@*/
+extern enum LibTTAr_MT_RetVal libttaR_mt_submit(
+	struct LibTTAr_MT *X_LIBTTAr_MT_RESTRICT mt,
+	/*@in@*/
+	const void *X_LIBTTAr_MT_RESTRICT buf,
+	size_t len,
+	size_t nsamples
+)
+/*@modifies	*mt@*/
+;
+
+#undef mt
+/*@external@*/ /*@unused@*/
+extern enum LibTTAr_MT_RetVal libttaR_mt_flush(
+	struct LibTTAr_MT *X_LIBTTAr_MT_RESTRICT mt
+)
+/*@modifies	*mt@*/
+;
+
+#undef mt
+/*@external@*/ /*@unused@*/
+extern void libttaR_mt_destroy(
+	/*@only@*/ /*@null@*/
+	struct LibTTAr_MT *X_LIBTTAr_MT_RESTRICT mt
+)
+/*@modifies	*mt@*/
+;
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#undef X_LIBTTAr_MT_RESTRICT
+
+/* EOF //////////////////////////////////////////////////////////////////// */
+#endif	/* H_LIBTTAr_MT_H */
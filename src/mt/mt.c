@@ -0,0 +1,508 @@
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// mt/mt.c                                                                  //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../libttaR.h"
+#include "../libttaR_mt.h"
+
+#include <unistd.h>
+
+#include "../cli/common.h"
+#include "../cli/modes/atomic.h"
+#include "../cli/modes/threads.posix.h"
+
+#include "./mt.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#undef mt
+static enum LibTTAr_MT_RetVal mt_alloc(struct LibTTAr_MT *RESTRICT mt)
+/*@modifies	*mt@*/
+;
+
+#undef mt
+static void mt_free(/*@only@*/ struct LibTTAr_MT *RESTRICT mt)
+/*@modifies	*mt@*/
+;
+
+#undef mt
+static enum LibTTAr_MT_RetVal mt_deliver(struct LibTTAr_MT *RESTRICT mt)
+/*@modifies	*mt@*/
+;
+
+#undef mt
+static void mt_slot_quit(struct LibTTAr_MT *RESTRICT mt)
+/*@modifies	*mt@*/
+;
+
+/*@null@*/
+static start_routine_ret mt_worker(void *)
+/*@modifies	internalState@*/
+;
+
+static unsigned int mt_nprocessors(void)
+/*@globals	internalState@*/
+;
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/**@fn libttaR_mt_create
+ * @brief creates a multi-threaded frame coder and starts its workers
+ *
+ * @param mt_out   - the created coder
+ * @param config   - coder settings
+ * @param callback - called with each coded frame, in order
+ * @param udata    - passed to 'callback'
+ *
+ * @return LIBTTAr_MT_OK on success
+ *
+ * @note read the manpage for more info
+**/
+BUILD_EXPORT
+enum LibTTAr_MT_RetVal
+libttaR_mt_create(
+	/*@out@*/ struct LibTTAr_MT **const RESTRICT mt_out,
+	const struct LibTTAr_MT_Config *const RESTRICT config,
+	const LibTTAr_MT_Callback callback, /*@null@*/ void *const udata
+)
+/*@modifies	*mt_out@*/
+{
+	struct LibTTAr_MT *mt;
+	enum LibTTAr_MT_RetVal retval;
+
+	*mt_out = NULL;
+
+	/* check the config */
+	if UNLIKELY (
+	     (callback == NULL)
+	    ||
+	     (((unsigned int) config->mode) > LIBTTAr_MT_DECODE)
+	    ||
+	     (((unsigned int) config->samplebytes) == 0)
+	    ||
+	     (((unsigned int) config->samplebytes) > LIBTTAr_SAMPLEBYTES_MAX)
+	    ||
+	     (((unsigned int) config->kernel) > LIBTTAr_KERNEL_MAX)
+	    ||
+	     (libttaR_test_nchan(config->nchan) == 0)
+	    ||
+	     (config->nsamples_perframe == 0)
+	    ||
+	     (config->nsamples_perframe > SIZE_MAX / config->nchan)
+	){
+		return LIBTTAr_MT_ERR_INVAL;
+	}
+
+	mt = calloc((size_t) 1u, sizeof *mt);
+	if UNLIKELY ( mt == NULL ){
+		return LIBTTAr_MT_ERR_ALLOC;
+	}
+	mt->config        = *config;
+	mt->callback      = callback;
+	mt->udata         = udata;
+	mt->ni32_perframe = config->nsamples_perframe * config->nchan;
+	mt->safety_margin = libttaR_ttabuf_safety_margin(
+		config->samplebytes, config->nchan
+	);
+	mt->nworkers      = (config->nthreads != 0
+		? config->nthreads : mt_nprocessors()
+	);
+	mt->nslots        = (config->queue_len != 0
+		? config->queue_len : QUEUE_LEN_DEFAULT(mt->nworkers)
+	);
+	if UNLIKELY ( mt->safety_margin == 0 ){
+		free(mt);
+		return LIBTTAr_MT_ERR_INVAL;
+	}
+
+	retval = mt_alloc(mt);
+	if UNLIKELY ( retval != LIBTTAr_MT_OK ){
+		mt_free(mt);
+		return retval;
+	}
+
+	/* start the workers; counted so that libttaR_mt_destroy() knows how
+	     many to stop
+	*/
+	for ( ; mt->nthreads < mt->nworkers; ++mt->nthreads ){
+		if UNLIKELY ( thread_create_nf(
+			&mt->worker[mt->nthreads].thread, mt_worker,
+			&mt->worker[mt->nthreads]
+		) != 0 ){
+			libttaR_mt_destroy(mt);
+			return LIBTTAr_MT_ERR_THREAD;
+		}
+	}
+
+	*mt_out = mt;
+	return LIBTTAr_MT_OK;
+}
+
+/**@fn libttaR_mt_submit
+ * @brief queues a frame for coding
+ *
+ * @param mt       - the coder
+ * @param buf      - enc: PCM, dec: TTA frame with its CRC
+ * @param len      - length of 'buf' in bytes
+ * @param nsamples - number of samples per channel in the frame
+ *
+ * @return LIBTTAr_MT_OK on success
+ *
+ * @note blocks while the queue is full, delivering the oldest frame
+ * @note read the manpage for more info
+**/
+BUILD_EXPORT
+enum LibTTAr_MT_RetVal
+libttaR_mt_submit(
+	struct LibTTAr_MT *const RESTRICT mt, const void *const RESTRICT buf,
+	const size_t len, const size_t nsamples
+)
+/*@modifies	*mt@*/
+{
+	struct MT_Slot *const slot = &mt->slot[mt->idx_submit % mt->nslots];
+	enum LibTTAr_MT_RetVal retval;
+
+	if UNLIKELY (
+	     (nsamples == 0) || (nsamples > mt->config.nsamples_perframe)
+	){
+		return LIBTTAr_MT_ERR_INVAL;
+	}
+
+	/* the slot is still holding the oldest frame */
+	if ( slot->busy ){
+		assert(mt->idx_deliver + mt->nslots == mt->idx_submit);
+		retval = mt_deliver(mt);
+		if UNLIKELY ( retval != LIBTTAr_MT_OK ){
+			return retval;
+		}
+	}
+
+	retval = (mt->config.mode == LIBTTAr_MT_ENCODE
+		? mt_slot_fill_enc(mt, slot, buf, len, nsamples)
+		: mt_slot_fill_dec(mt, slot, buf, len, nsamples)
+	);
+	if UNLIKELY ( retval != LIBTTAr_MT_OK ){
+		return retval;
+	}
+	slot->idx      = mt->idx_submit++;
+	slot->nsamples = nsamples;
+	slot->busy     = true;
+
+	waitvar_set(&slot->seq, SLOT_SEQ_READY(slot->idx));
+	return LIBTTAr_MT_OK;
+}
+
+/**@fn libttaR_mt_flush
+ * @brief waits for and delivers every queued frame
+ *
+ * @param mt - the coder
+ *
+ * @return LIBTTAr_MT_OK on success
+**/
+BUILD_EXPORT
+enum LibTTAr_MT_RetVal
+libttaR_mt_flush(struct LibTTAr_MT *const RESTRICT mt)
+/*@modifies	*mt@*/
+{
+	enum LibTTAr_MT_RetVal retval;
+
+	while ( mt->idx_deliver != mt->idx_submit ){
+		retval = mt_deliver(mt);
+		if UNLIKELY ( retval != LIBTTAr_MT_OK ){
+			return retval;
+		}
+	}
+	return LIBTTAr_MT_OK;
+}
+
+/**@fn libttaR_mt_destroy
+ * @brief stops the workers and frees the coder
+ *
+ * @param mt - the coder
+ *
+ * @note undelivered frames are dropped; call libttaR_mt_flush() first
+**/
+BUILD_EXPORT
+void
+libttaR_mt_destroy(/*@only@*/ /*@null@*/ struct LibTTAr_MT *const RESTRICT mt)
+/*@modifies	*mt@*/
+{
+	unsigned int i;
+
+	if ( mt == NULL ){
+		return;
+	}
+
+	/* the workers take tickets in order, so each one codes whatever is
+	     still queued, and then takes one of these and quits
+	*/
+	for ( i = 0; i < mt->nthreads; ++i ){
+		mt_slot_quit(mt);
+	}
+	for ( i = 0; i < mt->nthreads; ++i ){
+		thread_join(&mt->worker[i].thread);
+	}
+
+	mt_free(mt);
+	return;
+}
+
+/* ======================================================================== */
+
+/**@fn mt_alloc
+ * @brief allocates the slots and workers, and inits the sync objects
+ *
+ * @param mt - the coder
+ *
+ * @return LIBTTAr_MT_OK on success
+ *
+ * @note on failure, mt_free() cleans up whatever was done
+**/
+static enum LibTTAr_MT_RetVal
+mt_alloc(struct LibTTAr_MT *const RESTRICT mt)
+/*@modifies	*mt@*/
+{
+	const size_t pcmbuf_len  = (
+		mt->ni32_perframe * (size_t) mt->config.samplebytes
+	);
+	const size_t priv_size   = libttaR_codecstate_priv_size(
+		mt->config.nchan
+	);
+	const unsigned int nspin = WAITVAR_NSPIN(
+		mt->nworkers + 1u, mt_nprocessors()
+	);
+	/* * */
+	struct MT_Slot *slot;
+	struct MT_Worker *worker;
+	uintptr_t align;
+	unsigned int i;
+
+	if UNLIKELY ( priv_size == 0 ){
+		return LIBTTAr_MT_ERR_INVAL;
+	}
+
+	/* the slots' waitvars are counted so that mt_free() knows how many
+	     to destroy
+	*/
+	mt->slot = calloc((size_t) mt->nslots, sizeof *mt->slot);
+	if UNLIKELY ( mt->slot == NULL ){
+		return LIBTTAr_MT_ERR_ALLOC;
+	}
+	for ( ; mt->nslots_init < mt->nslots; ++mt->nslots_init ){
+		if UNLIKELY ( waitvar_init_nf(
+			&mt->slot[mt->nslots_init].seq, 0, nspin
+		) != 0 ){
+			return LIBTTAr_MT_ERR_THREAD;
+		}
+	}
+
+	mt->worker = calloc((size_t) mt->nworkers, sizeof *mt->worker);
+	if UNLIKELY ( mt->worker == NULL ){
+		return LIBTTAr_MT_ERR_ALLOC;
+	}
+
+	/* buffers */
+	for ( i = 0; i < mt->nslots; ++i ){
+		slot             = &mt->slot[i];
+		slot->ttabuf_len = pcmbuf_len + mt->safety_margin;
+		slot->pcmbuf     = malloc(pcmbuf_len);
+		slot->ttabuf     = malloc(slot->ttabuf_len);
+		if UNLIKELY (
+		     (slot->pcmbuf == NULL) || (slot->ttabuf == NULL)
+		){
+			return LIBTTAr_MT_ERR_ALLOC;
+		}
+	}
+	for ( i = 0; i < mt->nworkers; ++i ){
+		worker             = &mt->worker[i];
+		worker->mt         = mt;
+		worker->i32buf     = malloc(
+			mt->ni32_perframe * sizeof *worker->i32buf
+		);
+		worker->priv_alloc = malloc(
+			priv_size + LIBTTAr_CODECSTATE_PRIV_ALIGN
+		);
+		if UNLIKELY (
+		     (worker->i32buf == NULL) || (worker->priv_alloc == NULL)
+		){
+			return LIBTTAr_MT_ERR_ALLOC;
+		}
+		align = (uintptr_t) worker->priv_alloc;
+		align = (
+			(LIBTTAr_CODECSTATE_PRIV_ALIGN
+			 - (align % LIBTTAr_CODECSTATE_PRIV_ALIGN)
+			) % LIBTTAr_CODECSTATE_PRIV_ALIGN
+		);
+		worker->priv = (struct LibTTAr_CodecState_Priv *) (
+			&((uint8_t *) worker->priv_alloc)[align]
+		);
+	}
+	return LIBTTAr_MT_OK;
+}
+
+/**@fn mt_free
+ * @brief frees the coder; the workers must have already been joined
+ *
+ * @param mt - the coder
+ *
+ * @note safe on a partly done mt_alloc(); the callocs zeroed the rest
+**/
+static void
+mt_free(/*@only@*/ struct LibTTAr_MT *const RESTRICT mt)
+/*@modifies	*mt@*/
+{
+	unsigned int i;
+
+	if ( mt->worker != NULL ){
+		for ( i = 0; i < mt->nworkers; ++i ){
+			free(mt->worker[i].priv_alloc);
+			free(mt->worker[i].i32buf);
+		}
+		free(mt->worker);
+	}
+	if ( mt->slot != NULL ){
+		for ( i = 0; i < mt->nslots_init; ++i ){
+			waitvar_destroy(&mt->slot[i].seq);
+		}
+		for ( i = 0; i < mt->nslots; ++i ){
+			free(mt->slot[i].ttabuf);
+			free(mt->slot[i].pcmbuf);
+		}
+		free(mt->slot);
+	}
+	free(mt);
+	return;
+}
+
+/* ------------------------------------------------------------------------ */
+
+/**@fn mt_deliver
+ * @brief waits for the oldest queued frame, and passes it to the callback
+ *
+ * @param mt - the coder
+ *
+ * @return LIBTTAr_MT_OK, or LIBTTAr_MT_ERR_CALLBACK
+**/
+static enum LibTTAr_MT_RetVal
+mt_deliver(struct LibTTAr_MT *const RESTRICT mt)
+/*@modifies	*mt@*/
+{
+	struct MT_Slot *const slot = &mt->slot[mt->idx_deliver % mt->nslots];
+	struct LibTTAr_MT_Frame frame;
+	int result;
+
+	assert(slot->busy);
+
+	waitvar_wait(&slot->seq, SLOT_SEQ_DONE(slot->idx));
+
+	frame.idx      = slot->idx;
+	frame.data     = (mt->config.mode == LIBTTAr_MT_ENCODE
+		? (const void *) slot->ttabuf : (const void *) slot->pcmbuf
+	);
+	frame.len      = slot->data_len;
+	frame.nsamples = slot->nsamples;
+	frame.status   = slot->status;
+
+	slot->busy        = false;
+	mt->idx_deliver  += 1u;
+
+	result = mt->callback(mt->udata, &frame);
+	return (result == 0 ? LIBTTAr_MT_OK : LIBTTAr_MT_ERR_CALLBACK);
+}
+
+/* ------------------------------------------------------------------------ */
+
+/**@fn mt_slot_quit
+ * @brief queues a slot that tells the worker that takes it to quit
+ *
+ * @param mt - the coder
+ *
+ * @note undelivered frames are dropped, but they may still be coding
+**/
+static void
+mt_slot_quit(struct LibTTAr_MT *const RESTRICT mt)
+/*@modifies	*mt@*/
+{
+	struct MT_Slot *const slot = &mt->slot[mt->idx_submit % mt->nslots];
+
+	if ( slot->busy ){
+		waitvar_wait(&slot->seq, SLOT_SEQ_DONE(slot->idx));
+	}
+	slot->idx      = mt->idx_submit++;
+	slot->nsamples = 0;
+	slot->busy     = true;
+
+	waitvar_set(&slot->seq, SLOT_SEQ_READY(slot->idx));
+	return;
+}
+
+/* ------------------------------------------------------------------------ */
+
+/**@fn mt_worker
+ * @brief worker thread; codes queued frames until told to quit
+ *
+ * @param arg - worker struct
+ *
+ * @return NULL
+**/
+/*@null@*/
+static start_routine_ret
+mt_worker(void *const arg)
+/*@modifies	internalState@*/
+{
+	struct MT_Worker *const RESTRICT worker = arg;
+	struct LibTTAr_MT *const mt = worker->mt;
+	/* * */
+	struct MT_Slot *slot;
+	size_t ticket;
+
+	for (;;){
+		ticket = atomic_fetch_inc_z(&mt->idx_work);
+		slot   = &mt->slot[ticket % mt->nslots];
+		waitvar_wait(&slot->seq, SLOT_SEQ_READY(ticket));
+
+		if UNLIKELY ( slot->nsamples == 0 ){
+			waitvar_set(&slot->seq, SLOT_SEQ_DONE(ticket));
+			break;
+		}
+		if ( mt->config.mode == LIBTTAr_MT_ENCODE ){
+			mt_slot_encode(worker, slot);
+		}
+		else {	mt_slot_decode(worker, slot); }
+
+		waitvar_set(&slot->seq, SLOT_SEQ_DONE(ticket));
+	}
+	return NULL;
+}
+
+/* ------------------------------------------------------------------------ */
+
+/**@fn mt_nprocessors
+ * @brief number of online processors
+ *
+ * @return the number of online processors, at least 1
+**/
+static unsigned int
+mt_nprocessors(void)
+/*@globals	internalState@*/
+{
+	const long nproc = sysconf(_SC_NPROCESSORS_ONLN);
+
+	return (unsigned int) (nproc > 0 ? nproc : 1);
+}
+
+/* EOF //////////////////////////////////////////////////////////////////// */
@@ -0,0 +1,142 @@
+#ifndef H_TTA_MT_MT_H
+#define H_TTA_MT_MT_H
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// mt/mt.h                                                                  //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//      same pipeline as the CLI's: a ring of frame slots, each with a      //
+// waitvar sequence number, and an atomic ticket counter for the workers.   //
+// the thread calling submit/flush is the I/O thread; it delivers frames    //
+// in order as it needs their slots back. the threading code is the CLI's   //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../libttaR.h"
+#include "../libttaR_mt.h"
+
+#include "../cli/common.h"
+#include "../cli/modes/atomic.h"
+#include "../cli/modes/threads.posix.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/* same default as the CLI's FRAMEQUEUE_LEN */
+#define QUEUE_LEN_DEFAULT(x_nthreads)	(2u * ((unsigned int) (x_nthreads)))
+
+#define FRAME_CRC_SIZE			((size_t) 4u)
+
+/* ticket t lives in slot (t % nslots). the slot's seq is READY(t) once the
+     I/O thread has filled it, and DONE(t) once a worker has coded it. a
+     slot with no samples tells the worker that takes it to quit
+*/
+#define SLOT_SEQ_READY(x_ticket)	((uint32_t) (2u * (x_ticket) + 1u))
+#define SLOT_SEQ_DONE(x_ticket)		((uint32_t) (2u * (x_ticket) + 2u))
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+struct MT_Slot {
+	waitvar_p			seq;
+	size_t				idx;
+	size_t				nsamples;
+	size_t				data_len;	/* output */
+	size_t				nbytes_tta;	/* dec input */
+	size_t				ttabuf_len;
+	/*@only@*/
+	uint8_t				*pcmbuf;
+	/*@only@*/
+	uint8_t				*ttabuf;
+	enum LibTTAr_MT_FrameStatus	status;
+	bool				busy;
+};
+
+struct MT_Worker {
+	/*@dependent@*/
+	struct LibTTAr_MT			*mt;
+	/*@dependent@*/
+	struct LibTTAr_CodecState_Priv		*priv;
+	/*@only@*/
+	void					*priv_alloc;
+	/*@only@*/
+	int32_t					*i32buf;
+	thread_p				thread;
+};
+
+struct LibTTAr_MT {
+	struct LibTTAr_MT_Config	config;
+	LibTTAr_MT_Callback		callback;
+	/*@null@*/ /*@dependent@*/
+	void				*udata;
+	size_t				ni32_perframe;
+	size_t				safety_margin;
+	unsigned int			nslots;
+	unsigned int			nslots_init;	/* seq */
+	unsigned int			nworkers;
+	unsigned int			nthreads;	/* started */
+	/*@only@*/
+	struct MT_Slot			*slot;
+	/*@only@*/
+	struct MT_Worker		*worker;
+
+	/* I/O thread only */
+	size_t				idx_submit;
+	size_t				idx_deliver;
+
+	/* workers */
+	size_t				idx_work;	/* atomic */
+};
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+#undef slot
+BUILD_EXTERN enum LibTTAr_MT_RetVal mt_slot_fill_enc(
+	const struct LibTTAr_MT *RESTRICT, struct MT_Slot *RESTRICT slot,
+	const void *RESTRICT, size_t, size_t
+)
+/*@modifies	*slot@*/
+;
+
+#undef slot
+BUILD_EXTERN enum LibTTAr_MT_RetVal mt_slot_fill_dec(
+	const struct LibTTAr_MT *RESTRICT, struct MT_Slot *RESTRICT slot,
+	const void *RESTRICT, size_t, size_t
+)
+/*@modifies	*slot@*/
+;
+
+/* ------------------------------------------------------------------------ */
+
+#undef worker
+#undef slot
+HOT
+BUILD_EXTERN void mt_slot_encode(
+	struct MT_Worker *RESTRICT worker, struct MT_Slot *RESTRICT slot
+)
+/*@modifies	*worker,
+		*slot
+@*/
+;
+
+#undef worker
+#undef slot
+HOT
+BUILD_EXTERN void mt_slot_decode(
+	struct MT_Worker *RESTRICT worker, struct MT_Slot *RESTRICT slot
+)
+/*@modifies	*worker,
+		*slot
+@*/
+;
+
+/* EOF //////////////////////////////////////////////////////////////////// */
+#endif	/* H_TTA_MT_MT_H */
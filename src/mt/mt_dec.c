@@ -0,0 +1,151 @@
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// mt/mt_dec.c                                                              //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../libttaR.h"
+#include "../libttaR_mt.h"
+
+#include "../cli/common.h"
+#include "./mt.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/**@fn mt_slot_fill_dec
+ * @brief copies a TTA frame, with its CRC, into a slot
+ *
+ * @param mt       - the coder
+ * @param slot     - the slot
+ * @param buf      - TTA frame
+ * @param len      - length of 'buf' in bytes
+ * @param nsamples - number of samples per channel in the frame
+ *
+ * @return LIBTTAr_MT_OK on success
+ *
+ * @note the slot's ttabuf is grown to fit the frame and the safety margin
+**/
+BUILD enum LibTTAr_MT_RetVal
+mt_slot_fill_dec(
+	const struct LibTTAr_MT *const RESTRICT mt,
+	struct MT_Slot *const RESTRICT slot, const void *const RESTRICT buf,
+	const size_t len, UNUSED const size_t nsamples
+)
+/*@modifies	*slot@*/
+{
+	uint8_t *ttabuf;
+	size_t ttabuf_len;
+
+	if UNLIKELY (
+	     (len <= FRAME_CRC_SIZE) || (len > SIZE_MAX - mt->safety_margin)
+	){
+		return LIBTTAr_MT_ERR_INVAL;
+	}
+
+	ttabuf_len = len + mt->safety_margin;
+	if ( ttabuf_len > slot->ttabuf_len ){
+		ttabuf = realloc(slot->ttabuf, ttabuf_len);
+		if UNLIKELY ( ttabuf == NULL ){
+			return LIBTTAr_MT_ERR_ALLOC;
+		}
+		slot->ttabuf     = ttabuf;
+		slot->ttabuf_len = ttabuf_len;
+	}
+	memcpy(slot->ttabuf, buf, len);
+	slot->nbytes_tta = len - FRAME_CRC_SIZE;
+	return LIBTTAr_MT_OK;
+}
+
+/* ======================================================================== */
+
+/**@fn mt_slot_decode
+ * @brief decodes a slot's TTA frame to PCM, and checks the frame CRC
+ *
+ * @param worker - the worker
+ * @param slot   - the slot
+ *
+ * @note a frame that fails to decode is zero-padded to its full length
+**/
+HOT
+BUILD void
+mt_slot_decode(
+	struct MT_Worker *const RESTRICT worker,
+	struct MT_Slot *const RESTRICT slot
+)
+/*@modifies	*worker,
+		*slot
+@*/
+{
+	const struct LibTTAr_MT *const mt = worker->mt;
+	const size_t ni32 = slot->nsamples * mt->config.nchan;
+	const uint8_t *const crcbuf = &slot->ttabuf[slot->nbytes_tta];
+	/* * */
+	enum LibTTAr_DecRetVal status;
+	struct LibTTAr_CodecState_User user = LIBTTAr_CODECSTATE_USER_INIT;
+	struct LibTTAr_DecMisc misc;
+	uint32_t crc_read;
+	UNUSED union {	size_t z; } result;
+
+	crc_read = (
+		  ((uint32_t) crcbuf[0u])
+		| (((uint32_t) crcbuf[1u]) <<  8u)
+		| (((uint32_t) crcbuf[2u]) << 16u)
+		| (((uint32_t) crcbuf[3u]) << 24u)
+	);
+
+	/* decode TTA to I32 */
+	misc.dest_len            = mt->ni32_perframe;
+	misc.src_len             = slot->ttabuf_len;
+	misc.ni32_target         = ni32;
+	misc.nbytes_tta_target   = slot->nbytes_tta;
+	misc.ni32_perframe       = ni32;
+	misc.nbytes_tta_perframe = slot->nbytes_tta;
+	misc.samplebytes         = mt->config.samplebytes;
+	misc.nchan               = mt->config.nchan;
+	/* * */
+	status = libttaR_tta_decode_kernel(
+		worker->i32buf, slot->ttabuf, worker->priv, &user, &misc,
+		mt->config.kernel
+	);
+	switch ( status ){
+	case LIBTTAr_DRV_OK_DONE:
+		slot->status = (user.crc == crc_read
+			? LIBTTAr_MT_FRAME_OK : LIBTTAr_MT_FRAME_BADCRC
+		);
+		break;
+	case LIBTTAr_DRV_FAIL_DECODE:
+		memset(
+			&worker->i32buf[user.ni32_total], 0,
+			(ni32 - user.ni32_total) * sizeof *worker->i32buf
+		);
+		slot->status = LIBTTAr_MT_FRAME_FAIL;
+		break;
+	default:
+		/* bad frame length or the like */
+		memset(worker->i32buf, 0, ni32 * sizeof *worker->i32buf);
+		slot->status = LIBTTAr_MT_FRAME_FAIL;
+		break;
+	}
+
+	/* convert I32 to PCM */
+	result.z = libttaR_pcm_write(
+		slot->pcmbuf, worker->i32buf, ni32, mt->config.samplebytes
+	);
+	assert(result.z != 0);
+
+	slot->data_len = ni32 * (size_t) mt->config.samplebytes;
+	return;
+}
+
+/* EOF //////////////////////////////////////////////////////////////////// */
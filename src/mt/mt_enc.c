@@ -0,0 +1,144 @@
+/* ///////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// mt/mt_enc.c                                                              //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Copyright (C) 2023-2026, Shane Seelig                                    //
+// SPDX-License-Identifier: GPL-3.0-or-later                                //
+//                                                                          //
+/////////////////////////////////////////////////////////////////////////// */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../libttaR.h"
+#include "../libttaR_mt.h"
+
+#include "../cli/common.h"
+#include "./mt.h"
+
+/* //////////////////////////////////////////////////////////////////////// */
+
+/**@fn mt_slot_fill_enc
+ * @brief copies a PCM frame into a slot
+ *
+ * @param mt       - the coder
+ * @param slot     - the slot
+ * @param buf      - PCM frame
+ * @param len      - length of 'buf' in bytes
+ * @param nsamples - number of samples per channel in the frame
+ *
+ * @return LIBTTAr_MT_OK, or LIBTTAr_MT_ERR_INVAL
+**/
+BUILD enum LibTTAr_MT_RetVal
+mt_slot_fill_enc(
+	const struct LibTTAr_MT *const RESTRICT mt,
+	struct MT_Slot *const RESTRICT slot, const void *const RESTRICT buf,
+	const size_t len, const size_t nsamples
+)
+/*@modifies	*slot@*/
+{
+	const size_t nbytes_pcm = (
+		nsamples * mt->config.nchan * (size_t) mt->config.samplebytes
+	);
+
+	if UNLIKELY ( len != nbytes_pcm ){
+		return LIBTTAr_MT_ERR_INVAL;
+	}
+	memcpy(slot->pcmbuf, buf, len);
+	return LIBTTAr_MT_OK;
+}
+
+/* ======================================================================== */
+
+/**@fn mt_slot_encode
+ * @brief encodes a slot's PCM frame to TTA, and appends the frame CRC
+ *
+ * @param worker - the worker
+ * @param slot   - the slot
+ *
+ * @note the CRC is stored little-endian, same as in a TTA1 file
+**/
+HOT
+BUILD void
+mt_slot_encode(
+	struct MT_Worker *const RESTRICT worker,
+	struct MT_Slot *const RESTRICT slot
+)
+/*@modifies	*worker,
+		*slot
+@*/
+{
+	const struct LibTTAr_MT *const mt = worker->mt;
+	const size_t ni32 = slot->nsamples * mt->config.nchan;
+	/* * */
+	enum LibTTAr_EncRetVal status;
+	struct LibTTAr_CodecState_User user = LIBTTAr_CODECSTATE_USER_INIT;
+	struct LibTTAr_EncMisc misc;
+	uint8_t *ttabuf;
+	size_t ttabuf_len;
+	UNUSED union {	size_t z; } result;
+
+	/* convert PCM to I32 */
+	result.z = libttaR_pcm_read(
+		worker->i32buf, slot->pcmbuf, ni32, mt->config.samplebytes
+	);
+	assert(result.z != 0);
+
+	/* encode I32 to TTA */
+	misc.ni32_perframe = ni32;
+	misc.samplebytes   = mt->config.samplebytes;
+	misc.nchan         = mt->config.nchan;
+	goto loop_entr;
+	do {
+		ttabuf_len = slot->ttabuf_len + slot->ttabuf_len / 2u;
+		ttabuf     = realloc(slot->ttabuf, ttabuf_len);
+		if UNLIKELY ( ttabuf == NULL ){
+			slot->data_len = 0;
+			slot->status   = LIBTTAr_MT_FRAME_FAIL;
+			return;
+		}
+		slot->ttabuf     = ttabuf;
+		slot->ttabuf_len = ttabuf_len;
+loop_entr:
+		misc.dest_len    = (
+			slot->ttabuf_len - FRAME_CRC_SIZE
+			- user.nbytes_tta_total
+		);
+		misc.src_len     = mt->ni32_perframe - user.ni32_total;
+		misc.ni32_target = ni32 - user.ni32_total;
+
+		status = libttaR_tta_encode_kernel(
+			&slot->ttabuf[user.nbytes_tta_total],
+			&worker->i32buf[user.ni32_total],
+			worker->priv, &user, &misc, mt->config.kernel
+		);
+		if UNLIKELY (
+		     (status != LIBTTAr_ERV_OK_DONE)
+		    &&
+		     (status != LIBTTAr_ERV_OK_AGAIN)
+		){
+			slot->data_len = 0;
+			slot->status   = LIBTTAr_MT_FRAME_FAIL;
+			return;
+		}
+	}
+	while ( status == LIBTTAr_ERV_OK_AGAIN );
+
+	/* append the CRC */
+	ttabuf = &slot->ttabuf[user.nbytes_tta_total];
+	ttabuf[0u] = (uint8_t)  user.crc;
+	ttabuf[1u] = (uint8_t) (user.crc >>  8u);
+	ttabuf[2u] = (uint8_t) (user.crc >> 16u);
+	ttabuf[3u] = (uint8_t) (user.crc >> 24u);
+
+	slot->data_len = user.nbytes_tta_total + FRAME_CRC_SIZE;
+	slot->status   = LIBTTAr_MT_FRAME_OK;
+	return;
+}
+
+/* EOF //////////////////////////////////////////////////////////////////// */
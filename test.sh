@@ -0,0 +1,104 @@
+#!/bin/sh -
+#
+# usage: test.sh
+#
+# regression tests for the CLI; build with make.sh first. exits non-zero
+#   if any test fails
+#
+#   subframe: 'decode --subframe=N' must give the same bytes as '-S' for
+#     small N. silent audio codes to a few bits per sample, so a chunk can
+#     end with the rest of the frame already in the decoder's bitcache
+
+readonly ROOT="$(realpath "$(dirname "$0")")";
+readonly BUILD="$ROOT/build";
+
+readonly CLI="$BUILD/ttaR";
+
+##############################################################################
+
+if [ ! -x "$CLI" ]; then
+	printf '%s: %s not built; run make.sh\n' "$0" "$CLI" >&2;
+	exit 1;
+fi
+
+TMP="$(mktemp -d)" || exit $?;
+readonly TMP;
+trap 'rm -rf -- "$TMP"' EXIT;
+
+export LD_LIBRARY_PATH="$BUILD${LD_LIBRARY_PATH:+:$LD_LIBRARY_PATH}";
+
+NFAIL=0;
+
+# le32 VALUE; le16 VALUE
+le32() {
+	printf "$(printf '\\%03o\\%03o\\%03o\\%03o' \
+		$(($1 & 255)) $((($1 >> 8) & 255)) \
+		$((($1 >> 16) & 255)) $((($1 >> 24) & 255)) \
+	)";
+}
+le16() {
+	printf "$(printf '\\%03o\\%03o' $(($1 & 255)) $((($1 >> 8) & 255)))";
+}
+
+# mkwav OUTFILE SAMPLEBITS NCHAN < PCM
+mkwav() {
+	cat > "$TMP/pcm" || exit $?;
+	size="$(wc -c < "$TMP/pcm")";
+	blockalign=$(($3 * $2 / 8));
+	{
+		printf 'RIFF'; le32 $((36 + size)); printf 'WAVEfmt ';
+		le32 16; le16 1; le16 "$3"; le32 44100;
+		le32 $((44100 * blockalign)); le16 "$blockalign"; le16 "$2";
+		printf 'data'; le32 "$size";
+		cat "$TMP/pcm";
+	} > "$1" || exit $?;
+}
+
+# check NAME CMD...
+check() {
+	name="$1";
+	shift;
+	if ! "$@"; then
+		printf 'FAIL: %s\n' "$name" >&2;
+		NFAIL=$((NFAIL + 1));
+	fi
+}
+
+##############################################################################
+
+# subframe
+
+# ~3 frames each; 8-bit silence is 0x80
+head -c 120000 /dev/zero | tr '\000' '\200' \
+	| mkwav "$TMP/sil8_1.wav" 8 1;
+head -c 240000 /dev/zero | mkwav "$TMP/zero16_1.wav" 16 1;
+{ head -c 100000 /dev/urandom; head -c 140000 /dev/zero; } \
+	| mkwav "$TMP/mix8_2.wav" 8 2;
+{ head -c 360000 /dev/zero; head -c 360000 /dev/urandom; } \
+	| mkwav "$TMP/mix24_2.wav" 24 2;
+
+for wav in "$TMP"/*.wav; do
+	tta="${wav%.wav}.tta";
+	"$CLI" encode -q -S -o "$tta" -- "$wav" || exit $?;
+	"$CLI" decode -q -S -f raw -o "$TMP/ref.raw" -- "$tta" || exit $?;
+	for tm in -S -M; do
+		n=1;
+		while [ $n -le 8 ]; do
+			rm -f -- "$TMP/sub.raw";
+			check "subframe $(basename "$wav") $tm $n" "$CLI" decode \
+				-q $tm --subframe=$n -f raw -o "$TMP/sub.raw" \
+				-- "$tta";
+			check "subframe $(basename "$wav") $tm $n: output" \
+				cmp -s "$TMP/ref.raw" "$TMP/sub.raw";
+			n=$((n + 1));
+		done
+	done
+done
+
+##############################################################################
+
+if [ $NFAIL -ne 0 ]; then
+	printf '%d failed\n' $NFAIL >&2;
+	exit 1;
+fi
+printf 'all passed\n';